@@ -15,6 +15,8 @@
 #include <proc/pipeline/nodes/face_detection_node.hpp>
 #include <proc/pipeline/nodes/face_recognition_node.hpp>
 #include <proc/pipeline/nodes/face_matcher_node.hpp>
+#include <proc/pipeline/nodes/face_quality_node.hpp>
+#include <proc/pipeline/nodes/motion_gate_node.hpp>
 #include <proc/pipeline/nodes/person_detection_node.hpp>
 #include <proc/pipeline/nodes/resizer_node.hpp>
 #include <proc/pipeline/nodes/drawer_node.hpp>
@@ -22,6 +24,7 @@
 #include <proc/settings/settings_face_detector.hpp>
 #include <proc/settings/settings_person_detector.hpp>
 #include <proc/settings/settings_resizer.hpp>
+#include <proc/settings/settings_tiling_detector.hpp>
 #include <proc/settings/settings_neural_onnxruntime.hpp>
 #include <proc/settings/settings_video_processor_task.hpp>
 
@@ -46,6 +49,8 @@ Registrator::Registrator()
     REGISTER_TASK_SETTINGS_CREATOR(proc::FaceDetectionNodeSettings  ::SETTINGS_ID, &proc::create_face_detection_node_settings   );
     REGISTER_TASK_SETTINGS_CREATOR(proc::FaceRecognitionNodeSettings::SETTINGS_ID, &proc::create_face_recognition_node_settings );
     REGISTER_TASK_SETTINGS_CREATOR(proc::FaceMatcherNodeSettings    ::SETTINGS_ID, &proc::create_face_matcher_node_settings     );
+    REGISTER_TASK_SETTINGS_CREATOR(proc::FaceQualityNodeSettings    ::SETTINGS_ID, &proc::create_face_quality_node_settings     );
+    REGISTER_TASK_SETTINGS_CREATOR(proc::MotionGateNodeSettings     ::SETTINGS_ID, &proc::create_motion_gate_node_settings      );
     REGISTER_TASK_SETTINGS_CREATOR(proc::PersonDetectionNodeSettings::SETTINGS_ID, &proc::create_person_detection_node_settings );
     REGISTER_TASK_SETTINGS_CREATOR(proc::ResizerNodeSettings        ::SETTINGS_ID, &proc::create_resizer_node_settings          );
     REGISTER_TASK_SETTINGS_CREATOR(proc::DrawerNodeSettings         ::SETTINGS_ID, &proc::create_drawer_node_settings           );
@@ -54,6 +59,8 @@ Registrator::Registrator()
     REGISTER_TASK_CREATOR_UNIQUE(proc::FaceDetectionNodeSettings    ::SETTINGS_ID, &proc::create_face_detection_node    );
     REGISTER_TASK_CREATOR_UNIQUE(proc::FaceRecognitionNodeSettings  ::SETTINGS_ID, &proc::create_face_recognition_node  );
     REGISTER_TASK_CREATOR_UNIQUE(proc::FaceMatcherNodeSettings      ::SETTINGS_ID, &proc::create_face_matcher_node      );
+    REGISTER_TASK_CREATOR_UNIQUE(proc::FaceQualityNodeSettings      ::SETTINGS_ID, &proc::create_face_quality_node      );
+    REGISTER_TASK_CREATOR_UNIQUE(proc::MotionGateNodeSettings       ::SETTINGS_ID, &proc::create_motion_gate_node       );
     REGISTER_TASK_CREATOR_UNIQUE(proc::PersonDetectionNodeSettings  ::SETTINGS_ID, &proc::create_person_detection_node  );
     REGISTER_TASK_CREATOR_UNIQUE(proc::ResizerNodeSettings          ::SETTINGS_ID, &proc::create_resizer_node           );
     REGISTER_TASK_CREATOR_UNIQUE(proc::DrawerNodeSettings           ::SETTINGS_ID, &proc::create_drawer_node            );
@@ -65,11 +72,13 @@ Registrator::Registrator()
     /* clang-format off */
     REGISTER_TASK_SETTINGS_CREATOR(proc::SettingsFaceDetector       ::SETTINGS_ID, &proc::create_face_detector_settings         );
     REGISTER_TASK_SETTINGS_CREATOR(proc::SettingsPersonDetector     ::SETTINGS_ID, &proc::create_person_detector_settings       );
+    REGISTER_TASK_SETTINGS_CREATOR(proc::SettingsTilingDetector     ::SETTINGS_ID, &proc::create_tiling_detector_settings       );
     REGISTER_TASK_SETTINGS_CREATOR(proc::SettingsResizer            ::SETTINGS_ID, &proc::create_resizer_settings               );
     REGISTER_TASK_SETTINGS_CREATOR(proc::SettingsVideoProcessorTask ::SETTINGS_ID, &proc::create_video_processor_task_settings  );
 
     REGISTER_TASK_CREATOR_UNIQUE(proc::SettingsFaceDetector         ::SETTINGS_ID, &proc::create_face_detector          );
     REGISTER_TASK_CREATOR_UNIQUE(proc::SettingsPersonDetector       ::SETTINGS_ID, &proc::create_person_detector        );
+    REGISTER_TASK_CREATOR_UNIQUE(proc::SettingsTilingDetector       ::SETTINGS_ID, &proc::create_tiling_detector        );
     REGISTER_TASK_CREATOR_UNIQUE(proc::SettingsResizer              ::SETTINGS_ID, &proc::create_effect_resizer         );
     REGISTER_TASK_CREATOR_UNIQUE(proc::SettingsVideoProcessorTask   ::SETTINGS_ID, &proc::create_video_processor_task   );
     /* clang-format on */
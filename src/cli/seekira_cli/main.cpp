@@ -0,0 +1,169 @@
+#include <core/log/log.hpp>
+#include <core/base/json/json_utils.hpp>
+
+#include <application/registrator.hpp>
+
+#include <proc/video/offline_analyzer.hpp>
+
+#include <fmt/format.h>
+
+#include <charconv>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Headless batch analysis: SeekiraCli <config.json> [-o <output dir>] [-j <segments>] <video>...
+ *
+ * Config has the same layout as video_processing_manager.json. Results of every video are written
+ * to <output dir>/<video name>.seekira.tsv, by default next to the video.
+ * -j splits every video into keyframe-aligned segments analysed concurrently (overrides segment_workers).
+ */
+
+namespace {
+
+constexpr std::string_view RESULTS_EXTENSION = ".seekira.tsv";
+
+struct Arguments
+{
+    std::string config_path;
+    std::filesystem::path output_dir;
+    size_t segment_workers{0};  // 0 - из конфига
+    std::vector<std::string> videos;
+};
+
+bool parse_arguments(int argc, char* argv[], Arguments& args)
+{
+    for (int i = 1; i < argc; ++i)
+    {
+        const std::string arg = argv[i];
+        if (arg == "-o" || arg == "--output")
+        {
+            if (++i == argc)
+                return false;
+            args.output_dir = argv[i];
+        }
+        else if (arg == "-j" || arg == "--segments")
+        {
+            if (++i == argc)
+                return false;
+            const std::string_view value = argv[i];
+            const auto [ptr, ec] = std::from_chars(value.data(), value.data() + value.size(), args.segment_workers);
+            if (ec != std::errc() || ptr != value.data() + value.size())
+                return false;
+        }
+        else if (args.config_path.empty())
+        {
+            args.config_path = arg;
+        }
+        else
+        {
+            args.videos.push_back(arg);
+        }
+    }
+
+    return !args.config_path.empty() && !args.videos.empty();
+}
+
+std::filesystem::path get_results_path(const Arguments& args, const std::filesystem::path& video)
+{
+    const auto dir = args.output_dir.empty() ? video.parent_path() : args.output_dir;
+    return dir / (video.filename().string() + std::string(RESULTS_EXTENSION));
+}
+
+void print_stats(const step::proc::OfflineAnalysisStats& stats)
+{
+    fmt::print("{}: {} frames, {} faces ({} matched), {} persons\n", stats.filename, stats.frames, stats.faces,
+               stats.matched_faces, stats.persons);
+    if (stats.segments > 1)
+        fmt::print("    {} segments, {} warmup frames, stage times are summed over segments\n", stats.segments,
+                   stats.warmup_frames);
+    fmt::print("    decode   {:8.1f} fps  {:10.3f} s\n", stats.get_fps(stats.decode_time),
+               stats.decode_time.count() / 1e6);
+    fmt::print("    analysis {:8.1f} fps  {:10.3f} s  (waiting for decoder {:.3f} s)\n",
+               stats.get_fps(stats.analysis_time), stats.analysis_time.count() / 1e6, stats.decode_wait.count() / 1e6);
+    fmt::print("    total    {:8.1f} fps  {:10.3f} s\n", stats.get_fps(stats.wall_time), stats.wall_time.count() / 1e6);
+}
+
+void print_nodes_stats(const std::vector<step::proc::PipelineNodeStatsSnapshot>& nodes)
+{
+    for (const auto& node : nodes)
+    {
+        const auto fps = node.exec_mean.count() > 0 ? 1e6 / static_cast<double>(node.exec_mean.count()) : 0.0;
+        fmt::print("    {:<32} {:8} frames {:8.1f} fps  exec us mean/p95/max {}/{}/{}  exceptions {}\n", node.id,
+                   node.processed, fps, node.exec_mean.count(), node.exec_p95.count(), node.exec_max.count(),
+                   node.exceptions);
+    }
+}
+
+void print_pipeline_stats(const std::vector<step::proc::PipelineProfilerPtr>& profilers)
+{
+    for (size_t i = 0; i < profilers.size(); ++i)
+    {
+        if (!profilers[i])
+            continue;
+
+        fmt::print("Pipeline {} nodes (all files):\n", i);
+        print_nodes_stats(profilers[i]->get_nodes_snapshot());
+    }
+}
+
+}  // namespace
+
+int main(int argc, char* argv[])
+{
+    Arguments args;
+    if (!parse_arguments(argc, argv, args))
+    {
+        fmt::print(stderr, "Usage: {} <config.json> [-o <output dir>] [-j <segments>] <video>...\n",
+                   argc > 0 ? argv[0] : "SeekiraCli");
+        return 2;
+    }
+
+    int exit_code = 0;
+    try
+    {
+#ifdef STEPKIT_DEBUG
+        step::log::Logger::instance().set_log_level(L_DEBUG);
+#endif
+
+        step::app::Registrator::instance();
+
+        auto cfg = step::json::utils::from_file(args.config_path);
+        step::proc::OfflineAnalyzer analyzer(cfg);
+        if (args.segment_workers > 0)
+            analyzer.set_segment_workers(args.segment_workers);
+        STEP_LOG(L_INFO, "OfflineAnalyzer created, segment workers {}", analyzer.get_segment_workers());
+
+        for (const auto& video : args.videos)
+        {
+            try
+            {
+                const auto results_path = get_results_path(args, video);
+                print_stats(analyzer.analyze(video, results_path));
+                fmt::print("    results  {}\n", results_path.string());
+            }
+            catch (const std::exception& ex)
+            {
+                // Один битый файл не должен останавливать ночную обработку архива
+                STEP_LOG(L_ERROR, "Failed to analyze {}: {}", video, ex.what());
+                fmt::print(stderr, "{}: failed: {}\n", video, ex.what());
+                exit_code = 1;
+            }
+        }
+
+        print_pipeline_stats(analyzer.get_profilers());
+    }
+    catch (const std::exception& ex)
+    {
+        STEP_LOG(L_CRITICAL, "Unhandled exception: {}", ex.what());
+        exit_code = -1;
+    }
+    catch (...)
+    {
+        STEP_LOG(L_CRITICAL, "Unknown unhandled exception!");
+        exit_code = -1;
+    }
+
+    return exit_code;
+}
@@ -63,11 +63,15 @@ const std::string CFG_FLD::EXPOSURE = "exposure";
 const std::string CFG_FLD::FRAME_RATE = "frame_rate";
 const std::string CFG_FLD::RECONNECT_TIMEOUT = "reconnect_timeout";
 const std::string CFG_FLD::CYCLIC = "cyclic";
+const std::string CFG_FLD::REPLAY = "replay";
+const std::string CFG_FLD::REPLAY_FILE = "replay_file";
 
 const std::string CFG_FLD::TASK_SETTINGS_ID = "task_settings_id";
 
 const std::string CFG_FLD::PIXEL_FORMAT = "pixel_format";
 const std::string CFG_FLD::FRAME_SIZE = "frame_size";
+const std::string CFG_FLD::LETTERBOX = "letterbox";
+const std::string CFG_FLD::ANALYSIS_FRAMES = "analysis_frames";
 
 const std::string CFG_FLD::PIPELINE = "pipeline";
 const std::string CFG_FLD::NODE = "node";
@@ -75,6 +79,23 @@ const std::string CFG_FLD::NODES = "nodes";
 const std::string CFG_FLD::LINK = "link";
 const std::string CFG_FLD::LINKS = "links";
 const std::string CFG_FLD::SYNC_MODE = "sync_mode";
+const std::string CFG_FLD::FORK_JOIN = "fork_join";
+const std::string CFG_FLD::INPUT_POLICY = "input_policy";
+const std::string CFG_FLD::INPUT_QUEUE_SIZE = "input_queue_size";
+
+const std::string CFG_FLD::LOAD_CONTROL = "load_control";
+const std::string CFG_FLD::LOAD_SHEDDING = "load_shedding";
+const std::string CFG_FLD::LOAD_LEVELS = "levels";
+const std::string CFG_FLD::SAMPLE_INTERVAL = "sample_interval_ms";
+const std::string CFG_FLD::LATENCY_TARGET = "latency_target_ms";
+const std::string CFG_FLD::QUEUE_TARGET = "queue_target";
+const std::string CFG_FLD::RECOVER_RATIO = "recover_ratio";
+const std::string CFG_FLD::DEGRADE_SAMPLES = "degrade_samples";
+const std::string CFG_FLD::RECOVER_SAMPLES = "recover_samples";
+const std::string CFG_FLD::LOW_PRIORITY = "low_priority";
+const std::string CFG_FLD::RESIZE_SCALE = "resize_scale";
+const std::string CFG_FLD::DETECT_INTERVAL = "detect_interval";
+const std::string CFG_FLD::SKIP_RECOGNITION = "skip_recognition";
 
 const std::string CFG_FLD::VIDEO_PROCESSOR = "video_processor";
 
@@ -92,16 +113,72 @@ const std::string CFG_FLD::FACE_ENGINE_CONTROLLER = "face_engine_controller";
 
 const std::string CFG_FLD::PERSON_HOLDERS = "person_holders";
 const std::string CFG_FLD::PERSON_DETECTION_RESULT = "person_detection_result";
+const std::string CFG_FLD::DETECTION_SCORES = "detection_scores";
+
+const std::string CFG_FLD::DETECTOR_SETTINGS = "detector_settings";
+const std::string CFG_FLD::TILE_SIZE = "tile_size";
+const std::string CFG_FLD::TILE_OVERLAP = "tile_overlap";
+const std::string CFG_FLD::TILE_SCALES = "tile_scales";
+const std::string CFG_FLD::TILE_FULL_FRAME = "tile_full_frame";
+const std::string CFG_FLD::TILE_WORKERS = "tile_workers";
+const std::string CFG_FLD::NMS_THRESHOLD = "nms_threshold";
+
+const std::string CFG_FLD::MOTION_RESULT = "motion_result";
+const std::string CFG_FLD::MOTION_GATING = "motion_gating";
+const std::string CFG_FLD::MOTION_ANALYSIS_WIDTH = "analysis_width";
+const std::string CFG_FLD::MOTION_BLOCK_SIZE = "block_size";
+const std::string CFG_FLD::MOTION_PIXEL_THRESHOLD = "pixel_threshold";
+const std::string CFG_FLD::MOTION_BLOCK_THRESHOLD = "block_threshold";
+const std::string CFG_FLD::MOTION_ACTIVATE_FRAMES = "activate_frames";
+const std::string CFG_FLD::MOTION_DEACTIVATE_FRAMES = "deactivate_frames";
+const std::string CFG_FLD::MOTION_IDLE_INTERVAL = "idle_interval";
+const std::string CFG_FLD::MOTION_REGION_MARGIN = "region_margin";
+const std::string CFG_FLD::MOTION_MAX_REGION_AREA = "max_region_area";
+
+const std::string CFG_FLD::FACE_QUALITY = "face_quality";
+const std::string CFG_FLD::FACE_QUALITY_MIN_SIZE = "min_size";
+const std::string CFG_FLD::FACE_QUALITY_MIN_SHARPNESS = "min_sharpness";
+const std::string CFG_FLD::FACE_QUALITY_MAX_YAW = "max_yaw";
+const std::string CFG_FLD::FACE_QUALITY_MAX_PITCH = "max_pitch";
+const std::string CFG_FLD::FACE_QUALITY_MIN_CONFIDENCE = "min_confidence";
+const std::string CFG_FLD::FACE_QUALITY_SHARPNESS_SIZE = "sharpness_size";
+const std::string CFG_FLD::FACE_QUALITY_BEST_PER_TRACK = "best_per_track";
+const std::string CFG_FLD::FACE_QUALITY_TRACK_IOU = "track_iou";
+const std::string CFG_FLD::FACE_QUALITY_TRACK_TTL = "track_ttl";
+const std::string CFG_FLD::FACE_QUALITY_IMPROVE_RATIO = "improve_ratio";
 
 const std::string CFG_FLD::RESIZER_SETTINGS = "resizer_settings";
 const std::string CFG_FLD::RESIZER_SIZE_MODE = "size_mode";
 
 const std::string CFG_FLD::READER_FF_SETTINGS = "reader_ff";
+const std::string CFG_FLD::KEYFRAME_INDEX_SCAN = "keyframe_index_scan";
+const std::string CFG_FLD::KEYFRAME_INDEX_SIDECAR = "keyframe_index_sidecar";
+const std::string CFG_FLD::GOP_CACHE_SIZE = "gop_cache_size_mb";
+const std::string CFG_FLD::IO_BUFFER_SIZE = "io_buffer_size_kb";
+const std::string CFG_FLD::IO_MMAP = "io_mmap";
+const std::string CFG_FLD::IO_PREFETCH = "io_prefetch";
+const std::string CFG_FLD::DECODER_THREADS = "decoder_threads";
+const std::string CFG_FLD::REALTIME_PACING = "realtime_pacing";
+const std::string CFG_FLD::MAX_LATENESS = "max_lateness_ms";
+
+const std::string CFG_FLD::OFFLINE_ANALYZER = "offline_analyzer";
+const std::string CFG_FLD::SEGMENT_WORKERS = "segment_workers";
+const std::string CFG_FLD::SEGMENT_WARMUP = "segment_warmup_ms";
+
+const std::string CFG_FLD::INGEST_MANAGER = "ingest_manager";
+const std::string CFG_FLD::INGEST_WORKERS = "workers";
+const std::string CFG_FLD::INGEST_STREAMS = "streams";
+const std::string CFG_FLD::STREAM_PRIORITY = "priority";
+const std::string CFG_FLD::STREAM_QUEUE_SIZE = "queue_size";
 
 const std::string CFG_FLD::DRAWER_SETTINGS = "drawer_settings";
 
 const std::string CFG_FLD::NEURAL_NET_SETTINGS = "neural_net_settings";
 const std::string CFG_FLD::MEAN_VALUES = "mean_values";
 const std::string CFG_FLD::NORM_VALUES = "norm_values";
+const std::string CFG_FLD::PRECISION = "precision";
+const std::string CFG_FLD::QUANTIZATION = "quantization";
+const std::string CFG_FLD::INT8_MODEL_PATH = "int8_model_path";
+const std::string CFG_FLD::CALIBRATION_PATH = "calibration_path";
 
 }  // namespace step
\ No newline at end of file
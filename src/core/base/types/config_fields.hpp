@@ -85,6 +85,8 @@ public:
     static const std::string FRAME_RATE;
     static const std::string RECONNECT_TIMEOUT;
     static const std::string CYCLIC;
+    static const std::string REPLAY;
+    static const std::string REPLAY_FILE;
 
     /* Abstract task */
     static const std::string TASK_SETTINGS_ID;
@@ -92,6 +94,8 @@ public:
     /* Frame */
     static const std::string PIXEL_FORMAT;
     static const std::string FRAME_SIZE;
+    static const std::string LETTERBOX;
+    static const std::string ANALYSIS_FRAMES;
 
     /* Frame pipeline */
     static const std::string PIPELINE;
@@ -100,6 +104,24 @@ public:
     static const std::string LINK;
     static const std::string LINKS;
     static const std::string SYNC_MODE;
+    static const std::string FORK_JOIN;
+    static const std::string INPUT_POLICY;
+    static const std::string INPUT_QUEUE_SIZE;
+
+    /* Load control */
+    static const std::string LOAD_CONTROL;
+    static const std::string LOAD_SHEDDING;
+    static const std::string LOAD_LEVELS;
+    static const std::string SAMPLE_INTERVAL;
+    static const std::string LATENCY_TARGET;
+    static const std::string QUEUE_TARGET;
+    static const std::string RECOVER_RATIO;
+    static const std::string DEGRADE_SAMPLES;
+    static const std::string RECOVER_SAMPLES;
+    static const std::string LOW_PRIORITY;
+    static const std::string RESIZE_SCALE;
+    static const std::string DETECT_INTERVAL;
+    static const std::string SKIP_RECOGNITION;
 
     /* Video processing */
     static const std::string VIDEO_PROCESSOR;
@@ -119,6 +141,42 @@ public:
 
     static const std::string PERSON_HOLDERS;
     static const std::string PERSON_DETECTION_RESULT;
+    static const std::string DETECTION_SCORES;
+
+    /* Tiling detector */
+    static const std::string DETECTOR_SETTINGS;
+    static const std::string TILE_SIZE;
+    static const std::string TILE_OVERLAP;
+    static const std::string TILE_SCALES;
+    static const std::string TILE_FULL_FRAME;
+    static const std::string TILE_WORKERS;
+    static const std::string NMS_THRESHOLD;
+
+    /* Motion gate */
+    static const std::string MOTION_RESULT;
+    static const std::string MOTION_GATING;
+    static const std::string MOTION_ANALYSIS_WIDTH;
+    static const std::string MOTION_BLOCK_SIZE;
+    static const std::string MOTION_PIXEL_THRESHOLD;
+    static const std::string MOTION_BLOCK_THRESHOLD;
+    static const std::string MOTION_ACTIVATE_FRAMES;
+    static const std::string MOTION_DEACTIVATE_FRAMES;
+    static const std::string MOTION_IDLE_INTERVAL;
+    static const std::string MOTION_REGION_MARGIN;
+    static const std::string MOTION_MAX_REGION_AREA;
+
+    /* Face quality */
+    static const std::string FACE_QUALITY;
+    static const std::string FACE_QUALITY_MIN_SIZE;
+    static const std::string FACE_QUALITY_MIN_SHARPNESS;
+    static const std::string FACE_QUALITY_MAX_YAW;
+    static const std::string FACE_QUALITY_MAX_PITCH;
+    static const std::string FACE_QUALITY_MIN_CONFIDENCE;
+    static const std::string FACE_QUALITY_SHARPNESS_SIZE;
+    static const std::string FACE_QUALITY_BEST_PER_TRACK;
+    static const std::string FACE_QUALITY_TRACK_IOU;
+    static const std::string FACE_QUALITY_TRACK_TTL;
+    static const std::string FACE_QUALITY_IMPROVE_RATIO;
 
     /* Resizer */
     static const std::string RESIZER_SETTINGS;
@@ -126,6 +184,27 @@ public:
 
     /* ReaderFF */
     static const std::string READER_FF_SETTINGS;
+    static const std::string KEYFRAME_INDEX_SCAN;
+    static const std::string KEYFRAME_INDEX_SIDECAR;
+    static const std::string GOP_CACHE_SIZE;
+    static const std::string IO_BUFFER_SIZE;
+    static const std::string IO_MMAP;
+    static const std::string IO_PREFETCH;
+    static const std::string DECODER_THREADS;
+    static const std::string REALTIME_PACING;
+    static const std::string MAX_LATENESS;
+
+    /* Offline analyzer */
+    static const std::string OFFLINE_ANALYZER;
+    static const std::string SEGMENT_WORKERS;
+    static const std::string SEGMENT_WARMUP;
+
+    /* Ingest manager */
+    static const std::string INGEST_MANAGER;
+    static const std::string INGEST_WORKERS;
+    static const std::string INGEST_STREAMS;
+    static const std::string STREAM_PRIORITY;
+    static const std::string STREAM_QUEUE_SIZE;
 
     /* Drawer */
     static const std::string DRAWER_SETTINGS;
@@ -134,6 +213,10 @@ public:
     static const std::string NEURAL_NET_SETTINGS;
     static const std::string MEAN_VALUES;
     static const std::string NORM_VALUES;
+    static const std::string PRECISION;
+    static const std::string QUANTIZATION;
+    static const std::string INT8_MODEL_PATH;
+    static const std::string CALIBRATION_PATH;
 };
 
 }  // namespace step
\ No newline at end of file
@@ -10,6 +10,37 @@ void MetaStorage::set_attachment(const std::string& id, std::any&& attachment)
         STEP_LOG(L_TRACE, "MetaStorage already has {}, rewrite", id);
 
     m_storage[id] = std::move(attachment);
+    if (m_writer)
+        m_changes[id] = *m_writer;
+}
+
+void MetaStorage::track_changes(uint32_t writer) { m_writer = writer; }
+
+void MetaStorage::reset_changes()
+{
+    m_changes.clear();
+    m_writer.reset();
+}
+
+MetaStorage MetaStorage::fork() const
+{
+    MetaStorage copy;
+    copy.m_storage = m_storage;
+    copy.m_writer = m_writer;
+    return copy;
+}
+
+void MetaStorage::merge_changes(MetaStorage&& forked)
+{
+    for (const auto& [id, writer] : forked.m_changes)
+    {
+        if (auto it = m_changes.find(id); it != m_changes.cend() && it->second >= writer)
+            continue;
+
+        m_storage[id] = std::move(forked.m_storage[id]);
+        m_changes[id] = writer;
+    }
+    forked.m_changes.clear();
 }
 
 std::any MetaStorage::get_attachment_impl(const std::string& id) const
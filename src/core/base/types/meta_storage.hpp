@@ -3,6 +3,7 @@
 #include <core/log/log.hpp>
 
 #include <any>
+#include <cstdint>
 #include <optional>
 #include <memory>
 #include <string>
@@ -15,6 +16,25 @@ class MetaStorage
 public:
     void set_attachment(const std::string& id, std::any&& attachment);
 
+    /*! @brief Включает журнал изменений: дальнейшие записи помечаются меткой writer.
+        @details Метка задает порядок записей разных копий при слиянии, например индекс ветви пайплайна.
+    */
+    void track_changes(uint32_t writer);
+
+    /*! @brief Очищает журнал изменений и выключает его.
+    */
+    void reset_changes();
+
+    /*! @brief Копия для параллельной обработки: все вложения, пустой журнал и та же метка записи.
+    */
+    MetaStorage fork() const;
+
+    /*! @brief Переносит вложения, записанные в копии после fork(). Остальные не трогаются.
+        @details Из записей одного вложения остается запись с большей меткой, поэтому результат
+        не зависит от порядка слияния копий. Журнал копии очищается.
+    */
+    void merge_changes(MetaStorage&& forked);
+
     template <typename T>
     std::optional<T> get_attachment(const std::string& id) const noexcept
     {
@@ -38,6 +58,10 @@ private:
 
 private:
     std::unordered_map<std::string, std::any> m_storage;
+
+    // Журнал изменений: id вложения -> метка последней записи. Ведется только после track_changes
+    std::unordered_map<std::string, uint32_t> m_changes;
+    std::optional<uint32_t> m_writer;
 };
 
 using MetaStoragePtr = std::shared_ptr<MetaStorage>;
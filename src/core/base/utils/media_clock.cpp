@@ -0,0 +1,40 @@
+#include "media_clock.hpp"
+
+namespace step::utils {
+
+void MediaClock::start(Timestamp media_ts, Clock::time_point now)
+{
+    std::scoped_lock lock(m_guard);
+    m_media_anchor = media_ts;
+    m_wall_anchor = now;
+    m_started = true;
+}
+
+void MediaClock::reset()
+{
+    std::scoped_lock lock(m_guard);
+    m_started = false;
+}
+
+bool MediaClock::is_started() const
+{
+    std::scoped_lock lock(m_guard);
+    return m_started;
+}
+
+MediaClock::Clock::time_point MediaClock::get_deadline(Timestamp media_ts) const
+{
+    std::scoped_lock lock(m_guard);
+    // Без привязки кадр отдается сразу
+    if (!m_started)
+        return Clock::now();
+
+    return m_wall_anchor + std::chrono::duration_cast<Clock::duration>(media_ts - m_media_anchor);
+}
+
+Microseconds MediaClock::get_lateness(Timestamp media_ts, Clock::time_point now) const
+{
+    return std::chrono::duration_cast<Microseconds>(now - get_deadline(media_ts));
+}
+
+}  // namespace step::utils
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <core/base/types/time.hpp>
+
+#include <chrono>
+#include <mutex>
+
+namespace step::utils {
+
+/*! @brief Часы воспроизведения: переводят время кадра в момент, когда его пора отдать.
+    @details Привязка (start) связывает метку времени кадра с текущим моментом, дальше срок кадра
+    считается от нее, а не от момента выдачи предыдущего кадра: время чтения и обработки кадра
+    не накапливается в ошибку темпа. После паузы, перехода или отставания часы перепривязываются.
+    Потокобезопасны, один экземпляр может вести несколько источников.
+*/
+class MediaClock
+{
+public:
+    using Clock = std::chrono::steady_clock;
+
+public:
+    void start(Timestamp media_ts, Clock::time_point now = Clock::now());
+    void reset();
+    bool is_started() const;
+
+    /*! @brief Момент, к которому кадр с меткой media_ts должен быть отдан.
+    */
+    Clock::time_point get_deadline(Timestamp media_ts) const;
+
+    /*! @brief Насколько кадр опаздывает относительно своего срока, отрицательное значение - запас.
+    */
+    Microseconds get_lateness(Timestamp media_ts, Clock::time_point now = Clock::now()) const;
+
+private:
+    mutable std::mutex m_guard;
+    bool m_started{false};
+    Timestamp m_media_anchor{0};
+    Clock::time_point m_wall_anchor{};
+};
+
+}  // namespace step::utils
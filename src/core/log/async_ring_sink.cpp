@@ -0,0 +1,166 @@
+#include "async_ring_sink.hpp"
+
+#include <bit>
+#include <chrono>
+
+namespace {
+
+constexpr size_t MIN_CAPACITY = 64;
+constexpr int SPIN_COUNT = 64;
+constexpr size_t MAX_BATCH = 256;  // сообщений за один захват m_target_guard
+constexpr auto IDLE_SLEEP = std::chrono::microseconds(500);
+
+}  // namespace
+
+namespace step::log {
+
+AsyncRingSink::AsyncRingSink(spdlog::sink_ptr target, size_t capacity)
+    : m_target(std::move(target))
+    , m_slots(std::bit_ceil(std::max(capacity, MIN_CAPACITY)))
+    , m_mask(m_slots.size() - 1)
+{
+    for (size_t i = 0; i < m_slots.size(); ++i)
+        m_slots[i].sequence.store(i, std::memory_order_relaxed);
+
+    m_worker = std::thread(&AsyncRingSink::worker_thread, this);
+}
+
+AsyncRingSink::~AsyncRingSink()
+{
+    m_stop.store(true, std::memory_order_release);
+    if (m_worker.joinable())
+        m_worker.join();
+}
+
+void AsyncRingSink::log(const spdlog::details::log_msg& msg)
+{
+    if (!try_push(msg))
+        m_dropped.fetch_add(1, std::memory_order_relaxed);
+}
+
+void AsyncRingSink::flush()
+{
+    const auto target_pos = m_enqueue_pos.load(std::memory_order_acquire);
+    while (m_dequeue_pos.load(std::memory_order_acquire) < target_pos && !m_stop.load(std::memory_order_acquire))
+        std::this_thread::sleep_for(IDLE_SLEEP);
+
+    // Рабочий поток извлекает и пишет сообщения под m_target_guard, поэтому после захвата
+    // все извлеченные до target_pos сообщения уже записаны
+    std::scoped_lock lock(m_target_guard);
+    m_target->flush();
+}
+
+void AsyncRingSink::set_pattern(const std::string& pattern)
+{
+    std::scoped_lock lock(m_target_guard);
+    m_target->set_pattern(pattern);
+}
+
+void AsyncRingSink::set_formatter(std::unique_ptr<spdlog::formatter> sink_formatter)
+{
+    std::scoped_lock lock(m_target_guard);
+    m_target->set_formatter(std::move(sink_formatter));
+}
+
+bool AsyncRingSink::try_push(const spdlog::details::log_msg& msg)
+{
+    auto pos = m_enqueue_pos.load(std::memory_order_relaxed);
+    Slot* slot = nullptr;
+    for (;;)
+    {
+        slot = &m_slots[pos & m_mask];
+        const auto seq = slot->sequence.load(std::memory_order_acquire);
+        const auto diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos);
+        if (diff == 0)
+        {
+            if (m_enqueue_pos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                break;
+        }
+        else if (diff < 0)
+        {
+            return false;  // кольцо заполнено
+        }
+        else
+        {
+            pos = m_enqueue_pos.load(std::memory_order_relaxed);
+        }
+    }
+
+    // log_msg_buffer копирует payload во внутренний буфер (до 250 байт без аллокаций)
+    slot->msg = spdlog::details::log_msg_buffer(msg);
+    slot->sequence.store(pos + 1, std::memory_order_release);
+    return true;
+}
+
+bool AsyncRingSink::try_pop(spdlog::details::log_msg_buffer& msg)
+{
+    // Потребитель единственный, поэтому m_dequeue_pos меняется без CAS
+    const auto pos = m_dequeue_pos.load(std::memory_order_relaxed);
+    auto& slot = m_slots[pos & m_mask];
+    const auto seq = slot.sequence.load(std::memory_order_acquire);
+    if (static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos + 1) < 0)
+        return false;
+
+    msg = std::move(slot.msg);
+    slot.sequence.store(pos + m_mask + 1, std::memory_order_release);
+    m_dequeue_pos.store(pos + 1, std::memory_order_release);
+    return true;
+}
+
+void AsyncRingSink::report_dropped()
+{
+    const auto dropped = m_dropped.load(std::memory_order_relaxed);
+    if (dropped == m_reported_dropped)
+        return;
+
+    const auto msg_text = fmt::format("ASYNC_LOG; msg=log ring is full, {} messages dropped ({} total)",
+                                      dropped - m_reported_dropped, dropped);
+    m_target->log(spdlog::details::log_msg(spdlog::string_view_t(), L_WARN, msg_text));
+    m_reported_dropped = dropped;
+}
+
+void AsyncRingSink::worker_thread()
+{
+    spdlog::details::log_msg_buffer msg;
+    int idle_spins = 0;
+    for (;;)
+    {
+        // Целевой sink однопоточный (_st): вызовы flush/set_pattern из других потоков идут под той же
+        // блокировкой, ее захват на пачку сообщений почти всегда без конкуренции
+        size_t written = 0;
+        {
+            std::scoped_lock lock(m_target_guard);
+            for (; written < MAX_BATCH && try_pop(msg); ++written)
+            {
+                if (m_target->should_log(msg.level))
+                    m_target->log(msg);
+            }
+
+            if (written == 0)
+                report_dropped();
+        }
+
+        if (written > 0)
+        {
+            idle_spins = 0;
+            continue;
+        }
+
+        if (m_stop.load(std::memory_order_acquire))
+        {
+            // Дописываем то, что успели поставить до остановки
+            std::scoped_lock lock(m_target_guard);
+            while (try_pop(msg))
+                m_target->log(msg);
+            m_target->flush();
+            return;
+        }
+
+        if (++idle_spins < SPIN_COUNT)
+            std::this_thread::yield();
+        else
+            std::this_thread::sleep_for(IDLE_SLEEP);
+    }
+}
+
+}  // namespace step::log
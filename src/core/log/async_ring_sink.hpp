@@ -0,0 +1,65 @@
+#pragma once
+
+#include "log_common.hpp"
+
+#include <spdlog/details/log_msg_buffer.h>
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace step::log {
+
+/*! @brief Асинхронный sink: потоки-производители кладут сообщения в ограниченное lock-free кольцо,
+    фоновый поток форматирует их и пишет в целевой sink.
+    @details Кольцо - bounded MPMC очередь Вьюкова с одним потребителем. При переполнении сообщение
+    отбрасывается (производитель никогда не блокируется), число потерь периодически пишется в лог.
+*/
+class AsyncRingSink : public spdlog::sinks::sink
+{
+public:
+    AsyncRingSink(spdlog::sink_ptr target, size_t capacity);
+    ~AsyncRingSink() override;
+
+    void log(const spdlog::details::log_msg& msg) override;
+
+    /*! @brief Дожидается записи всех ранее поставленных сообщений и сбрасывает целевой sink.
+        @details flush, set_pattern и set_formatter обращаются к целевому sink под той же блокировкой,
+        что и фоновый поток, целевой sink может быть однопоточным.
+    */
+    void flush() override;
+    void set_pattern(const std::string& pattern) override;
+    void set_formatter(std::unique_ptr<spdlog::formatter> sink_formatter) override;
+
+    uint64_t get_dropped_count() const noexcept { return m_dropped.load(std::memory_order_relaxed); }
+
+private:
+    struct Slot
+    {
+        std::atomic<size_t> sequence{0};
+        spdlog::details::log_msg_buffer msg;
+    };
+
+    bool try_push(const spdlog::details::log_msg& msg);
+    bool try_pop(spdlog::details::log_msg_buffer& msg);
+    void worker_thread();
+    void report_dropped();
+
+private:
+    std::mutex m_target_guard;  // все обращения к m_target
+    spdlog::sink_ptr m_target;
+    std::vector<Slot> m_slots;
+    size_t m_mask;
+
+    alignas(64) std::atomic<size_t> m_enqueue_pos{0};
+    alignas(64) std::atomic<size_t> m_dequeue_pos{0};
+    alignas(64) std::atomic<uint64_t> m_dropped{0};
+    uint64_t m_reported_dropped{0};
+
+    std::atomic_bool m_stop{false};
+    std::thread m_worker;
+};
+
+}  // namespace step::log
@@ -1,4 +1,5 @@
 #include "log.hpp"
+#include "async_ring_sink.hpp"
 
 #include <spdlog/common.h>
 #include <spdlog/cfg/env.h>
@@ -9,13 +10,19 @@ constexpr const char* m_loggerNAME = "stepkit_logger";
 
 constexpr const char* LOG_PATTERN = "%Y-%m-%d %H:%M:%S.%f; %^%8l%$; thread %t; %v";
 
-spdlog::sink_ptr CreateStderrSink(step::log::LoggingSettings::SyncMode syncMode, step::log::LOG_LEVEL level)
+spdlog::sink_ptr CreateStderrSink(const step::log::LoggingSettings& settings, step::log::LOG_LEVEL level)
 {
     spdlog::sink_ptr sink;
-    if (syncMode == step::log::LoggingSettings::SyncMode::Sync)
+    if (settings.get_sync_policy() == step::log::LoggingSettings::SyncMode::Sync)
+    {
         sink = std::make_shared<spdlog::sinks::stderr_color_sink_st>();
+    }
     else
-        sink = std::make_shared<spdlog::sinks::stderr_color_sink_mt>();
+    {
+        // В stderr пишет только фоновый поток кольца, поэтому достаточно _st sink'а
+        sink = std::make_shared<step::log::AsyncRingSink>(std::make_shared<spdlog::sinks::stderr_color_sink_st>(),
+                                                          settings.get_async_queue_size());
+    }
     sink->set_level(level);
 
     return sink;
@@ -47,9 +54,16 @@ void Logger::set_settings(LoggingSettings&& settings)
     reset();
 
     // Create stderr sink with level L_TRACE to grab all messages in backtrace
-    m_logger = std::make_shared<spdlog::logger>(m_loggerNAME, CreateStderrSink(settings.get_sync_policy(), L_TRACE));
+    m_logger = std::make_shared<spdlog::logger>(m_loggerNAME, CreateStderrSink(settings, L_TRACE));
+    m_backtrace_level = L_OFF;
     if (settings.get_backtrace_size() != 0)
+    {
         m_logger->enable_backtrace(settings.get_backtrace_size());
+        m_backtrace_level = settings.get_backtrace_level();
+    }
+    // Критические ошибки должны попасть в stderr до возможного падения процесса. Ждать, пока кольцо
+    // асинхронного вывода опустеет, допустимо только для них: остальные сообщения не блокируют поток
+    m_logger->flush_on(L_CRITICAL);
 
     m_logger->set_pattern(LOG_PATTERN);
 
@@ -60,6 +74,7 @@ void Logger::set_settings(LoggingSettings&& settings)
     // registration is safe
     spdlog::register_logger(m_logger);
     spdlog::cfg::load_env_levels();
+    update_min_level();
 }
 
 void Logger::reset()
@@ -69,16 +84,24 @@ void Logger::reset()
 
     spdlog::shutdown();
     m_logger.reset();
+    update_min_level();
 }
 
 void Logger::set_log_level(LOG_LEVEL level)
 {
     if (m_logger)
         m_logger->set_level(level);
+    update_min_level();
 }
 
 LOG_LEVEL Logger::get_log_level() const { return m_logger ? m_logger->level() : L_OFF; }
 
+void Logger::update_min_level()
+{
+    const auto level = m_logger ? std::min(m_logger->level(), m_backtrace_level) : L_OFF;
+    m_min_level.store(static_cast<int>(level), std::memory_order_relaxed);
+}
+
 void Logger::dump_backtrace()
 {
     if (m_logger)
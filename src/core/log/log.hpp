@@ -2,6 +2,8 @@
 
 #include "log_settings.hpp"
 
+#include <atomic>
+#include <chrono>
 #include <thread>
 #include <string>
 #include <string_view>
@@ -21,6 +23,14 @@ public:
     LOG_LEVEL get_log_level() const;
     void dump_backtrace();
 
+    /*! @brief Быстрая проверка уровня до форматирования сообщения.
+        @details Учитывает уровень логгера и уровень backtrace, если он включен.
+    */
+    bool should_log(LOG_LEVEL level) const noexcept
+    {
+        return static_cast<int>(level) >= m_min_level.load(std::memory_order_relaxed);
+    }
+
     template <typename... Args>
     void log(LOG_LEVEL level, const fmt::format_string<Args...>& str, Args&&... args)
     {
@@ -42,16 +52,60 @@ private:
     Logger& operator=(const Logger&) = delete;
     Logger& operator=(Logger&&) = delete;
 
+    void update_min_level();
+
 private:
     std::shared_ptr<spdlog::logger> m_logger;
+    LOG_LEVEL m_backtrace_level{L_OFF};
+    std::atomic<int> m_min_level{static_cast<int>(L_TRACE)};
+};
+
+/*! @brief Ограничитель частоты повторяющихся сообщений (используется в STEP_LOG_THROTTLE).
+    @details Пропускает не более одного сообщения за период и считает подавленные.
+*/
+class LogThrottle
+{
+public:
+    bool try_acquire(std::chrono::steady_clock::duration period) noexcept
+    {
+        const auto now = std::chrono::steady_clock::now().time_since_epoch().count();
+        auto last = m_last.load(std::memory_order_relaxed);
+        if (last != 0 && now - last < period.count())
+        {
+            m_suppressed.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        return m_last.compare_exchange_strong(last, now, std::memory_order_relaxed);
+    }
+
+    uint64_t take_suppressed() noexcept { return m_suppressed.exchange(0, std::memory_order_relaxed); }
+
+private:
+    std::atomic<std::chrono::steady_clock::rep> m_last{0};
+    std::atomic<uint64_t> m_suppressed{0};
 };
 
 }  // namespace step::log
 
 // {:>20.20s}; - STEPKIT_MODULE_NAME
+// Аргументы вычисляются и форматируются только если уровень включен
 #define STEP_LOG(level, format, ...)                                                                                   \
-    step::log::Logger::instance().log(level, "{}; msg=" format " ({}:{}, {})", STEPKIT_MODULE_NAME, ##__VA_ARGS__,     \
-                                      __FILE__, __LINE__, __FUNCTION__)
+    do                                                                                                                 \
+    {                                                                                                                  \
+        if (static_cast<int>(level) >= STEP_LOG_ACTIVE_LEVEL && step::log::Logger::instance().should_log(level))       \
+            step::log::Logger::instance().log(level, "{}; msg=" format " ({}:{}, {})", STEPKIT_MODULE_NAME,            \
+                                              ##__VA_ARGS__, __FILE__, __LINE__, __FUNCTION__);                        \
+    } while (false)
+
+// Для повторяющихся сообщений: не чаще одного раза за period, с числом подавленных
+#define STEP_LOG_THROTTLE(level, period, format, ...)                                                                  \
+    do                                                                                                                 \
+    {                                                                                                                  \
+        static step::log::LogThrottle s_step_log_throttle;                                                             \
+        if (static_cast<int>(level) >= STEP_LOG_ACTIVE_LEVEL && step::log::Logger::instance().should_log(level) &&     \
+            s_step_log_throttle.try_acquire(period))                                                                   \
+            STEP_LOG(level, format " [suppressed {}]", ##__VA_ARGS__, s_step_log_throttle.take_suppressed());          \
+    } while (false)
 
 #define STEP_LOG_TO_DEFAULT_NO_SOURCE(level, format, ...)                                                              \
     step::log::Logger::instance().log_to_default(level, "{}; msg=" format, STEPKIT_MODULE_NAME, ##__VA_ARGS__)
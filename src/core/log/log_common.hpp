@@ -14,7 +14,13 @@ constexpr auto kCRITICAL = "CRITICAL"sv;
 constexpr auto kOFF = "OFF"sv;
 }  // namespace detail
 
-#define SPDLOG_ACTIVE_LEVEL SPDLOG_LEVEL_TRACE
+// Уровень, ниже которого STEP_LOG вырезается на этапе компиляции (0 - trace ... 6 - off),
+// задается через STEPKIT_LOG_ACTIVE_LEVEL в CMake
+#ifndef STEP_LOG_ACTIVE_LEVEL
+#define STEP_LOG_ACTIVE_LEVEL 0
+#endif
+
+#define SPDLOG_ACTIVE_LEVEL STEP_LOG_ACTIVE_LEVEL
 #define SPDLOG_LEVEL_NAMES                                                                                             \
     {                                                                                                                  \
         detail::kTRACE, detail::kDEBUG, detail::kINFO, detail::kWARNING, detail::kERROR, detail::kCRITICAL,            \
@@ -15,14 +15,22 @@ public:
 
 public:
     void set_backtrace_size(size_t value) { m_backtrace_size = value; }
+    void set_backtrace_level(LOG_LEVEL value) { m_backtrace_level = value; }
     void set_sync_mode(SyncMode value) { m_sync_mode = value; }
+    void set_async_queue_size(size_t value) { m_async_queue_size = value; }
 
     size_t get_backtrace_size() const noexcept { return m_backtrace_size; }
+    LOG_LEVEL get_backtrace_level() const noexcept { return m_backtrace_level; }
     SyncMode get_sync_policy() const noexcept { return m_sync_mode; }
+    size_t get_async_queue_size() const noexcept { return m_async_queue_size; }
 
 private:
     size_t m_backtrace_size{1000};
+    // Сообщения ниже этого уровня не попадают в backtrace и не форматируются, если отключены в логгере
+    LOG_LEVEL m_backtrace_level{L_DEBUG};
     SyncMode m_sync_mode{SyncMode::Async};
+    // Емкость кольца асинхронного sink'а, при переполнении сообщения отбрасываются
+    size_t m_async_queue_size{8192};
 };
 
 }  // namespace step::log
@@ -0,0 +1,32 @@
+#include "delivery_queue.hpp"
+
+#include <core/base/utils/find_pair.hpp>
+#include <core/base/utils/string_utils.hpp>
+
+namespace {
+
+/* clang-format off */
+const std::pair<step::threading::DeliveryPolicy, std::string> g_delivery_policies[] = {
+    { step::threading::DeliveryPolicy::Queue        , "queue"       },
+    { step::threading::DeliveryPolicy::DropOldest   , "drop_oldest" },
+    { step::threading::DeliveryPolicy::LatestOnly   , "latest_only" },
+};
+/* clang-format on */
+
+}  // namespace
+
+namespace step::utils {
+
+template <>
+std::string to_string(step::threading::DeliveryPolicy policy)
+{
+    return find_by_type(policy, g_delivery_policies);
+}
+
+template <>
+void from_string(step::threading::DeliveryPolicy& policy, const std::string& str)
+{
+    find_by_str(str, policy, g_delivery_policies);
+}
+
+}  // namespace step::utils
@@ -0,0 +1,163 @@
+#pragma once
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <optional>
+
+namespace step::threading {
+
+/*! @brief Что делать с новыми данными, если потребитель не успевает.
+*/
+enum class DeliveryPolicy
+{
+    Undefined,
+    Queue,       ///< без потерь: производитель ждет места в очереди
+    DropOldest,  ///< очередь ограничена, при переполнении вытесняются самые старые данные
+    LatestOnly,  ///< хранятся только последние данные, задержка не больше одного элемента
+};
+
+/*! @brief Счетчики очереди доставки.
+*/
+struct DeliveryStats
+{
+    uint64_t pushed{0};
+    uint64_t delivered{0};
+    uint64_t dropped{0};  ///< вытеснены политикой или остались в очереди при остановке
+    uint64_t blocked{0};  ///< сколько раз производитель ждал места (Queue)
+    size_t max_size{0};
+};
+
+enum class DeliveryResult
+{
+    Accepted,
+    AcceptedWithDrop,  ///< принято, но вытеснены более старые данные
+    Stopped,
+};
+
+/*! @brief Очередь между источником и одним потребителем с явной политикой переполнения.
+    @details Политику и емкость нужно задавать до начала работы. Для LatestOnly емкость всегда 1.
+*/
+template <typename T>
+class DeliveryQueue
+{
+public:
+    DeliveryQueue(DeliveryPolicy policy = DeliveryPolicy::DropOldest, size_t capacity = 1)
+    {
+        configure(policy, capacity);
+    }
+
+    void configure(DeliveryPolicy policy, size_t capacity)
+    {
+        std::scoped_lock lock(m_guard);
+        m_policy = policy;
+        m_capacity = (policy == DeliveryPolicy::LatestOnly) ? 1 : std::max<size_t>(capacity, 1);
+    }
+
+    DeliveryPolicy get_policy() const
+    {
+        std::scoped_lock lock(m_guard);
+        return m_policy;
+    }
+
+    DeliveryResult push(T item)
+    {
+        std::unique_lock lock(m_guard);
+        if (m_policy == DeliveryPolicy::Queue && m_items.size() >= m_capacity && !m_stopped)
+        {
+            ++m_stats.blocked;
+            m_not_full.wait(lock, [this]() { return m_stopped || m_items.size() < m_capacity; });
+        }
+
+        if (m_stopped)
+            return DeliveryResult::Stopped;
+
+        auto result = DeliveryResult::Accepted;
+        while (m_items.size() >= m_capacity)
+        {
+            m_items.pop_front();
+            ++m_stats.dropped;
+            result = DeliveryResult::AcceptedWithDrop;
+        }
+
+        m_items.push_back(std::move(item));
+        ++m_stats.pushed;
+        m_stats.max_size = std::max(m_stats.max_size, m_items.size());
+        m_not_empty.notify_one();
+        return result;
+    }
+
+    std::optional<T> try_pop()
+    {
+        std::scoped_lock lock(m_guard);
+        return pop_front();
+    }
+
+    /*! @brief Ждет данные, после stop возвращает std::nullopt.
+    */
+    std::optional<T> pop()
+    {
+        std::unique_lock lock(m_guard);
+        m_not_empty.wait(lock, [this]() { return m_stopped || !m_items.empty(); });
+        return pop_front();
+    }
+
+    /*! @brief Будит ожидающих, оставшиеся данные считаются потерянными.
+    */
+    void stop()
+    {
+        std::scoped_lock lock(m_guard);
+        m_stopped = true;
+        m_stats.dropped += m_items.size();
+        m_items.clear();
+        m_not_full.notify_all();
+        m_not_empty.notify_all();
+    }
+
+    void restart()
+    {
+        std::scoped_lock lock(m_guard);
+        m_stopped = false;
+    }
+
+    size_t size() const
+    {
+        std::scoped_lock lock(m_guard);
+        return m_items.size();
+    }
+
+    bool empty() const { return size() == 0; }
+
+    DeliveryStats get_stats() const
+    {
+        std::scoped_lock lock(m_guard);
+        return m_stats;
+    }
+
+private:
+    std::optional<T> pop_front()
+    {
+        if (m_items.empty())
+            return std::nullopt;
+
+        std::optional<T> item(std::move(m_items.front()));
+        m_items.pop_front();
+        ++m_stats.delivered;
+        m_not_full.notify_one();
+        return item;
+    }
+
+private:
+    mutable std::mutex m_guard;
+    std::condition_variable m_not_empty;
+    std::condition_variable m_not_full;
+    std::deque<T> m_items;
+    DeliveryPolicy m_policy{DeliveryPolicy::DropOldest};
+    size_t m_capacity{1};
+    DeliveryStats m_stats;
+    bool m_stopped{false};
+};
+
+}  // namespace step::threading
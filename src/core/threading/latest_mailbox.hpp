@@ -0,0 +1,69 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <optional>
+
+namespace step::threading {
+
+/*! @brief Lock-free ячейка на одно значение: новое значение вытесняет непрочитанное.
+    @details Для передачи последних данных от любого числа производителей одному потребителю, которому
+    промежуточные значения не нужны (кадры для отображения). Памяти занято не больше одного значения,
+    вытесненное значение освобождается в потоке производителя. Обмен - один atomic exchange указателя.
+*/
+template <typename T>
+class LatestMailbox
+{
+public:
+    LatestMailbox() = default;
+    ~LatestMailbox() { delete m_slot.exchange(nullptr, std::memory_order_acquire); }
+
+    LatestMailbox(const LatestMailbox&) = delete;
+    LatestMailbox& operator=(const LatestMailbox&) = delete;
+
+    /*! @brief Кладет значение, true - ячейка была пуста и потребителя нужно разбудить.
+        @details Пока значение не забрано, потребитель уже разбужен: повторные оповещения не нужны.
+    */
+    bool put(T value)
+    {
+        auto* prev = m_slot.exchange(new T(std::move(value)), std::memory_order_acq_rel);
+        if (!prev)
+            return true;
+
+        delete prev;
+        m_skipped.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    std::optional<T> take()
+    {
+        std::unique_ptr<T> value(m_slot.exchange(nullptr, std::memory_order_acq_rel));
+        if (!value)
+            return std::nullopt;
+
+        m_taken.fetch_add(1, std::memory_order_relaxed);
+        return std::move(*value);
+    }
+
+    /*! @brief Сбрасывает непрочитанное значение, оно считается пропущенным.
+    */
+    void clear()
+    {
+        std::unique_ptr<T> value(m_slot.exchange(nullptr, std::memory_order_acq_rel));
+        if (value)
+            m_skipped.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    bool empty() const noexcept { return m_slot.load(std::memory_order_acquire) == nullptr; }
+
+    uint64_t get_taken_count() const noexcept { return m_taken.load(std::memory_order_relaxed); }
+    uint64_t get_skipped_count() const noexcept { return m_skipped.load(std::memory_order_relaxed); }
+
+private:
+    std::atomic<T*> m_slot{nullptr};
+    std::atomic<uint64_t> m_taken{0};
+    std::atomic<uint64_t> m_skipped{0};
+};
+
+}  // namespace step::threading
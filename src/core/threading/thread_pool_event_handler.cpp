@@ -19,9 +19,14 @@
 
 #include <core/log/log.hpp>
 
+#include <algorithm>
+#include <mutex>
+#include <thread>
+
 namespace step::threading {
 
 std::unique_ptr<ThreadPoolEventHandler> g_thread_pool;
+std::mutex g_thread_pool_guard;
 
 struct ThreadPoolEventHandler::Impl
 {
@@ -40,16 +45,31 @@ struct ThreadPoolEventHandler::Impl
 
 void set_global_thread_pool(std::unique_ptr<ThreadPoolEventHandler>&& thread_pool)
 {
+    std::scoped_lock lock(g_thread_pool_guard);
     g_thread_pool = std::move(thread_pool);
 }
 
 ThreadPoolEventHandler& get_global_thread_pool()
 {
+    std::scoped_lock lock(g_thread_pool_guard);
     STEP_ASSERT(g_thread_pool, "Global thread pool wasn't set");
 
     return *g_thread_pool;
 }
 
+ThreadPoolEventHandler& get_or_create_global_thread_pool()
+{
+    std::scoped_lock lock(g_thread_pool_guard);
+    if (!g_thread_pool)
+    {
+        const auto threads_count = std::max(1u, std::thread::hardware_concurrency());
+        STEP_LOG(L_INFO, "Create global thread pool with {} threads", threads_count);
+        g_thread_pool = std::make_unique<ThreadPoolEventHandler>(threads_count);
+    }
+
+    return *g_thread_pool;
+}
+
 //..............................................................................
 
 ThreadPoolEventHandler::ThreadPoolEventHandler(unsigned int threadCount) : m_impl(std::make_unique<Impl>(threadCount))
@@ -70,6 +90,8 @@ void ThreadPoolEventHandler::stop()
 
 void ThreadPoolEventHandler::add_task(const std::function<void()>& task) { m_impl->m_service.post(std::bind(task)); }
 
+bool ThreadPoolEventHandler::try_run_one() { return m_impl->m_service.poll_one() > 0; }
+
 //..............................................................................
 
 }  // namespace step::threading
\ No newline at end of file
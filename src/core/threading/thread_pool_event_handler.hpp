@@ -35,6 +35,13 @@ public:
 	*/
     void add_task(const std::function<void()>& task);
 
+    /**
+	@brief Выполняет в текущем потоке одну готовую задачу из очереди, если она есть.
+
+	Нужен потокам, которые ждут завершения своих задач в пуле: вместо простоя они помогают его разгребать.
+	*/
+    bool try_run_one();
+
     /// Останавливает планировщик и дожидается завершения всех задач.
     void stop();
 
@@ -53,4 +60,9 @@ void set_global_thread_pool(std::unique_ptr<ThreadPoolEventHandler>&& thread_poo
  */
 ThreadPoolEventHandler& get_global_thread_pool();
 
+/**
+ * @brief Глобальный ThreadPool, при отсутствии создается с числом потоков по числу ядер.
+ */
+ThreadPoolEventHandler& get_or_create_global_thread_pool();
+
 }  // namespace step::threading
@@ -0,0 +1,56 @@
+#include "frame_video_buffer.hpp"
+
+#include <core/exception/assert.hpp>
+
+#include <QSysInfo>
+
+namespace step::gui {
+
+FrameVideoBuffer::FrameVideoBuffer(video::FramePtr frame) : QAbstractVideoBuffer(NoHandle), m_frame(std::move(frame))
+{
+    STEP_ASSERT(m_frame, "Invalid frame for FrameVideoBuffer");
+}
+
+uchar* FrameVideoBuffer::map(MapMode mode, int* num_bytes, int* bytes_per_line)
+{
+    if (mode != ReadOnly || m_map_mode != NotMapped)
+        return nullptr;
+
+    m_map_mode = mode;
+    if (num_bytes)
+        *num_bytes = static_cast<int>(m_frame->stride * m_frame->size.height);
+    if (bytes_per_line)
+        *bytes_per_line = static_cast<int>(m_frame->stride);
+
+    return m_frame->data();
+}
+
+QVideoFrame::PixelFormat get_video_pixel_format(video::PixFmt pix_fmt)
+{
+    // 32-битные форматы Qt заданы словом 0xAARRGGBB, порядок байт BGRA совпадает с ним только на little endian
+    const bool little_endian = QSysInfo::ByteOrder == QSysInfo::LittleEndian;
+
+    switch (pix_fmt)
+    {
+        case video::PixFmt::GRAY:
+            return QVideoFrame::Format_Y8;
+        case video::PixFmt::RGB:
+            return QVideoFrame::Format_RGB24;
+        case video::PixFmt::BGR:
+            return QVideoFrame::Format_BGR24;
+        case video::PixFmt::BGRA:
+            return little_endian ? QVideoFrame::Format_ARGB32 : QVideoFrame::Format_Invalid;
+        case video::PixFmt::RGBA:
+            return little_endian ? QVideoFrame::Format_ABGR32 : QVideoFrame::Format_Invalid;
+        default:
+            return QVideoFrame::Format_Invalid;
+    }
+}
+
+QVideoFrame make_video_frame(const video::FramePtr& frame, QVideoFrame::PixelFormat pixel_format)
+{
+    const QSize size(static_cast<int>(frame->size.width), static_cast<int>(frame->size.height));
+    return QVideoFrame(new FrameVideoBuffer(frame), size, pixel_format);
+}
+
+}  // namespace step::gui
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <video/frame/interfaces/frame.hpp>
+
+#include <QAbstractVideoBuffer>
+#include <QVideoFrame>
+
+namespace step::gui {
+
+/*! @brief Буфер QVideoFrame поверх кадра без копирования.
+    @details Держит FramePtr, пока surface не освободит QVideoFrame. Данные кадра только для чтения:
+    кадр может одновременно читать пайплайн.
+*/
+class FrameVideoBuffer : public QAbstractVideoBuffer
+{
+public:
+    FrameVideoBuffer(video::FramePtr frame);
+
+    MapMode mapMode() const override { return m_map_mode; }
+    uchar* map(MapMode mode, int* num_bytes, int* bytes_per_line) override;
+    void unmap() override { m_map_mode = NotMapped; }
+
+private:
+    video::FramePtr m_frame;
+    MapMode m_map_mode{NotMapped};
+};
+
+/*! @brief Формат QVideoFrame с той же раскладкой байт, что у кадра, Format_Invalid если такого нет.
+*/
+QVideoFrame::PixelFormat get_video_pixel_format(video::PixFmt pix_fmt);
+
+/*! @brief QVideoFrame над кадром без копирования данных.
+*/
+QVideoFrame make_video_frame(const video::FramePtr& frame, QVideoFrame::PixelFormat pixel_format);
+
+}  // namespace step::gui
@@ -1,34 +1,70 @@
 #include "video_frame_provider_ff.hpp"
+#include "frame_video_buffer.hpp"
 
 #include <core/log/log.hpp>
 #include <core/base/utils/time_utils.hpp>
 
-#include <gui/utils/qimage_utils.hpp>
+#include <video/frame/utils/frame_utils_opencv.hpp>
+
 #include <gui/utils/log_handler.hpp>
 
 #include <gui/interfaces/declare_metatype.hpp>
 #include <gui/interfaces/objects_connector_id.hpp>
 
+#include <opencv2/imgproc.hpp>
+
+namespace {
+
+/*! @brief Кадр в Format_RGB32 (байты BGRA на little endian): одна конвертация без промежуточного QImage.
+*/
+step::video::FramePtr convert_to_rgb32(const step::video::FramePtr& frame)
+{
+    if (frame->pix_fmt == step::video::PixFmt::BGRA)
+        return frame;
+
+    auto converted = std::make_shared<step::video::Frame>(frame->size, step::video::PixFmt::BGRA);
+    converted->ts = frame->ts;
+    auto dst = step::video::utils::to_mat(*converted);
+    cv::cvtColor(step::video::utils::to_mat(*frame), dst,
+                 step::video::utils::get_colorspace_convert_id(frame->pix_fmt, step::video::PixFmt::BGRA));
+    return converted;
+}
+
+}  // namespace
+
 namespace step::gui {
 
 VideoFrameProviderFF::VideoFrameProviderFF(QObject* parent /*= nullptr*/) : IVideoFrameProvider(parent)
 {
     // QueuedConnection, чтобы выполнить обработку в GUI потоке
-    connect(this, &VideoFrameProviderFF::frame_updated_signal, this, &VideoFrameProviderFF::on_process_frame_slot,
+    connect(this, &VideoFrameProviderFF::frame_ready_signal, this, &VideoFrameProviderFF::on_frame_ready_slot,
             Qt::ConnectionType::QueuedConnection);
 }
 
-VideoFrameProviderFF::~VideoFrameProviderFF() {}
+VideoFrameProviderFF::~VideoFrameProviderFF()
+{
+    STEP_LOG(L_INFO, "VideoFrameProviderFF: presented {} frames, skipped {}", m_mailbox.get_taken_count(),
+             m_mailbox.get_skipped_count());
+}
 
 void VideoFrameProviderFF::process_frame(step::video::FramePtr frame_ptr)
 {
-    // Шлем сигнал, чтобы выполнить обработку в GUI потоке
-    emit frame_updated_signal(frame_ptr);
+    // Сигнал только для пустого ящика: пока GUI поток не забрал кадр, он уже разбужен, а новый кадр
+    // просто заменяет старый. В очереди событий не больше одного оповещения, в памяти - одного кадра
+    if (m_mailbox.put(std::move(frame_ptr)))
+        emit frame_ready_signal();
+}
+
+void VideoFrameProviderFF::on_frame_ready_slot()
+{
+    // Забирается самый новый кадр на момент обработки события, кадры между событиями пропускаются
+    if (auto frame_ptr = m_mailbox.take())
+        present_frame(*frame_ptr);
 }
 
-void VideoFrameProviderFF::on_process_frame_slot(const step::video::FramePtr& frame_ptr)
+void VideoFrameProviderFF::present_frame(const step::video::FramePtr& frame_ptr)
 {
-    //step::utils::ExecutionTimer<Milliseconds> timer("VideoFrameProviderFF::on_process_frame_slot");
+    //step::utils::ExecutionTimer<Milliseconds> timer("VideoFrameProviderFF::present_frame");
     try
     {
         if (!frame_ptr)
@@ -37,31 +73,32 @@ void VideoFrameProviderFF::on_process_frame_slot(const step::video::FramePtr& fr
             return;
         }
 
-        auto image = utils::frame_to_qimage_deep(*frame_ptr);
-        if (image.isNull())
-            return;
-
-        QVideoFrame::PixelFormat pixel_format = QVideoFrame::pixelFormatFromImageFormat(image.format());
-
-        // принудительно конвертируем в 100% рабочий формат для surface
-        if (pixel_format == QVideoFrame::PixelFormat::Format_Invalid)
-        {
-            image.convertTo(QImage::Format::Format_RGB32);
-            pixel_format = QVideoFrame::pixelFormatFromImageFormat(image.format());
-        }
-
         std::scoped_lock(m_guard);
         // если формат кадра по какой-то причине поменялся (или это первый кадр)-
         // выполним повторную (первичную) инициализацию surface
-        if (image.size() != m_format.frameSize() || pixel_format != m_format.pixelFormat())
+        if (frame_ptr->size != m_frame_size || frame_ptr->pix_fmt != m_frame_pix_fmt)
         {
             STEP_LOG(L_INFO, "Try to init surface format with frame: {}", frame_ptr);
             close_surface();
-            auto format = QVideoSurfaceFormat(image.size(), pixel_format);
-            if (format.isValid())
+            m_frame_size = {};
+            m_frame_pix_fmt = video::PixFmt::Undefined;
+
+            // Кадр показывается как есть, если surface поддерживает его раскладку, иначе конвертируется
+            // в 100% рабочий для surface формат RGB32
+            auto pixel_format = get_video_pixel_format(frame_ptr->pix_fmt);
+            m_convert_frames = pixel_format == QVideoFrame::Format_Invalid ||
+                               !m_surface->supportedPixelFormats().contains(pixel_format);
+            if (m_convert_frames)
+                pixel_format = QVideoFrame::Format_RGB32;
+
+            auto format = QVideoSurfaceFormat(
+                QSize(static_cast<int>(frame_ptr->size.width), static_cast<int>(frame_ptr->size.height)),
+                pixel_format);
+            if (format.isValid() && m_surface->start(format))
             {
                 m_format = format;
-                m_surface->start(m_format);
+                m_frame_size = frame_ptr->size;
+                m_frame_pix_fmt = frame_ptr->pix_fmt;
             }
             else
             {
@@ -70,8 +107,11 @@ void VideoFrameProviderFF::on_process_frame_slot(const step::video::FramePtr& fr
             }
         }
 
+        // Surface отпускает QVideoFrame, а с ним и кадр, когда кадр больше не нужен для отрисовки
+        auto video_frame_ptr = m_convert_frames ? convert_to_rgb32(frame_ptr) : frame_ptr;
+
         STEP_LOG(L_TRACE, "VideoFrameProviderFF: Frame processing: {}", frame_ptr);
-        if (!m_surface->present(QVideoFrame(image)))
+        if (!m_surface->present(make_video_frame(video_frame_ptr, m_format.pixelFormat())))
         {
             STEP_LOG(L_ERROR, "Failed to present frame");
             return;
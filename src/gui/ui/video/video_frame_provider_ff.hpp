@@ -1,5 +1,7 @@
 #pragma once
 
+#include <core/threading/latest_mailbox.hpp>
+
 #include <video/frame/interfaces/frame_interfaces.hpp>
 
 #include <gui/interfaces/video_frame_provider.hpp>
@@ -13,17 +15,30 @@ public:
     VideoFrameProviderFF(QObject* parent = nullptr);
     ~VideoFrameProviderFF();
 
+    /*! @brief Сколько кадров вытеснено более новыми, не дойдя до отображения.
+    */
+    uint64_t get_skipped_frames() const noexcept { return m_mailbox.get_skipped_count(); }
+
 private:
     void process_frame(video::FramePtr frame_ptr);
+    void present_frame(const video::FramePtr& frame_ptr);
 
 private slots:
-    void on_process_frame_slot(const step::video::FramePtr& frame_ptr);
+    void on_frame_ready_slot();
 
 signals:
-    void frame_updated_signal(const step::video::FramePtr& frame_ptr);
+    void frame_ready_signal();
 
 private:
     std::exception_ptr m_exception;
+
+    // Последний кадр от источника: GUI поток забирает только самый новый, очередь событий Qt не растет
+    threading::LatestMailbox<video::FramePtr> m_mailbox;
+
+    // Кадры, под которые запущен surface
+    video::FrameSize m_frame_size;
+    video::PixFmt m_frame_pix_fmt{video::PixFmt::Undefined};
+    bool m_convert_frames{false};
 };
 
 }  // namespace step::gui
\ No newline at end of file
@@ -0,0 +1,331 @@
+#include "face_quality.hpp"
+
+#include <core/exception/assert.hpp>
+
+#include <video/frame/utils/frame_utils.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <numbers>
+#include <numeric>
+
+namespace {
+
+// Точки сетки MeshFitter (нумерация MediaPipe Face Mesh), глаза и рот как в MeshFitterModule
+constexpr size_t g_mesh_points = 468;
+constexpr size_t g_nose_tip = 1;
+constexpr size_t g_left_eye[] = {160, 158, 144, 153};
+constexpr size_t g_right_eye[] = {385, 387, 380, 373};
+constexpr size_t g_mouth[] = {13, 14};
+
+// Приближенная геометрия лица: выступ кончика носа относительно межглазного расстояния и
+// положение кончика носа в анфас как доля расстояния от линии глаз до рта
+constexpr double g_nose_depth = 0.4;
+constexpr double g_nose_height = 0.6;
+
+struct Vec2
+{
+    double x{0.0};
+    double y{0.0};
+};
+
+template <size_t N>
+Vec2 mean_point(const step::proc::FaceLandmarks& landmarks, const size_t (&indices)[N])
+{
+    Vec2 point;
+    for (const auto index : indices)
+    {
+        point.x += landmarks[index].x;
+        point.y += landmarks[index].y;
+    }
+    return {point.x / N, point.y / N};
+}
+
+double dot(const Vec2& lhs, const Vec2& rhs) { return lhs.x * rhs.x + lhs.y * rhs.y; }
+
+Vec2 diff(const Vec2& lhs, const Vec2& rhs) { return {lhs.x - rhs.x, lhs.y - rhs.y}; }
+
+double to_degrees(double radians) { return radians * 180.0 / std::numbers::pi; }
+
+double to_radians(double degrees) { return degrees * std::numbers::pi / 180.0; }
+
+// Доля value от удвоенного порога: лица чуть выше порога не должны вытеснять заметно лучшие
+double saturate(double value, double threshold) { return threshold > 0 ? std::min(1.0, value / (2 * threshold)) : 1.0; }
+
+double calc_iou(const step::Rect& lhs, const step::Rect& rhs)
+{
+    const int64_t width = std::min(lhs.p1.x, rhs.p1.x) - std::max(lhs.p0.x, rhs.p0.x);
+    const int64_t height = std::min(lhs.p1.y, rhs.p1.y) - std::max(lhs.p0.y, rhs.p0.y);
+    if (width <= 0 || height <= 0)
+        return 0.0;
+
+    const int64_t intersection = width * height;
+    const int64_t united = int64_t(lhs.length()) * lhs.height() + int64_t(rhs.length()) * rhs.height() - intersection;
+    return united > 0 ? static_cast<double>(intersection) / united : 0.0;
+}
+
+}  // namespace
+
+namespace step::proc {
+
+FaceRecognizerData FaceTrackIdentity::get_recognizer_data() const
+{
+    std::scoped_lock lock(m_guard);
+    return m_recognizer_data;
+}
+
+FaceMatchStatus FaceTrackIdentity::get_match_status() const
+{
+    std::scoped_lock lock(m_guard);
+    return m_match_status;
+}
+
+void FaceTrackIdentity::set_recognizer_data(const FaceRecognizerData& value)
+{
+    std::scoped_lock lock(m_guard);
+    m_recognizer_data = value;
+}
+
+void FaceTrackIdentity::set_match_status(FaceMatchStatus value)
+{
+    std::scoped_lock lock(m_guard);
+    m_match_status = value;
+}
+
+namespace {
+
+double calc_region_sharpness(const video::Frame& frame, const Rect& rect, size_t sample_size)
+{
+    const size_t channels = video::utils::get_channels_count(frame.pix_fmt);
+    STEP_ASSERT(channels == 1 || channels == 3 || channels == 4, "Unsupported face quality pixel format: {}",
+                frame.pix_fmt);
+    STEP_ASSERT(sample_size >= 3, "Invalid sharpness sample size: {}", sample_size);
+
+    const int x0 = std::clamp(rect.p0.x, 0, static_cast<int>(frame.size.width));
+    const int y0 = std::clamp(rect.p0.y, 0, static_cast<int>(frame.size.height));
+    const int x1 = std::clamp(rect.p1.x, x0, static_cast<int>(frame.size.width));
+    const int y1 = std::clamp(rect.p1.y, y0, static_cast<int>(frame.size.height));
+
+    const size_t length = x1 - x0;
+    const size_t height = y1 - y0;
+    const size_t step = std::max<size_t>((std::max(length, height) + sample_size - 1) / sample_size, 1);
+    const size_t width = length / step;
+    const size_t rows = height / step;
+    if (width < 3 || rows < 3)
+        return 0.0;
+
+    const auto weights = video::utils::get_luma_weights(frame.pix_fmt);
+    const size_t pixel_step = step * channels;
+
+    std::vector<int32_t> luma(width * rows);
+    for (size_t y = 0; y < rows; ++y)
+    {
+        const uint8_t* src = frame.data() + (y0 + y * step) * frame.stride + x0 * channels;
+        int32_t* dst = luma.data() + y * width;
+        if (channels == 1)
+        {
+            for (size_t x = 0; x < width; ++x, src += pixel_step)
+                dst[x] = src[0];
+            continue;
+        }
+
+        for (size_t x = 0; x < width; ++x, src += pixel_step)
+            dst[x] = static_cast<int32_t>(weights.weighted_sum<uint32_t>(src[0], src[1], src[2]) /
+                                          video::utils::LumaWeights::SCALE);
+    }
+
+    int64_t sum = 0;
+    int64_t sum_sq = 0;
+    for (size_t y = 1; y + 1 < rows; ++y)
+    {
+        const int32_t* up = luma.data() + (y - 1) * width;
+        const int32_t* row = up + width;
+        const int32_t* down = row + width;
+        for (size_t x = 1; x + 1 < width; ++x)
+        {
+            const int64_t laplacian = 4 * row[x] - row[x - 1] - row[x + 1] - up[x] - down[x];
+            sum += laplacian;
+            sum_sq += laplacian * laplacian;
+        }
+    }
+
+    const double count = static_cast<double>((width - 2) * (rows - 2));
+    const double mean = sum / count;
+    return sum_sq / count - mean * mean;
+}
+
+}  // namespace
+
+double calc_sharpness(const video::Frame& frame, const Rect& rect, size_t sample_size)
+{
+    // Яркость из GRAY копии декодера, если лицо в ней не мельче выборки: иначе резкость несравнима
+    const auto gray = video::utils::find_largest_analysis_frame(frame, video::PixFmt::GRAY);
+    if (gray && frame.size.width > 0 && frame.size.height > 0)
+    {
+        const auto scale = [](int value, size_t to, size_t from) {
+            return static_cast<int>(static_cast<int64_t>(value) * static_cast<int64_t>(to) /
+                                    static_cast<int64_t>(from));
+        };
+        const auto& from = frame.size;
+        const auto& to = gray->size;
+        const Rect gray_rect(scale(rect.p0.x, to.width, from.width), scale(rect.p0.y, to.height, from.height),
+                             scale(rect.p1.x, to.width, from.width), scale(rect.p1.y, to.height, from.height));
+        if (static_cast<size_t>(std::max({gray_rect.length(), gray_rect.height(), 0})) >= sample_size)
+            return calc_region_sharpness(*gray, gray_rect, sample_size);
+    }
+
+    return calc_region_sharpness(frame, rect, sample_size);
+}
+
+std::optional<HeadAngles> estimate_head_angles(const FaceLandmarks& landmarks)
+{
+    if (landmarks.size() < g_mesh_points)
+        return std::nullopt;
+
+    const auto left_eye = mean_point(landmarks, g_left_eye);
+    const auto right_eye = mean_point(landmarks, g_right_eye);
+    const auto mouth = diff(mean_point(landmarks, g_mouth), left_eye);
+    const auto nose = diff(Vec2{double(landmarks[g_nose_tip].x), double(landmarks[g_nose_tip].y)}, left_eye);
+
+    const auto eyes = diff(right_eye, left_eye);
+    const double eyes_distance = std::sqrt(dot(eyes, eyes));
+    if (eyes_distance < 1.0)
+        return std::nullopt;
+
+    // Перпендикуляр к линии глаз: по нему считается наклон, вдоль линии глаз - поворот
+    const Vec2 normal{-eyes.y / eyes_distance, eyes.x / eyes_distance};
+    const double mouth_distance = dot(mouth, normal);
+    if (std::abs(mouth_distance) < 1.0)
+        return std::nullopt;
+
+    // Кончик носа выступает из плоскости глаз и рта: при повороте на угол a его проекция смещается на depth * tg(a)
+    const double across = dot(nose, eyes) / (eyes_distance * eyes_distance);
+    const double down = dot(nose, normal) / mouth_distance;
+
+    HeadAngles angles;
+    angles.yaw = to_degrees(std::atan((across - 0.5) / g_nose_depth));
+    angles.pitch = to_degrees(std::atan((down - g_nose_height) / g_nose_depth));
+    return angles;
+}
+
+FaceQualityFilter::FaceQualityFilter(const SettingsFaceQuality& settings) : m_settings(settings) {}
+
+void FaceQualityFilter::reset() { m_tracks.clear(); }
+
+FaceQuality FaceQualityFilter::evaluate(const video::Frame& frame, const IFace& face) const
+{
+    const auto rect = face.get_rect();
+
+    FaceQuality quality;
+    quality.size = std::max(std::min(rect.length(), rect.height()), 0);
+    quality.confidence = face.get_confidence();
+    quality.angles = estimate_head_angles(face.get_landmarks());
+
+    const bool check_yaw = quality.angles && m_settings.get_max_yaw() > 0;
+    const bool check_pitch = quality.angles && m_settings.get_max_pitch() > 0;
+
+    /* clang-format off */
+    const bool cheap_passed = true
+        && quality.size >= m_settings.get_min_size()
+        && quality.confidence >= m_settings.get_min_confidence()
+        && (!check_yaw || std::abs(quality.angles->yaw) <= m_settings.get_max_yaw())
+        && (!check_pitch || std::abs(quality.angles->pitch) <= m_settings.get_max_pitch())
+    ;
+    /* clang-format on */
+
+    // Резкость - самая дорогая проверка, для отсеянных лиц не считается
+    if (!cheap_passed)
+        return quality;
+
+    quality.sharpness = calc_sharpness(frame, rect, m_settings.get_sharpness_size());
+    quality.passed = quality.sharpness >= m_settings.get_min_sharpness();
+
+    quality.score = quality.confidence * saturate(quality.size, m_settings.get_min_size()) *
+                    saturate(quality.sharpness, m_settings.get_min_sharpness());
+    if (quality.angles)
+        quality.score *= std::cos(to_radians(quality.angles->yaw)) * std::cos(to_radians(quality.angles->pitch));
+
+    return quality;
+}
+
+FaceQualities FaceQualityFilter::process(const video::Frame& frame, const Faces& faces)
+{
+    FaceQualities qualities;
+    qualities.reserve(faces.size());
+    for (const auto& face : faces)
+        qualities.push_back(evaluate(frame, *face));
+
+    // Лучшие лица сопоставляются с треками первыми
+    std::vector<size_t> order(faces.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(),
+                     [&qualities](size_t lhs, size_t rhs) { return qualities[lhs].score > qualities[rhs].score; });
+
+    std::vector<uint8_t> matched(m_tracks.size(), 0);
+    for (const auto index : order)
+    {
+        const auto rect = faces[index]->get_rect();
+
+        size_t track_index = m_tracks.size();
+        double best_iou = m_settings.get_track_iou();
+        for (size_t i = 0; i < m_tracks.size(); ++i)
+        {
+            if (matched[i])
+                continue;
+
+            const auto iou = calc_iou(rect, m_tracks[i].rect);
+            if (iou >= best_iou)
+            {
+                best_iou = iou;
+                track_index = i;
+            }
+        }
+
+        if (track_index == m_tracks.size())
+        {
+            m_tracks.emplace_back();
+            matched.push_back(0);
+        }
+        matched[track_index] = 1;
+
+        auto& track = m_tracks[track_index];
+        track.rect = rect;
+        track.missed_frames = 0;
+
+        auto& quality = qualities[index];
+        quality.track = track.identity;
+        if (!quality.passed)
+            continue;
+
+        // Первое прошедшее лицо трека распознается всегда, затем только заметно лучшие
+        const bool is_first = track.best_score <= 0;
+        if (!m_settings.get_best_per_track() || is_first ||
+            quality.score > track.best_score * (1.0 + m_settings.get_improve_ratio()))
+        {
+            quality.selected = true;
+            track.best_score = std::max(quality.score, std::numeric_limits<double>::min());
+        }
+    }
+
+    for (size_t i = 0; i < m_tracks.size(); ++i)
+        if (!matched[i])
+            ++m_tracks[i].missed_frames;
+
+    std::erase_if(m_tracks,
+                  [ttl = m_settings.get_track_ttl()](const Track& track) { return track.missed_frames > ttl; });
+
+    return qualities;
+}
+
+bool need_recognition(const std::optional<FaceQualities>& qualities, size_t index)
+{
+    return !qualities || (index < qualities->size() && (*qualities)[index].selected);
+}
+
+FaceTrackIdentityPtr get_track_identity(const std::optional<FaceQualities>& qualities, size_t index)
+{
+    return qualities && index < qualities->size() ? (*qualities)[index].track : nullptr;
+}
+
+}  // namespace step::proc
@@ -0,0 +1,119 @@
+#pragma once
+
+#include <core/base/types/rect.hpp>
+
+#include <video/frame/interfaces/frame.hpp>
+
+#include <proc/interfaces/face.hpp>
+#include <proc/settings/settings_face_quality.hpp>
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <vector>
+
+namespace step::proc {
+
+/*! @brief Углы поворота головы в градусах, 0 - анфас.
+*/
+struct HeadAngles
+{
+    double yaw{0.0};    // Поворот влево-вправо
+    double pitch{0.0};  // Наклон вверх-вниз
+};
+
+/*! @brief Итог распознавания трека лица: шаблон и статус сравнения последнего отобранного лица.
+    @details Узлы распознавания и сравнения записывают сюда результат отобранного лица и переносят его
+    на неотобранные лица того же трека, так что статус лица не пропадает между отобранными кадрами.
+    Потокобезопасен: соседние кадры могут обрабатываться разными узлами одновременно.
+*/
+class FaceTrackIdentity
+{
+public:
+    FaceRecognizerData get_recognizer_data() const;
+    FaceMatchStatus get_match_status() const;
+
+    void set_recognizer_data(const FaceRecognizerData& value);
+    void set_match_status(FaceMatchStatus value);
+
+private:
+    mutable std::mutex m_guard;
+    FaceRecognizerData m_recognizer_data;
+    FaceMatchStatus m_match_status{FaceMatchStatus::Undefined};
+};
+
+using FaceTrackIdentityPtr = std::shared_ptr<FaceTrackIdentity>;
+
+/*! @brief Оценка качества лица.
+    @details score - сводная оценка 0..1 для выбора лучшего лица трека: уверенность детектора, умноженная
+    на насыщающиеся к удвоенным порогам доли размера и резкости и на косинусы углов головы.
+*/
+struct FaceQuality
+{
+    int size{0};                       // Меньшая сторона rect, пиксели
+    double sharpness{0.0};             // Дисперсия лапласиана яркости
+    double confidence{0.0};
+    std::optional<HeadAngles> angles;  // Нет без landmarks
+    double score{0.0};
+    bool passed{false};                // Все пороги пройдены
+    bool selected{false};              // Лицо нужно распознавать
+    FaceTrackIdentityPtr track;        // Общий для лиц одного трека, нет без трека
+};
+
+/*! @brief Оценки лиц, публикуются в MetaStorage под CFG_FLD::FACE_QUALITY в порядке CFG_FLD::FACES.
+*/
+using FaceQualities = std::vector<FaceQuality>;
+
+/*! @brief Резкость области rect кадра: дисперсия 4-связного лапласиана яркости.
+    @details Область прореживается с целым шагом до стороны не больше sample_size: резкость сравнима
+    у лиц разного размера, а цена не зависит от размера лица. Прореживание без усреднения не сглаживает края.
+    Яркость берется из GRAY копии кадра для анализа, если декодер ее подготовил и лицо в ней не мельче
+    sample_size, иначе считается по кадру.
+*/
+double calc_sharpness(const video::Frame& frame, const Rect& rect, size_t sample_size);
+
+/*! @brief Углы головы по landmarks сетки MeshFitter (468 точек).
+    @details Оценка по положению кончика носа относительно линии глаз и рта без модели камеры,
+    для отсева профилей ее достаточно. Для других наборов landmarks возвращает std::nullopt.
+*/
+std::optional<HeadAngles> estimate_head_angles(const FaceLandmarks& landmarks);
+
+/*! @brief Отбор лиц для распознавания по качеству.
+    @details Треки лиц - сопоставление rect соседних кадров по IoU, собственных id у лиц нет.
+    Не потокобезопасен: хранит треки.
+*/
+class FaceQualityFilter
+{
+public:
+    FaceQualityFilter(const SettingsFaceQuality& settings);
+
+    FaceQuality evaluate(const video::Frame& frame, const IFace& face) const;
+    FaceQualities process(const video::Frame& frame, const Faces& faces);
+    void reset();
+
+    size_t get_tracks_count() const noexcept { return m_tracks.size(); }
+
+private:
+    struct Track
+    {
+        Rect rect;
+        double best_score{0.0};
+        size_t missed_frames{0};
+        FaceTrackIdentityPtr identity{std::make_shared<FaceTrackIdentity>()};
+    };
+
+private:
+    SettingsFaceQuality m_settings;
+    std::vector<Track> m_tracks;
+};
+
+/*! @brief Нужно ли распознавать лицо index, без оценок качества распознаются все лица.
+*/
+bool need_recognition(const std::optional<FaceQualities>& qualities, size_t index);
+
+/*! @brief Итог распознавания трека лица index, nullptr без оценок качества или без трека.
+*/
+FaceTrackIdentityPtr get_track_identity(const std::optional<FaceQualities>& qualities, size_t index);
+
+}  // namespace step::proc
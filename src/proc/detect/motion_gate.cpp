@@ -0,0 +1,326 @@
+#include "motion_gate.hpp"
+#include "tiling.hpp"
+
+#include <core/base/utils/find_pair.hpp>
+#include <core/base/utils/string_utils.hpp>
+#include <core/exception/assert.hpp>
+
+#include <video/frame/utils/frame_utils.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <string_view>
+#include <utility>
+
+namespace {
+/* clang-format off */
+
+constexpr std::pair<step::proc::MotionGating, std::string_view> g_motion_gatings[] = {
+    { step::proc::MotionGating::Undefined   , "undefined"   },
+    { step::proc::MotionGating::None        , "none"        },
+    { step::proc::MotionGating::Skip        , "skip"        },
+    { step::proc::MotionGating::Regions     , "regions"     },
+};
+
+/* clang-format on */
+
+}  // namespace
+
+namespace step::utils {
+
+template <>
+std::string to_string(step::proc::MotionGating type)
+{
+    return find_by_type(type, g_motion_gatings);
+}
+
+template <>
+void from_string(step::proc::MotionGating& type, const std::string& str)
+{
+    find_by_str(str, type, g_motion_gatings);
+}
+
+}  // namespace step::utils
+
+namespace step::proc {
+
+MotionGate::MotionGate(const SettingsMotionGate& settings) : m_settings(settings)
+{
+    STEP_ASSERT(m_settings.get_analysis_width() > 0 && m_settings.get_block_size() > 0,
+                "Invalid motion analysis width {} or block size {}", m_settings.get_analysis_width(),
+                m_settings.get_block_size());
+}
+
+void MotionGate::reset()
+{
+    m_luma_size = {};
+    m_prev_luma.clear();
+    m_block_ttl.clear();
+    m_changed_frames = 0;
+    m_idle_frames = 0;
+    m_active = false;
+}
+
+MotionResult MotionGate::process(const video::Frame& frame)
+{
+    const auto analysis_frame = video::utils::find_largest_analysis_frame(frame, video::PixFmt::GRAY);
+    update_luma(analysis_frame ? *analysis_frame : frame);
+
+    MotionResult result;
+    result.frame_size = frame.size;
+    const Rect whole_frame(0, 0, static_cast<int>(frame.size.width), static_cast<int>(frame.size.height));
+
+    // Первый кадр или смена разрешения: сравнивать не с чем, кадр детектируется целиком
+    if (m_prev_luma.size() != m_luma.size())
+    {
+        m_prev_luma = m_luma;
+        m_grid = {};
+        m_changed_frames = 0;
+        m_idle_frames = 0;
+        m_active = false;
+        result.active = true;
+        result.regions.push_back(whole_frame);
+        return result;
+    }
+
+    update_blocks(result);
+
+    m_changed_frames = result.changed ? m_changed_frames + 1 : 0;
+    if (!m_active && m_changed_frames >= m_settings.get_activate_frames())
+        m_active = true;
+
+    result.mask.resize(m_block_ttl.size());
+    std::transform(m_block_ttl.cbegin(), m_block_ttl.cend(), result.mask.begin(),
+                   [](size_t ttl) { return static_cast<uint8_t>(ttl > 0); });
+    if (m_active && std::none_of(result.mask.cbegin(), result.mask.cend(), [](uint8_t value) { return value; }))
+        m_active = false;
+
+    if (m_active)
+    {
+        m_idle_frames = 0;
+        result.active = true;
+        result.regions = find_regions(frame.size);
+    }
+    else if (m_settings.get_idle_interval() > 0 && ++m_idle_frames >= m_settings.get_idle_interval())
+    {
+        m_idle_frames = 0;
+        result.active = true;
+        result.regions.push_back(whole_frame);
+    }
+
+    std::swap(m_luma, m_prev_luma);
+    return result;
+}
+
+void MotionGate::update_luma(const video::Frame& source)
+{
+    const size_t channels = video::utils::get_channels_count(source.pix_fmt);
+    STEP_ASSERT(channels == 1 || channels == 3 || channels == 4, "Unsupported motion gate pixel format: {}",
+                source.pix_fmt);
+
+    const size_t analysis_width = m_settings.get_analysis_width();
+    const size_t k = std::max<size_t>((source.size.width + analysis_width - 1) / analysis_width, 1);
+    const video::FrameSize luma_size(source.size.width / k, source.size.height / k);
+    STEP_ASSERT(luma_size.width > 0 && luma_size.height > 0, "Frame {} is too small for motion analysis",
+                source.size);
+
+    if (luma_size != m_luma_size)
+    {
+        m_luma_size = luma_size;
+        m_prev_luma.clear();
+    }
+    m_luma.resize(luma_size.width * luma_size.height);
+
+    const auto weights = video::utils::get_luma_weights(source.pix_fmt);
+    const uint32_t norm = static_cast<uint32_t>(k * k);
+    const uint64_t color_norm = static_cast<uint64_t>(norm) * video::utils::LumaWeights::SCALE;
+
+    const size_t row_bytes = luma_size.width * k * channels;
+    m_row_sums.resize(row_bytes);
+
+    for (size_t y = 0; y < luma_size.height; ++y)
+    {
+        // Сумма k строк источника - непрерывный цикл по байтам без ветвлений
+        std::fill(m_row_sums.begin(), m_row_sums.end(), 0);
+        for (size_t r = 0; r < k; ++r)
+        {
+            const uint8_t* row = source.data() + (y * k + r) * source.stride;
+            uint32_t* sums = m_row_sums.data();
+            for (size_t i = 0; i < row_bytes; ++i)
+                sums[i] += row[i];
+        }
+
+        uint8_t* luma = m_luma.data() + y * luma_size.width;
+        const uint32_t* sums = m_row_sums.data();
+        if (channels == 1)
+        {
+            for (size_t x = 0; x < luma_size.width; ++x, sums += k)
+            {
+                uint32_t sum = 0;
+                for (size_t i = 0; i < k; ++i)
+                    sum += sums[i];
+                luma[x] = static_cast<uint8_t>(sum / norm);
+            }
+            continue;
+        }
+
+        for (size_t x = 0; x < luma_size.width; ++x)
+        {
+            uint64_t c0 = 0, c1 = 0, c2 = 0;
+            for (size_t i = 0; i < k; ++i, sums += channels)
+            {
+                c0 += sums[0];
+                c1 += sums[1];
+                c2 += sums[2];
+            }
+            luma[x] = static_cast<uint8_t>(weights.weighted_sum(c0, c1, c2) / color_norm);
+        }
+    }
+}
+
+void MotionGate::update_blocks(MotionResult& result)
+{
+    const size_t block = m_settings.get_block_size();
+    const video::FrameSize grid((m_luma_size.width + block - 1) / block, (m_luma_size.height + block - 1) / block);
+    const size_t blocks_count = grid.width * grid.height;
+    if (grid != m_grid)
+    {
+        m_grid = grid;
+        m_block_ttl.assign(blocks_count, 0);
+    }
+    m_block_counts.assign(blocks_count, 0);
+
+    const int threshold = m_settings.get_pixel_threshold();
+    for (size_t y = 0; y < m_luma_size.height; ++y)
+    {
+        const uint8_t* cur = m_luma.data() + y * m_luma_size.width;
+        const uint8_t* prev = m_prev_luma.data() + y * m_luma_size.width;
+        uint32_t* counts = m_block_counts.data() + (y / block) * grid.width;
+
+        for (size_t bx = 0; bx < grid.width; ++bx)
+        {
+            const size_t x0 = bx * block;
+            const size_t x1 = std::min(x0 + block, m_luma_size.width);
+            uint32_t count = 0;
+            for (size_t x = x0; x < x1; ++x)
+                count += static_cast<uint32_t>(std::abs(int(cur[x]) - int(prev[x])) > threshold);
+            counts[bx] += count;
+        }
+    }
+
+    size_t changed_blocks = 0;
+    for (size_t by = 0; by < grid.height; ++by)
+    {
+        const size_t block_height = std::min(block, m_luma_size.height - by * block);
+        for (size_t bx = 0; bx < grid.width; ++bx)
+        {
+            const size_t block_width = std::min(block, m_luma_size.width - bx * block);
+            const size_t index = by * grid.width + bx;
+
+            auto& ttl = m_block_ttl[index];
+            if (m_block_counts[index] > m_settings.get_block_threshold() * block_width * block_height)
+            {
+                ++changed_blocks;
+                ttl = m_settings.get_deactivate_frames();
+            }
+            else if (ttl > 0)
+            {
+                --ttl;
+            }
+        }
+    }
+
+    result.grid = grid;
+    result.changed = changed_blocks > 0;
+    result.changed_fraction = static_cast<double>(changed_blocks) / blocks_count;
+}
+
+std::vector<Rect> MotionGate::find_regions(const video::FrameSize& frame_size) const
+{
+    const int grid_width = static_cast<int>(m_grid.width);
+    const int grid_height = static_cast<int>(m_grid.height);
+    const int block = static_cast<int>(m_settings.get_block_size());
+    const int margin = static_cast<int>(m_settings.get_region_margin());
+    const int frame_width = static_cast<int>(frame_size.width);
+    const int frame_height = static_cast<int>(frame_size.height);
+    const double scale_x = static_cast<double>(frame_size.width) / m_luma_size.width;
+    const double scale_y = static_cast<double>(frame_size.height) / m_luma_size.height;
+
+    std::vector<Rect> regions;
+    std::vector<uint8_t> visited(m_block_ttl.size(), 0);
+    std::vector<Point2D> stack;
+    int64_t regions_area = 0;
+
+    for (int start = 0; start < grid_width * grid_height; ++start)
+    {
+        if (visited[start] || m_block_ttl[start] == 0)
+            continue;
+
+        // Связная область движущихся блоков (8-связность) и ее габарит в блоках
+        Rect blocks(start % grid_width, start / grid_width, start % grid_width, start / grid_width);
+        visited[start] = 1;
+        stack.push_back(blocks.p0);
+        while (!stack.empty())
+        {
+            const auto point = stack.back();
+            stack.pop_back();
+            blocks = Rect(std::min(blocks.p0.x, point.x), std::min(blocks.p0.y, point.y),
+                          std::max(blocks.p1.x, point.x), std::max(blocks.p1.y, point.y));
+
+            for (int dy = -1; dy <= 1; ++dy)
+            {
+                for (int dx = -1; dx <= 1; ++dx)
+                {
+                    const int x = point.x + dx;
+                    const int y = point.y + dy;
+                    if (x < 0 || y < 0 || x >= grid_width || y >= grid_height)
+                        continue;
+
+                    const int index = y * grid_width + x;
+                    if (visited[index] || m_block_ttl[index] == 0)
+                        continue;
+
+                    visited[index] = 1;
+                    stack.emplace_back(x, y);
+                }
+            }
+        }
+
+        const int x0 = std::max(blocks.p0.x - margin, 0) * block;
+        const int y0 = std::max(blocks.p0.y - margin, 0) * block;
+        const int x1 = (blocks.p1.x + margin + 1) * block;
+        const int y1 = (blocks.p1.y + margin + 1) * block;
+        const Rect region(static_cast<int>(x0 * scale_x), static_cast<int>(y0 * scale_y),
+                          std::min(frame_width, static_cast<int>(std::ceil(x1 * scale_x))),
+                          std::min(frame_height, static_cast<int>(std::ceil(y1 * scale_y))));
+        regions_area += static_cast<int64_t>(region.length()) * region.height();
+        regions.push_back(region);
+    }
+
+    if (regions_area > m_settings.get_max_region_area() * frame_width * frame_height)
+        return {Rect(0, 0, frame_width, frame_height)};
+
+    return regions;
+}
+
+DetectionResult detect_gated(IDetector& detector, video::Frame& frame, const std::optional<MotionResult>& motion,
+                             MotionGating gating, double nms_threshold)
+{
+    if (!motion || gating == MotionGating::None || motion->frame_size != frame.size)
+        return detector.process(frame);
+
+    if (!motion->active)
+        return {};
+
+    if (gating == MotionGating::Skip)
+        return detector.process(frame);
+
+    std::vector<DetectionResult> results;
+    results.reserve(motion->regions.size());
+    for (const auto& region : motion->regions)
+        results.push_back(detect_in_region(detector, frame, region));
+
+    return merge_region_results(motion->regions, results, nms_threshold);
+}
+
+}  // namespace step::proc
@@ -0,0 +1,84 @@
+#pragma once
+
+#include <core/base/types/rect.hpp>
+
+#include <video/frame/interfaces/frame.hpp>
+
+#include <proc/interfaces/detector_interface.hpp>
+#include <proc/settings/settings_motion_gate.hpp>
+
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+namespace step::proc {
+
+/*! @brief Результат проверки движения, публикуется в MetaStorage под CFG_FLD::MOTION_RESULT.
+    @details mask - блоки сетки grid (по строкам), в которых недавно было движение (с учетом гистерезиса).
+    regions - области кадра размера frame_size для детекции в его координатах, пусто если active == false.
+*/
+struct MotionResult
+{
+    bool active{false};           // Детекторы нужно запускать
+    bool changed{false};          // На этом кадре есть измененные блоки
+    double changed_fraction{0.0};  // Доля измененных на этом кадре блоков
+    video::FrameSize frame_size;
+    video::FrameSize grid;
+    std::vector<uint8_t> mask;
+    std::vector<Rect> regions;
+};
+
+/*! @brief Как детектор использует MotionResult.
+*/
+enum class MotionGating
+{
+    Undefined,
+    None,     // Детекция каждого кадра
+    Skip,     // Кадры без движения пропускаются, остальные целиком
+    Regions,  // Детекция только в областях движения
+};
+
+/*! @brief Дешевая проверка движения: разность уменьшенных кадров по яркости с порогом по блокам.
+    @details Яркость берется из GRAY копии кадра для анализа, если декодер ее подготовил, иначе считается
+    усреднением кадра по квадратам k x k. Внутренние циклы идут по непрерывным строкам без ветвлений
+    и векторизуются компилятором. Не потокобезопасен: хранит предыдущий кадр.
+*/
+class MotionGate
+{
+public:
+    MotionGate(const SettingsMotionGate& settings);
+
+    MotionResult process(const video::Frame& frame);
+    void reset();
+
+private:
+    void update_luma(const video::Frame& source);
+    void update_blocks(MotionResult& result);
+    std::vector<Rect> find_regions(const video::FrameSize& frame_size) const;
+
+private:
+    SettingsMotionGate m_settings;
+
+    video::FrameSize m_luma_size;
+    std::vector<uint8_t> m_luma;
+    std::vector<uint8_t> m_prev_luma;
+    std::vector<uint32_t> m_row_sums;
+    std::vector<uint32_t> m_block_counts;
+
+    video::FrameSize m_grid;
+    std::vector<size_t> m_block_ttl;  // Сколько кадров блок еще считается движущимся
+    size_t m_changed_frames{0};
+    size_t m_idle_frames{0};
+    bool m_active{false};
+};
+
+/*! @brief Детекция с учетом движения.
+    @details Без MotionResult, с MotionGating::None или если размер кадра изменился после проверки движения,
+    кадр обрабатывается целиком. Если движения нет, возвращается пустой результат без вызова детектора.
+    Для MotionGating::Regions детектор запускается на областях движения, результаты сводятся
+    merge_region_results.
+*/
+DetectionResult detect_gated(IDetector& detector, video::Frame& frame, const std::optional<MotionResult>& motion,
+                             MotionGating gating, double nms_threshold = 0.5);
+
+}  // namespace step::proc
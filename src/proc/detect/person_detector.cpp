@@ -1,8 +1,10 @@
 #include "registrator.hpp"
 
+#include <core/base/types/config_fields.hpp>
 #include <core/task/settings_factory.hpp>
 #include <core/task/task_factory.hpp>
 
+#include <video/frame/utils/frame_utils.hpp>
 #include <video/frame/utils/frame_utils_opencv.hpp>
 
 #include <proc/settings/settings_person_detector.hpp>
@@ -13,6 +15,8 @@
 
 #include <proc/neural/yolo/yolox_wrapper.hpp>
 
+#include <optional>
+
 namespace step::proc {
 
 class PersonDetector : public BaseDetector<SettingsPersonDetector>
@@ -24,6 +28,7 @@ public:
 
         auto resizer_settings = CREATE_SETTINGS(m_typed_settings.get_resizer_cfg());
         m_resizer = IEffect::from_abstract(CREATE_TASK_UNIQUE(resizer_settings));
+        init_analysis_format(*dynamic_cast<SettingsResizer*>(resizer_settings.get()));
 
         m_net = INeuralNet::from_abstract(CREATE_TASK_UNIQUE(CREATE_SETTINGS(m_typed_settings.get_neural_net_cfg())));
 
@@ -43,8 +48,10 @@ public:
     DetectionResult process(video::Frame& frame)
     {
         //utils::ExecutionTimer<Milliseconds> timer("PersonDetector");
-        auto resized = m_resizer->process(frame);
-        auto neural_output = m_net->process(resized);
+        // Кадр нужного размера уже подготовлен декодером - полноразмерный кадр не трогаем
+        const auto analysis_frame =
+            m_analysis_format ? video::utils::find_analysis_frame(frame, *m_analysis_format) : nullptr;
+        auto neural_output = analysis_frame ? m_net->process(*analysis_frame) : process_resized(frame);
         auto yolo_objects = m_yolox.process(neural_output, frame.size);
 
         std::vector<Rect> bboxes;
@@ -54,11 +61,43 @@ public:
                               static_cast<int>(item.rect.y + item.rect.height));
         });
 
-        DetectionResult result(std::move(bboxes));
+        std::vector<double> scores;
+        scores.reserve(yolo_objects.size());
+        std::transform(yolo_objects.cbegin(), yolo_objects.cend(), std::back_inserter(scores),
+                       [](const auto& item) { return static_cast<double>(item.prob); });
+
+        MetaStorage storage;
+        storage.set_attachment(CFG_FLD::DETECTION_SCORES, std::move(scores));
+
+        DetectionResult result(std::move(bboxes), std::move(storage));
         return result;
     }
 
 private:
+    /*! @brief Формат копии кадра от декодера, совпадающий с результатом ресайзера.
+        @details Есть только для режимов с фиксированным выходным размером.
+    */
+    void init_analysis_format(const SettingsResizer& resizer_settings)
+    {
+        const auto size_mode = resizer_settings.get_size_mode();
+        if (size_mode != SettingsResizer::SizeMode::Direct && size_mode != SettingsResizer::SizeMode::Padding)
+            return;
+
+        video::AnalysisFrameFormat format;
+        format.size = resizer_settings.get_frame_size();
+        format.pix_fmt = video::PixFmt::BGR;  // сеть сама меняет каналы местами (swap_rb)
+        format.letterbox = (size_mode == SettingsResizer::SizeMode::Padding);
+        m_analysis_format = format;
+    }
+
+    NeuralOutput process_resized(video::Frame& frame)
+    {
+        auto resized = m_resizer->process(frame);
+        return m_net->process(resized);
+    }
+
+private:
+    std::optional<video::AnalysisFrameFormat> m_analysis_format;
     std::unique_ptr<IEffect> m_resizer;
     std::unique_ptr<INeuralNet> m_net;
     YoloxWrapper m_yolox;
@@ -1,6 +1,9 @@
 #pragma once
 
 #include <proc/interfaces/detector_interface.hpp>
+#include <proc/settings/settings_tiling_detector.hpp>
+
+#include <functional>
 
 namespace step::proc {
 
@@ -8,4 +11,13 @@ std::unique_ptr<IDetector> create_face_detector(const std::shared_ptr<task::Base
 
 std::unique_ptr<IDetector> create_person_detector(const std::shared_ptr<task::BaseSettings>& settings);
 
+using DetectorCreator = std::function<DetectorPtr()>;
+
+/*! @brief Детектор по тайлам кадра, внутренние детекторы (по одному на поток) создаются create_detector.
+*/
+std::unique_ptr<IDetector> create_tiling_detector_with(const SettingsTilingDetector& settings,
+                                                       const DetectorCreator& create_detector);
+
+std::unique_ptr<IDetector> create_tiling_detector(const std::shared_ptr<task::BaseSettings>& settings);
+
 }  // namespace step::proc
\ No newline at end of file
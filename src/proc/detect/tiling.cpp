@@ -0,0 +1,205 @@
+#include "tiling.hpp"
+
+#include <core/base/types/config_fields.hpp>
+#include <core/exception/assert.hpp>
+
+#include <proc/interfaces/face.hpp>
+
+#include <algorithm>
+#include <climits>
+#include <cmath>
+#include <numeric>
+
+namespace {
+
+// Начала тайлов длины tile на отрезке [0, length)
+std::vector<int> tile_offsets(int length, int tile, double overlap)
+{
+    std::vector<int> offsets;
+    const int step = std::max(1, static_cast<int>(std::lround(tile * (1.0 - overlap))));
+    for (int offset = 0;; offset += step)
+    {
+        if (offset + tile >= length)
+        {
+            offsets.push_back(length - tile);
+            break;
+        }
+        offsets.push_back(offset);
+    }
+    return offsets;
+}
+
+int64_t area(const step::Rect& rect)
+{
+    return static_cast<int64_t>(std::max(0, rect.length())) * std::max(0, rect.height());
+}
+
+int64_t intersection_area(const step::Rect& lhs, const step::Rect& rhs)
+{
+    const step::Rect inter(std::max(lhs.p0.x, rhs.p0.x), std::max(lhs.p0.y, rhs.p0.y), std::min(lhs.p1.x, rhs.p1.x),
+                           std::min(lhs.p1.y, rhs.p1.y));
+    return area(inter);
+}
+
+step::Rect shift_rect(const step::Rect& rect, const step::Point2D& offset)
+{
+    return step::Rect(rect.p0.x + offset.x, rect.p0.y + offset.y, rect.p1.x + offset.x, rect.p1.y + offset.y);
+}
+
+}  // namespace
+
+namespace step::proc {
+
+std::vector<Rect> make_detection_tiles(const video::FrameSize& frame_size, const video::FrameSize& tile_size,
+                                       double overlap, const std::vector<double>& scales, bool full_frame)
+{
+    STEP_ASSERT(tile_size.width > 0 && tile_size.height > 0, "Invalid tile size: {}", tile_size);
+    STEP_ASSERT(overlap >= 0 && overlap < 1, "Invalid tile overlap: {}", overlap);
+
+    const int frame_width = static_cast<int>(frame_size.width);
+    const int frame_height = static_cast<int>(frame_size.height);
+
+    std::vector<Rect> tiles;
+    if (frame_width <= 0 || frame_height <= 0)
+        return tiles;
+
+    const Rect whole_frame(0, 0, frame_width, frame_height);
+    if (full_frame)
+        tiles.push_back(whole_frame);
+
+    for (const auto scale : scales)
+    {
+        STEP_ASSERT(scale > 0, "Invalid tile scale: {}", scale);
+
+        const int tile_width = std::min(frame_width, static_cast<int>(std::lround(tile_size.width / scale)));
+        const int tile_height = std::min(frame_height, static_cast<int>(std::lround(tile_size.height / scale)));
+        for (const auto y : tile_offsets(frame_height, std::max(1, tile_height), overlap))
+        {
+            for (const auto x : tile_offsets(frame_width, std::max(1, tile_width), overlap))
+            {
+                const Rect tile(x, y, x + tile_width, y + tile_height);
+                if (std::find(tiles.cbegin(), tiles.cend(), tile) == tiles.cend())
+                    tiles.push_back(tile);
+            }
+        }
+    }
+
+    return tiles;
+}
+
+std::vector<size_t> suppress_tile_duplicates(const std::vector<Rect>& bboxes, const std::vector<double>& scores,
+                                             double threshold)
+{
+    STEP_ASSERT(bboxes.size() == scores.size(), "Bboxes and scores count mismatch: {} != {}", bboxes.size(),
+                scores.size());
+
+    std::vector<size_t> order(bboxes.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(),
+                     [&scores](size_t lhs, size_t rhs) { return scores[lhs] > scores[rhs]; });
+
+    std::vector<size_t> kept;
+    for (const auto index : order)
+    {
+        const auto index_area = area(bboxes[index]);
+        const bool is_duplicate = std::any_of(kept.cbegin(), kept.cend(), [&](size_t kept_index) {
+            const auto min_area = std::min(index_area, area(bboxes[kept_index]));
+            return min_area > 0 && intersection_area(bboxes[index], bboxes[kept_index]) > threshold * min_area;
+        });
+        if (!is_duplicate)
+            kept.push_back(index);
+    }
+
+    return kept;
+}
+
+DetectionResult detect_in_region(IDetector& detector, video::Frame& frame, const Rect& region)
+{
+    if (region.p0 == Point2D(0, 0) && region.length() == static_cast<int>(frame.size.width) &&
+        region.height() == static_cast<int>(frame.size.height))
+        return detector.process(frame);
+
+    auto* data = frame.data() + region.p0.y * frame.stride + region.p0.x * frame.bpp() / CHAR_BIT;
+    auto region_frame = video::Frame::create(video::FrameSize(region.length(), region.height()), frame.stride,
+                                             frame.pix_fmt, data, video::Frame::empty_deleter, frame.ts,
+                                             frame.duration);
+    return detector.process(region_frame);
+}
+
+DetectionResult merge_region_results(const std::vector<Rect>& regions, const std::vector<DetectionResult>& results,
+                                     double nms_threshold)
+{
+    STEP_ASSERT(regions.size() == results.size(), "Regions and results count mismatch: {} != {}", regions.size(),
+                results.size());
+
+    std::vector<Rect> bboxes;
+    std::vector<double> scores;
+    Faces faces;
+    bool has_scores = false;
+
+    for (size_t i = 0; i < results.size(); ++i)
+    {
+        const auto& result = results[i];
+        const auto& offset = regions[i].p0;
+
+        const auto region_scores = result.data().get_attachment<std::vector<double>>(CFG_FLD::DETECTION_SCORES);
+        const auto region_faces = result.data().get_attachment<Faces>(CFG_FLD::FACES);
+        STEP_ASSERT(!region_scores || region_scores->size() == result.bboxes().size(), "Invalid detection scores!");
+        STEP_ASSERT(!region_faces || region_faces->size() == result.bboxes().size(), "Invalid detected faces!");
+
+        for (size_t j = 0; j < result.bboxes().size(); ++j)
+        {
+            bboxes.push_back(shift_rect(result.bboxes()[j], offset));
+
+            double score = 1.0;
+            if (region_scores)
+            {
+                score = (*region_scores)[j];
+                has_scores = true;
+            }
+            else if (region_faces)
+            {
+                score = (*region_faces)[j]->get_confidence();
+            }
+            scores.push_back(score);
+
+            if (!region_faces)
+                continue;
+
+            // Лицо остается привязанным к изображению области, в координаты кадра переводятся rect и landmarks
+            const auto& face = (*region_faces)[j];
+            face->set_rect(shift_rect(face->get_rect(), offset));
+            auto landmarks = face->get_landmarks();
+            for (auto& point : landmarks)
+                point = Point2D(point.x + offset.x, point.y + offset.y);
+            face->set_landmarks(landmarks);
+            faces.push_back(face);
+        }
+    }
+
+    STEP_ASSERT(faces.empty() || faces.size() == bboxes.size(), "Detected faces are missing for some regions!");
+
+    const auto kept = suppress_tile_duplicates(bboxes, scores, nms_threshold);
+
+    std::vector<Rect> kept_bboxes;
+    std::vector<double> kept_scores;
+    Faces kept_faces;
+    kept_bboxes.reserve(kept.size());
+    for (const auto index : kept)
+    {
+        kept_bboxes.push_back(bboxes[index]);
+        kept_scores.push_back(scores[index]);
+        if (!faces.empty())
+            kept_faces.push_back(faces[index]);
+    }
+
+    MetaStorage storage;
+    if (has_scores)
+        storage.set_attachment(CFG_FLD::DETECTION_SCORES, std::move(kept_scores));
+    if (!faces.empty())
+        storage.set_attachment(CFG_FLD::FACES, std::move(kept_faces));
+
+    return {std::move(kept_bboxes), std::move(storage)};
+}
+
+}  // namespace step::proc
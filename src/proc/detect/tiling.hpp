@@ -0,0 +1,41 @@
+#pragma once
+
+#include <core/base/types/rect.hpp>
+
+#include <video/frame/interfaces/frame.hpp>
+
+#include <proc/interfaces/detector_interface.hpp>
+
+#include <vector>
+
+namespace step::proc {
+
+/*! @brief Тайлы кадра frame_size в его координатах.
+    @details Для каждого масштаба s кадр покрывается тайлами tile_size / s (не больше кадра), соседние тайлы
+    перекрываются на долю overlap, последний тайл ряда прижимается к краю кадра. full_frame добавляет
+    весь кадр первым тайлом. Совпадающие тайлы разных масштабов не повторяются.
+*/
+std::vector<Rect> make_detection_tiles(const video::FrameSize& frame_size, const video::FrameSize& tile_size,
+                                       double overlap, const std::vector<double>& scales, bool full_frame);
+
+/*! @brief Индексы bboxes, оставшихся после NMS по всем тайлам, по убыванию scores.
+    @details Перекрытие - площадь пересечения к площади меньшего bbox: объект на границе тайла обрезан,
+    и его часть должна подавляться полным bbox из соседнего тайла, хотя IoU у них мал.
+*/
+std::vector<size_t> suppress_tile_duplicates(const std::vector<Rect>& bboxes, const std::vector<double>& scores,
+                                             double threshold);
+
+/*! @brief Детекция в области кадра: внутреннему детектору передается view области без копирования.
+    @details Для области во весь кадр передается сам кадр - вместе с копиями для анализа от декодера.
+    Результат в координатах области.
+*/
+DetectionResult detect_in_region(IDetector& detector, video::Frame& frame, const Rect& region);
+
+/*! @brief Результаты детекции по областям кадра, сведенные в координаты кадра.
+    @details bboxes сдвигаются на начало своей области и сводятся suppress_tile_duplicates. Переносятся
+    вложения CFG_FLD::DETECTION_SCORES и CFG_FLD::FACES (у лиц сдвигаются rect и landmarks).
+*/
+DetectionResult merge_region_results(const std::vector<Rect>& regions, const std::vector<DetectionResult>& results,
+                                     double nms_threshold);
+
+}  // namespace step::proc
@@ -0,0 +1,104 @@
+#include "registrator.hpp"
+#include "tiling.hpp"
+
+#include <core/task/settings_factory.hpp>
+#include <core/task/task_factory.hpp>
+
+#include <proc/interfaces/face_engine_user.hpp>
+
+#include <atomic>
+#include <future>
+
+namespace step::proc {
+
+/*! @brief Детектор, запускающий внутренний детектор на тайлах кадра.
+    @details Мелкие объекты на кадрах высокого разрешения теряются, если весь кадр сжимается до входа сети.
+    Тайл передается внутреннему детектору как view кадра без копирования. Тайлы разбирают по очереди
+    tile_workers экземпляров внутреннего детектора, каждый в своем потоке. Экземпляры детектора не делят
+    состояние, но детекторы face engine по conn_id получают от контроллера один общий движок, а он не
+    реентерабелен: поэтому все экземпляры, кроме первого, перед запуском переводятся на собственный
+    экземпляр движка (IFaceEngineUser::use_own_face_engine_instance).
+    Результаты сводятся в координаты кадра merge_region_results.
+*/
+class TilingDetector : public BaseDetector<SettingsTilingDetector>
+{
+public:
+    TilingDetector(const SettingsTilingDetector& settings, const DetectorCreator& create_detector)
+    {
+        set_settings(settings);
+
+        const auto workers = std::max<size_t>(m_typed_settings.get_workers(), 1);
+        m_detectors.reserve(workers);
+        for (size_t i = 0; i < workers; ++i)
+        {
+            auto detector = create_detector();
+            STEP_ASSERT(detector, "Can't create tiling detector: invalid inner detector!");
+            if (auto face_engine_user = dynamic_cast<IFaceEngineUser*>(detector.get()); face_engine_user && i > 0)
+                m_face_engine_users.push_back(face_engine_user);
+            m_detectors.push_back(std::move(detector));
+        }
+    }
+
+    DetectionResult process(video::Frame& frame)
+    {
+        if (m_tiles.empty() || m_tiles_frame_size != frame.size)
+        {
+            m_tiles = make_detection_tiles(frame.size, m_typed_settings.get_tile_size(),
+                                           m_typed_settings.get_tile_overlap(), m_typed_settings.get_tile_scales(),
+                                           m_typed_settings.get_full_frame());
+            m_tiles_frame_size = frame.size;
+        }
+
+        // Движок назначается контроллером после создания детектора, поэтому свой экземпляр создается здесь.
+        // Детектор со своим внутренним движком назначенного не имеет и работает как раньше
+        for (auto* face_engine_user : m_face_engine_users)
+            face_engine_user->use_own_face_engine_instance();
+
+        std::vector<DetectionResult> results(m_tiles.size());
+        std::atomic_size_t next_tile{0};
+        auto worker = [this, &frame, &results, &next_tile](IDetector& detector) {
+            for (size_t i = next_tile++; i < m_tiles.size(); i = next_tile++)
+                results[i] = detect_in_region(detector, frame, m_tiles[i]);
+        };
+
+        std::vector<std::future<void>> futures;
+        const auto workers = std::min(m_detectors.size(), m_tiles.size());
+        for (size_t i = 1; i < workers; ++i)
+            futures.push_back(std::async(std::launch::async, worker, std::ref(*m_detectors[i])));
+        worker(*m_detectors.front());
+        for (auto& future : futures)
+            future.get();
+
+        return merge_region_results(m_tiles, results, m_typed_settings.get_nms_threshold());
+    }
+
+private:
+    std::vector<DetectorPtr> m_detectors;
+    std::vector<IFaceEngineUser*> m_face_engine_users;  // Все экземпляры, кроме первого
+    std::vector<Rect> m_tiles;
+    video::FrameSize m_tiles_frame_size;
+};
+
+}  // namespace step::proc
+
+namespace step::proc {
+
+std::unique_ptr<IDetector> create_tiling_detector_with(const SettingsTilingDetector& settings,
+                                                       const DetectorCreator& create_detector)
+{
+    return std::make_unique<TilingDetector>(settings, create_detector);
+}
+
+std::unique_ptr<IDetector> create_tiling_detector(const std::shared_ptr<task::BaseSettings>& settings)
+{
+    STEP_ASSERT(settings, "Can't create tiling detector: empty settings!");
+
+    const auto& typed_settings = dynamic_cast<const SettingsTilingDetector&>(*settings);
+    STEP_ASSERT(typed_settings.get_detector_cfg(), "Can't create tiling detector: empty detector settings!");
+
+    return create_tiling_detector_with(typed_settings, [&typed_settings]() {
+        return IDetector::from_abstract(CREATE_TASK_UNIQUE(CREATE_SETTINGS(typed_settings.get_detector_cfg())));
+    });
+}
+
+}  // namespace step::proc
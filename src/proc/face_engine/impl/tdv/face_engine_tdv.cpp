@@ -7,46 +7,62 @@
 #include <video/frame/utils/frame_utils.hpp>
 #include <video/frame/utils/frame_utils_opencv.hpp>
 
-#include <thirdparty/tdv/api/Service.h>
 #include <thirdparty/tdv/data/Context.h>
+#include <thirdparty/tdv/modules/FaceIdentificationModule.h>
+#include <thirdparty/tdv/modules/MatcherModule.h>
+#include <thirdparty/tdv/modules/MeshFitterModule.h>
+#include <thirdparty/tdv/modules/detection_modules/FaceDetectionModule.h>
 
 #include <opencv2/opencv.hpp>
 
 namespace {
 
 /* clang-format off */
-const std::string UNIT_TYPE = "unit_type";
 const std::string USE_CUDA = "use_cuda";
 const std::string THRESHOLD = "threshold";
+const std::string MODEL_PATH = "model_path";
 
 const std::string FACE_DETECTOR_UNIT_NAME      = "FACE_DETECTOR";
 const std::string FACE_RECOGNIZER_UNIT_NAME    = "FACE_RECOGNIZER";
 const std::string FACE_LANDMARKS_UNIT_NAME     = "MESH_FITTER";
-const std::string FACE_MATCHER_UNIT_NAME       = "MATCHER_MODULE";
-/* clang-format on */
 
-/* clang-format off */
-const std::map<int, std::string> g_cvtype_to_str {
-    { CV_8U , "uint8_t"  },
-    { CV_8S , "int8_t"   },
-    { CV_16U, "uint16_t" },
-    { CV_16S, "int16_t"  },
-    { CV_32S, "int32_t"  },
-    { CV_32F, "float"    },
-    { CV_64F, "double"   }
+// Имена моделей юнитов в каталоге SDK, см. thirdparty/tdv/api/c_api.cpp
+const std::map<std::string, std::string> g_unit_models {
+    { FACE_DETECTOR_UNIT_NAME   , "face.onnx"        },
+    { FACE_RECOGNIZER_UNIT_NAME , "recognizer.onnx"  },
+    { FACE_LANDMARKS_UNIT_NAME  , "mesh_fitter.onnx" },
 };
 /* clang-format on */
 
-void mat_to_bsm(api::Context& bsm_ctx, const cv::Mat& img, bool copy = false)
+/*! @brief RGB-изображение кадра для детектора.
+    @details Копией для анализа от декодера детектор и лица владеют совместно. RGB кадр оборачивается
+    без копирования, такое изображение ссылается на кадр вызывающего (borrowed) и действительно только
+    до выхода из detect. Остальные форматы конвертируются сразу в новый буфер.
+*/
+struct RgbImage
+{
+    std::shared_ptr<cv::Mat> image;
+    bool borrowed{false};
+};
+
+RgbImage get_rgb_image(const video::Frame& frame, bool need_full_size)
 {
-    const cv::Mat& input_img = img.isContinuous() ? img : img.clone();  // setDataPtr requires continuous data
-    size_t copy_sz = (copy || !img.isContinuous()) ? input_img.total() * input_img.elemSize() : 0;
-    bsm_ctx["format"] = "NDARRAY";
-    bsm_ctx["blob"].setDataPtr(input_img.data, copy_sz);
-    bsm_ctx["dtype"] = g_cvtype_to_str.at(input_img.depth());
-    for (int i = 0; i < input_img.dims; ++i)
-        bsm_ctx["shape"].push_back(input_img.size[i]);
-    bsm_ctx["shape"].push_back(input_img.channels());
+    auto analysis_frame = video::utils::find_largest_analysis_frame(frame, video::PixFmt::RGB);
+    if (analysis_frame && (!need_full_size || analysis_frame->size == frame.size))
+    {
+        // cv::Mat держит копию для анализа
+        return {std::shared_ptr<cv::Mat>(new cv::Mat(video::utils::to_mat(*analysis_frame)),
+                                         [analysis_frame](cv::Mat* mat) { delete mat; })};
+    }
+
+    if (frame.pix_fmt == video::PixFmt::RGB)
+        return {std::make_shared<cv::Mat>(video::utils::to_mat(frame)), true};
+
+    auto image = std::make_shared<cv::Mat>(frame.size.height, frame.size.width,
+                                           video::utils::get_cv_data_type(video::PixFmt::RGB));
+    cv::cvtColor(video::utils::to_mat(frame), *image,
+                 video::utils::get_colorspace_convert_id(frame.pix_fmt, video::PixFmt::RGB));
+    return {image};
 }
 
 }  // namespace
@@ -56,7 +72,7 @@ namespace step::proc {
 FacePtr FaceTDV::clone() const noexcept
 {
     auto face = FaceTDV::create_face();
-    std::dynamic_pointer_cast<FaceTDV>(face)->m_impl = std::make_shared<api::Context>(*m_impl);
+    std::dynamic_pointer_cast<FaceTDV>(face)->m_impl = std::make_shared<tdv::data::FaceData>(m_impl->clone());
 
     face->set_confidence(get_confidence());
     face->set_frame(video::Frame::clone_deep(get_frame()));
@@ -67,60 +83,74 @@ FacePtr FaceTDV::clone() const noexcept
     return face;
 }
 
+/*! @brief Face engine на модулях TDV.
+    @details tdv::data::Context нужен только для конфигурации модулей. Между детектором, mesh fitter,
+    распознаванием и сравнением данные лица передаются типизированным tdv::data::FaceData:
+    без поиска по ключам и без отдельного узла в куче на каждое поле.
+*/
 class FaceEngineTDV : public BaseFaceEngine
 {
 public:
     FaceEngineTDV(IFaceEngine::Initializer&& init) : BaseFaceEngine(std::move(init)) { load_models(); }
 
+    std::shared_ptr<IFaceEngine> create_instance() const override
+    {
+        return create_face_engine_tdv(IFaceEngine::Initializer(m_init));
+    }
+
     Faces detect(const video::Frame& frame) override
     {
         STEP_ASSERT(m_mode & FE_DETECTION, "Can't detect faces: wrong mode!");
-        STEP_ASSERT(m_detector_ctx, "Can't detect faces: invalid context!");
         STEP_ASSERT(m_face_detector, "Can't detect faces: invalid proc block!");
 
-        auto copied = frame;
-        video::utils::convert_colorspace(copied, video::PixFmt::RGB);
-        auto mat = video::utils::to_mat(copied);
-
-        cv::resize(mat, mat, cv::Size(copied.size.width, copied.size.height));
-
-        auto io_data = m_service->createContext();
-        auto img_ctx = m_service->createContext();
-
-        mat_to_bsm(img_ctx, mat);
-        io_data["image"] = img_ctx;
-        (*m_face_detector)(io_data);
+        // RGB-копия от декодера избавляет от копирования и конвертации полного кадра.
+        // Landmarks считаются в координатах исходного кадра, для них годится только копия того же размера
+        auto [image, borrowed] = get_rgb_image(frame, m_mode & FE_LANDMARKS);
 
         Faces faces;
+        std::vector<tdv::data::FaceData*> fitter_batch;
 
-        for (const api::Context& obj : io_data["objects"])
+        for (auto& obj : m_face_detector->detect(image))
         {
-            if (obj["class"].getString().compare("face"))
-                continue;
-
             auto face = FaceTDV::create_face();
-            const api::Context& rect_ctx = obj.at("bbox");
-            face->set_rect(Rect({static_cast<int>(rect_ctx[0].getDouble() * frame.size.width),
-                                 static_cast<int>(rect_ctx[1].getDouble() * frame.size.height),
-                                 static_cast<int>(rect_ctx[2].getDouble() * frame.size.width),
-                                 static_cast<int>(rect_ctx[3].getDouble() * frame.size.height)}));
+            face->set_rect(Rect({static_cast<int>(obj.bbox[0] * frame.size.width),
+                                 static_cast<int>(obj.bbox[1] * frame.size.height),
+                                 static_cast<int>(obj.bbox[2] * frame.size.width),
+                                 static_cast<int>(obj.bbox[3] * frame.size.height)}));
 
-            face->set_confidence(obj.at("confidence").getDouble());
+            face->set_confidence(obj.confidence);
 
-            face->set_impl_data(std::make_shared<api::Context>(obj));
+            auto impl_data = std::make_shared<tdv::data::FaceData>(std::move(obj));
+            fitter_batch.push_back(impl_data.get());
+            face->set_impl_data(std::move(impl_data));
 
             /*
             TODO Crop face
             if (m_save_frames)
-                face->set_frame(video::utils::crop_frame_deep(copied, face->get_rect()));
+                face->set_frame(video::utils::crop_frame_deep(frame, face->get_rect()));
             */
 
-            if (m_mode & FE_LANDMARKS)
-                calc_landmarks(copied, face);
-
             faces.push_back(face);
         }
 
+        // Landmarks всех лиц кадра - один батч mesh fitter вместо запуска сети на каждое лицо
+        if ((m_mode & FE_LANDMARKS) && !faces.empty())
+        {
+            STEP_ASSERT(m_mesh_fitter, "Can't find landmarks: invalid proc block!");
+            m_mesh_fitter->fit(fitter_batch);
+            for (const auto& face : faces)
+                set_landmarks(frame, face);
+        }
+
+        // Распознавание идет после detect по изображению лица, поэтому кадр вызывающего копируется,
+        // только если на нем есть лица. Одна копия общая для всех лиц кадра
+        if (borrowed && !faces.empty())
+        {
+            auto owned_image = std::make_shared<cv::Mat>(image->clone());
+            for (auto* face_data : fitter_batch)
+                face_data->image = owned_image;
+        }
+
         // TODO check faces for duplicating, etc...
 
         return faces;
@@ -129,7 +159,6 @@ public:
     void recognize(const FacePtr& face) override
     {
         STEP_ASSERT(m_mode & FE_RECOGNITION, "Can't recognize faces: wrong mode!");
-        STEP_ASSERT(m_recognizer_ctx, "Can't recognize faces: invalid context!");
         STEP_ASSERT(m_recognizer_module, "Can't recognize faces: invalid proc block!");
 
         auto face_tdv = std::dynamic_pointer_cast<FaceTDV>(face);
@@ -138,21 +167,9 @@ public:
         auto impl_data = face_tdv->get_impl_data();
         STEP_ASSERT(impl_data, "Invalid FaceTDV impl data!");
 
-        (*m_recognizer_module)(*impl_data);
-
-        auto recognizer_data_ctx = (*impl_data)["template"];
-        //auto recognizer_data_size_ctx = (*impl_data)["template_size"];
-        if (recognizer_data_ctx.isNone())  // || recognizer_data_size_ctx.isNone())
-        {
-            STEP_LOG(L_ERROR, "Can't recognize face!");
-            return;
-        }
-
         try
         {
-            //auto data_size = recognizer_data_size_ctx.getLong();
-            face->set_recognizer_data(
-                reinterpret_cast<tdv::data::Context*>(recognizer_data_ctx.getHandle())->get<std::vector<float>>());
+            m_recognizer_module->identify(*impl_data);
         }
         catch (const std::exception& e)
         {
@@ -164,12 +181,19 @@ public:
             STEP_LOG(L_ERROR, "Unknown exception handled due face recognize");
             return;
         }
+
+        if (!impl_data->hasTemplate())
+        {
+            STEP_LOG(L_ERROR, "Can't recognize face!");
+            return;
+        }
+
+        face->set_recognizer_data(FaceRecognizerData(impl_data->templ.begin(), impl_data->templ.end()));
     }
 
     FaceMatchResult compare(const FacePtr& face0, const FacePtr& face1) override
     {
         STEP_ASSERT(m_mode & FE_RECOGNITION, "Can't compare faces: wrong mode!");
-        STEP_ASSERT(m_matcher_ctx, "Can't compare faces: invalid context!");
         STEP_ASSERT(m_matcher_module, "Can't compare faces: invalid proc block!");
 
         auto face0_tdv = std::dynamic_pointer_cast<FaceTDV>(face0);
@@ -179,13 +203,9 @@ public:
         auto impl0_data = face0_tdv->get_impl_data();
         auto impl1_data = face1_tdv->get_impl_data();
         STEP_ASSERT(impl0_data && impl1_data, "Invalid FaceTDV impl data!");
+        STEP_ASSERT(impl0_data->hasTemplate() && impl1_data->hasTemplate(), "Can't compare unrecognized faces!");
 
-        api::Context matcher_data = m_service->createContext();
-        matcher_data["verification"]["objects"].push_back(*impl0_data);
-        matcher_data["verification"]["objects"].push_back(*impl1_data);
-        (*m_matcher_module)(matcher_data);
-
-        return FaceMatchResult(calc_match_probability(matcher_data["verification"]["result"]["distance"].getDouble()),
+        return FaceMatchResult(calc_match_probability(m_matcher_module->compare(*impl0_data, *impl1_data)),
                                m_match_prob_threshold);
     }
 
@@ -193,7 +213,6 @@ protected:
     void calc_landmarks(const video::Frame& frame, const FacePtr& face) override
     {
         STEP_ASSERT(m_mode & FE_LANDMARKS, "Can't find landmarks: wrong mode!");
-        STEP_ASSERT(m_fitter_ctx, "Can't find landmarks: invalid context!");
         STEP_ASSERT(m_mesh_fitter, "Can't find landmarks: invalid proc block!");
 
         auto face_tdv = std::dynamic_pointer_cast<FaceTDV>(face);
@@ -202,29 +221,34 @@ protected:
         auto impl_data = face_tdv->get_impl_data();
         STEP_ASSERT(impl_data, "Invalid FaceTDV impl data!");
 
-        (*m_mesh_fitter)(*impl_data);
+        m_mesh_fitter->fit(*impl_data);
+        set_landmarks(frame, face);
+    }
 
-        auto fitter = (*impl_data)["fitter"];
-        if (fitter.isNone())
+private:
+    /*! @brief Переводит keypoints mesh fitter в landmarks лица в координатах кадра.
+    */
+    void set_landmarks(const video::Frame& frame, const FacePtr& face) const
+    {
+        auto impl_data = std::dynamic_pointer_cast<FaceTDV>(face)->get_impl_data();
+        if (!impl_data->hasFitter())
         {
             STEP_LOG(L_ERROR, "Can't calc landmarks!");
             return;
         }
 
         FaceLandmarks landmarks;
-        for (const api::Context& point : fitter["keypoints"])
-            landmarks.push_back({static_cast<int>(point[0].getDouble() * frame.size.width),
-                                 static_cast<int>(point[1].getDouble() * frame.size.height)});
-        landmarks.shrink_to_fit();
+        landmarks.reserve(impl_data->keypoints.size);
+        for (const auto& point : impl_data->keypoints)
+            landmarks.push_back({static_cast<int>(point.x * frame.size.width),
+                                 static_cast<int>(point.y * frame.size.height)});
 
         face->set_landmarks(landmarks);
     }
 
-private:
     bool load_models() override
     {
-        if (m_models_path.empty() || !std::filesystem::is_directory(m_models_path) ||
-            m_models_path.string().back() != '/')
+        if (m_models_path.empty() || !std::filesystem::is_directory(m_models_path))
         {
             STEP_LOG(L_ERROR, "Can't load models for FaceEngineTDV, invalid models dir path: {}",
                      m_models_path.string());
@@ -233,40 +257,24 @@ private:
 
         try
         {
-            m_service = std::make_unique<api::Service>(api::Service::createService(m_models_path.string()));
-
             const auto use_cuda = m_device_type == DeviceType::CUDA;
 
             if (m_mode & FE_DETECTION)
-            {
-                m_detector_ctx = std::make_unique<api::Context>(m_service->createContext());
-                (*m_detector_ctx)[UNIT_TYPE] = FACE_DETECTOR_UNIT_NAME;
-                (*m_detector_ctx)[USE_CUDA] = use_cuda;
-                m_face_detector =
-                    std::make_unique<api::ProcessingBlock>(m_service->createProcessingBlock(*m_detector_ctx));
-            }
+                m_face_detector = std::make_unique<tdv::modules::FaceDetectionModule>(
+                    make_unit_config(FACE_DETECTOR_UNIT_NAME, use_cuda));
 
             if (m_mode & FE_LANDMARKS)
-            {
-                m_fitter_ctx = std::make_unique<api::Context>(m_service->createContext());
-                (*m_fitter_ctx)[UNIT_TYPE] = FACE_LANDMARKS_UNIT_NAME;
-                (*m_fitter_ctx)[USE_CUDA] = use_cuda;
-                m_mesh_fitter = std::make_unique<api::ProcessingBlock>(m_service->createProcessingBlock(*m_fitter_ctx));
-            }
+                m_mesh_fitter = std::make_unique<tdv::modules::MeshFitterModule>(
+                    make_unit_config(FACE_LANDMARKS_UNIT_NAME, use_cuda));
 
             if (m_mode & FE_RECOGNITION)
             {
-                m_recognizer_ctx = std::make_unique<api::Context>(m_service->createContext());
-                (*m_recognizer_ctx)[UNIT_TYPE] = FACE_RECOGNIZER_UNIT_NAME;
-                (*m_recognizer_ctx)[USE_CUDA] = use_cuda;
-                m_recognizer_module =
-                    std::make_unique<api::ProcessingBlock>(m_service->createProcessingBlock(*m_recognizer_ctx));
-
-                m_matcher_ctx = std::make_unique<api::Context>(m_service->createContext());
-                (*m_matcher_ctx)[UNIT_TYPE] = FACE_MATCHER_UNIT_NAME;
-                (*m_matcher_ctx)[THRESHOLD] = m_match_gt_threshold;
-                m_matcher_module =
-                    std::make_unique<api::ProcessingBlock>(m_service->createProcessingBlock(*m_matcher_ctx));
+                m_recognizer_module = std::make_unique<tdv::modules::FaceIdentificationModule>(
+                    make_unit_config(FACE_RECOGNIZER_UNIT_NAME, use_cuda));
+
+                tdv::data::Context matcher_config;
+                matcher_config[THRESHOLD] = m_match_gt_threshold;
+                m_matcher_module = std::make_unique<tdv::modules::MatcherModule>(matcher_config);
             }
         }
         catch (std::exception& e)
@@ -285,35 +293,35 @@ private:
         return true;
     }
 
+    tdv::data::Context make_unit_config(const std::string& unit_name, bool use_cuda) const
+    {
+        auto model_path = m_models_path / g_unit_models.at(unit_name);
+        if (m_precision == ModelPrecision::INT8)
+        {
+            model_path = make_int8_model_path(model_path);
+            STEP_ASSERT(std::filesystem::is_regular_file(model_path), "No INT8 model for unit {}: {}", unit_name,
+                        model_path.string());
+        }
+
+        tdv::data::Context config;
+        config[MODEL_PATH] = model_path.string();
+        config[USE_CUDA] = use_cuda;
+        return config;
+    }
+
     void reset()
     {
-        m_detector_ctx.reset();
         m_face_detector.reset();
-
-        m_fitter_ctx.reset();
         m_mesh_fitter.reset();
-
-        m_recognizer_ctx.reset();
         m_recognizer_module.reset();
-
-        m_matcher_ctx.reset();
         m_matcher_module.reset();
-
-        m_service.reset();
     }
 
 private:
-    std::unique_ptr<api::Service> m_service;
-
-    std::unique_ptr<api::Context> m_detector_ctx;
-    std::unique_ptr<api::Context> m_fitter_ctx;
-    std::unique_ptr<api::Context> m_recognizer_ctx;
-    std::unique_ptr<api::Context> m_matcher_ctx;
-
-    std::unique_ptr<api::ProcessingBlock> m_face_detector;
-    std::unique_ptr<api::ProcessingBlock> m_mesh_fitter;
-    std::unique_ptr<api::ProcessingBlock> m_recognizer_module;
-    std::unique_ptr<api::ProcessingBlock> m_matcher_module;
+    std::unique_ptr<tdv::modules::FaceDetectionModule> m_face_detector;
+    std::unique_ptr<tdv::modules::MeshFitterModule> m_mesh_fitter;
+    std::unique_ptr<tdv::modules::FaceIdentificationModule> m_recognizer_module;
+    std::unique_ptr<tdv::modules::MatcherModule> m_matcher_module;
 };
 
 }  // namespace step::proc
@@ -325,4 +333,4 @@ std::shared_ptr<IFaceEngine> create_face_engine_tdv(IFaceEngine::Initializer&& i
     return std::make_shared<FaceEngineTDV>(std::move(init));
 }
 
-}  // namespace step::proc
\ No newline at end of file
+}  // namespace step::proc
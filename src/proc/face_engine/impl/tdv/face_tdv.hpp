@@ -2,13 +2,13 @@
 
 #include <proc/interfaces/face.hpp>
 
-#include <thirdparty/tdv/api/Context.h>
+#include <thirdparty/tdv/data/FaceData.h>
 
 namespace step::proc {
 
 class FaceEngineTDV;
 
-class FaceTDV : public BaseFace<api::Context>
+class FaceTDV : public BaseFace<tdv::data::FaceData>
 {
     friend class FaceEngineTDV;
 
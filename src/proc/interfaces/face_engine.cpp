@@ -19,6 +19,9 @@ void IFaceEngine::Initializer::deserialize(const ObjectPtrJSON& container)
     step::utils::from_string<IFaceEngine::Mode>(mode, json::get<std::string>(container, CFG_FLD::MODE));
     save_frames = json::get<bool>(container, CFG_FLD::FACE_ENGINE_INIT_SAVE_FRAMES);
     step::utils::from_string<DeviceType>(device, json::get<std::string>(container, CFG_FLD::DEVICE));
+    precision = ModelPrecision::FP32;
+    if (auto precision_str = json::get_opt<std::string>(container, CFG_FLD::PRECISION))
+        step::utils::from_string<ModelPrecision>(precision, *precision_str);
     match_gt_threshold = json::get<double>(container, CFG_FLD::FACE_MATCHING_GROUNDTRUTH_THRESHOLD);
     match_gf_threshold = json::get<double>(container, CFG_FLD::FACE_MATCHING_GROUNDFALSE_THRESHOLD);
     match_prob_threshold = json::get<double>(container, CFG_FLD::FACE_MATCHING_PROBABILITY_THRESHOLD);
@@ -33,6 +36,7 @@ bool IFaceEngine::Initializer::is_valid() const noexcept
         && type != FaceEngineType::Undefined
         && mode != Mode::FE_UNDEFINED
         && device != DeviceType::Undefined
+        && precision != ModelPrecision::Undefined
         && !models_path.empty()
         && !step::utils::compare(match_gt_threshold, 0.0)
         && !step::utils::compare(match_gf_threshold, 0.0)
@@ -50,6 +54,7 @@ bool IFaceEngine::Initializer::operator==(const IFaceEngine::Initializer& rhs) c
         && mode == rhs.mode
         && save_frames == rhs.save_frames
         && device == rhs.device
+        && precision == rhs.precision
         && step::utils::compare(match_gt_threshold, rhs.match_gt_threshold)
         && step::utils::compare(match_gf_threshold, rhs.match_gf_threshold)
         && step::utils::compare(match_prob_threshold, rhs.match_prob_threshold)
@@ -2,6 +2,7 @@
 
 #include "device_type.hpp"
 #include "face.hpp"
+#include "model_precision.hpp"
 
 #include <proc/interfaces/face_engine_type.hpp>
 
@@ -32,6 +33,7 @@ public:
         Mode mode{FE_UNDEFINED};
         std::filesystem::path models_path;
         DeviceType device{DeviceType::Undefined};
+        ModelPrecision precision{ModelPrecision::FP32};  // INT8 - загружаются модели "<name>_int8.onnx"
         bool save_frames = false;        // Обрезка кадра и сохранение в IFace
         double match_gt_threshold{0.0};  // groundtruth threshold
         double match_gf_threshold{0.0};  // groundfalse threshold
@@ -52,6 +54,12 @@ public:
     virtual void recognize(const FacePtr&) = 0;
     virtual FaceMatchResult compare(const FacePtr&, const FacePtr&) = 0;
 
+    /*! @brief Новый экземпляр с теми же настройками.
+        @details Методы движка не реентерабельны: потоки, вызывающие движок одновременно, должны работать
+        каждый со своим экземпляром. Экземпляр загружает свои модели.
+    */
+    virtual std::shared_ptr<IFaceEngine> create_instance() const = 0;
+
 protected:
     virtual void calc_landmarks(const video::Frame&, const FacePtr&) = 0;
 
@@ -65,7 +73,9 @@ class BaseFaceEngine : public IFaceEngine
 {
 protected:
     BaseFaceEngine(IFaceEngine::Initializer&& init)
-        : m_device_type(std::move(init.device))
+        : m_init(init)
+        , m_device_type(std::move(init.device))
+        , m_precision(std::move(init.precision))
         , m_mode(std::move(init.mode))
         , m_models_path(std::move(init.models_path))
         , m_save_frames(std::move(init.save_frames))
@@ -78,7 +88,9 @@ protected:
     double calc_match_probability(double distance) const noexcept override;
 
 protected:
+    IFaceEngine::Initializer m_init;  // Для create_instance
     DeviceType m_device_type;
+    ModelPrecision m_precision;
     IFaceEngine::Mode m_mode;
     std::filesystem::path m_models_path;
     bool m_save_frames = false;  // Обрезка кадра и сохранение в IFace
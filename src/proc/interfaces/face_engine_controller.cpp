@@ -6,7 +6,11 @@
 
 namespace step::proc {
 
-IFaceEngineController::IFaceEngineController(const ObjectPtrJSON& cfg) : IConnectionSource() { deserialize(cfg); }
+IFaceEngineController::IFaceEngineController(const ObjectPtrJSON& cfg) : IConnectionSource()
+{
+    if (cfg)
+        deserialize(cfg);
+}
 
 void IFaceEngineController::connect(IConnectionObject* obj)
 {
@@ -21,9 +25,22 @@ void IFaceEngineController::deserialize(const ObjectPtrJSON& container)
 {
     set_conn_id(json::get<std::string>(container, CFG_FLD::FACE_ENGINE_CONNECTION_ID));
 
-    IFaceEngine::Initializer init;
-    init.deserialize(json::get_object(container, CFG_FLD::FACE_ENGINE_INIT));
-    set_face_engine(create_face_engine(std::move(init)));
+    m_face_engine_init.deserialize(json::get_object(container, CFG_FLD::FACE_ENGINE_INIT));
+    set_face_engine(create_face_engine_instance());
+}
+
+std::shared_ptr<IFaceEngine> IFaceEngineController::create_face_engine_instance() const
+{
+    return create_face_engine(IFaceEngine::Initializer(m_face_engine_init));
+}
+
+void IFaceEngineController::set_users_face_engine(size_t first_user, size_t last_user,
+                                                  const std::shared_ptr<IFaceEngine>& face_engine)
+{
+    STEP_ASSERT(first_user <= last_user && last_user <= m_users.size(), "Invalid face engine users range [{}, {})",
+                first_user, last_user);
+    for (size_t i = first_user; i < last_user; ++i)
+        m_users[i]->set_face_engine(face_engine);
 }
 
 }  // namespace step::proc
\ No newline at end of file
@@ -10,6 +10,8 @@ namespace step::proc {
 class IFaceEngineController : public IUserController<IFaceEngineUser>, public IConnectionSource, public ISerializable
 {
 public:
+    /*! @details Без cfg face engine не создается, get_face_engine() возвращает nullptr.
+    */
     IFaceEngineController(const ObjectPtrJSON& cfg);
     virtual ~IFaceEngineController() = default;
 
@@ -22,6 +24,19 @@ public:
 
     virtual std::shared_ptr<IFaceEngine> get_face_engine() const { return m_face_engine; }
 
+    /*! @brief Новый экземпляр face engine с настройками контроллера.
+        @details Экземпляр загружает свои модели и не делит состояние с другими, поэтому пайплайны разных
+        рабочих потоков вызывают свои движки без общей блокировки.
+    */
+    std::shared_ptr<IFaceEngine> create_face_engine_instance() const;
+
+    /*! @brief Назначает face_engine пользователям с индексами [first_user, last_user) в порядке подключения.
+        @details Пользователи хранят weak_ptr, владеть экземпляром должен вызывающий.
+    */
+    void set_users_face_engine(size_t first_user, size_t last_user, const std::shared_ptr<IFaceEngine>& face_engine);
+
+    size_t get_users_count() const noexcept { return m_users.size(); }
+
     void deserialize(const ObjectPtrJSON& container);
 
 private:
@@ -33,6 +48,7 @@ private:
     void disconnect(IConnectionObject*) override;
 
 protected:
+    IFaceEngine::Initializer m_face_engine_init;
     std::shared_ptr<IFaceEngine> m_face_engine;
 };
 
@@ -13,7 +13,30 @@ class IFaceEngineUser : public IConnectionObject
 public:
     virtual ~IFaceEngineUser() = default;
 
-    virtual void set_face_engine(const std::weak_ptr<IFaceEngine>& face_engine) { m_face_engine = face_engine; }
+    virtual void set_face_engine(const std::weak_ptr<IFaceEngine>& face_engine)
+    {
+        if (!m_own_face_engine)
+            m_face_engine = face_engine;
+    }
+
+    /*! @brief Заменяет назначенный контроллером face engine собственным экземпляром с теми же настройками.
+        @details Нужен, когда пользователи одного контроллера вызывают движок из разных потоков одновременно.
+        Собственный экземпляр принадлежит пользователю, последующие set_face_engine его не меняют.
+        Возвращает false, если движок пользователю не назначен.
+    */
+    bool use_own_face_engine_instance()
+    {
+        if (m_own_face_engine)
+            return true;
+
+        const auto face_engine = m_face_engine.lock();
+        if (!face_engine)
+            return false;
+
+        m_own_face_engine = face_engine->create_instance();
+        m_face_engine = m_own_face_engine;
+        return true;
+    }
 
 protected:
     std::shared_ptr<IFaceEngine> get_face_engine(bool required = true) const
@@ -27,6 +50,9 @@ protected:
 
 protected:
     std::weak_ptr<IFaceEngine> m_face_engine;
+
+private:
+    std::shared_ptr<IFaceEngine> m_own_face_engine;
 };
 
 }  // namespace step::proc
\ No newline at end of file
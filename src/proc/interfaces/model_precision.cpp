@@ -0,0 +1,62 @@
+#include "model_precision.hpp"
+
+#include <core/base/utils/find_pair.hpp>
+#include <core/base/utils/string_utils.hpp>
+
+#include <string_view>
+#include <utility>
+
+namespace {
+/* clang-format off */
+
+constexpr std::pair<step::proc::ModelPrecision, std::string_view> g_model_precisions[] = {
+    { step::proc::ModelPrecision::FP32, "fp32" },
+    { step::proc::ModelPrecision::INT8, "int8" },
+};
+
+constexpr std::pair<step::proc::QuantizationMode, std::string_view> g_quantization_modes[] = {
+    { step::proc::QuantizationMode::Dynamic , "dynamic" },
+    { step::proc::QuantizationMode::Static  , "static"  },
+};
+
+/* clang-format on */
+}  // namespace
+
+namespace step::proc {
+
+std::filesystem::path make_int8_model_path(const std::filesystem::path& fp32_model_path)
+{
+    auto path = fp32_model_path;
+    path.replace_filename(fp32_model_path.stem().string() + "_int8" + fp32_model_path.extension().string());
+    return path;
+}
+
+}  // namespace step::proc
+
+namespace step::utils {
+
+template <>
+std::string to_string(step::proc::ModelPrecision precision)
+{
+    return find_by_type(precision, g_model_precisions);
+}
+
+template <>
+void from_string(step::proc::ModelPrecision& precision, const std::string& str)
+{
+    find_by_str(str, precision, g_model_precisions);
+}
+
+template <>
+std::string to_string(step::proc::QuantizationMode mode)
+{
+    return find_by_type(mode, g_quantization_modes);
+}
+
+template <>
+void from_string(step::proc::QuantizationMode& mode, const std::string& str)
+{
+    find_by_str(str, mode, g_quantization_modes);
+}
+
+}  // namespace step::utils
@@ -0,0 +1,29 @@
+#pragma once
+
+#include <filesystem>
+
+namespace step::proc {
+
+enum class ModelPrecision
+{
+    Undefined,
+    FP32,
+    INT8,
+};
+
+/*! @brief Способ получения INT8 модели.
+    Dynamic - веса квантованы заранее, активации квантуются на лету (не требует калибровки).
+    Static - веса и активации квантованы по калибровочному набору (QDQ-модель).
+*/
+enum class QuantizationMode
+{
+    Undefined,
+    Dynamic,
+    Static,
+};
+
+/*! @brief Путь к квантованному варианту модели по соглашению "<name>_int8.<ext>" рядом с FP32 моделью.
+*/
+std::filesystem::path make_int8_model_path(const std::filesystem::path& fp32_model_path);
+
+}  // namespace step::proc
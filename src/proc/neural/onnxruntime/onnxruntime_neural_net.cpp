@@ -3,6 +3,7 @@
 #include <core/log/log.hpp>
 #include <core/base/utils/type_utils.hpp>
 #include <core/base/utils/time_utils.hpp>
+#include <core/base/utils/string_utils.hpp>
 
 #include <video/frame/utils/frame_utils_opencv.hpp>
 
@@ -24,7 +25,8 @@ public:
     OnnxRuntimeNeuralNet(const std::shared_ptr<task::BaseSettings>& settings)
     {
         set_settings(*settings);
-        const auto& model_path = m_typed_settings.get_model_path();
+        const auto model_path = m_typed_settings.get_active_model_path();
+        const auto precision = m_typed_settings.get_precision();
         try
         {
             m_ort_env = std::make_unique<Ort::Env>(ORT_LOGGING_LEVEL_WARNING, STEPKIT_MODULE_NAME);
@@ -44,6 +46,10 @@ public:
                     options.cudnn_conv_algo_search = OrtCudnnConvAlgoSearch::OrtCudnnConvAlgoSearchExhaustive;
                     options.do_copy_in_default_stream = 1;
                     m_ort_session_options->AppendExecutionProvider_CUDA(options);
+
+                    if (precision == ModelPrecision::INT8)
+                        STEP_LOG(L_WARN, "INT8 model {} on CUDA: quantized operators may fall back to CPU",
+                                 model_path.string());
                 }
                 break;
 
@@ -77,8 +83,14 @@ public:
                     m_output_names.push_back(m_ort_session->GetOutputName(i, allocator));
             }
 
-            STEP_LOG(L_INFO, "Loaded base onnxruntime net: inputs: {}, outputs: {}, input size: {}, path: {}",
-                     m_input_count, m_ouput_count, m_input_size, model_path.string());
+            STEP_LOG(L_INFO,
+                     "Loaded base onnxruntime net: inputs: {}, outputs: {}, input size: {}, precision: {}, path: {}",
+                     m_input_count, m_ouput_count, m_input_size, step::utils::to_string(precision),
+                     model_path.string());
+            if (precision == ModelPrecision::INT8)
+                STEP_LOG(L_INFO, "Quantization: {}, calibration: {}",
+                         step::utils::to_string(m_typed_settings.get_quantization_mode()),
+                         m_typed_settings.get_calibration_path().string());
         }
         catch (std::exception& ex)
         {
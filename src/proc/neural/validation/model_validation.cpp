@@ -0,0 +1,147 @@
+#include "model_validation.hpp"
+
+#include <core/exception/assert.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+
+namespace step::proc {
+
+double QuantizationReport::speedup() const noexcept
+{
+    return int8_latency.mean.count() > 0
+               ? static_cast<double>(fp32_latency.mean.count()) / static_cast<double>(int8_latency.mean.count())
+               : 0.0;
+}
+
+double calc_iou(const Rect& lhs, const Rect& rhs) noexcept
+{
+    const int x0 = std::max(lhs.p0.x, rhs.p0.x);
+    const int y0 = std::max(lhs.p0.y, rhs.p0.y);
+    const int x1 = std::min(lhs.p1.x, rhs.p1.x);
+    const int y1 = std::min(lhs.p1.y, rhs.p1.y);
+
+    const double inter = static_cast<double>(std::max(0, x1 - x0)) * std::max(0, y1 - y0);
+    const double uni = static_cast<double>(lhs.length()) * lhs.height() +
+                       static_cast<double>(rhs.length()) * rhs.height() - inter;
+
+    return uni > 0.0 ? inter / uni : 0.0;
+}
+
+double calc_average_precision(const std::vector<DetectionSample>& samples, double iou_threshold /*= 0.5*/)
+{
+    // (уверенность детекции, признак true positive)
+    std::vector<std::pair<double, bool>> matches;
+    size_t groundtruth_count = 0;
+
+    for (const auto& sample : samples)
+    {
+        STEP_ASSERT(sample.scores.empty() || sample.scores.size() == sample.detections.size(),
+                    "Detection scores count {} mismatch detections count {}", sample.scores.size(),
+                    sample.detections.size());
+
+        groundtruth_count += sample.groundtruth.size();
+        std::vector<bool> used(sample.groundtruth.size(), false);
+
+        for (size_t rank = 0; rank < sample.detections.size(); ++rank)
+        {
+            double best_iou = 0.0;
+            size_t best_index = sample.groundtruth.size();
+            for (size_t i = 0; i < sample.groundtruth.size(); ++i)
+            {
+                if (used[i])
+                    continue;
+
+                const auto iou = calc_iou(sample.detections[rank], sample.groundtruth[i]);
+                if (iou > best_iou)
+                {
+                    best_iou = iou;
+                    best_index = i;
+                }
+            }
+
+            const bool is_tp = best_index < sample.groundtruth.size() && best_iou >= iou_threshold;
+            if (is_tp)
+                used[best_index] = true;
+
+            matches.emplace_back(sample.scores.empty() ? -static_cast<double>(rank) : sample.scores[rank], is_tp);
+        }
+    }
+
+    if (groundtruth_count == 0)
+        return matches.empty() ? 1.0 : 0.0;
+
+    std::stable_sort(matches.begin(), matches.end(),
+                     [](const auto& lhs, const auto& rhs) { return lhs.first > rhs.first; });
+
+    std::vector<double> precisions, recalls;
+    precisions.reserve(matches.size());
+    recalls.reserve(matches.size());
+
+    size_t tp = 0;
+    for (size_t i = 0; i < matches.size(); ++i)
+    {
+        tp += matches[i].second;
+        precisions.push_back(static_cast<double>(tp) / (i + 1));
+        recalls.push_back(static_cast<double>(tp) / groundtruth_count);
+    }
+
+    // огибающая precision справа налево
+    for (int i = static_cast<int>(precisions.size()) - 2; i >= 0; --i)
+        precisions[i] = std::max(precisions[i], precisions[i + 1]);
+
+    double ap = 0.0;
+    double prev_recall = 0.0;
+    for (size_t i = 0; i < precisions.size(); ++i)
+    {
+        ap += (recalls[i] - prev_recall) * precisions[i];
+        prev_recall = recalls[i];
+    }
+
+    return ap;
+}
+
+double calc_cosine_similarity(const std::vector<float>& lhs, const std::vector<float>& rhs)
+{
+    STEP_ASSERT(lhs.size() == rhs.size(), "Can't calc cosine similarity: different sizes {} and {}", lhs.size(),
+                rhs.size());
+
+    double dot = 0.0, lhs_norm = 0.0, rhs_norm = 0.0;
+    for (size_t i = 0; i < lhs.size(); ++i)
+    {
+        dot += static_cast<double>(lhs[i]) * rhs[i];
+        lhs_norm += static_cast<double>(lhs[i]) * lhs[i];
+        rhs_norm += static_cast<double>(rhs[i]) * rhs[i];
+    }
+
+    if (lhs_norm <= 0.0 || rhs_norm <= 0.0)
+        return 0.0;
+
+    return dot / (std::sqrt(lhs_norm) * std::sqrt(rhs_norm));
+}
+
+LatencyStats calc_latency_stats(std::vector<Microseconds> samples)
+{
+    LatencyStats stats;
+    if (samples.empty())
+        return stats;
+
+    std::sort(samples.begin(), samples.end());
+
+    const auto percentile = [&samples](double p) {
+        const auto index = static_cast<size_t>(std::ceil(p * samples.size())) - 1;
+        return samples[std::min(index, samples.size() - 1)];
+    };
+
+    stats.count = samples.size();
+    stats.min = samples.front();
+    stats.max = samples.back();
+    stats.mean = std::accumulate(samples.begin(), samples.end(), Microseconds(0)) / samples.size();
+    stats.p50 = percentile(0.5);
+    stats.p95 = percentile(0.95);
+
+    return stats;
+}
+
+}  // namespace step::proc
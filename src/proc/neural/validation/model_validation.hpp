@@ -0,0 +1,87 @@
+#pragma once
+
+#include <core/base/types/rect.hpp>
+#include <core/base/types/time.hpp>
+
+#include <fmt/format.h>
+
+#include <vector>
+
+namespace step::proc {
+
+/*! @brief Статистика времени инференса модели.
+*/
+struct LatencyStats
+{
+    size_t count{0};
+    Microseconds mean{0};
+    Microseconds min{0};
+    Microseconds max{0};
+    Microseconds p50{0};
+    Microseconds p95{0};
+};
+
+/*! @brief Разметка и результат детектора на одном изображении.
+    @details scores - уверенности детекций. Если пусты, детекции считаются упорядоченными по убыванию
+    уверенности (так их отдают детекторы после NMS) и сравниваются по рангу.
+*/
+struct DetectionSample
+{
+    std::vector<Rect> groundtruth;
+    std::vector<Rect> detections;
+    std::vector<double> scores;
+};
+
+/*! @brief Сводка сравнения FP32 и INT8 вариантов модели на размеченном наборе.
+*/
+struct QuantizationReport
+{
+    double fp32_map{0.0};
+    double int8_map{0.0};
+    double mean_cosine_similarity{1.0};  // между эмбеддингами FP32 и INT8, 1.0 - без дрейфа
+    double min_cosine_similarity{1.0};
+    LatencyStats fp32_latency;
+    LatencyStats int8_latency;
+
+    double map_delta() const noexcept { return int8_map - fp32_map; }
+    double speedup() const noexcept;
+};
+
+double calc_iou(const Rect& lhs, const Rect& rhs) noexcept;
+
+/*! @brief Average precision (площадь под PR-кривой, all-point interpolation) по набору изображений.
+    @details Детекция считается верной, если IoU с еще не сопоставленным groundtruth >= iou_threshold.
+*/
+double calc_average_precision(const std::vector<DetectionSample>& samples, double iou_threshold = 0.5);
+
+double calc_cosine_similarity(const std::vector<float>& lhs, const std::vector<float>& rhs);
+
+LatencyStats calc_latency_stats(std::vector<Microseconds> samples);
+
+}  // namespace step::proc
+
+template <>
+struct fmt::formatter<step::proc::LatencyStats> : fmt::formatter<string_view>
+{
+    template <typename FormatContext>
+    auto format(const step::proc::LatencyStats& stats, FormatContext& ctx)
+    {
+        return fmt::format_to(ctx.out(), "count: {}, mean: {}us, min: {}us, p50: {}us, p95: {}us, max: {}us",
+                              stats.count, stats.mean, stats.min, stats.p50, stats.p95, stats.max);
+    }
+};
+
+template <>
+struct fmt::formatter<step::proc::QuantizationReport> : fmt::formatter<string_view>
+{
+    template <typename FormatContext>
+    auto format(const step::proc::QuantizationReport& report, FormatContext& ctx)
+    {
+        return fmt::format_to(ctx.out(),
+                              "mAP fp32: {:.4f}, int8: {:.4f}, delta: {:+.4f}; cosine mean: {:.4f}, min: {:.4f}; "
+                              "latency fp32: [{}], int8: [{}], speedup: {:.2f}x",
+                              report.fp32_map, report.int8_map, report.map_delta(), report.mean_cosine_similarity,
+                              report.min_cosine_similarity, report.fp32_latency, report.int8_latency,
+                              report.speedup());
+    }
+};
@@ -25,20 +25,20 @@ std::vector<YoloObject> YoloxWrapper::process(const NeuralOutput& neural_output,
 {
     const float* data = !neural_output.data_vec.empty() ? neural_output.data_vec.data() : neural_output.data_ptr;
 
-    auto yolo_objects = generate_yolox_proposals(data);
-    std::sort(yolo_objects.begin(), yolo_objects.end(),
+    generate_yolox_proposals(data);
+    std::sort(m_proposals.begin(), m_proposals.end(),
               [](const auto& item0, const auto& item1) { return item0.prob > item1.prob; });
 
-    auto nms_sorted_indexes = nms_sorted_bboxes(yolo_objects);
+    nms_sorted_bboxes();
 
     double width_scale = 1.0 * orig_frame_size.width / m_frame_size.width;
     double height_scale = 1.0 * orig_frame_size.height / m_frame_size.height;
 
     std::vector<YoloObject> result;
-    result.reserve(nms_sorted_indexes.size());
-    std::transform(nms_sorted_indexes.cbegin(), nms_sorted_indexes.cend(), std::back_inserter(result),
-                   [this, &yolo_objects, &width_scale, &height_scale](int nms_sorted_index) {
-                       auto obj = yolo_objects[nms_sorted_index];
+    result.reserve(m_picked.size());
+    std::transform(m_picked.cbegin(), m_picked.cend(), std::back_inserter(result),
+                   [this, &width_scale, &height_scale](int nms_sorted_index) {
+                       auto obj = m_proposals[nms_sorted_index];
 
                        // Recalculate bboxes to orig frame size
                        const auto x0 = obj.rect.x * width_scale;
@@ -79,9 +79,9 @@ void YoloxWrapper::generate_grid_and_strides()
     }
 }
 
-std::vector<YoloObject> YoloxWrapper::generate_yolox_proposals(const float* feat_ptr)
+void YoloxWrapper::generate_yolox_proposals(const float* feat_ptr)
 {
-    std::vector<YoloObject> yolo_objects;
+    m_proposals.clear();
 
     try
     {
@@ -117,7 +117,7 @@ std::vector<YoloObject> YoloxWrapper::generate_yolox_proposals(const float* feat
                     obj.label = class_idx;
                     obj.prob = box_prob;
 
-                    yolo_objects.push_back(obj);
+                    m_proposals.push_back(obj);
                 }
 
             }  // class loop
@@ -130,38 +130,35 @@ std::vector<YoloObject> YoloxWrapper::generate_yolox_proposals(const float* feat
     catch (std::exception& e)
     {
         STEP_LOG(L_ERROR, "Exception handled due generate_yolox_proposals: {}", e.what());
-        return {};
+        m_proposals.clear();
     }
     catch (...)
     {
         STEP_LOG(L_ERROR, "Unknown exception handled due generate_yolox_proposals");
-        return {};
+        m_proposals.clear();
     }
-
-    return yolo_objects;
 }
 
-std::vector<int> YoloxWrapper::nms_sorted_bboxes(const std::vector<YoloObject>& objects)
+void YoloxWrapper::nms_sorted_bboxes()
 {
-    std::vector<int> result;
+    m_picked.clear();
 
-    std::vector<float> areas;
-    areas.reserve(objects.size());
-    std::transform(objects.cbegin(), objects.cend(), std::back_inserter(areas),
+    m_areas.clear();
+    std::transform(m_proposals.cbegin(), m_proposals.cend(), std::back_inserter(m_areas),
                    [](const auto& item) { return item.rect.area(); });
 
-    for (int i = 0; i < objects.size(); ++i)
+    for (int i = 0; i < m_proposals.size(); ++i)
     {
-        const auto& obj0 = objects[i];
+        const auto& obj0 = m_proposals[i];
 
         bool need_keep = true;
-        for (int j = 0; j < result.size(); ++j)
+        for (int j = 0; j < m_picked.size(); ++j)
         {
-            const auto& obj1 = objects[result[j]];
+            const auto& obj1 = m_proposals[m_picked[j]];
 
             // intersection over union
             float inter_area = (obj0.rect & obj1.rect).area();
-            float union_area = areas[i] + areas[result[j]] - inter_area;
+            float union_area = m_areas[i] + m_areas[m_picked[j]] - inter_area;
             // float IoU = inter_area / union_area
             if (inter_area / union_area > m_nms_threshold)
             {
@@ -171,10 +168,8 @@ std::vector<int> YoloxWrapper::nms_sorted_bboxes(const std::vector<YoloObject>&
         }
 
         if (need_keep)
-            result.push_back(i);
+            m_picked.push_back(i);
     }
-
-    return result;
 }
 
 }  // namespace step::proc
\ No newline at end of file
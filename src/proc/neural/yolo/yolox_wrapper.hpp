@@ -43,8 +43,14 @@ public:
 
 private:
     void generate_grid_and_strides();
-    std::vector<YoloObject> generate_yolox_proposals(const float* feat_ptr);
-    std::vector<int> nms_sorted_bboxes(const std::vector<YoloObject>& objects);
+    /*! @brief Кандидаты из выхода сети в m_proposals.
+        @details Выход читается на месте: строка якоря - (class_count + 5) float подряд.
+    */
+    void generate_yolox_proposals(const float* feat_ptr);
+
+    /*! @brief Индексы m_proposals, оставшихся после NMS, в m_picked. m_proposals отсортированы по убыванию prob.
+    */
+    void nms_sorted_bboxes();
 
 private:
     int m_grid_count{0};
@@ -55,6 +61,11 @@ private:
     step::video::FrameSize m_frame_size;
 
     std::vector<GridAndStride> m_grid_strides;
+
+    // Переиспользуются между кадрами: постобработка не выделяет память, пока не растет число кандидатов
+    std::vector<YoloObject> m_proposals;
+    std::vector<float> m_areas;
+    std::vector<int> m_picked;
 };
 
 }  // namespace step::proc
\ No newline at end of file
@@ -2,6 +2,7 @@
 
 #include "async_pipeline_branch.hpp"
 
+#include <core/threading/delivery_queue.hpp>
 #include <core/threading/thread_pool_execute_policy.hpp>
 #include <core/threading/thread_pool.hpp>
 #include <core/log/log.hpp>
@@ -43,6 +44,7 @@ protected:
     using ThreadPoolType = step::threading::ThreadPool<PipelineIdType, PipelineDataPtr<TData>, PipelineDataPtr<TData>>;
 
     using OutputDataMapType = robin_hood::unordered_map<PipelineIdType, PipelineDataPtr<TData>>;
+    using IndexType = PipelineExecutionPlan::IndexType;
 
 public:
     virtual ~AsyncPipeline()
@@ -52,26 +54,62 @@ public:
         // Stop (thread_pool_stop_impl) will be called from ThreadPool::stop during ThreadPool destruction
     }
 
+    /*! @brief Отдает данные во входную ветвь.
+        @details Если ветвь занята, данные ждут во входной очереди по политике input_policy:
+        по умолчанию (latest_only) ждет только последний кадр, задержка остается ограниченной.
+        false - пайплайн останавливается, данные не приняты.
+    */
     bool add_process_data(PipelineDataPtr<TData>&& data)
     {
         if (!ThreadPoolType::is_running())
+        {
+            m_input.restart();
             ThreadPoolType::run();
+        }
+
+        const auto& profiler = BasePipeline<TData>::m_profiler;
+        if (m_load_controller)
+            apply_load_control(*data);
+
+        const auto result = m_input.push({std::move(data), profiler->now()});
+        if (result == threading::DeliveryResult::AcceptedWithDrop)
+        {
+            const auto root_index = BasePipeline<TData>::m_plan.get_root_index();
+            profiler->record_drop(m_workers[root_index]->get_stats());
+            STEP_LOG_THROTTLE(L_DEBUG, Seconds(1), "Pipeline {}: input branch is busy, older input data dropped",
+                              BasePipeline<TData>::m_settings.name);
+        }
 
-        return add_process_data(BasePipeline<TData>::get_root_id(), std::move(data));
+        return result != threading::DeliveryResult::Stopped;
     }
 
+    threading::DeliveryStats get_input_stats() const { return m_input.get_stats(); }
+
 private:
-    bool add_process_data(const PipelineIdType& id, PipelineDataPtr<TData>&& data)
+    /*! @brief Замер нагрузки раз в sample_interval и решение регулятора для кадра во вложении.
+        @details Вызывается из потока источника. Потери входной очереди уже учтены профилировщиком
+        у входной ветви. Для очереди емкостью 1 (latest_only) заполненность не учитывается - перегрузку
+        показывают потери кадров. Приоритет потока берется из настроек пайплайна (priority).
+    */
+    void apply_load_control(PipelineData<TData>& data)
     {
-        std::scoped_lock lock(m_branches_data_guard);
-        auto& branch_data = m_branches_data[id];
-        if (branch_data.status != BranchStatus::Finished)
-            return false;
+        const auto& settings = BasePipeline<TData>::m_settings;
+        const auto& profiler = BasePipeline<TData>::m_profiler;
+        const auto now = profiler->now();
+        if (m_load_controller->need_sample(now))
+        {
+            const auto capacity = settings.input_policy == threading::DeliveryPolicy::LatestOnly
+                                      ? size_t(1)
+                                      : std::max<size_t>(settings.input_queue_size, 1);
+            const double queue_fill = capacity > 1 ? static_cast<double>(m_input.size()) / capacity : 0.0;
+            m_load_controller->update(m_load_controller->make_sample({profiler}, queue_fill, 0, now));
+        }
 
-        branch_data = {std::move(data), BranchStatus::Ready};
-        return true;
+        auto shedding = m_load_controller->get_shedding(settings.priority, m_load_frame_counter);
+        data.storage.set_attachment(CFG_FLD::LOAD_SHEDDING, std::make_any<LoadShedding>(std::move(shedding)));
     }
 
+private:
     void thread_pool_stop_impl() override
     {
         // NO LOCK THERE
@@ -79,7 +117,8 @@ private:
         // All threads already joined and stopped
         STEP_LOG(L_INFO, "Stopping pipeline {}", BasePipeline<TData>::m_settings.name);
 
-        for (auto& [id, branch_data] : m_branches_data)
+        m_input.stop();
+        for (auto& branch_data : m_branches_data)
             branch_data = {nullptr, BranchStatus::Finished};
 
         STEP_LOG(L_INFO, "Pipeline {} has been stopped", BasePipeline<TData>::m_settings.name);
@@ -87,17 +126,20 @@ private:
 
     void thread_pool_iteration() override
     {
-        const auto& root_id = BasePipeline<TData>::get_root_id();
+        const auto root_index = BasePipeline<TData>::m_plan.get_root_index();
+        const auto& profiler = BasePipeline<TData>::m_profiler;
         bool is_ready;
 
         std::scoped_lock lock(m_branches_data_guard);
 
         // Check for exceptions
-        for (auto& [id, branch] : ThreadPoolType::m_threads)
+        for (IndexType index = 0; index < m_workers.size(); ++index)
         {
+            const auto& branch = m_workers[index];
             if (!branch->has_exceptions())
                 continue;
 
+            const auto& id = BasePipeline<TData>::m_plan.get_id(index);
             STEP_LOG(L_ERROR, "Pipeline {}: Handle exceptions from branch {}", BasePipeline<TData>::m_settings.name,
                      id);
             for (auto branch_exception : branch->get_exceptions())
@@ -110,7 +152,7 @@ private:
                 {
                     STEP_LOG(L_ERROR, "Pipeline {}: Branch {} exception: {}", BasePipeline<TData>::m_settings.name, id,
                              e.what());
-                    m_branches_data[id] = {nullptr, BranchStatus::Finished};
+                    m_branches_data[index] = {nullptr, BranchStatus::Finished};
                     m_output_branches_data[id].reset();
                 }
             }
@@ -118,18 +160,28 @@ private:
             branch->reset_exceptions();
         }
 
+        // Входная ветвь освободилась - забираем следующие данные из входной очереди
+        if (m_branches_data[root_index].status == BranchStatus::Finished)
+        {
+            if (auto input = m_input.try_pop())
+                m_branches_data[root_index] = {std::move(input->data), BranchStatus::Ready, input->push_time};
+        }
+
         // For ParallelWait we ensure that all branches are stopped and input are ready
         bool ready_for_wait_iteration = true;
         if (BasePipeline<TData>::m_settings.sync_policy == PipelineSyncPolicy::ParallelWait)
         {
-            ready_for_wait_iteration = std::ranges::all_of(m_branches_data, [&root_id](const auto& item) {
-                return item.first == root_id ? item.second.status == BranchStatus::Ready
-                                             : item.second.status == BranchStatus::Finished;
-            });
+            for (IndexType index = 0; index < m_branches_data.size() && ready_for_wait_iteration; ++index)
+            {
+                const auto expected = index == root_index ? BranchStatus::Ready : BranchStatus::Finished;
+                ready_for_wait_iteration = m_branches_data[index].status == expected;
+            }
         }
 
-        for (auto& [id, branch_data] : m_branches_data)
+        for (IndexType index = 0; index < m_branches_data.size(); ++index)
         {
+            auto& branch_data = m_branches_data[index];
+
             // Skip if branch is running now
             if (branch_data.status == BranchStatus::Running)
                 continue;
@@ -139,7 +191,7 @@ private:
             if (BasePipeline<TData>::m_settings.sync_policy == PipelineSyncPolicy::ParallelWait)
             {
                 // For ParallelWait we should ensure that we are processing input with all stopped other branches
-                is_ready = is_ready && (root_id != id || root_id == id && ready_for_wait_iteration);
+                is_ready = is_ready && (root_index != index || ready_for_wait_iteration);
             }
 
             // Skip if smth is not ready
@@ -149,12 +201,15 @@ private:
             STEP_ASSERT(branch_data.data_to_process && branch_data.status == BranchStatus::Ready,
                         "Invalid pipeline process data for start!");
 
-            STEP_LOG(L_INFO, "Pipeline {} start branch {}", BasePipeline<TData>::m_settings.name, id);
+            const auto& branch = m_workers[index];
+            const auto& id = BasePipeline<TData>::m_plan.get_id(index);
+            STEP_LOG(L_TRACE, "Pipeline {} start branch {}", BasePipeline<TData>::m_settings.name, id);
 
             // Copy processing data and clear it from storage
             //    to skip next data before finishing
 
-            ThreadPoolType::m_threads[id]->add_data(std::move(branch_data.data_to_process));
+            profiler->record_queue_wait(branch->get_stats(), branch_data.ready_time, profiler->now());
+            branch->add_data(std::move(branch_data.data_to_process));
             branch_data = {nullptr, BranchStatus::Running};
             m_output_branches_data[id].reset();
         }
@@ -163,46 +218,58 @@ private:
 private:
     virtual void create_branch(const PipelineNodePtr<TData>& branch_root) override
     {
-        auto id = branch_root->get_id();
-        ThreadPoolType::add_thread_worker(std::make_shared<AsyncPipelineBranch<TData>>(branch_root));
+        STEP_ASSERT(branch_root, "Can't create branch: empty root");
+        const auto index = BasePipeline<TData>::m_plan.index_of(branch_root->get_id());
+        STEP_ASSERT(index == m_workers.size(), "AsyncPipeline: branch {} is created out of plan order",
+                    branch_root->get_id());
 
-        auto& branch = ThreadPoolType::m_threads[id];
+        auto branch = std::make_shared<AsyncPipelineBranch<TData>>(branch_root);
+        ThreadPoolType::add_thread_worker(branch);
         branch->register_observer(this);
-        m_branches_data[id] = {nullptr, BranchStatus::Finished};
+        branch->set_profiler(BasePipeline<TData>::m_profiler);
+
+        m_workers.push_back(std::move(branch));
+        m_branches_data.emplace_back();
+
+        if (index == BasePipeline<TData>::m_plan.get_root_index())
+        {
+            const auto& settings = BasePipeline<TData>::m_settings;
+            m_input.configure(settings.input_policy, settings.input_queue_size);
+            if (settings.load_control)
+                m_load_controller = std::make_unique<LoadController>(*settings.load_control, settings.name);
+        }
     }
 
     virtual void add_node_to_branch(const PipelineIdType& branch_id, const PipelineNodePtr<TData>& node) override
     {
         STEP_ASSERT(node, "Can't add node to branch {}: empty node", branch_id);
-        STEP_ASSERT(ThreadPoolType::m_threads.contains(branch_id), "AsyncPipeline doesn't have branch {}", branch_id);
-
-        auto branch = std::dynamic_pointer_cast<PipelineBranch<TData>>(ThreadPoolType::m_threads[branch_id]);
-        branch->add_node(node);
+        m_workers[BasePipeline<TData>::m_plan.index_of(branch_id)]->add_node(node);
     }
 
     // IThreadPoolWorkerEventObserver
 private:
     void on_finished(const PipelineIdType& id, const ThreadPoolResultDataType& data) override
     {
-        STEP_LOG(L_INFO, "on_finished branch {}", id);
+        STEP_LOG(L_TRACE, "on_finished branch {}", id);
         if (ThreadPoolType::need_stop())
         {
             STEP_LOG(L_INFO, "Skip on_finished branch {} due stopping", id);
             return;
         }
 
-        const auto branch_last_id =
-            std::dynamic_pointer_cast<PipelineBranch<TData>>(ThreadPoolType::m_threads[id])->get_last_id();
-
-        const auto& children_ids = BasePipeline<TData>::get_node(branch_last_id)->get_children_ids();
+        const auto& plan = BasePipeline<TData>::m_plan;
+        const auto& profiler = BasePipeline<TData>::m_profiler;
+        const auto index = plan.index_of(id);
 
         std::scoped_lock lock(m_branches_data_guard);
-        m_branches_data[id] = {nullptr, BranchStatus::Finished};
-        for (const auto& child_id : children_ids)
+        m_branches_data[index] = {nullptr, BranchStatus::Finished};
+        for (const auto child_index : plan.get_children(index))
         {
-            auto& branch_data = m_branches_data[child_id];
+            auto& branch_data = m_branches_data[child_index];
             if (branch_data.status == BranchStatus::Finished)
-                branch_data = {clone_pipeline_data(data), BranchStatus::Ready};
+                branch_data = {clone_pipeline_data(data), BranchStatus::Ready, profiler->now()};
+            else
+                profiler->record_drop(m_workers[child_index]->get_stats());
         }
 
         m_output_branches_data[id] = clone_pipeline_data(data);
@@ -264,10 +331,22 @@ private:
     {
         TProcessData data_to_process{nullptr};
         BranchStatus status{BranchStatus::Finished};
+        PipelineProfiler::Clock::time_point ready_time{};  // момент перехода в Ready, для учета ожидания
     };
+    struct InputData
+    {
+        PipelineDataPtr<TData> data;
+        PipelineProfiler::Clock::time_point push_time;
+    };
+    // Входная очередь пайплайна, ожидание в ней учитывается как ожидание входной ветви
+    threading::DeliveryQueue<InputData> m_input;
+    std::unique_ptr<LoadController> m_load_controller;
+    uint64_t m_load_frame_counter{0};
+
     mutable std::mutex m_branches_data_guard;
-    // Здесь входные данные для каждой ветви пайплайна
-    robin_hood::unordered_map<PipelineIdType, BranchProcessData<PipelineDataPtr<TData>>> m_branches_data;
+    // Ветви и их входные данные, индексируются индексом ветви в плане исполнения
+    std::vector<std::shared_ptr<AsyncPipelineBranch<TData>>> m_workers;
+    std::vector<BranchProcessData<PipelineDataPtr<TData>>> m_branches_data;
 
     /*
         Здесь выходные данные каждой ветви пайплайна.
@@ -0,0 +1,167 @@
+#include "load_controller.hpp"
+
+#include <core/base/json/json_utils.hpp>
+#include <core/base/types/config_fields.hpp>
+#include <core/exception/assert.hpp>
+#include <core/log/log.hpp>
+
+#include <algorithm>
+
+namespace {
+
+struct DefaultLevel
+{
+    double resize_scale;
+    size_t detect_interval;
+    bool skip_recognition;
+};
+
+/* clang-format off */
+constexpr DefaultLevel g_default_levels[] = {
+    { 1.0   , 1 , false },
+    { 0.75  , 1 , false },
+    { 0.75  , 2 , true  },
+    { 0.5   , 3 , true  },
+};
+/* clang-format on */
+
+}  // namespace
+
+namespace step::proc {
+
+void LoadLevel::deserialize(const ObjectPtrJSON& container)
+{
+    resize_scale = json::get<double>(container, CFG_FLD::RESIZE_SCALE, 1.0);
+    STEP_ASSERT(resize_scale > 0.0 && resize_scale <= 1.0, "Invalid load level resize scale: {}", resize_scale);
+    detect_interval = std::max<size_t>(json::get<size_t>(container, CFG_FLD::DETECT_INTERVAL, 1), 1);
+    skip_recognition = json::get<bool>(container, CFG_FLD::SKIP_RECOGNITION, false);
+}
+
+LoadControlSettings::LoadControlSettings()
+{
+    for (const auto& default_level : g_default_levels)
+    {
+        auto& level = levels.emplace_back();
+        level.resize_scale = default_level.resize_scale;
+        level.detect_interval = default_level.detect_interval;
+        level.skip_recognition = default_level.skip_recognition;
+    }
+}
+
+void LoadControlSettings::deserialize(const ObjectPtrJSON& container)
+{
+    sample_interval = Milliseconds(json::get<size_t>(container, CFG_FLD::SAMPLE_INTERVAL, 500));
+    latency_target = Milliseconds(json::get<size_t>(container, CFG_FLD::LATENCY_TARGET, 100));
+    queue_target = json::get<double>(container, CFG_FLD::QUEUE_TARGET, 0.75);
+    recover_ratio = json::get<double>(container, CFG_FLD::RECOVER_RATIO, 0.5);
+    degrade_samples = std::max<size_t>(json::get<size_t>(container, CFG_FLD::DEGRADE_SAMPLES, 2), 1);
+    recover_samples = std::max<size_t>(json::get<size_t>(container, CFG_FLD::RECOVER_SAMPLES, 6), 1);
+    low_priority = json::get<double>(container, CFG_FLD::LOW_PRIORITY, 1.0);
+    STEP_ASSERT(sample_interval.count() > 0 && latency_target.count() > 0, "Invalid load control intervals");
+    STEP_ASSERT(recover_ratio > 0.0 && recover_ratio < 1.0, "Invalid load control recover ratio: {}", recover_ratio);
+
+    if (auto levels_json = json::opt_array(container, CFG_FLD::LOAD_LEVELS))
+    {
+        levels.clear();
+        json::for_each_in_array<ObjectPtrJSON>(levels_json, [this](const ObjectPtrJSON& level_cfg) {
+            levels.emplace_back().deserialize(level_cfg);
+        });
+    }
+    STEP_ASSERT(!levels.empty(), "Load control: empty levels");
+}
+
+LoadController::LoadController(const LoadControlSettings& settings, const std::string& name)
+    : m_settings(settings), m_name(name)
+{
+    STEP_ASSERT(!m_settings.levels.empty(), "Load control {}: empty levels", m_name);
+}
+
+LoadSample LoadController::make_sample(const std::vector<PipelineProfilerPtr>& profilers, double queue_fill,
+                                       uint64_t dropped_total, Clock::time_point now)
+{
+    m_last_sample = now;
+
+    std::unordered_map<std::string, StageTotals> totals;
+    for (const auto& profiler : profilers)
+    {
+        if (!profiler)
+            continue;
+
+        for (const auto* stats : profiler->get_all_branch_stats())
+        {
+            auto& stage = totals[stats->id];
+            stage.count += stats->execution.count();
+            stage.time += stats->execution.total() + stats->queue_wait.total();
+            dropped_total += stats->dropped.load(std::memory_order_relaxed);
+        }
+    }
+
+    LoadSample sample;
+    sample.queue_fill = queue_fill;
+    sample.dropped = dropped_total - std::min(dropped_total, m_dropped_total);
+    m_dropped_total = dropped_total;
+
+    for (const auto& [id, stage] : totals)
+    {
+        const auto& prev = m_stage_totals[id];
+        if (stage.count <= prev.count)
+            continue;
+
+        const auto latency = (stage.time - prev.time) / static_cast<Microseconds::rep>(stage.count - prev.count);
+        if (latency > sample.stage_latency)
+        {
+            sample.stage_latency = latency;
+            sample.stage = id;
+        }
+    }
+    m_stage_totals = std::move(totals);
+
+    return sample;
+}
+
+bool LoadController::update(const LoadSample& sample)
+{
+    const auto latency_target = std::chrono::duration_cast<Microseconds>(m_settings.latency_target);
+    const bool overloaded =
+        sample.stage_latency > latency_target || sample.queue_fill > m_settings.queue_target || sample.dropped > 0;
+    const bool relaxed = sample.stage_latency.count() < latency_target.count() * m_settings.recover_ratio &&
+                         sample.queue_fill <= m_settings.queue_target * m_settings.recover_ratio && sample.dropped == 0;
+
+    // Между порогами ступень держится, счетчики сбрасываются - колебаний на границе нет
+    m_overload_samples = overloaded ? m_overload_samples + 1 : 0;
+    m_recover_samples = relaxed ? m_recover_samples + 1 : 0;
+
+    const auto prev_level = m_level;
+    if (m_overload_samples >= m_settings.degrade_samples && m_level + 1 < m_settings.levels.size())
+        ++m_level;
+    else if (m_recover_samples >= m_settings.recover_samples && m_level > 0)
+        --m_level;
+
+    if (m_level == prev_level)
+        return false;
+
+    m_overload_samples = 0;
+    m_recover_samples = 0;
+
+    const auto& level = m_settings.levels[m_level];
+    STEP_LOG(m_level > prev_level ? L_WARN : L_INFO,
+             "Load control {}: level {} -> {} (resize x{}, detect every {}, skip recognition {}); slowest stage {} "
+             "{} us, queue fill {:.2f}, dropped {}",
+             m_name, prev_level, m_level, level.resize_scale, level.detect_interval, level.skip_recognition,
+             sample.stage, sample.stage_latency.count(), sample.queue_fill, sample.dropped);
+    return true;
+}
+
+LoadShedding LoadController::get_shedding(double priority, uint64_t& frame_counter) const
+{
+    const auto& level = m_settings.levels[m_level];
+
+    LoadShedding shedding;
+    shedding.level = m_level;
+    shedding.resize_scale = level.resize_scale;
+    shedding.skip_detection = frame_counter++ % level.detect_interval != 0;
+    shedding.skip_recognition = level.skip_recognition && priority < m_settings.low_priority;
+    return shedding;
+}
+
+}  // namespace step::proc
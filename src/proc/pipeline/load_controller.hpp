@@ -0,0 +1,123 @@
+#pragma once
+
+#include "pipeline_profiler.hpp"
+
+#include <core/base/interfaces/serializable.hpp>
+#include <core/base/types/time.hpp>
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace step::proc {
+
+/*! @brief Ступень деградации качества.
+*/
+struct LoadLevel : public ISerializable
+{
+    double resize_scale{1.0};      ///< множитель размера кадра ResizerNode перед детекторами
+    size_t detect_interval{1};     ///< детекция на каждом N-м кадре потока, между ними - прошлый результат
+    bool skip_recognition{false};  ///< распознавание пропускается для потоков низкого приоритета
+
+    void deserialize(const ObjectPtrJSON& container) override;
+};
+
+/*! @brief Настройки регулятора нагрузки, секция load_control.
+    @details Раз в sample_interval регулятор смотрит задержку этапов (выполнение + ожидание ветви) за прошедший
+    интервал, заполненность входных очередей и потерянные кадры. Перегрузка - задержка выше latency_target,
+    заполненность выше queue_target или потери; degrade_samples таких замеров подряд повышают ступень.
+    Ступень понижается после recover_samples замеров подряд без потерь, с задержкой и заполненностью ниже
+    recover_ratio от целевых. levels[0] - полное качество, без levels используется ступенчатый набор
+    по умолчанию.
+*/
+struct LoadControlSettings : public ISerializable
+{
+    Milliseconds sample_interval{500};
+    Milliseconds latency_target{100};
+    double queue_target{0.75};
+    double recover_ratio{0.5};
+    size_t degrade_samples{2};
+    size_t recover_samples{6};
+    double low_priority{1.0};  ///< потоки с приоритетом ниже считаются низкоприоритетными
+    std::vector<LoadLevel> levels;
+
+    LoadControlSettings();
+
+    void deserialize(const ObjectPtrJSON& container) override;
+};
+
+/*! @brief Замер нагрузки за интервал.
+*/
+struct LoadSample
+{
+    std::string stage;          ///< самый медленный этап (ветвь пайплайна)
+    Microseconds stage_latency{0};
+    double queue_fill{0.0};     ///< 0..1
+    uint64_t dropped{0};        ///< потеряно кадров за интервал
+};
+
+/*! @brief Решение регулятора для кадра, передается узлам вложением CFG_FLD::LOAD_SHEDDING.
+*/
+struct LoadShedding
+{
+    size_t level{0};
+    double resize_scale{1.0};
+    bool skip_detection{false};
+    bool skip_recognition{false};
+};
+
+/*! @brief Регулятор нагрузки: намеренно снижает качество обработки при перегрузке и возвращает его,
+    когда нагрузка спадает.
+    @details Предсказуемая деградация (меньший вход детектора, детекция через кадр, без распознавания
+    у второстепенных потоков) вместо растущей задержки и случайных потерь кадров. Смена ступени
+    пишется в лог. Не потокобезопасен, вызывающий сериализует обращения.
+*/
+class LoadController
+{
+public:
+    using Clock = std::chrono::steady_clock;
+
+    LoadController(const LoadControlSettings& settings, const std::string& name);
+
+    bool need_sample(Clock::time_point now) const noexcept { return now - m_last_sample >= m_settings.sample_interval; }
+
+    /*! @brief Замер по разности со счетчиками профилировщиков прошлого замера.
+        @details Ветви с одинаковым id в разных профилировщиках (пайплайны рабочих потоков) считаются одним этапом.
+        dropped_total - счетчик потерь вне профилировщиков (входные очереди) с начала работы.
+    */
+    LoadSample make_sample(const std::vector<PipelineProfilerPtr>& profilers, double queue_fill,
+                           uint64_t dropped_total, Clock::time_point now);
+
+    /*! @brief Обновляет ступень по замеру, true - ступень изменилась.
+    */
+    bool update(const LoadSample& sample);
+
+    size_t get_level() const noexcept { return m_level; }
+    const LoadControlSettings& get_settings() const noexcept { return m_settings; }
+
+    /*! @brief Решение для очередного кадра потока с приоритетом priority.
+        @details frame_counter - счетчик кадров потока, по нему прореживается детекция.
+    */
+    LoadShedding get_shedding(double priority, uint64_t& frame_counter) const;
+
+private:
+    struct StageTotals
+    {
+        uint64_t count{0};
+        Microseconds time{0};
+    };
+
+private:
+    LoadControlSettings m_settings;
+    std::string m_name;
+
+    size_t m_level{0};
+    size_t m_overload_samples{0};
+    size_t m_recover_samples{0};
+
+    Clock::time_point m_last_sample{};
+    std::unordered_map<std::string, StageTotals> m_stage_totals;
+    uint64_t m_dropped_total{0};
+};
+
+}  // namespace step::proc
@@ -4,6 +4,8 @@
 
 #include <proc/pipeline/pipeline_task.hpp>
 
+#include <proc/detect/motion_gate.hpp>
+
 #include <proc/settings/settings_face_detector.hpp>
 
 namespace step::proc {
@@ -23,8 +25,11 @@ public:
         return m_face_detector_settings;
     }
 
+    MotionGating get_motion_gating() const noexcept { return m_motion_gating; }
+
 private:
     std::shared_ptr<task::BaseSettings> m_face_detector_settings;
+    MotionGating m_motion_gating{MotionGating::None};
 };
 
 std::shared_ptr<task::BaseSettings> create_face_detection_node_settings(const ObjectPtrJSON&);
@@ -4,8 +4,10 @@
 #include <core/task/settings_factory.hpp>
 #include <core/task/task_factory.hpp>
 
+#include <proc/detect/face_quality.hpp>
 #include <proc/interfaces/detector_interface.hpp>
 #include <proc/interfaces/face_engine_user.hpp>
+#include <proc/pipeline/load_controller.hpp>
 
 #include <proc/face_engine/holder/person_holder.hpp>
 
@@ -68,6 +70,11 @@ public:
         if (m_typed_settings.get_skip_flag())
             return;
 
+        // Без детекции на кадре повторены лица прошлой детекции, они уже распознаны
+        const auto shedding = pipeline_data->storage.get_attachment<LoadShedding>(CFG_FLD::LOAD_SHEDDING);
+        if (shedding && (shedding->skip_recognition || shedding->skip_detection))
+            return;
+
         const auto& face_detection_result_opt =
             pipeline_data->storage.get_attachment<DetectionResult>(CFG_FLD::FACE_DETECTION_RESULT);
         if (!face_detection_result_opt.has_value())
@@ -78,9 +85,21 @@ public:
         if (!faces_opt.has_value())
             return;
 
-        Faces matched_faces;
-        for (const auto& face : faces_opt.value())
+        const auto qualities = pipeline_data->storage.get_attachment<FaceQualities>(CFG_FLD::FACE_QUALITY);
+        const auto& faces = faces_opt.value();
+        for (size_t i = 0; i < faces.size(); ++i)
         {
+            const auto& face = faces[i];
+            const auto track = get_track_identity(qualities, i);
+
+            // Лица, не отобранные по качеству, не распознавались: статус берется у их трека
+            if (!need_recognition(qualities, i))
+            {
+                if (track)
+                    face->set_match_status(track->get_match_status());
+                continue;
+            }
+
             for (const auto& person : m_persons)
             {
                 const auto status = person.compare(face);
@@ -90,6 +109,9 @@ public:
                     break;
                 }
             }
+
+            if (track)
+                track->set_match_status(face->get_match_status());
         }
     }
 
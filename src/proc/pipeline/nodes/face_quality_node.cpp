@@ -0,0 +1,73 @@
+#include "face_quality_node.hpp"
+
+#include <core/base/types/config_fields.hpp>
+
+#include <proc/detect/face_quality.hpp>
+#include <proc/interfaces/detector_interface.hpp>
+#include <proc/pipeline/load_controller.hpp>
+
+namespace step::proc {
+
+const std::string FaceQualityNodeSettings::SETTINGS_ID = "FaceQualityNodeSettings";
+
+std::shared_ptr<task::BaseSettings> create_face_quality_node_settings(const ObjectPtrJSON& cfg)
+{
+    return std::make_shared<FaceQualityNodeSettings>(cfg);
+}
+
+void FaceQualityNodeSettings::deserialize(const ObjectPtrJSON& container)
+{
+    m_settings.deserialize(json::get_object(container, CFG_FLD::SETTINGS));
+}
+
+}  // namespace step::proc
+
+namespace step::proc {
+
+/*! @brief Оценка качества лиц между детекцией и распознаванием.
+    @details Публикует FaceQualities под CFG_FLD::FACE_QUALITY. Узлы распознавания и сравнения после этого
+    узла обрабатывают только лица с FaceQuality::selected: мелкие, размытые и повернутые лица дают
+    бесполезные шаблоны и ложные совпадения. Остальным лицам они переносят шаблон и статус сравнения
+    последнего отобранного лица трека (FaceQuality::track).
+*/
+class FaceQualityPipelineNode : public PipelineNodeTask<video::Frame, FaceQualityNodeSettings>
+{
+public:
+    FaceQualityPipelineNode(const std::shared_ptr<task::BaseSettings>& settings)
+    {
+        set_settings(*settings);
+        m_filter = std::make_unique<FaceQualityFilter>(m_typed_settings.get_face_quality_settings());
+    }
+
+    void process(PipelineDataPtr<video::Frame> pipeline_data) override
+    {
+        // Лица, повторенные с прошлой детекции, уже прошли трекинг и отбор
+        const auto shedding = pipeline_data->storage.get_attachment<LoadShedding>(CFG_FLD::LOAD_SHEDDING);
+        if (shedding && shedding->skip_detection)
+            return;
+
+        const auto& face_detection_result_opt =
+            pipeline_data->storage.get_attachment<DetectionResult>(CFG_FLD::FACE_DETECTION_RESULT);
+        if (!face_detection_result_opt.has_value())
+            return;
+
+        const auto& faces_opt = face_detection_result_opt.value().data().get_attachment<Faces>(CFG_FLD::FACES);
+        if (!faces_opt.has_value())
+            return;
+
+        auto qualities = m_filter->process(pipeline_data->data, faces_opt.value());
+
+        pipeline_data->storage.set_attachment(CFG_FLD::FACE_QUALITY,
+                                              std::make_any<FaceQualities>(std::move(qualities)));
+    }
+
+private:
+    std::unique_ptr<FaceQualityFilter> m_filter;
+};
+
+std::unique_ptr<task::IAbstractTask> create_face_quality_node(const std::shared_ptr<task::BaseSettings>& settings)
+{
+    return std::make_unique<FaceQualityPipelineNode>(settings);
+}
+
+}  // namespace step::proc
@@ -0,0 +1,31 @@
+#pragma once
+
+#include <core/log/log.hpp>
+
+#include <proc/pipeline/pipeline_task.hpp>
+
+#include <proc/settings/settings_face_quality.hpp>
+
+namespace step::proc {
+
+class FaceQualityNodeSettings : public task::BaseSettings
+{
+public:
+    TASK_SETTINGS(FaceQualityNodeSettings)
+
+    FaceQualityNodeSettings() = default;
+
+    bool operator==(const FaceQualityNodeSettings& rhs) const noexcept { return m_settings == rhs.m_settings; }
+    bool operator!=(const FaceQualityNodeSettings& rhs) const noexcept { return !(*this == rhs); }
+
+    const SettingsFaceQuality& get_face_quality_settings() const noexcept { return m_settings; }
+
+private:
+    SettingsFaceQuality m_settings;
+};
+
+std::shared_ptr<task::BaseSettings> create_face_quality_node_settings(const ObjectPtrJSON&);
+
+std::unique_ptr<task::IAbstractTask> create_face_quality_node(const std::shared_ptr<task::BaseSettings>& settings);
+
+}  // namespace step::proc
@@ -4,8 +4,10 @@
 #include <core/task/settings_factory.hpp>
 #include <core/task/task_factory.hpp>
 
+#include <proc/detect/face_quality.hpp>
 #include <proc/interfaces/detector_interface.hpp>
 #include <proc/interfaces/face_engine_user.hpp>
+#include <proc/pipeline/load_controller.hpp>
 
 namespace step::proc {
 
@@ -52,6 +54,11 @@ public:
         if (m_typed_settings.get_skip_flag())
             return;
 
+        // Без детекции на кадре повторены лица прошлой детекции, они уже распознаны
+        const auto shedding = pipeline_data->storage.get_attachment<LoadShedding>(CFG_FLD::LOAD_SHEDDING);
+        if (shedding && (shedding->skip_recognition || shedding->skip_detection))
+            return;
+
         const auto& face_detection_result_opt =
             pipeline_data->storage.get_attachment<DetectionResult>(CFG_FLD::FACE_DETECTION_RESULT);
         if (!face_detection_result_opt.has_value())
@@ -62,8 +69,24 @@ public:
         if (!faces_opt.has_value())
             return;
 
-        for (const auto& face : faces_opt.value())
-            get_face_engine(true)->recognize(face);
+        // После FaceQualityPipelineNode распознаются только отобранные лица,
+        // остальные получают шаблон последнего отобранного лица своего трека
+        const auto qualities = pipeline_data->storage.get_attachment<FaceQualities>(CFG_FLD::FACE_QUALITY);
+        const auto& faces = faces_opt.value();
+        for (size_t i = 0; i < faces.size(); ++i)
+        {
+            const auto track = get_track_identity(qualities, i);
+            if (need_recognition(qualities, i))
+            {
+                get_face_engine(true)->recognize(faces[i]);
+                if (track && !faces[i]->get_recognizer_data().empty())
+                    track->set_recognizer_data(faces[i]->get_recognizer_data());
+            }
+            else if (track)
+            {
+                faces[i]->set_recognizer_data(track->get_recognizer_data());
+            }
+        }
     }
 };
 
@@ -0,0 +1,55 @@
+#include "motion_gate_node.hpp"
+
+#include <core/base/types/config_fields.hpp>
+
+#include <proc/detect/motion_gate.hpp>
+
+namespace step::proc {
+
+const std::string MotionGateNodeSettings::SETTINGS_ID = "MotionGateNodeSettings";
+
+std::shared_ptr<task::BaseSettings> create_motion_gate_node_settings(const ObjectPtrJSON& cfg)
+{
+    return std::make_shared<MotionGateNodeSettings>(cfg);
+}
+
+void MotionGateNodeSettings::deserialize(const ObjectPtrJSON& container)
+{
+    m_settings.deserialize(json::get_object(container, CFG_FLD::SETTINGS));
+}
+
+}  // namespace step::proc
+
+namespace step::proc {
+
+/*! @brief Проверка движения перед детекторами.
+    @details Публикует MotionResult под CFG_FLD::MOTION_RESULT. Узлы детекции после этого узла пропускают
+    кадры без движения или ограничиваются областями движения согласно своему CFG_FLD::MOTION_GATING.
+*/
+class MotionGatePipelineNode : public PipelineNodeTask<video::Frame, MotionGateNodeSettings>
+{
+public:
+    MotionGatePipelineNode(const std::shared_ptr<task::BaseSettings>& settings)
+    {
+        set_settings(*settings);
+        m_motion_gate = std::make_unique<MotionGate>(m_typed_settings.get_motion_gate_settings());
+    }
+
+    void process(PipelineDataPtr<video::Frame> pipeline_data) override
+    {
+        auto motion_result = m_motion_gate->process(pipeline_data->data);
+
+        pipeline_data->storage.set_attachment(CFG_FLD::MOTION_RESULT,
+                                              std::make_any<MotionResult>(std::move(motion_result)));
+    }
+
+private:
+    std::unique_ptr<MotionGate> m_motion_gate;
+};
+
+std::unique_ptr<task::IAbstractTask> create_motion_gate_node(const std::shared_ptr<task::BaseSettings>& settings)
+{
+    return std::make_unique<MotionGatePipelineNode>(settings);
+}
+
+}  // namespace step::proc
@@ -0,0 +1,31 @@
+#pragma once
+
+#include <core/log/log.hpp>
+
+#include <proc/pipeline/pipeline_task.hpp>
+
+#include <proc/settings/settings_motion_gate.hpp>
+
+namespace step::proc {
+
+class MotionGateNodeSettings : public task::BaseSettings
+{
+public:
+    TASK_SETTINGS(MotionGateNodeSettings)
+
+    MotionGateNodeSettings() = default;
+
+    bool operator==(const MotionGateNodeSettings& rhs) const noexcept { return m_settings == rhs.m_settings; }
+    bool operator!=(const MotionGateNodeSettings& rhs) const noexcept { return !(*this == rhs); }
+
+    const SettingsMotionGate& get_motion_gate_settings() const noexcept { return m_settings; }
+
+private:
+    SettingsMotionGate m_settings;
+};
+
+std::shared_ptr<task::BaseSettings> create_motion_gate_node_settings(const ObjectPtrJSON&);
+
+std::unique_ptr<task::IAbstractTask> create_motion_gate_node(const std::shared_ptr<task::BaseSettings>& settings);
+
+}  // namespace step::proc
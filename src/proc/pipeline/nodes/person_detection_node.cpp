@@ -1,10 +1,14 @@
 #include "person_detection_node.hpp"
 
 #include <core/base/types/config_fields.hpp>
+#include <core/base/utils/string_utils.hpp>
 #include <core/task/settings_factory.hpp>
 #include <core/task/task_factory.hpp>
 
 #include <proc/interfaces/detector_interface.hpp>
+#include <proc/pipeline/load_controller.hpp>
+
+#include <optional>
 
 namespace step::proc {
 
@@ -19,6 +23,9 @@ void PersonDetectionNodeSettings::deserialize(const ObjectPtrJSON& container)
 {
     auto settings_json = json::get_object(container, CFG_FLD::SETTINGS);
     m_person_detector_settings = CREATE_SETTINGS(settings_json);
+
+    if (auto motion_gating = json::get_opt<std::string>(container, CFG_FLD::MOTION_GATING))
+        step::utils::from_string(m_motion_gating, *motion_gating);
 }
 
 }  // namespace step::proc
@@ -39,14 +46,31 @@ public:
 
     void process(PipelineDataPtr<video::Frame> pipeline_data) override
     {
-        auto detect_result = m_person_detector->process(pipeline_data->data);
+        // На пропущенном кадре повторяется последний результат, чтобы рамки не мигали
+        const auto shedding = pipeline_data->storage.get_attachment<LoadShedding>(CFG_FLD::LOAD_SHEDDING);
+        if (shedding && shedding->skip_detection)
+        {
+            if (m_last_result && m_last_frame_size == pipeline_data->data.size)
+                pipeline_data->storage.set_attachment(CFG_FLD::PERSON_DETECTION_RESULT,
+                                                      std::make_any<DetectionResult>(*m_last_result));
+            return;
+        }
+
+        auto detect_result =
+            detect_gated(*m_person_detector, pipeline_data->data,
+                         pipeline_data->storage.get_attachment<MotionResult>(CFG_FLD::MOTION_RESULT),
+                         m_typed_settings.get_motion_gating());
 
+        m_last_result = detect_result;
+        m_last_frame_size = pipeline_data->data.size;
         pipeline_data->storage.set_attachment(CFG_FLD::PERSON_DETECTION_RESULT,
                                               std::make_any<decltype(detect_result)>(detect_result));
     }
 
 private:
     std::unique_ptr<IDetector> m_person_detector;
+    std::optional<DetectionResult> m_last_result;  ///< рамки в координатах кадра размера m_last_frame_size
+    video::FrameSize m_last_frame_size;
 };
 
 std::unique_ptr<task::IAbstractTask> create_person_detection_node(const std::shared_ptr<task::BaseSettings>& settings)
@@ -5,6 +5,7 @@
 #include <core/task/task_factory.hpp>
 
 #include <proc/interfaces/effect_interface.hpp>
+#include <proc/pipeline/load_controller.hpp>
 
 namespace step::proc {
 
@@ -39,11 +40,33 @@ public:
 
     void process(PipelineDataPtr<video::Frame> pipeline_data) override
     {
+        const auto shedding = pipeline_data->storage.get_attachment<LoadShedding>(CFG_FLD::LOAD_SHEDDING);
+        apply_resize_scale(shedding ? shedding->resize_scale : 1.0);
+
         pipeline_data->data = std::move(m_resizer->process(pipeline_data->data));
     }
 
+private:
+    // Регулятор нагрузки уменьшает целевой размер SettingsResizer, другие эффекты не трогаются
+    void apply_resize_scale(double scale)
+    {
+        if (scale == m_resize_scale)
+            return;
+
+        const auto* base_settings =
+            dynamic_cast<const SettingsResizer*>(m_typed_settings.get_resizer_settings_base().get());
+        if (!base_settings)
+            return;
+
+        auto settings = *base_settings;
+        settings.set_frame_size(base_settings->get_frame_size() * scale);
+        m_resizer->set_settings(settings);
+        m_resize_scale = scale;
+    }
+
 private:
     std::unique_ptr<IEffect> m_resizer;
+    double m_resize_scale{1.0};
 };
 
 std::unique_ptr<task::IAbstractTask> create_resizer_node(const std::shared_ptr<task::BaseSettings>& settings)
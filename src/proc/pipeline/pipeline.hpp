@@ -1,6 +1,7 @@
 #pragma once
 
 #include "pipeline_branch.hpp"
+#include "pipeline_execution_plan.hpp"
 #include "pipeline_settings.hpp"
 
 #include <core/graph/graph.hpp>
@@ -15,7 +16,12 @@ class BasePipeline : public graph::BaseGraph, public ISerializable
 public:
     BasePipeline() {}
 
-    virtual ~BasePipeline() { STEP_LOG(L_TRACE, "BasePipeline {} destruction", m_settings.name); }
+    virtual ~BasePipeline()
+    {
+        STEP_LOG(L_TRACE, "BasePipeline {} destruction", m_settings.name);
+        if (m_profiler)
+            m_profiler->log_report();
+    }
 
     void initialize(const ObjectPtrJSON& pipeline_json)
     {
@@ -34,9 +40,16 @@ public:
 
     PipelineSyncPolicy get_sync_policy() const { return m_settings.sync_policy; }
 
+    /*! @brief Счетчики и гистограммы задержек по узлам и ветвям, экспорт trace-событий.
+    */
+    const PipelineProfilerPtr& get_profiler() const noexcept { return m_profiler; }
+
+    const PipelineExecutionPlan& get_execution_plan() const noexcept { return m_plan; }
+
     virtual void process(const PipelineDataPtr<TData>& data) { STEP_UNDEFINED("BasePipeline process is undefined!"); }
 
 protected:
+    // Ветви создаются в порядке индексов плана исполнения
     virtual void create_branch(const PipelineNodePtr<TData>& branch_root) = 0;
     virtual void add_node_to_branch(const PipelineIdType& branch_id, const PipelineNodePtr<TData>& node) = 0;
 
@@ -52,9 +65,12 @@ protected:
         const auto& pipeline_name = m_settings.name;
         STEP_LOG(L_INFO, "Pipeline name: {}", pipeline_name);
 
+        m_profiler = std::make_shared<PipelineProfiler>(pipeline_name);
+
         auto nodes_collection = json::get_array(pipeline_json, CFG_FLD::NODES);
         json::for_each_in_array<ObjectPtrJSON>(nodes_collection, [this](const ObjectPtrJSON& node_cfg) {
             auto node = std::make_shared<PipelineNode<TData>>(node_cfg);
+            node->set_profiler(m_profiler);
             add_node(node->get_id(), node);
         });
 
@@ -82,36 +98,42 @@ protected:
             for (const auto& child_id : get_node(parent_id)->get_children_ids())
                 branch_ids.insert(child_id);
 
+        std::vector<std::vector<PipelineNodePtr<TData>>> branches_nodes;
+        std::vector<PipelineExecutionPlan::BranchBounds> branches_bounds;
         for (const auto& id : branch_ids)
         {
-            auto list_front_id = id;
+            auto& nodes = branches_nodes.emplace_back();
             auto processed_id = id;
-            auto node = get_node(processed_id);
-
-            auto pipeline_node = std::dynamic_pointer_cast<PipelineNode<TData>>(node);
-            create_branch(pipeline_node);
-
-            if (node->get_children_ids().empty())
-                continue;
-
-            processed_id = node->get_children_ids().front();
-
-            while (!branch_ids.contains(processed_id))
+            while (true)
             {
                 auto node = get_node(processed_id);
-                add_node_to_branch(list_front_id, std::dynamic_pointer_cast<PipelineNode<TData>>(node));
+                nodes.push_back(std::dynamic_pointer_cast<PipelineNode<TData>>(node));
 
                 if (node->get_children_ids().empty())
                     break;
 
                 processed_id = node->get_children_ids().front();
+                if (branch_ids.contains(processed_id))
+                    break;
             }
+            branches_bounds.push_back({id, nodes.back()->get_id()});
+        }
+
+        const auto order = m_plan.compile(*this, branches_bounds, get_root_id());
+        for (const auto input_index : order)
+        {
+            const auto& nodes = branches_nodes[input_index];
+            create_branch(nodes.front());
+            for (size_t i = 1; i < nodes.size(); ++i)
+                add_node_to_branch(nodes.front()->get_id(), nodes[i]);
         }
     }
 
 protected:
     PipelineSettings m_settings;
     PipelineNodePtr<TData> m_root;
+    PipelineProfilerPtr m_profiler{nullptr};
+    PipelineExecutionPlan m_plan;
 };
 
 }  // namespace step::proc
\ No newline at end of file
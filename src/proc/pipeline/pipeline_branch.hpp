@@ -4,7 +4,7 @@
 
 #include <core/exception/assert.hpp>
 
-#include <list>
+#include <vector>
 
 namespace step::proc {
 
@@ -36,12 +36,40 @@ public:
 
     void process(const PipelineDataPtr<TData>& data)
     {
-        for (const auto& node : m_list)
-            node->process(data);
+        if (!m_profiler)
+        {
+            for (const auto& node : m_list)
+                node->process(data);
+            return;
+        }
+
+        const auto start = m_profiler->now();
+        try
+        {
+            for (const auto& node : m_list)
+                node->process(data);
+        }
+        catch (...)
+        {
+            m_profiler->record_exception(m_stats);
+            throw;
+        }
+        m_profiler->record_execution(m_stats, start, m_profiler->now());
+    }
+
+    void set_profiler(const PipelineProfilerPtr& profiler)
+    {
+        m_profiler = profiler;
+        m_stats = m_profiler ? m_profiler->register_branch(get_id()) : nullptr;
     }
 
+    PipelineNodeStats* get_stats() const noexcept { return m_stats; }
+
 private:
-    std::list<PipelineNodePtr<TData>> m_list;
+    std::vector<PipelineNodePtr<TData>> m_list;
+
+    PipelineProfilerPtr m_profiler{nullptr};
+    PipelineNodeStats* m_stats{nullptr};
 };
 
 }  // namespace step::proc
\ No newline at end of file
@@ -45,4 +45,14 @@ inline PipelineDataPtr<TData> clone_pipeline_data(const PipelineDataPtr<TData>&
     return std::make_shared<PipelineData<TData>>(clone_pipeline_data(*data_ptr));
 }
 
+/*! @brief Копия для ветви, которая выполняется параллельно с соседними.
+    @details Изменения вложений потом возвращаются в исходные данные через MetaStorage::merge_changes.
+*/
+template <typename TData>
+inline PipelineDataPtr<TData> fork_pipeline_data(const PipelineDataPtr<TData>& data_ptr)
+{
+    STEP_ASSERT(data_ptr, "Can't fork empty pipeline data!");
+    return std::make_shared<PipelineData<TData>>(data_ptr->data, data_ptr->storage.fork());
+}
+
 }  // namespace step::proc
\ No newline at end of file
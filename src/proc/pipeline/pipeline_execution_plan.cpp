@@ -0,0 +1,116 @@
+#include "pipeline_execution_plan.hpp"
+
+#include <core/exception/assert.hpp>
+#include <core/log/log.hpp>
+
+#include <deque>
+
+namespace step::proc {
+
+std::vector<size_t> PipelineExecutionPlan::compile(const graph::BaseGraph& graph,
+                                                   const std::vector<BranchBounds>& branches, const IdType& root_id)
+{
+    const auto count = branches.size();
+    STEP_ASSERT(count < INVALID_INDEX, "Too many pipeline branches: {}", count);
+
+    robin_hood::unordered_map<IdType, size_t> input_index;
+    for (size_t i = 0; i < count; ++i)
+    {
+        const auto [it, inserted] = input_index.emplace(branches[i].first_id, i);
+        STEP_ASSERT(inserted, "Execution plan: duplicated branch {}", branches[i].first_id);
+    }
+    STEP_ASSERT(input_index.contains(root_id), "Execution plan: no root branch {}", root_id);
+
+    // Связи между ветвями: потомки последнего узла ветви - это начала других ветвей
+    std::vector<std::vector<size_t>> input_children(count);
+    std::vector<uint32_t> input_dependencies(count, 0);
+    for (size_t i = 0; i < count; ++i)
+    {
+        for (const auto& child_id : graph.get_node(branches[i].last_id)->get_children_ids())
+        {
+            auto it = input_index.find(child_id);
+            STEP_ASSERT(it != input_index.end(), "Execution plan: node {} is not a branch start", child_id);
+            input_children[i].push_back(it->second);
+            ++input_dependencies[it->second];
+        }
+    }
+
+    STEP_ASSERT(input_dependencies[input_index[root_id]] == 0, "Execution plan: root branch {} has parents",
+                root_id);
+
+    // Алгоритм Кана, корень - первым
+    std::vector<size_t> order;
+    order.reserve(count);
+    {
+        auto remaining = input_dependencies;
+        std::deque<size_t> ready;
+        ready.push_back(input_index[root_id]);
+        for (size_t i = 0; i < count; ++i)
+            if (remaining[i] == 0 && branches[i].first_id != root_id)
+                ready.push_back(i);
+
+        while (!ready.empty())
+        {
+            const auto i = ready.front();
+            ready.pop_front();
+            order.push_back(i);
+            for (const auto child : input_children[i])
+                if (--remaining[child] == 0)
+                    ready.push_back(child);
+        }
+    }
+    STEP_ASSERT(order.size() == count, "Execution plan: pipeline graph has a cycle");
+
+    std::vector<IndexType> plan_index(count);
+    for (size_t i = 0; i < count; ++i)
+        plan_index[order[i]] = static_cast<IndexType>(i);
+
+    m_ids.clear();
+    m_children.clear();
+    m_children_offsets.assign(1, 0);
+    m_dependency_counts.clear();
+    m_parents.assign(count, INVALID_INDEX);
+    m_has_forks = false;
+    m_index_by_id.clear();
+    for (size_t i = 0; i < count; ++i)
+    {
+        const auto input = order[i];
+        m_ids.push_back(branches[input].first_id);
+        m_dependency_counts.push_back(input_dependencies[input]);
+        m_index_by_id[m_ids.back()] = static_cast<IndexType>(i);
+
+        for (const auto child : input_children[input])
+        {
+            m_children.push_back(plan_index[child]);
+            m_parents[plan_index[child]] = static_cast<IndexType>(i);
+        }
+        m_children_offsets.push_back(static_cast<IndexType>(m_children.size()));
+        m_has_forks = m_has_forks || input_children[input].size() > 1;
+    }
+
+    m_root_index = plan_index[input_index[root_id]];
+    m_reachable.assign(count, false);
+    m_reachable[m_root_index] = true;
+    for (IndexType i = 0; i < count; ++i)
+    {
+        if (!m_reachable[i])
+        {
+            STEP_LOG(L_WARN, "Execution plan: branch {} is unreachable from root {}", m_ids[i], root_id);
+            continue;
+        }
+        for (const auto child : get_children(i))
+            m_reachable[child] = true;
+    }
+
+    STEP_LOG(L_INFO, "Execution plan compiled: {} branches, {} links, root {}", count, m_children.size(), root_id);
+    return order;
+}
+
+PipelineExecutionPlan::IndexType PipelineExecutionPlan::index_of(const IdType& id) const
+{
+    auto it = m_index_by_id.find(id);
+    STEP_ASSERT(it != m_index_by_id.end(), "Execution plan has no branch {}", id);
+    return it->second;
+}
+
+}  // namespace step::proc
@@ -0,0 +1,84 @@
+#pragma once
+
+#include <core/graph/graph.hpp>
+
+#include <robin_hood.h>
+
+#include <cstdint>
+#include <span>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace step::proc {
+
+/*! @brief Плоский план исполнения пайплайна, компилируется из графа один раз после десериализации.
+    @details Ветви пронумерованы в топологическом порядке (родитель всегда раньше потомков), поэтому
+    исполнитель просто идет по индексам 0..size()-1. Потомки хранятся в CSR-массиве,
+    для каждой ветви известно число родителей (счетчик зависимостей).
+    Строковые id остаются только для отчетов и обратной связи с ThreadPool.
+*/
+class PipelineExecutionPlan
+{
+public:
+    using IdType = graph::BaseGraph::IdType;
+    using IndexType = uint32_t;
+    static constexpr IndexType INVALID_INDEX = static_cast<IndexType>(-1);
+
+    /*! @brief Описание ветви для компиляции: id первого и последнего узла.
+    */
+    struct BranchBounds
+    {
+        IdType first_id;
+        IdType last_id;
+    };
+
+public:
+    PipelineExecutionPlan() = default;
+
+    /*! @brief Компилирует план по графу и набору ветвей.
+        @return Перестановку: для каждого индекса плана - индекс ветви во входном векторе.
+    */
+    std::vector<size_t> compile(const graph::BaseGraph& graph, const std::vector<BranchBounds>& branches,
+                                const IdType& root_id);
+
+    size_t size() const noexcept { return m_ids.size(); }
+    bool empty() const noexcept { return m_ids.empty(); }
+
+    IndexType get_root_index() const noexcept { return m_root_index; }
+    IndexType index_of(const IdType& id) const;
+    const IdType& get_id(IndexType index) const { return m_ids[index]; }
+
+    std::span<const IndexType> get_children(IndexType index) const noexcept
+    {
+        return {m_children.data() + m_children_offsets[index], m_children.data() + m_children_offsets[index + 1]};
+    }
+
+    /*! @brief Родитель ветви (граф пайплайна строится с одним родителем у узла), INVALID_INDEX у корня.
+    */
+    IndexType get_parent(IndexType index) const noexcept { return m_parents[index]; }
+
+    const std::vector<uint32_t>& get_dependency_counts() const noexcept { return m_dependency_counts; }
+
+    /*! @brief Есть ли ветви с несколькими потомками, т.е. независимые соседние ветви.
+    */
+    bool has_forks() const noexcept { return m_has_forks; }
+
+    /*! @brief Ветвь достижима из корня, т.е. получает данные при обработке кадра.
+    */
+    bool is_reachable(IndexType index) const noexcept { return m_reachable[index]; }
+
+private:
+    std::vector<IdType> m_ids;
+    std::vector<IndexType> m_children_offsets;
+    std::vector<IndexType> m_children;
+    std::vector<uint32_t> m_dependency_counts;
+    std::vector<IndexType> m_parents;
+    std::vector<bool> m_reachable;
+    IndexType m_root_index{INVALID_INDEX};
+    bool m_has_forks{false};
+
+    robin_hood::unordered_map<IdType, IndexType> m_index_by_id;
+};
+
+}  // namespace step::proc
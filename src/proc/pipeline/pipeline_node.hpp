@@ -1,5 +1,6 @@
 #pragma once
 
+#include "pipeline_profiler.hpp"
 #include "pipeline_task.hpp"
 
 #include <core/log/log.hpp>
@@ -31,7 +32,29 @@ public:
     void process(const PipelineDataPtr<TData>& data)
     {
         STEP_LOG(L_TRACE, "Processing pipeline node {}", m_id);
-        m_task->process(data);
+        if (!m_profiler)
+        {
+            m_task->process(data);
+            return;
+        }
+
+        const auto start = m_profiler->now();
+        try
+        {
+            m_task->process(data);
+        }
+        catch (...)
+        {
+            m_profiler->record_exception(m_stats);
+            throw;
+        }
+        m_profiler->record_execution(m_stats, start, m_profiler->now());
+    }
+
+    void set_profiler(const PipelineProfilerPtr& profiler)
+    {
+        m_profiler = profiler;
+        m_stats = m_profiler ? m_profiler->register_node(m_id) : nullptr;
     }
 
 private:
@@ -47,6 +70,9 @@ private:
 
 private:
     mutable std::unique_ptr<IPipelineNodeTask<TData>> m_task;
+
+    PipelineProfilerPtr m_profiler{nullptr};
+    PipelineNodeStats* m_stats{nullptr};
 };
 
 template <typename TData>
@@ -0,0 +1,337 @@
+#include "pipeline_profiler.hpp"
+
+#include <core/log/log.hpp>
+#include <core/exception/assert.hpp>
+
+#include <fmt/format.h>
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <fstream>
+
+namespace {
+
+uint32_t current_trace_tid()
+{
+    static std::atomic<uint32_t> s_tid_counter{0};
+    thread_local const uint32_t tid = ++s_tid_counter;
+    return tid;
+}
+
+std::string escape_json(const std::string& str)
+{
+    std::string result;
+    result.reserve(str.size());
+    for (const auto c : str)
+    {
+        if (c == '"' || c == '\\')
+            result.push_back('\\');
+        result.push_back(c);
+    }
+    return result;
+}
+
+void update_max(std::atomic<uint64_t>& max_value, uint64_t value) noexcept
+{
+    auto prev = max_value.load(std::memory_order_relaxed);
+    while (prev < value && !max_value.compare_exchange_weak(prev, value, std::memory_order_relaxed))
+    {
+    }
+}
+
+}  // namespace
+
+namespace step::proc {
+
+size_t LatencyHistogram::bucket_index(uint64_t value) noexcept
+{
+    if (value < SUB_BUCKET_COUNT)
+        return static_cast<size_t>(value);
+
+    const size_t msb = std::min<size_t>(std::bit_width(value) - 1, MAX_MSB);
+    if (msb == MAX_MSB && (value >> MAX_MSB) > 1)
+        return BUCKET_COUNT - 1;
+
+    const auto sub = static_cast<size_t>(value >> (msb - SUB_BUCKET_BITS)) - SUB_BUCKET_COUNT;
+    return (msb - SUB_BUCKET_BITS + 1) * SUB_BUCKET_COUNT + sub;
+}
+
+uint64_t LatencyHistogram::bucket_value(size_t index) noexcept
+{
+    if (index < SUB_BUCKET_COUNT)
+        return index;
+
+    const size_t group = index / SUB_BUCKET_COUNT;
+    const size_t sub = index % SUB_BUCKET_COUNT;
+    const size_t shift = group - 1;  // msb - SUB_BUCKET_BITS
+
+    const uint64_t lower = static_cast<uint64_t>(SUB_BUCKET_COUNT + sub) << shift;
+    return lower + ((uint64_t(1) << shift) >> 1);  // середина бакета
+}
+
+void LatencyHistogram::record(Microseconds value) noexcept
+{
+    const auto us = static_cast<uint64_t>(std::max<Microseconds::rep>(value.count(), 0));
+
+    m_buckets[bucket_index(us)].fetch_add(1, std::memory_order_relaxed);
+    m_count.fetch_add(1, std::memory_order_relaxed);
+    m_sum.fetch_add(us, std::memory_order_relaxed);
+    update_max(m_max, us);
+}
+
+void LatencyHistogram::reset() noexcept
+{
+    for (auto& bucket : m_buckets)
+        bucket.store(0, std::memory_order_relaxed);
+
+    m_count.store(0, std::memory_order_relaxed);
+    m_sum.store(0, std::memory_order_relaxed);
+    m_max.store(0, std::memory_order_relaxed);
+}
+
+Microseconds LatencyHistogram::mean() const noexcept
+{
+    const auto cnt = count();
+    return cnt ? Microseconds(m_sum.load(std::memory_order_relaxed) / cnt) : Microseconds(0);
+}
+
+Microseconds LatencyHistogram::percentile(double p) const noexcept
+{
+    // Счетчики читаются без общей блокировки, поэтому сумма по бакетам может немного отличаться от m_count
+    uint64_t total = 0;
+    for (const auto& bucket : m_buckets)
+        total += bucket.load(std::memory_order_relaxed);
+
+    if (total == 0)
+        return Microseconds(0);
+
+    const auto target = std::max<uint64_t>(1, static_cast<uint64_t>(std::ceil(p * total)));
+    uint64_t cumulative = 0;
+    size_t i = 0;
+    for (; i < BUCKET_COUNT; ++i)
+    {
+        cumulative += m_buckets[i].load(std::memory_order_relaxed);
+        if (cumulative >= target)
+            break;
+    }
+
+    // Последний бакет не ограничен сверху, значения в нем оцениваются максимумом
+    if (i < BUCKET_COUNT - 1)
+        return Microseconds(std::min(bucket_value(i), m_max.load(std::memory_order_relaxed)));
+
+    return max();
+}
+
+void PipelineNodeStats::reset() noexcept
+{
+    execution.reset();
+    queue_wait.reset();
+    processed.store(0, std::memory_order_relaxed);
+    dropped.store(0, std::memory_order_relaxed);
+    exceptions.store(0, std::memory_order_relaxed);
+}
+
+PipelineProfiler::PipelineProfiler(const std::string& pipeline_name)
+    : m_name(pipeline_name), m_init_time(Clock::now())
+{
+}
+
+PipelineNodeStats* PipelineProfiler::register_node(const std::string& id)
+{
+    auto& stats = m_nodes[id];
+    if (!stats)
+        stats = std::make_unique<PipelineNodeStats>(id, "node");
+    return stats.get();
+}
+
+PipelineNodeStats* PipelineProfiler::register_branch(const std::string& id)
+{
+    auto& stats = m_branches[id];
+    if (!stats)
+        stats = std::make_unique<PipelineNodeStats>(id, "branch");
+    return stats.get();
+}
+
+void PipelineProfiler::record_execution(PipelineNodeStats* stats, Clock::time_point start, Clock::time_point finish)
+{
+    if (!stats)
+        return;
+
+    const auto duration = std::chrono::duration_cast<Microseconds>(finish - start);
+    stats->execution.record(duration);
+    stats->processed.fetch_add(1, std::memory_order_relaxed);
+
+    if (!is_trace_enabled())
+        return;
+
+    const auto ts = std::chrono::duration_cast<Microseconds>(start - m_init_time).count();
+    const auto tid = current_trace_tid();
+
+    std::scoped_lock lock(m_trace_guard);
+    if (m_trace_events.size() < m_trace_max_events)
+        m_trace_events.push_back({stats, ts, duration.count(), tid});
+}
+
+void PipelineProfiler::record_queue_wait(PipelineNodeStats* stats, Clock::time_point ready,
+                                         Clock::time_point start) noexcept
+{
+    if (stats)
+        stats->queue_wait.record(std::chrono::duration_cast<Microseconds>(start - ready));
+}
+
+void PipelineProfiler::record_drop(PipelineNodeStats* stats) noexcept
+{
+    if (stats)
+        stats->dropped.fetch_add(1, std::memory_order_relaxed);
+}
+
+void PipelineProfiler::record_exception(PipelineNodeStats* stats) noexcept
+{
+    if (stats)
+        stats->exceptions.fetch_add(1, std::memory_order_relaxed);
+}
+
+PipelineNodeStats* PipelineProfiler::get_node_stats(const std::string& id) const
+{
+    auto it = m_nodes.find(id);
+    return it == m_nodes.cend() ? nullptr : it->second.get();
+}
+
+PipelineNodeStats* PipelineProfiler::get_branch_stats(const std::string& id) const
+{
+    auto it = m_branches.find(id);
+    return it == m_branches.cend() ? nullptr : it->second.get();
+}
+
+std::vector<const PipelineNodeStats*> PipelineProfiler::get_all_branch_stats() const
+{
+    std::vector<const PipelineNodeStats*> result;
+    result.reserve(m_branches.size());
+    for (const auto& [id, stats] : m_branches)
+        result.push_back(stats.get());
+    return result;
+}
+
+std::vector<PipelineNodeStatsSnapshot> PipelineProfiler::make_snapshot(
+    const std::unordered_map<std::string, std::unique_ptr<PipelineNodeStats>>& stats)
+{
+    std::vector<PipelineNodeStatsSnapshot> snapshot;
+    snapshot.reserve(stats.size());
+    for (const auto& [id, item] : stats)
+    {
+        PipelineNodeStatsSnapshot s;
+        s.id = id;
+        s.processed = item->processed.load(std::memory_order_relaxed);
+        s.dropped = item->dropped.load(std::memory_order_relaxed);
+        s.exceptions = item->exceptions.load(std::memory_order_relaxed);
+
+        s.exec_mean = item->execution.mean();
+        s.exec_p50 = item->execution.percentile(0.50);
+        s.exec_p95 = item->execution.percentile(0.95);
+        s.exec_p99 = item->execution.percentile(0.99);
+        s.exec_max = item->execution.max();
+
+        s.wait_mean = item->queue_wait.mean();
+        s.wait_p50 = item->queue_wait.percentile(0.50);
+        s.wait_p95 = item->queue_wait.percentile(0.95);
+        s.wait_p99 = item->queue_wait.percentile(0.99);
+        s.wait_max = item->queue_wait.max();
+
+        snapshot.push_back(std::move(s));
+    }
+
+    // Самые тяжелые узлы - первыми
+    std::sort(snapshot.begin(), snapshot.end(),
+              [](const auto& lhs, const auto& rhs) { return lhs.exec_p95 > rhs.exec_p95; });
+    return snapshot;
+}
+
+std::vector<PipelineNodeStatsSnapshot> PipelineProfiler::get_nodes_snapshot() const { return make_snapshot(m_nodes); }
+
+std::vector<PipelineNodeStatsSnapshot> PipelineProfiler::get_branches_snapshot() const
+{
+    return make_snapshot(m_branches);
+}
+
+void PipelineProfiler::log_report() const
+{
+    const auto log_snapshot = [this](const char* title, const std::vector<PipelineNodeStatsSnapshot>& snapshot) {
+        for (const auto& s : snapshot)
+        {
+            STEP_LOG(L_INFO,
+                     "Pipeline {} {} {}: processed {}, dropped {}, exceptions {}; exec us mean/p50/p95/p99/max "
+                     "{}/{}/{}/{}/{}; wait us mean/p50/p95/p99/max {}/{}/{}/{}/{}",
+                     m_name, title, s.id, s.processed, s.dropped, s.exceptions, s.exec_mean, s.exec_p50, s.exec_p95,
+                     s.exec_p99, s.exec_max, s.wait_mean, s.wait_p50, s.wait_p95, s.wait_p99, s.wait_max);
+        }
+    };
+
+    log_snapshot("branch", get_branches_snapshot());
+    log_snapshot("node", get_nodes_snapshot());
+}
+
+void PipelineProfiler::reset()
+{
+    for (auto& [id, stats] : m_nodes)
+        stats->reset();
+    for (auto& [id, stats] : m_branches)
+        stats->reset();
+
+    std::scoped_lock lock(m_trace_guard);
+    m_trace_events.clear();
+}
+
+void PipelineProfiler::start_trace(size_t max_events /*= 1'000'000*/)
+{
+    std::scoped_lock lock(m_trace_guard);
+    m_trace_events.clear();
+    m_trace_events.reserve(std::min<size_t>(max_events, 64 * 1024));
+    m_trace_max_events = max_events;
+    m_trace_enabled.store(true);
+    STEP_LOG(L_INFO, "Pipeline {}: trace started, max events {}", m_name, max_events);
+}
+
+void PipelineProfiler::stop_trace()
+{
+    m_trace_enabled.store(false);
+    std::scoped_lock lock(m_trace_guard);
+    STEP_LOG(L_INFO, "Pipeline {}: trace stopped, events {}", m_name, m_trace_events.size());
+}
+
+std::string PipelineProfiler::get_chrome_trace() const
+{
+    fmt::memory_buffer buffer;
+    auto out = std::back_inserter(buffer);
+
+    fmt::format_to(out, "{{\"displayTimeUnit\":\"ms\",\"traceEvents\":[");
+    fmt::format_to(out, "{{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"args\":{{\"name\":\"{}\"}}}}",
+                   escape_json(m_name));
+
+    std::scoped_lock lock(m_trace_guard);
+    for (const auto& event : m_trace_events)
+    {
+        fmt::format_to(out,
+                       ",{{\"name\":\"{}\",\"cat\":\"{}\",\"ph\":\"X\",\"ts\":{},\"dur\":{},\"pid\":1,\"tid\":{}}}",
+                       escape_json(event.stats->id), event.stats->category, event.ts, event.dur, event.tid);
+    }
+    fmt::format_to(out, "]}}");
+
+    return fmt::to_string(buffer);
+}
+
+bool PipelineProfiler::export_chrome_trace(const std::filesystem::path& path) const
+{
+    std::ofstream file(path, std::ios::out | std::ios::trunc);
+    if (!file.is_open())
+    {
+        STEP_LOG(L_ERROR, "Pipeline {}: can't open trace file {}", m_name, path.string());
+        return false;
+    }
+
+    file << get_chrome_trace();
+    STEP_LOG(L_INFO, "Pipeline {}: trace exported to {}", m_name, path.string());
+    return file.good();
+}
+
+}  // namespace step::proc
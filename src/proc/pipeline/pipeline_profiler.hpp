@@ -0,0 +1,145 @@
+#pragma once
+
+#include <core/base/types/time.hpp>
+
+#include <array>
+#include <atomic>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace step::proc {
+
+/*! @brief Lock-free гистограмма задержек в микросекундах с log-linear бакетами (в духе HDR Histogram).
+    @details Значения < 16 хранятся точно, дальше каждая степень двойки делится на 16 линейных бакетов,
+    что дает относительную погрешность перцентилей не хуже ~6%.
+*/
+class LatencyHistogram
+{
+public:
+    void record(Microseconds value) noexcept;
+    void reset() noexcept;
+
+    uint64_t count() const noexcept { return m_count.load(std::memory_order_relaxed); }
+    Microseconds max() const noexcept { return Microseconds(m_max.load(std::memory_order_relaxed)); }
+    Microseconds total() const noexcept { return Microseconds(m_sum.load(std::memory_order_relaxed)); }
+    Microseconds mean() const noexcept;
+    Microseconds percentile(double p) const noexcept;
+
+private:
+    static constexpr size_t SUB_BUCKET_BITS = 4;
+    static constexpr size_t SUB_BUCKET_COUNT = 1 << SUB_BUCKET_BITS;
+    static constexpr size_t MAX_MSB = 35;  // ~9.5 часов, все что больше - в последний бакет
+    static constexpr size_t BUCKET_COUNT = (MAX_MSB - SUB_BUCKET_BITS + 2) * SUB_BUCKET_COUNT;
+
+    static size_t bucket_index(uint64_t value) noexcept;
+    static uint64_t bucket_value(size_t index) noexcept;
+
+private:
+    std::array<std::atomic<uint64_t>, BUCKET_COUNT> m_buckets{};
+    std::atomic<uint64_t> m_count{0};
+    std::atomic<uint64_t> m_sum{0};
+    std::atomic<uint64_t> m_max{0};
+};
+
+/*! @brief Счетчики узла (или ветви) пайплайна. Пишутся из рабочих потоков без блокировок.
+*/
+struct PipelineNodeStats
+{
+    PipelineNodeStats(const std::string& stats_id, const char* stats_category)
+        : id(stats_id), category(stats_category)
+    {
+    }
+
+    const std::string id;
+    const char* category;         // "node" / "branch", категория trace-событий
+    LatencyHistogram execution;   // время работы узла
+    LatencyHistogram queue_wait;  // время от готовности данных до начала обработки
+    std::atomic<uint64_t> processed{0};
+    std::atomic<uint64_t> dropped{0};
+    std::atomic<uint64_t> exceptions{0};
+
+    void reset() noexcept;
+};
+
+struct PipelineNodeStatsSnapshot
+{
+    std::string id;
+    uint64_t processed{0};
+    uint64_t dropped{0};
+    uint64_t exceptions{0};
+    Microseconds exec_mean{0}, exec_p50{0}, exec_p95{0}, exec_p99{0}, exec_max{0};
+    Microseconds wait_mean{0}, wait_p50{0}, wait_p95{0}, wait_p99{0}, wait_max{0};
+};
+
+/*! @brief Профилировщик пайплайна: постоянные счетчики по узлам/ветвям и, по запросу,
+    запись событий для экспорта в Chrome trace-event JSON (открывается в chrome://tracing и Perfetto).
+    @details Узлы и ветви регистрируются при построении пайплайна, после этого набор счетчиков не меняется,
+    поэтому обращения к ним из рабочих потоков не требуют синхронизации.
+*/
+class PipelineProfiler
+{
+public:
+    using Clock = std::chrono::steady_clock;
+
+    PipelineProfiler(const std::string& pipeline_name);
+
+    PipelineNodeStats* register_node(const std::string& id);
+    PipelineNodeStats* register_branch(const std::string& id);
+
+    Clock::time_point now() const noexcept { return Clock::now(); }
+
+    /*! @brief Фиксирует выполнение узла/ветви: гистограмма + trace-событие, если запись включена.
+    */
+    void record_execution(PipelineNodeStats* stats, Clock::time_point start, Clock::time_point finish);
+    void record_queue_wait(PipelineNodeStats* stats, Clock::time_point ready, Clock::time_point start) noexcept;
+    void record_drop(PipelineNodeStats* stats) noexcept;
+    void record_exception(PipelineNodeStats* stats) noexcept;
+
+    PipelineNodeStats* get_node_stats(const std::string& id) const;
+    PipelineNodeStats* get_branch_stats(const std::string& id) const;
+    std::vector<const PipelineNodeStats*> get_all_branch_stats() const;
+
+    std::vector<PipelineNodeStatsSnapshot> get_nodes_snapshot() const;
+    std::vector<PipelineNodeStatsSnapshot> get_branches_snapshot() const;
+    void log_report() const;
+    void reset();
+
+    // Trace events
+    void start_trace(size_t max_events = 1'000'000);
+    void stop_trace();
+    bool is_trace_enabled() const noexcept { return m_trace_enabled.load(std::memory_order_relaxed); }
+    std::string get_chrome_trace() const;
+    bool export_chrome_trace(const std::filesystem::path& path) const;
+
+private:
+    struct TraceEvent
+    {
+        const PipelineNodeStats* stats;
+        int64_t ts;   // мкс от создания профилировщика
+        int64_t dur;  // мкс
+        uint32_t tid;
+    };
+
+    static std::vector<PipelineNodeStatsSnapshot> make_snapshot(
+        const std::unordered_map<std::string, std::unique_ptr<PipelineNodeStats>>& stats);
+
+private:
+    std::string m_name;
+    Clock::time_point m_init_time;
+
+    std::unordered_map<std::string, std::unique_ptr<PipelineNodeStats>> m_nodes;
+    std::unordered_map<std::string, std::unique_ptr<PipelineNodeStats>> m_branches;
+
+    std::atomic_bool m_trace_enabled{false};
+    mutable std::mutex m_trace_guard;
+    std::vector<TraceEvent> m_trace_events;
+    size_t m_trace_max_events{0};
+};
+
+using PipelineProfilerPtr = std::shared_ptr<PipelineProfiler>;
+
+}  // namespace step::proc
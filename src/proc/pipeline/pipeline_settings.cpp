@@ -2,6 +2,7 @@
 
 #include <core/base/types/config_fields.hpp>
 #include <core/base/utils/find_pair.hpp>
+#include <core/exception/assert.hpp>
 
 namespace {
 
@@ -40,6 +41,18 @@ void PipelineSettings::deserialize(const ObjectPtrJSON& config)
 {
     name = json::get<std::string>(config, CFG_FLD::NAME);
     utils::from_string(sync_policy, json::get<std::string>(config, CFG_FLD::SYNC_MODE));
+    fork_join = json::get<bool>(config, CFG_FLD::FORK_JOIN, false);
+    input_policy = threading::DeliveryPolicy::LatestOnly;
+    if (auto policy = json::get_opt<std::string>(config, CFG_FLD::INPUT_POLICY))
+        utils::from_string(input_policy, *policy);
+    STEP_ASSERT(input_policy != threading::DeliveryPolicy::Undefined, "Pipeline {}: invalid input policy", name);
+    input_queue_size = json::get<size_t>(config, CFG_FLD::INPUT_QUEUE_SIZE, 1);
+
+    load_control.reset();
+    if (auto load_control_cfg = json::opt_object(config, CFG_FLD::LOAD_CONTROL))
+        load_control.emplace().deserialize(load_control_cfg);
+    priority = json::get<double>(config, CFG_FLD::STREAM_PRIORITY, 1.0);
+    STEP_ASSERT(priority > 0.0, "Pipeline {}: invalid priority {}", name, priority);
 }
 
 }  // namespace step::proc
\ No newline at end of file
@@ -1,11 +1,17 @@
 #pragma once
 
+#include "load_controller.hpp"
+
 #include <core/base/interfaces/serializable.hpp>
 
 #include <core/base/utils/string_utils.hpp>
 
+#include <core/threading/delivery_queue.hpp>
+
 #include <fmt/format.h>
 
+#include <optional>
+
 namespace step::proc {
 
 enum class PipelineSyncPolicy
@@ -20,6 +26,15 @@ struct PipelineSettings : public ISerializable
 {
     std::string name;
     PipelineSyncPolicy sync_policy{PipelineSyncPolicy::Undefined};
+    // SyncPipeline: независимые ветви кадра выполняются параллельно в общем пуле потоков
+    bool fork_join{false};
+    // AsyncPipeline: что делать с кадром, пришедшим пока входная ветвь занята
+    threading::DeliveryPolicy input_policy{threading::DeliveryPolicy::LatestOnly};
+    size_t input_queue_size{1};
+    // AsyncPipeline: регулятор нагрузки, без секции load_control качество не снижается
+    std::optional<LoadControlSettings> load_control;
+    // AsyncPipeline: приоритет потока для регулятора, ниже load_control.low_priority - распознавание отключается
+    double priority{1.0};
 
     PipelineSettings() = default;
     PipelineSettings(const ObjectPtrJSON& config);
@@ -35,7 +50,8 @@ struct fmt::formatter<step::proc::PipelineSettings> : fmt::formatter<string_view
     template <typename FormatContext>
     auto format(const step::proc::PipelineSettings& settings, FormatContext& ctx)
     {
-        return fmt::format_to(ctx.out(), "name: {}; sync_mode {};", settings.name,
-                              step::utils::to_string(settings.sync_policy));
+        return fmt::format_to(ctx.out(), "name: {}; sync_mode {}; fork_join {}; input {} ({});", settings.name,
+                              step::utils::to_string(settings.sync_policy), settings.fork_join,
+                              step::utils::to_string(settings.input_policy), settings.input_queue_size);
     }
 };
@@ -2,52 +2,233 @@
 
 #include <proc/pipeline/pipeline.hpp>
 
-#include <queue>
+#include <core/threading/thread_pool_event_handler.hpp>
+
+#include <algorithm>
+#include <condition_variable>
+#include <exception>
+#include <mutex>
 
 namespace step::proc {
 
+/*! @brief Синхронный пайплайн: process возвращается, когда кадр прошел все ветви.
+    @details С fork_join в настройках независимые соседние ветви кадра выполняются параллельно
+    в глобальном пуле потоков. Ветвь с наименьшим индексом продолжает работать с данными родителя,
+    остальные получают копию (fork_pipeline_data). Записи вложений помечаются индексом ветви в плане,
+    после завершения всех ветвей из записей одного вложения остается запись ветви с большим индексом -
+    как при последовательном выполнении, где она выполняется последней. Итог не зависит от планирования
+    потоков, если ветви не читают вложения соседних ветвей: при параллельном выполнении ветвь видит
+    только записи своих предков. Изменения самих данных (TData) в копиях не возвращаются.
+*/
 template <typename TData>
 class SyncPipeline : public BasePipeline<TData>
 {
+    using IndexType = PipelineExecutionPlan::IndexType;
+    using TimePoint = PipelineProfiler::Clock::time_point;
+
 public:
     virtual void process(const PipelineDataPtr<TData>& data) override
     {
-        std::queue<PipelineIdType> id_queue;
-        id_queue.push(BasePipeline<TData>::get_root_id());
         STEP_LOG(L_DEBUG, "Start SyncPipeline {} process", BasePipeline<TData>::m_settings.name);
 
-        while (!id_queue.empty())
+        if (BasePipeline<TData>::m_settings.fork_join && BasePipeline<TData>::m_plan.has_forks())
+            process_fork_join(data);
+        else
+            process_sequential(data);
+    }
+
+private:
+    /*! @brief Состояние fork-join обработки одного кадра, индексируется индексом ветви в плане.
+        @details Живет на стеке вызова process: задачи пула обращаются к нему только до завершения кадра.
+    */
+    struct ForkJoinState
+    {
+        ForkJoinState(const PipelineExecutionPlan& plan)
+            : pending(plan.get_dependency_counts())
+            , ready_times(plan.size())
+            , branch_data(plan.size())
+            , executed(plan.size(), false)
+        {
+        }
+
+        std::vector<uint32_t> pending;
+        std::vector<TimePoint> ready_times;
+        std::vector<PipelineDataPtr<TData>> branch_data;
+        std::vector<char> executed;
+        std::mutex guard;
+        std::condition_variable join_cv;
+        size_t in_flight{1};
+        std::exception_ptr exception;
+    };
+
+private:
+    void process_sequential(const PipelineDataPtr<TData>& data)
+    {
+        const auto& profiler = BasePipeline<TData>::m_profiler;
+        const auto& plan = BasePipeline<TData>::m_plan;
+
+        // Ветви пронумерованы топологически: к моменту обработки ветви все ее родители уже отработали.
+        // Счетчик зависимостей обнуляется, когда отработали все родители - тогда ветвь получает данные.
+        // Состояние кадра локальное: process можно вызывать из нескольких потоков одновременно.
+        const auto& dependency_counts = plan.get_dependency_counts();
+        std::vector<uint32_t> pending(dependency_counts);
+        std::vector<TimePoint> ready_times(m_branches.size());
+
+        const auto root_index = plan.get_root_index();
+        ready_times[root_index] = profiler->now();
+        for (IndexType index = 0; index < m_branches.size(); ++index)
         {
-            const auto id = id_queue.front();
-            STEP_LOG(L_DEBUG, "Process node {}", id);
-            STEP_ASSERT(m_branches.contains(id), "No {} in branch", id);
-            auto& branch = m_branches[id];
+            if (index != root_index && (dependency_counts[index] == 0 || pending[index] != 0))
+                continue;
+
+            auto& branch = m_branches[index];
+            STEP_LOG(L_DEBUG, "Process branch {}", plan.get_id(index));
+            profiler->record_queue_wait(branch.get_stats(), ready_times[index], profiler->now());
             branch.process(data);
-            id_queue.pop();
 
-            for (const auto& child_id : BasePipeline<TData>::get_node(branch.get_last_id())->get_children_ids())
-                id_queue.push(child_id);
+            const auto finish_time = profiler->now();
+            for (const auto child_index : plan.get_children(index))
+            {
+                if (--pending[child_index] == 0)
+                    ready_times[child_index] = finish_time;
+            }
+        }
+    }
+
+    void process_fork_join(const PipelineDataPtr<TData>& data)
+    {
+        const auto& plan = BasePipeline<TData>::m_plan;
+        auto& pool = threading::get_or_create_global_thread_pool();
+
+        ForkJoinState state(plan);
+        const auto root_index = plan.get_root_index();
+        data->storage.track_changes(root_index);
+        state.branch_data[root_index] = data;
+        state.ready_times[root_index] = BasePipeline<TData>::m_profiler->now();
+
+        // Вызывающий поток сам выполняет цепочку от корня, затем помогает пулу, пока ветви кадра не завершатся
+        run_branch(root_index, state, pool);
+        {
+            std::unique_lock lock(state.guard);
+            while (state.in_flight != 0)
+            {
+                lock.unlock();
+                const bool has_run = pool.try_run_one();
+                lock.lock();
+                if (!has_run)
+                    state.join_cv.wait_for(lock, Milliseconds(1), [&state]() { return state.in_flight == 0; });
+            }
+        }
+
+        // Копии сливаются прямо в исходные данные: побеждает запись с большим индексом ветви,
+        // порядок слияния не важен. Копия, общая для цепочки ветвей, сливается один раз
+        for (IndexType index = 0; index < m_branches.size(); ++index)
+        {
+            const auto& branch_data = state.branch_data[index];
+            if (state.executed[index] && branch_data != data)
+                data->storage.merge_changes(std::move(branch_data->storage));
+        }
+        data->storage.reset_changes();
+
+        if (state.exception)
+            std::rethrow_exception(state.exception);
+    }
+
+    void run_branch(IndexType index, ForkJoinState& state, threading::ThreadPoolEventHandler& pool)
+    {
+        const auto& profiler = BasePipeline<TData>::m_profiler;
+        const auto& plan = BasePipeline<TData>::m_plan;
+
+        std::vector<IndexType> ready;
+        while (index != PipelineExecutionPlan::INVALID_INDEX)
+        {
+            auto& branch = m_branches[index];
+            STEP_LOG(L_DEBUG, "Process branch {}", plan.get_id(index));
+            profiler->record_queue_wait(branch.get_stats(), state.ready_times[index], profiler->now());
+
+            std::exception_ptr exception;
+            try
+            {
+                state.branch_data[index]->storage.track_changes(index);
+                branch.process(state.branch_data[index]);
+            }
+            catch (...)
+            {
+                exception = std::current_exception();
+            }
+
+            ready.clear();
+            {
+                std::scoped_lock lock(state.guard);
+                state.executed[index] = true;
+                if (exception && !state.exception)
+                    state.exception = exception;
+
+                // После исключения новые ветви не запускаются, уже запущенные дорабатывают
+                if (!state.exception)
+                {
+                    const auto finish_time = profiler->now();
+                    for (const auto child_index : plan.get_children(index))
+                    {
+                        if (--state.pending[child_index] != 0)
+                            continue;
+
+                        state.ready_times[child_index] = finish_time;
+                        ready.push_back(child_index);
+                    }
+                }
+
+                // Текущий поток продолжает первую готовую ветвь, остальные уходят в пул.
+                // Последнее обращение к state - под блокировкой: после него process может вернуться
+                if (ready.empty())
+                {
+                    if (--state.in_flight == 0)
+                        state.join_cv.notify_all();
+                }
+                else
+                {
+                    state.in_flight += ready.size() - 1;
+                }
+            }
+
+            if (ready.empty())
+                return;
+
+            const auto next = *std::min_element(ready.cbegin(), ready.cend());
+            for (const auto child_index : ready)
+            {
+                if (child_index == next)
+                    continue;
+
+                state.branch_data[child_index] = fork_pipeline_data(state.branch_data[index]);
+                pool.add_task([this, child_index, &state, &pool]() { run_branch(child_index, state, pool); });
+            }
+
+            state.branch_data[next] = state.branch_data[index];
+            index = next;
         }
     }
 
-private:
     virtual void create_branch(const PipelineNodePtr<TData>& branch_root) override
     {
         STEP_ASSERT(branch_root, "Can't create branch: empty root");
-        STEP_ASSERT(!m_branches.contains(branch_root->get_id()), "SyncPipeline already has branch {}",
+        const auto index = BasePipeline<TData>::m_plan.index_of(branch_root->get_id());
+        STEP_ASSERT(index == m_branches.size(), "SyncPipeline: branch {} is created out of plan order",
                     branch_root->get_id());
-        m_branches[branch_root->get_id()] = PipelineBranch<TData>(branch_root);
+
+        auto& branch = m_branches.emplace_back(branch_root);
+        branch.set_profiler(BasePipeline<TData>::m_profiler);
     }
 
     virtual void add_node_to_branch(const PipelineIdType& branch_id, const PipelineNodePtr<TData>& node) override
     {
         STEP_ASSERT(node, "Can't add node to branch {}: empty node", branch_id);
-        STEP_ASSERT(m_branches.contains(branch_id), "SyncPipeline doesn't have branch {}", branch_id);
-        m_branches[branch_id].add_node(node);
+        m_branches[BasePipeline<TData>::m_plan.index_of(branch_id)].add_node(node);
     }
 
 private:
-    std::map<PipelineIdType, PipelineBranch<TData>> m_branches;
+    // Индексируются индексом ветви в плане исполнения. После построения не меняются
+    std::vector<PipelineBranch<TData>> m_branches;
 };
 
-}  // namespace step::proc
\ No newline at end of file
+}  // namespace step::proc
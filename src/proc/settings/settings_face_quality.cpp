@@ -0,0 +1,48 @@
+#include "settings_face_quality.hpp"
+
+#include <core/base/types/config_fields.hpp>
+
+namespace step::proc {
+
+const std::string SettingsFaceQuality::SETTINGS_ID = "SettingsFaceQuality";
+
+bool SettingsFaceQuality::operator==(const SettingsFaceQuality& rhs) const noexcept
+{
+    /* clang-format off */
+    return true
+        && m_min_size == rhs.m_min_size
+        && m_min_sharpness == rhs.m_min_sharpness
+        && m_max_yaw == rhs.m_max_yaw
+        && m_max_pitch == rhs.m_max_pitch
+        && m_min_confidence == rhs.m_min_confidence
+        && m_sharpness_size == rhs.m_sharpness_size
+        && m_best_per_track == rhs.m_best_per_track
+        && m_track_iou == rhs.m_track_iou
+        && m_track_ttl == rhs.m_track_ttl
+        && m_improve_ratio == rhs.m_improve_ratio
+    ;
+    /* clang-format on */
+}
+
+void SettingsFaceQuality::deserialize(const ObjectPtrJSON& container)
+{
+    m_min_size = json::get_opt<int>(container, CFG_FLD::FACE_QUALITY_MIN_SIZE).value_or(48);
+    m_min_sharpness = json::get_opt<double>(container, CFG_FLD::FACE_QUALITY_MIN_SHARPNESS).value_or(50.0);
+    m_max_yaw = json::get_opt<double>(container, CFG_FLD::FACE_QUALITY_MAX_YAW).value_or(35.0);
+    m_max_pitch = json::get_opt<double>(container, CFG_FLD::FACE_QUALITY_MAX_PITCH).value_or(25.0);
+    m_min_confidence = json::get_opt<double>(container, CFG_FLD::FACE_QUALITY_MIN_CONFIDENCE).value_or(0.6);
+    STEP_ASSERT(m_min_size >= 0 && m_min_sharpness >= 0 && m_max_yaw >= 0 && m_max_pitch >= 0,
+                "Invalid face quality thresholds");
+
+    m_sharpness_size = json::get_opt<size_t>(container, CFG_FLD::FACE_QUALITY_SHARPNESS_SIZE).value_or(64);
+    STEP_ASSERT(m_sharpness_size >= 3, "Invalid face quality sharpness size: {}", m_sharpness_size);
+
+    m_best_per_track = json::get_opt<bool>(container, CFG_FLD::FACE_QUALITY_BEST_PER_TRACK).value_or(true);
+    m_track_iou = json::get_opt<double>(container, CFG_FLD::FACE_QUALITY_TRACK_IOU).value_or(0.3);
+    m_track_ttl = json::get_opt<size_t>(container, CFG_FLD::FACE_QUALITY_TRACK_TTL).value_or(10);
+    m_improve_ratio = json::get_opt<double>(container, CFG_FLD::FACE_QUALITY_IMPROVE_RATIO).value_or(0.1);
+    STEP_ASSERT(m_track_iou > 0 && m_track_iou <= 1, "Invalid face quality track IoU: {}", m_track_iou);
+    STEP_ASSERT(m_improve_ratio >= 0, "Invalid face quality improve ratio: {}", m_improve_ratio);
+}
+
+}  // namespace step::proc
@@ -0,0 +1,68 @@
+#pragma once
+
+#include <core/task/base_task.hpp>
+
+namespace step::proc {
+
+/*! @brief Настройки оценки качества лиц перед распознаванием.
+    @details Лицо проходит, если меньшая сторона rect не меньше min_size, дисперсия лапласиана яркости
+    (резкость, по области лица, уменьшенной до sharpness_size) не меньше min_sharpness, уверенность детектора
+    не меньше min_confidence, а углы поворота головы по landmarks не больше max_yaw/max_pitch градусов.
+    Порог 0 отключает проверку. С best_per_track из прошедших лиц одного трека (сопоставление по IoU не ниже
+    track_iou, трек живет track_ttl кадров без лица) распознается первое и затем только лица с оценкой
+    лучше прежней больше чем в 1 + improve_ratio раз.
+*/
+class SettingsFaceQuality : public task::BaseSettings
+{
+public:
+    TASK_SETTINGS(SettingsFaceQuality)
+
+    SettingsFaceQuality() = default;
+
+    bool operator==(const SettingsFaceQuality& rhs) const noexcept;
+    bool operator!=(const SettingsFaceQuality& rhs) const noexcept { return !(*this == rhs); }
+
+    void set_min_size(int value) { m_min_size = value; }
+    int get_min_size() const noexcept { return m_min_size; }
+
+    void set_min_sharpness(double value) { m_min_sharpness = value; }
+    double get_min_sharpness() const noexcept { return m_min_sharpness; }
+
+    void set_max_yaw(double value) { m_max_yaw = value; }
+    double get_max_yaw() const noexcept { return m_max_yaw; }
+
+    void set_max_pitch(double value) { m_max_pitch = value; }
+    double get_max_pitch() const noexcept { return m_max_pitch; }
+
+    void set_min_confidence(double value) { m_min_confidence = value; }
+    double get_min_confidence() const noexcept { return m_min_confidence; }
+
+    void set_sharpness_size(size_t value) { m_sharpness_size = value; }
+    size_t get_sharpness_size() const noexcept { return m_sharpness_size; }
+
+    void set_best_per_track(bool value) { m_best_per_track = value; }
+    bool get_best_per_track() const noexcept { return m_best_per_track; }
+
+    void set_track_iou(double value) { m_track_iou = value; }
+    double get_track_iou() const noexcept { return m_track_iou; }
+
+    void set_track_ttl(size_t value) { m_track_ttl = value; }
+    size_t get_track_ttl() const noexcept { return m_track_ttl; }
+
+    void set_improve_ratio(double value) { m_improve_ratio = value; }
+    double get_improve_ratio() const noexcept { return m_improve_ratio; }
+
+public:
+    int m_min_size{48};
+    double m_min_sharpness{50.0};
+    double m_max_yaw{35.0};
+    double m_max_pitch{25.0};
+    double m_min_confidence{0.6};
+    size_t m_sharpness_size{64};
+    bool m_best_per_track{true};
+    double m_track_iou{0.3};
+    size_t m_track_ttl{10};
+    double m_improve_ratio{0.1};
+};
+
+}  // namespace step::proc
@@ -0,0 +1,47 @@
+#include "settings_motion_gate.hpp"
+
+#include <core/base/types/config_fields.hpp>
+
+namespace step::proc {
+
+const std::string SettingsMotionGate::SETTINGS_ID = "SettingsMotionGate";
+
+bool SettingsMotionGate::operator==(const SettingsMotionGate& rhs) const noexcept
+{
+    /* clang-format off */
+    return true
+        && m_analysis_width == rhs.m_analysis_width
+        && m_block_size == rhs.m_block_size
+        && m_pixel_threshold == rhs.m_pixel_threshold
+        && m_block_threshold == rhs.m_block_threshold
+        && m_activate_frames == rhs.m_activate_frames
+        && m_deactivate_frames == rhs.m_deactivate_frames
+        && m_idle_interval == rhs.m_idle_interval
+        && m_region_margin == rhs.m_region_margin
+        && m_max_region_area == rhs.m_max_region_area
+    ;
+    /* clang-format on */
+}
+
+void SettingsMotionGate::deserialize(const ObjectPtrJSON& container)
+{
+    m_analysis_width = json::get_opt<size_t>(container, CFG_FLD::MOTION_ANALYSIS_WIDTH).value_or(320);
+    m_block_size = json::get_opt<size_t>(container, CFG_FLD::MOTION_BLOCK_SIZE).value_or(8);
+    STEP_ASSERT(m_analysis_width > 0 && m_block_size > 0, "Invalid motion analysis width {} or block size {}",
+                m_analysis_width, m_block_size);
+
+    m_pixel_threshold = json::get_opt<int>(container, CFG_FLD::MOTION_PIXEL_THRESHOLD).value_or(20);
+    m_block_threshold = json::get_opt<double>(container, CFG_FLD::MOTION_BLOCK_THRESHOLD).value_or(0.1);
+    STEP_ASSERT(m_block_threshold >= 0 && m_block_threshold < 1, "Invalid motion block threshold: {}",
+                m_block_threshold);
+
+    m_activate_frames =
+        std::max<size_t>(json::get_opt<size_t>(container, CFG_FLD::MOTION_ACTIVATE_FRAMES).value_or(1), 1);
+    m_deactivate_frames =
+        std::max<size_t>(json::get_opt<size_t>(container, CFG_FLD::MOTION_DEACTIVATE_FRAMES).value_or(25), 1);
+    m_idle_interval = json::get_opt<size_t>(container, CFG_FLD::MOTION_IDLE_INTERVAL).value_or(0);
+    m_region_margin = json::get_opt<size_t>(container, CFG_FLD::MOTION_REGION_MARGIN).value_or(1);
+    m_max_region_area = json::get_opt<double>(container, CFG_FLD::MOTION_MAX_REGION_AREA).value_or(0.5);
+}
+
+}  // namespace step::proc
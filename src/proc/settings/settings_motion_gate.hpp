@@ -0,0 +1,65 @@
+#pragma once
+
+#include <core/task/base_task.hpp>
+
+namespace step::proc {
+
+/*! @brief Настройки дешевой проверки движения перед детекторами.
+    @details Кадр уменьшается до ширины analysis_width (по яркости), сравнивается с предыдущим по блокам
+    block_size x block_size. Пиксель изменен, если яркость отличается больше чем на pixel_threshold, блок -
+    если изменена доля пикселей больше block_threshold. Гистерезис: движение начинается после activate_frames
+    кадров подряд с изменениями и заканчивается через deactivate_frames кадров без изменений в блоке.
+    idle_interval - период полной детекции без движения (0 - не запускать), чтобы не терять неподвижные объекты.
+    Области изменений расширяются на region_margin блоков; если они покрывают больше max_region_area кадра,
+    областью становится весь кадр.
+*/
+class SettingsMotionGate : public task::BaseSettings
+{
+public:
+    TASK_SETTINGS(SettingsMotionGate)
+
+    SettingsMotionGate() = default;
+
+    bool operator==(const SettingsMotionGate& rhs) const noexcept;
+    bool operator!=(const SettingsMotionGate& rhs) const noexcept { return !(*this == rhs); }
+
+    void set_analysis_width(size_t value) { m_analysis_width = value; }
+    size_t get_analysis_width() const noexcept { return m_analysis_width; }
+
+    void set_block_size(size_t value) { m_block_size = value; }
+    size_t get_block_size() const noexcept { return m_block_size; }
+
+    void set_pixel_threshold(int value) { m_pixel_threshold = value; }
+    int get_pixel_threshold() const noexcept { return m_pixel_threshold; }
+
+    void set_block_threshold(double value) { m_block_threshold = value; }
+    double get_block_threshold() const noexcept { return m_block_threshold; }
+
+    void set_activate_frames(size_t value) { m_activate_frames = value; }
+    size_t get_activate_frames() const noexcept { return m_activate_frames; }
+
+    void set_deactivate_frames(size_t value) { m_deactivate_frames = value; }
+    size_t get_deactivate_frames() const noexcept { return m_deactivate_frames; }
+
+    void set_idle_interval(size_t value) { m_idle_interval = value; }
+    size_t get_idle_interval() const noexcept { return m_idle_interval; }
+
+    void set_region_margin(size_t value) { m_region_margin = value; }
+    size_t get_region_margin() const noexcept { return m_region_margin; }
+
+    void set_max_region_area(double value) { m_max_region_area = value; }
+    double get_max_region_area() const noexcept { return m_max_region_area; }
+
+public:
+    size_t m_analysis_width{320};
+    size_t m_block_size{8};
+    int m_pixel_threshold{20};
+    double m_block_threshold{0.1};
+    size_t m_activate_frames{1};
+    size_t m_deactivate_frames{25};
+    size_t m_idle_interval{0};
+    size_t m_region_margin{1};
+    double m_max_region_area{0.5};
+};
+
+}  // namespace step::proc
@@ -18,6 +18,10 @@ bool SettingsNeuralOnnxRuntime::operator==(const SettingsNeuralOnnxRuntime& rhs)
         && m_device_type == rhs.m_device_type
         && m_means == rhs.m_means
         && m_norms == rhs.m_norms
+        && m_precision == rhs.m_precision
+        && m_quantization_mode == rhs.m_quantization_mode
+        && m_int8_model_path == rhs.m_int8_model_path
+        && m_calibration_path == rhs.m_calibration_path
     ;
     /* clang-format on */
 }
@@ -44,6 +48,33 @@ void SettingsNeuralOnnxRuntime::deserialize(const ObjectPtrJSON& container)
         json::for_each_in_array<double>(norm_json,
                                         [this](double value) { m_norms.push_back(static_cast<float>(value)); });
     }
+
+    m_precision = ModelPrecision::FP32;
+    if (auto precision = json::get_opt<std::string>(container, CFG_FLD::PRECISION))
+        step::utils::from_string(m_precision, *precision);
+
+    m_quantization_mode = QuantizationMode::Undefined;
+    m_int8_model_path.clear();
+    m_calibration_path.clear();
+    if (m_precision == ModelPrecision::INT8)
+    {
+        step::utils::from_string(m_quantization_mode, json::get<std::string>(container, CFG_FLD::QUANTIZATION));
+        m_int8_model_path = json::get<std::string>(container, CFG_FLD::INT8_MODEL_PATH, std::string());
+        m_calibration_path = json::get<std::string>(container, CFG_FLD::CALIBRATION_PATH, std::string());
+
+        STEP_ASSERT(m_quantization_mode != QuantizationMode::Undefined, "Undefined quantization mode for INT8 model {}",
+                    m_model_path.string());
+        STEP_ASSERT(m_quantization_mode != QuantizationMode::Static || !m_calibration_path.empty(),
+                    "Static quantization of {} requires calibration path", m_model_path.string());
+    }
+}
+
+std::filesystem::path SettingsNeuralOnnxRuntime::get_active_model_path() const
+{
+    if (m_precision != ModelPrecision::INT8)
+        return m_model_path;
+
+    return m_int8_model_path.empty() ? make_int8_model_path(m_model_path) : m_int8_model_path;
 }
 
 std::shared_ptr<task::BaseSettings> create_neural_onnxruntime_settings(const ObjectPtrJSON& cfg)
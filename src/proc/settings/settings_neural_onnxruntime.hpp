@@ -3,6 +3,7 @@
 #include <core/task/base_task.hpp>
 
 #include <proc/interfaces/device_type.hpp>
+#include <proc/interfaces/model_precision.hpp>
 
 #include <filesystem>
 
@@ -30,12 +31,33 @@ public:
     const std::vector<float>& get_norms() const noexcept { return m_norms; }
     void set_norms(const std::vector<float>& values) { m_norms = values; }
 
+    void set_precision(ModelPrecision value) { m_precision = value; }
+    ModelPrecision get_precision() const noexcept { return m_precision; }
+
+    void set_quantization_mode(QuantizationMode value) { m_quantization_mode = value; }
+    QuantizationMode get_quantization_mode() const noexcept { return m_quantization_mode; }
+
+    void set_int8_model_path(const std::filesystem::path& value) { m_int8_model_path = value; }
+    const std::filesystem::path& get_int8_model_path() const noexcept { return m_int8_model_path; }
+
+    void set_calibration_path(const std::filesystem::path& value) { m_calibration_path = value; }
+    const std::filesystem::path& get_calibration_path() const noexcept { return m_calibration_path; }
+
+    /*! @brief Путь к модели, которую нужно загрузить с учетом выбранной точности.
+    */
+    std::filesystem::path get_active_model_path() const;
+
 public:
     std::filesystem::path m_model_path;
     DeviceType m_device_type{DeviceType::Undefined};
 
     std::vector<float> m_means;
     std::vector<float> m_norms;
+
+    ModelPrecision m_precision{ModelPrecision::FP32};
+    QuantizationMode m_quantization_mode{QuantizationMode::Undefined};
+    std::filesystem::path m_int8_model_path;   // пусто - используется "<model>_int8.onnx"
+    std::filesystem::path m_calibration_path;  // калибровочный набор для Static квантования (метаданные)
 };
 
 std::shared_ptr<task::BaseSettings> create_neural_onnxruntime_settings(const ObjectPtrJSON&);
@@ -0,0 +1,58 @@
+#include "settings_tiling_detector.hpp"
+
+#include <core/base/types/config_fields.hpp>
+
+namespace step::proc {
+
+const std::string SettingsTilingDetector::SETTINGS_ID = "SettingsTilingDetector";
+
+bool SettingsTilingDetector::operator==(const SettingsTilingDetector& rhs) const noexcept
+{
+    /* clang-format off */
+    return true
+        && m_detector_cfg == rhs.m_detector_cfg
+        && m_tile_size == rhs.m_tile_size
+        && m_tile_overlap == rhs.m_tile_overlap
+        && m_tile_scales == rhs.m_tile_scales
+        && m_full_frame == rhs.m_full_frame
+        && m_workers == rhs.m_workers
+        && m_nms_threshold == rhs.m_nms_threshold
+    ;
+    /* clang-format on */
+}
+
+void SettingsTilingDetector::deserialize(const ObjectPtrJSON& container)
+{
+    m_detector_cfg = json::get_object(container, CFG_FLD::DETECTOR_SETTINGS);
+    m_tile_size.deserialize(json::get_object(container, CFG_FLD::TILE_SIZE));
+    STEP_ASSERT(m_tile_size.width > 0 && m_tile_size.height > 0, "Invalid tile size: {}", m_tile_size);
+
+    m_tile_overlap = json::get_opt<double>(container, CFG_FLD::TILE_OVERLAP).value_or(0.2);
+    STEP_ASSERT(m_tile_overlap >= 0 && m_tile_overlap < 1, "Invalid tile overlap: {}", m_tile_overlap);
+
+    m_tile_scales.clear();
+    if (auto scales_json = json::opt_array(container, CFG_FLD::TILE_SCALES))
+    {
+        m_tile_scales.reserve(scales_json->size());
+        json::for_each_in_array<double>(scales_json, [this](double value) {
+            STEP_ASSERT(value > 0, "Invalid tile scale: {}", value);
+            m_tile_scales.push_back(value);
+        });
+    }
+    if (m_tile_scales.empty())
+        m_tile_scales.push_back(1.0);
+
+    m_full_frame = json::get_opt<bool>(container, CFG_FLD::TILE_FULL_FRAME).value_or(true);
+    m_workers = std::max<size_t>(json::get_opt<size_t>(container, CFG_FLD::TILE_WORKERS).value_or(1), 1);
+    m_nms_threshold = json::get_opt<double>(container, CFG_FLD::NMS_THRESHOLD).value_or(0.5);
+}
+
+std::shared_ptr<task::BaseSettings> create_tiling_detector_settings(const ObjectPtrJSON& cfg)
+{
+    auto settings = std::make_shared<SettingsTilingDetector>();
+    settings->deserialize(cfg);
+
+    return settings;
+}
+
+}  // namespace step::proc
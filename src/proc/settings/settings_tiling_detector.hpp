@@ -0,0 +1,61 @@
+#pragma once
+
+#include <core/task/base_task.hpp>
+
+#include <video/frame/interfaces/frame_size.hpp>
+
+#include <vector>
+
+namespace step::proc {
+
+/*! @brief Детектор по тайлам кадра поверх любого IDetector.
+    @details detector_cfg - настройки внутреннего детектора. tile_size - размер тайла в пикселях кадра
+    при масштабе 1, для масштаба s тайл покрывает tile_size / s пикселей кадра (внутренний детектор
+    сам приводит тайл к размеру входа сети). tile_overlap - доля перекрытия соседних тайлов.
+    tile_workers - число экземпляров внутреннего детектора, обрабатывающих тайлы одновременно. Детектор
+    face engine по conn_id в каждом экземпляре, кроме первого, загружает собственный экземпляр движка.
+*/
+class SettingsTilingDetector : public task::BaseSettings
+{
+public:
+    TASK_SETTINGS(SettingsTilingDetector)
+
+    SettingsTilingDetector() = default;
+
+    bool operator==(const SettingsTilingDetector& rhs) const noexcept;
+    bool operator!=(const SettingsTilingDetector& rhs) const noexcept { return !(*this == rhs); }
+
+    void set_detector_cfg(const ObjectPtrJSON& value) { m_detector_cfg = value; }
+    const ObjectPtrJSON& get_detector_cfg() const noexcept { return m_detector_cfg; }
+
+    void set_tile_size(const video::FrameSize& value) { m_tile_size = value; }
+    const video::FrameSize& get_tile_size() const noexcept { return m_tile_size; }
+
+    void set_tile_overlap(double value) { m_tile_overlap = value; }
+    double get_tile_overlap() const noexcept { return m_tile_overlap; }
+
+    void set_tile_scales(const std::vector<double>& value) { m_tile_scales = value; }
+    const std::vector<double>& get_tile_scales() const noexcept { return m_tile_scales; }
+
+    void set_full_frame(bool value) { m_full_frame = value; }
+    bool get_full_frame() const noexcept { return m_full_frame; }
+
+    void set_workers(size_t value) { m_workers = value; }
+    size_t get_workers() const noexcept { return m_workers; }
+
+    void set_nms_threshold(double value) { m_nms_threshold = value; }
+    double get_nms_threshold() const noexcept { return m_nms_threshold; }
+
+public:
+    ObjectPtrJSON m_detector_cfg;
+    video::FrameSize m_tile_size;
+    double m_tile_overlap{0.2};
+    std::vector<double> m_tile_scales{1.0};
+    bool m_full_frame{true};  // Дополнительно весь кадр целиком - для крупных объектов
+    size_t m_workers{1};
+    double m_nms_threshold{0.5};
+};
+
+std::shared_ptr<task::BaseSettings> create_tiling_detector_settings(const ObjectPtrJSON&);
+
+}  // namespace step::proc
@@ -0,0 +1,417 @@
+#include "ingest_manager.hpp"
+
+#include <core/base/types/config_fields.hpp>
+#include <core/base/json/json_utils.hpp>
+#include <core/base/utils/string_utils.hpp>
+#include <core/exception/assert.hpp>
+#include <core/log/log.hpp>
+
+#include <core/task/settings_factory.hpp>
+
+#include <proc/pipeline/pipeline_profiler.hpp>
+#include <proc/settings/settings_video_processor_task.hpp>
+
+#include <algorithm>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+step::Microseconds elapsed(Clock::time_point start, Clock::time_point finish = Clock::now())
+{
+    return std::chrono::duration_cast<step::Microseconds>(finish - start);
+}
+
+double get_fps(uint64_t frames, step::Microseconds time)
+{
+    return time.count() > 0 ? static_cast<double>(frames) * 1'000'000.0 / static_cast<double>(time.count()) : 0.0;
+}
+
+}  // namespace
+
+namespace step::proc {
+
+struct IngestManager::Stream : public video::IFrameSourceObserver
+{
+    struct QueuedFrame
+    {
+        video::FramePtr frame;
+        Clock::time_point arrival;
+    };
+
+    Stream(IngestManager& manager, const IngestStreamSettings& settings)
+        : manager(manager), settings(settings), frames(settings.policy, settings.queue_size)
+    {
+    }
+
+    void process_frame(video::FramePtr frame) override { manager.push_frame(*this, std::move(frame)); }
+
+    IngestManager& manager;
+    const IngestStreamSettings settings;
+    video::IFrameSource* source{nullptr};
+    std::unique_ptr<video::ff::FileFrameSource> file;
+
+    threading::DeliveryQueue<QueuedFrame> frames;
+
+    size_t index{0};  ///< индекс в m_streams и в планировщике
+    std::unique_ptr<FrameSyncPipeline> pipeline;
+    size_t first_face_engine_user{0}, last_face_engine_user{0};  ///< узлы пайплайна среди пользователей face engine
+    IFaceEngine* face_engine{nullptr};  ///< к которому подключены узлы, меняет только обрабатывающий поток
+
+    // Под m_guard менеджера
+    bool busy{false};
+    bool finished{false};
+
+    uint64_t received{0};
+    uint64_t load_frames{0};  ///< счетчик для прореживания детекции регулятором нагрузки
+    uint64_t processed{0};
+    uint64_t exceptions{0};
+    Microseconds busy_time{0};
+    LatencyHistogram latency;
+};
+
+void IngestStreamSettings::deserialize(const ObjectPtrJSON& container)
+{
+    id = json::get<std::string>(container, CFG_FLD::ID);
+    filename = json::get<std::string>(container, CFG_FLD::FILENAME, "");
+    priority = json::get<double>(container, CFG_FLD::STREAM_PRIORITY, 1.0);
+    queue_size = std::max<size_t>(json::get<size_t>(container, CFG_FLD::STREAM_QUEUE_SIZE, 4), 1);
+    policy = threading::DeliveryPolicy::DropOldest;
+    if (auto policy_str = json::get_opt<std::string>(container, CFG_FLD::INPUT_POLICY))
+        utils::from_string(policy, *policy_str);
+    STEP_ASSERT(policy != threading::DeliveryPolicy::Undefined, "Ingest manager: invalid input policy of stream {}",
+                id);
+}
+
+IngestManager::IngestManager(const ObjectPtrJSON& cfg)
+    : IFaceEngineController(json::get_object(cfg, CFG_FLD::FACE_ENGINE_CONTROLLER))
+{
+    if (auto reader_cfg = json::opt_object(cfg, CFG_FLD::READER_FF_SETTINGS))
+        m_source_settings.deserialize(reader_cfg);
+
+    auto ingest_cfg = json::get_object(cfg, CFG_FLD::INGEST_MANAGER);
+    m_workers_count = json::get<size_t>(ingest_cfg, CFG_FLD::INGEST_WORKERS, 0);
+    if (m_workers_count == 0)
+        m_workers_count = std::max(std::thread::hardware_concurrency(), 1u);
+
+    // Узлы пайплайна подключаются к face engine через коннектор, источник должен быть уже зарегистрирован
+    Connector::register_conn_source(this);
+
+    auto settings = CREATE_SETTINGS(json::get_object(cfg, CFG_FLD::VIDEO_PROCESSOR));
+    auto processor_settings = std::dynamic_pointer_cast<SettingsVideoProcessorTask>(settings);
+    STEP_ASSERT(processor_settings, "Invalid video processor settings for ingest manager");
+    m_pipeline_cfg = processor_settings->get_pipeline_cfg();
+
+    // Первый рабочий поток работает с основным face engine, остальные - каждый со своим экземпляром
+    if (m_face_engine)
+    {
+        m_worker_face_engines.push_back(m_face_engine);
+        while (m_worker_face_engines.size() < m_workers_count)
+            m_worker_face_engines.push_back(create_face_engine_instance());
+    }
+
+    if (auto load_control_cfg = json::opt_object(ingest_cfg, CFG_FLD::LOAD_CONTROL))
+    {
+        LoadControlSettings load_control;
+        load_control.deserialize(load_control_cfg);
+        m_load_controller = std::make_unique<LoadController>(load_control, "ingest");
+    }
+
+    if (auto streams_json = json::opt_array(ingest_cfg, CFG_FLD::INGEST_STREAMS))
+    {
+        json::for_each_in_array<ObjectPtrJSON>(streams_json, [this](const ObjectPtrJSON& stream_cfg) {
+            IngestStreamSettings stream_settings;
+            stream_settings.deserialize(stream_cfg);
+            add_stream(stream_settings);
+        });
+    }
+}
+
+IngestManager::~IngestManager() { stop(); }
+
+void IngestManager::add_stream(const IngestStreamSettings& settings, video::IFrameSource* source)
+{
+    STEP_ASSERT(m_stopped, "Ingest manager: streams can't be added while running");
+    STEP_ASSERT(settings.priority > 0.0, "Ingest manager: invalid priority {} of stream {}", settings.priority,
+                settings.id);
+    STEP_ASSERT(!settings.filename.empty() || source, "Ingest manager: no frame source for stream {}", settings.id);
+
+    auto stream = std::make_unique<Stream>(*this, settings);
+    stream->index = m_scheduler.add_stream(settings.priority);
+    STEP_ASSERT(stream->index == m_streams.size(), "Ingest manager: scheduler is out of sync with streams");
+
+    stream->first_face_engine_user = get_users_count();
+    stream->pipeline = FrameSyncPipeline::create(m_pipeline_cfg);
+    stream->last_face_engine_user = get_users_count();
+
+    if (settings.filename.empty())
+        stream->source = source;
+    else
+        stream->file = std::make_unique<video::ff::FileFrameSource>(settings.filename, m_source_settings);
+
+    m_streams.push_back(std::move(stream));
+}
+
+void IngestManager::set_result_callback(ResultCallback callback)
+{
+    STEP_ASSERT(m_stopped, "Ingest manager: result callback can't be changed while running");
+    m_result_callback = std::move(callback);
+}
+
+void IngestManager::start()
+{
+    {
+        std::scoped_lock lock(m_guard);
+        if (!m_stopped)
+            return;
+
+        m_stopped = false;
+        m_start_time = Clock::now();
+    }
+
+    for (auto& stream : m_streams)
+    {
+        stream->frames.restart();
+        if (stream->source)
+            stream->source->register_observer(stream.get());
+    }
+
+    for (size_t i = 0; i < m_workers_count; ++i)
+        m_workers.emplace_back(&IngestManager::worker_routine, this, i);
+
+    STEP_LOG(L_INFO, "Ingest manager started: {} streams, {} workers", m_streams.size(), m_workers_count);
+}
+
+void IngestManager::stop()
+{
+    {
+        std::scoped_lock lock(m_guard);
+        if (m_stopped)
+            return;
+
+        m_stopped = true;
+        m_ready_cv.notify_all();
+        m_files_cv.notify_all();
+    }
+
+    for (auto& stream : m_streams)
+    {
+        // Будит источник, ждущий места в очереди (policy queue), оставшиеся кадры идут в потерянные
+        stream->frames.stop();
+        if (stream->source)
+            stream->source->unregister_observer(stream.get());
+        if (stream->file)
+            stream->file->terminate();
+    }
+
+    for (auto& worker : m_workers)
+        worker.join();
+    m_workers.clear();
+}
+
+void IngestManager::wait_files_finished()
+{
+    std::unique_lock lock(m_guard);
+    m_files_cv.wait(lock, [this]() {
+        return m_stopped || std::all_of(m_streams.begin(), m_streams.end(), [](const auto& stream) {
+                   return !stream->file || (stream->finished && !stream->busy);
+               });
+    });
+}
+
+void IngestManager::push_frame(Stream& stream, video::FramePtr frame)
+{
+    if (!frame)
+        return;
+
+    // С политикой queue источник может ждать места, поэтому без m_guard
+    if (stream.frames.push({std::move(frame), Clock::now()}) == threading::DeliveryResult::Stopped)
+        return;
+
+    std::scoped_lock lock(m_guard);
+    ++stream.received;
+
+    // Простой без кадров не копит долг: поток возвращается в очередь с текущим виртуальным временем
+    if (!stream.busy && stream.frames.size() == 1)
+        m_scheduler.resume(stream.index);
+
+    m_ready_cv.notify_one();
+}
+
+bool IngestManager::is_ready(const Stream& stream) const
+{
+    return !stream.busy && (!stream.frames.empty() || (stream.file && !stream.finished));
+}
+
+LoadShedding IngestManager::get_load_shedding(Stream& stream)
+{
+    // Под m_guard
+    const auto now = Clock::now();
+    if (m_load_controller->need_sample(now))
+    {
+        double queue_fill = 0.0;
+        uint64_t dropped = 0;
+        for (const auto& item : m_streams)
+        {
+            queue_fill = std::max(queue_fill, static_cast<double>(item->frames.size()) / item->settings.queue_size);
+            dropped += item->frames.get_stats().dropped;
+        }
+        m_load_controller->update(m_load_controller->make_sample(get_profilers(), queue_fill, dropped, now));
+    }
+
+    return m_load_controller->get_shedding(stream.settings.priority, stream.load_frames);
+}
+
+IngestManager::Stream* IngestManager::pick_stream()
+{
+    const auto index = m_scheduler.pick([this](size_t i) { return is_ready(*m_streams[i]); });
+    return index ? m_streams[*index].get() : nullptr;
+}
+
+void IngestManager::worker_routine(size_t worker_index)
+{
+    const auto face_engine = m_worker_face_engines.empty() ? nullptr : m_worker_face_engines[worker_index];
+
+    std::unique_lock lock(m_guard);
+    while (true)
+    {
+        Stream* stream = nullptr;
+        m_ready_cv.wait(lock, [this, &stream]() { return m_stopped || (stream = pick_stream()) != nullptr; });
+        if (m_stopped)
+            break;
+
+        stream->busy = true;
+        m_scheduler.start(stream->index);
+
+        Stream::QueuedFrame queued;
+        if (auto next = stream->frames.try_pop())
+            queued = std::move(*next);
+
+        std::optional<LoadShedding> shedding;
+        if (m_load_controller)
+            shedding = get_load_shedding(*stream);
+        lock.unlock();
+
+        // Узлы пайплайна потока вызывают face engine рабочего потока, который сейчас обрабатывает поток
+        if (face_engine && stream->face_engine != face_engine.get())
+        {
+            set_users_face_engine(stream->first_face_engine_user, stream->last_face_engine_user, face_engine);
+            stream->face_engine = face_engine.get();
+        }
+
+        const auto start = Clock::now();
+        const bool from_source = !!queued.frame;
+        bool failed = false;
+        if (!from_source)
+        {
+            queued.arrival = start;
+            try
+            {
+                queued.frame = stream->file->read_frame();
+            }
+            catch (const std::exception& e)
+            {
+                STEP_LOG(L_ERROR, "Ingest manager: stream {}: decoding failed, stream is finished: {}",
+                         stream->settings.id, e.what());
+                failed = true;
+            }
+        }
+
+        if (queued.frame)
+        {
+            // Кадр внешнего источника могут держать другие наблюдатели, декодированный - только мы
+            auto data = from_source ? VideoProcessorInfo::create(*queued.frame)
+                                    : VideoProcessorInfo::create(std::move(*queued.frame));
+            if (shedding)
+                data->storage.set_attachment(CFG_FLD::LOAD_SHEDDING, std::make_any<LoadShedding>(*shedding));
+            try
+            {
+                stream->pipeline->process(data);
+                if (m_result_callback)
+                    m_result_callback(stream->settings.id, *data);
+            }
+            catch (const std::exception& e)
+            {
+                STEP_LOG(L_ERROR, "Ingest manager: stream {}: handled exception due frame {} processing: {}",
+                         stream->settings.id, data->data.ts.count(), e.what());
+                failed = true;
+            }
+        }
+
+        const auto finish = Clock::now();
+        if (queued.frame)
+            stream->latency.record(elapsed(queued.arrival, finish));
+
+        lock.lock();
+        const auto cost = elapsed(start, finish);
+        stream->busy = false;
+        stream->busy_time += cost;
+        m_scheduler.charge(stream->index, cost);
+        stream->exceptions += failed ? 1 : 0;
+        if (queued.frame && !failed)
+            ++stream->processed;
+
+        if (!from_source)
+        {
+            if (queued.frame)
+                ++stream->received;
+            else
+                stream->finished = true;
+        }
+
+        m_ready_cv.notify_one();
+        if (stream->finished)
+            m_files_cv.notify_all();
+    }
+}
+
+std::vector<IngestStreamStats> IngestManager::get_stats() const
+{
+    std::scoped_lock lock(m_guard);
+    const auto running_time = elapsed(m_start_time);
+
+    std::vector<IngestStreamStats> result;
+    result.reserve(m_streams.size());
+    for (const auto& stream : m_streams)
+    {
+        IngestStreamStats stats;
+        stats.id = stream->settings.id;
+        stats.priority = stream->settings.priority;
+        stats.received = stream->received;
+        stats.processed = stream->processed;
+        stats.dropped = stream->frames.get_stats().dropped;
+        stats.exceptions = stream->exceptions;
+        stats.input_fps = get_fps(stream->received, running_time);
+        stats.output_fps = get_fps(stream->processed, running_time);
+        stats.latency_mean = stream->latency.mean();
+        stats.latency_p95 = stream->latency.percentile(0.95);
+        stats.latency_max = stream->latency.max();
+        stats.busy_time = stream->busy_time;
+        stats.finished = stream->finished;
+        result.push_back(std::move(stats));
+    }
+    return result;
+}
+
+std::vector<PipelineProfilerPtr> IngestManager::get_profilers() const
+{
+    std::vector<PipelineProfilerPtr> profilers;
+    for (const auto& stream : m_streams)
+        profilers.push_back(stream->pipeline->get_profiler());
+    return profilers;
+}
+
+void IngestManager::log_report() const
+{
+    for (const auto& stats : get_stats())
+    {
+        STEP_LOG(L_INFO,
+                 "Ingest stream {} (priority {}): in {:.1f} fps, out {:.1f} fps; received {}, processed {}, "
+                 "dropped {}, exceptions {}; latency us mean/p95/max {}/{}/{}; busy {} us{}",
+                 stats.id, stats.priority, stats.input_fps, stats.output_fps, stats.received, stats.processed,
+                 stats.dropped, stats.exceptions, stats.latency_mean.count(), stats.latency_p95.count(),
+                 stats.latency_max.count(), stats.busy_time.count(), stats.finished ? ", finished" : "");
+    }
+}
+
+}  // namespace step::proc
@@ -0,0 +1,132 @@
+#pragma once
+
+#include <core/base/types/time.hpp>
+
+#include <video/ffmpeg/reader/file_frame_source.hpp>
+#include <video/frame/interfaces/frame_interfaces.hpp>
+
+#include <core/threading/delivery_queue.hpp>
+
+#include <proc/interfaces/face_engine_controller.hpp>
+#include <proc/interfaces/video_processor_interface.hpp>
+#include <proc/pipeline/impl/frame_pipeline.hpp>
+#include <proc/pipeline/load_controller.hpp>
+#include <proc/video/stream_scheduler.hpp>
+
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace step::proc {
+
+/*! @brief Настройки одного входного потока.
+*/
+struct IngestStreamSettings : public ISerializable
+{
+    std::string id;
+    std::string filename;  ///< пусто - кадры приходят от источника, переданного в add_stream
+    double priority{1.0};  ///< доля обработки пропорциональна приоритету
+    size_t queue_size{4};
+    threading::DeliveryPolicy policy{threading::DeliveryPolicy::DropOldest};  ///< что делать при переполнении
+
+    void deserialize(const ObjectPtrJSON& container) override;
+};
+
+/*! @brief Статистика потока с момента start.
+*/
+struct IngestStreamStats
+{
+    std::string id;
+    double priority{1.0};
+    uint64_t received{0};  ///< пришло от источника или декодировано из файла
+    uint64_t processed{0};
+    uint64_t dropped{0};   ///< вытеснено из очереди или осталось в ней при остановке
+    uint64_t exceptions{0};
+    double input_fps{0.0};
+    double output_fps{0.0};
+    Microseconds latency_mean{0}, latency_p95{0}, latency_max{0};  ///< от поступления кадра до результата
+    Microseconds busy_time{0};  ///< время рабочих потоков, потраченное на поток
+    bool finished{false};       ///< файл дочитан до конца
+};
+
+/*! @brief Обработка многих входных потоков (камер, файлов) общим пулом рабочих потоков.
+    @details У каждого входного потока свой пайплайн: узлы с состоянием (MotionGate, треки FaceQualityFilter)
+    видят кадры только своей камеры, по одному и по порядку. Face engine, самые тяжелые модели,
+    создается на рабочий поток, а не на камеру: перед кадром узлы пайплайна потока подключаются к движку
+    взявшего его рабочего потока. Файловые потоки декодируются теми же рабочими потоками.
+
+    Планирование - взвешенная справедливая очередь (StreamScheduler): свободный рабочий поток берет готовый
+    поток с наименьшим виртуальным временем, доли обработки пропорциональны приоритетам, простой без кадров
+    не копит долг.
+
+    Конфигурация совпадает с VideoProcessingManager, плюс секция ingest_manager:
+    workers (0 - по числу ядер) и streams - массив {id, filename, priority, queue_size, input_policy}.
+    Необязательная load_control включает общий для всех потоков регулятор нагрузки (LoadController):
+    при перегрузке снижается качество обработки, распознавание отключается у потоков с приоритетом ниже
+    low_priority.
+*/
+class IngestManager : public IFaceEngineController
+{
+public:
+    using ResultCallback = std::function<void(const std::string& stream_id, const VideoProcessorInfo&)>;
+
+public:
+    IngestManager(const ObjectPtrJSON& cfg);
+    ~IngestManager();
+
+    /*! @brief Добавляет поток, до start. Без filename кадры берутся от source как от наблюдаемого источника.
+    */
+    void add_stream(const IngestStreamSettings& settings, video::IFrameSource* source = nullptr);
+
+    /*! @brief Вызывается из рабочих потоков для каждого обработанного кадра.
+    */
+    void set_result_callback(ResultCallback callback);
+
+    void start();
+    void stop();
+
+    /*! @brief Ждет, пока все файловые потоки будут дочитаны и обработаны.
+        @details Потоки от внешних источников не ждет, их очереди могут быть не пусты.
+    */
+    void wait_files_finished();
+
+    size_t get_workers_count() const noexcept { return m_workers_count; }
+    std::vector<IngestStreamStats> get_stats() const;
+    std::vector<PipelineProfilerPtr> get_profilers() const;
+    void log_report() const;
+
+private:
+    struct Stream;
+
+    void push_frame(Stream& stream, video::FramePtr frame);
+    void worker_routine(size_t worker_index);
+    Stream* pick_stream();
+    bool is_ready(const Stream& stream) const;
+    LoadShedding get_load_shedding(Stream& stream);
+
+private:
+    ObjectPtrJSON m_pipeline_cfg;
+    video::ff::FileFrameSourceSettings m_source_settings;
+    ResultCallback m_result_callback;
+
+    size_t m_workers_count{1};
+    std::vector<std::shared_ptr<IFaceEngine>> m_worker_face_engines;  ///< по одному на рабочий поток
+    std::vector<std::thread> m_workers;
+
+    std::vector<std::unique_ptr<Stream>> m_streams;
+    std::unique_ptr<LoadController> m_load_controller;
+    mutable std::mutex m_guard;
+    std::condition_variable m_ready_cv;
+    std::condition_variable m_files_cv;
+    StreamScheduler m_scheduler;  ///< под m_guard
+    bool m_stopped{true};
+    std::chrono::steady_clock::time_point m_start_time;
+};
+
+}  // namespace step::proc
@@ -0,0 +1,430 @@
+#include "offline_analyzer.hpp"
+
+#include <core/base/types/config_fields.hpp>
+#include <core/base/json/json_utils.hpp>
+
+#include <core/task/settings_factory.hpp>
+
+#include <video/ffmpeg/reader/file_frame_source.hpp>
+
+#include <proc/interfaces/detector_interface.hpp>
+#include <proc/interfaces/face.hpp>
+#include <proc/interfaces/video_processor_interface.hpp>
+#include <proc/settings/settings_video_processor_task.hpp>
+
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <fstream>
+#include <mutex>
+#include <thread>
+
+namespace {
+
+constexpr std::string_view RESULTS_FORMAT_HEADER = "# seekira offline results v1";
+constexpr size_t FRAME_QUEUE_SIZE = 8;  // сглаживает разброс времени кадров между декодером и пайплайном
+
+using Clock = std::chrono::steady_clock;
+
+step::Microseconds elapsed(Clock::time_point start, Clock::time_point finish = Clock::now())
+{
+    return std::chrono::duration_cast<step::Microseconds>(finish - start);
+}
+
+}  // namespace
+
+namespace step::proc {
+
+namespace {
+
+/*! @brief Ограниченная очередь кадров между потоком декодирования и пайплайном.
+    @details nullptr в очереди - конец файла.
+*/
+class FrameQueue
+{
+public:
+    FrameQueue(size_t capacity) : m_capacity(std::max<size_t>(capacity, 1)) {}
+
+    bool push(video::FramePtr frame)
+    {
+        std::unique_lock lock(m_guard);
+        m_not_full.wait(lock, [this]() { return m_stopped || m_frames.size() < m_capacity; });
+        if (m_stopped)
+            return false;
+
+        m_frames.push_back(std::move(frame));
+        m_not_empty.notify_one();
+        return true;
+    }
+
+    video::FramePtr pop()
+    {
+        std::unique_lock lock(m_guard);
+        m_not_empty.wait(lock, [this]() { return !m_frames.empty(); });
+
+        auto frame = std::move(m_frames.front());
+        m_frames.pop_front();
+        m_not_full.notify_one();
+        return frame;
+    }
+
+    void stop()
+    {
+        std::scoped_lock lock(m_guard);
+        m_stopped = true;
+        m_frames.clear();
+        m_not_full.notify_all();
+    }
+
+private:
+    const size_t m_capacity;
+    std::mutex m_guard;
+    std::condition_variable m_not_empty;
+    std::condition_variable m_not_full;
+    std::deque<video::FramePtr> m_frames;
+    bool m_stopped{false};
+};
+
+class ResultsWriter
+{
+public:
+    ResultsWriter(std::ostream& stream) : m_stream(stream) {}
+
+    void write_header(const std::string& filename)
+    {
+        m_stream << RESULTS_FORMAT_HEADER << '\n';
+        m_stream << "# file\t" << filename << '\n';
+        m_stream << "# ts_us\ttype\tx0\ty0\tx1\ty1\tscore\tmatch\n";
+    }
+
+    void write(const VideoProcessorInfo& info, OfflineAnalysisStats& stats)
+    {
+        const auto ts = info.data.ts.count();
+
+        if (auto faces_result = info.storage.get_attachment<DetectionResult>(CFG_FLD::FACE_DETECTION_RESULT))
+        {
+            const auto faces = faces_result->data().get_attachment<Faces>(CFG_FLD::FACES);
+            for (const auto& face : faces.value_or(Faces()))
+            {
+                const auto match_status = face->get_match_status();
+                if (match_status == FaceMatchStatus::Matched || match_status == FaceMatchStatus::Possible)
+                    ++stats.matched_faces;
+
+                write_object(ts, 'F', face->get_rect(), face->get_confidence());
+                m_stream << '\t' << static_cast<int>(match_status) << '\n';
+            }
+            stats.faces += faces ? faces->size() : 0;
+        }
+
+        if (auto persons_result = info.storage.get_attachment<DetectionResult>(CFG_FLD::PERSON_DETECTION_RESULT))
+        {
+            const auto& bboxes = persons_result->bboxes();
+            const auto scores = persons_result->data().get_attachment<std::vector<double>>(CFG_FLD::DETECTION_SCORES);
+            for (size_t i = 0; i < bboxes.size(); ++i)
+            {
+                const auto score = (scores && i < scores->size()) ? (*scores)[i] : 0.0;
+                write_object(ts, 'P', bboxes[i], score);
+                m_stream << '\n';
+            }
+            stats.persons += bboxes.size();
+        }
+    }
+
+    void write_footer(const OfflineAnalysisStats& stats)
+    {
+        m_stream << "# frames\t" << stats.frames << '\n';
+        m_stream.flush();
+        if (!m_stream)
+            STEP_THROW_RUNTIME("Failed to write results for file {}", stats.filename);
+    }
+
+private:
+    void write_object(int64_t ts, char type, const Rect& rect, double score)
+    {
+        m_stream << ts << '\t' << type << '\t' << rect.p0.x << '\t' << rect.p0.y << '\t' << rect.p1.x << '\t'
+                 << rect.p1.y << '\t' << score;
+    }
+
+private:
+    std::ostream& m_stream;
+};
+
+}  // namespace
+
+double OfflineAnalysisStats::get_fps(Microseconds time) const noexcept
+{
+    return time.count() > 0 ? static_cast<double>(frames) * 1'000'000.0 / static_cast<double>(time.count()) : 0.0;
+}
+
+void OfflineAnalysisStats::append(const OfflineAnalysisStats& segment_stats)
+{
+    frames += segment_stats.frames;
+    warmup_frames += segment_stats.warmup_frames;
+    faces += segment_stats.faces;
+    persons += segment_stats.persons;
+    matched_faces += segment_stats.matched_faces;
+    decode_time += segment_stats.decode_time;
+    analysis_time += segment_stats.analysis_time;
+    decode_wait += segment_stats.decode_wait;
+}
+
+OfflineAnalyzer::OfflineAnalyzer(const ObjectPtrJSON& cfg)
+    : IFaceEngineController(json::opt_object(cfg, CFG_FLD::FACE_ENGINE_CONTROLLER))
+{
+    // Задержка выдачи кадров здесь не важна, по умолчанию декодер занимает все ядра
+    m_source_settings.decoder.threads = 0;
+    if (auto reader_cfg = json::opt_object(cfg, CFG_FLD::READER_FF_SETTINGS))
+        m_source_settings.deserialize(reader_cfg);
+
+    if (auto analyzer_cfg = json::opt_object(cfg, CFG_FLD::OFFLINE_ANALYZER))
+    {
+        set_segment_workers(json::get<size_t>(analyzer_cfg, CFG_FLD::SEGMENT_WORKERS, 1));
+        m_segment_warmup = json::get<video::ff::TimeFF>(analyzer_cfg, CFG_FLD::SEGMENT_WARMUP, 0) * 1000;
+    }
+
+    // Узлы пайплайна подключаются к face engine через коннектор, источник должен быть уже зарегистрирован
+    Connector::register_conn_source(this);
+
+    auto settings = CREATE_SETTINGS(json::get_object(cfg, CFG_FLD::VIDEO_PROCESSOR));
+    auto processor_settings = std::dynamic_pointer_cast<SettingsVideoProcessorTask>(settings);
+    STEP_ASSERT(processor_settings, "Invalid video processor settings for offline analyzer");
+
+    m_pipeline_cfg = processor_settings->get_pipeline_cfg();
+    prepare_pipelines(1);
+}
+
+std::vector<PipelineProfilerPtr> OfflineAnalyzer::get_profilers() const
+{
+    std::vector<PipelineProfilerPtr> profilers;
+    for (const auto& pipeline : m_pipelines)
+        profilers.push_back(pipeline->get_profiler());
+    return profilers;
+}
+
+void OfflineAnalyzer::prepare_pipelines(size_t count)
+{
+    while (m_pipelines.size() < count)
+    {
+        const auto first_user = get_users_count();
+        m_pipelines.push_back(FrameSyncPipeline::create(m_pipeline_cfg));
+
+        // Первый пайплайн работает с основным face engine, остальные - каждый со своим экземпляром
+        if (m_pipelines.size() > 1 && m_face_engine)
+        {
+            m_worker_face_engines.push_back(create_face_engine_instance());
+            set_users_face_engine(first_user, get_users_count(), m_worker_face_engines.back());
+        }
+    }
+}
+
+std::vector<video::ff::VideoSegment> OfflineAnalyzer::plan_segments(
+    const std::string& filename, std::vector<video::ff::KeyframeIndex::Entry>& keyframes)
+{
+    video::ff::ParserFF parser;
+    parser.set_io_settings(m_source_settings.io);
+    if (!parser.open_file(filename))
+        STEP_THROW_RUNTIME("Offline analyzer: failed to open file {}", filename);
+
+    if (!parser.build_keyframe_index())
+    {
+        STEP_LOG(L_WARN, "Offline analyzer: no keyframe index for {}, file is processed as one segment", filename);
+        return {video::ff::VideoSegment()};
+    }
+
+    keyframes = parser.get_keyframe_index().get_entries();
+    std::vector<video::ff::TimestampFF> keyframe_times;
+    keyframe_times.reserve(keyframes.size());
+    for (const auto& keyframe : keyframes)
+        keyframe_times.push_back(keyframe.pts);
+
+    return video::ff::split_into_segments(keyframe_times, parser.get_duration(), m_segment_workers, m_segment_warmup);
+}
+
+OfflineAnalysisStats OfflineAnalyzer::analyze(const std::string& filename, const std::filesystem::path& results_path)
+{
+    const auto start_time = Clock::now();
+
+    std::vector<video::ff::KeyframeIndex::Entry> keyframes;
+    const auto segments =
+        (m_segment_workers > 1) ? plan_segments(filename, keyframes) : std::vector{video::ff::VideoSegment()};
+    prepare_pipelines(segments.size());
+
+    std::ofstream results(results_path);
+    if (!results)
+        STEP_THROW_RUNTIME("Can't open results file {}", results_path.string());
+
+    ResultsWriter writer(results);
+    writer.write_header(filename);
+
+    OfflineAnalysisStats stats;
+    stats.filename = filename;
+    stats.segments = segments.size();
+
+    if (segments.size() == 1)
+    {
+        stats.append(analyze_segment(filename, segments.front(), keyframes, *m_pipelines.front(), results));
+    }
+    else
+    {
+        // Сегменты пишут во временные файлы, склеиваются по порядку: строки остаются отсортированы по ts
+        std::vector<std::filesystem::path> part_paths(segments.size());
+        std::vector<OfflineAnalysisStats> segment_stats(segments.size());
+        std::vector<std::exception_ptr> exceptions(segments.size());
+        std::vector<std::thread> workers;
+        for (size_t i = 0; i < segments.size(); ++i)
+        {
+            part_paths[i] = results_path;
+            part_paths[i] += fmt::format(".part{}", i);
+            workers.emplace_back([&, i]() {
+                try
+                {
+                    std::ofstream part(part_paths[i]);
+                    if (!part)
+                        STEP_THROW_RUNTIME("Can't open results file {}", part_paths[i].string());
+                    segment_stats[i] = analyze_segment(filename, segments[i], keyframes, *m_pipelines[i], part);
+                }
+                catch (...)
+                {
+                    exceptions[i] = std::current_exception();
+                }
+            });
+        }
+        for (auto& worker : workers)
+            worker.join();
+
+        for (size_t i = 0; i < segments.size(); ++i)
+        {
+            if (!exceptions[i])
+            {
+                std::ifstream part(part_paths[i]);
+                if (part.peek() != std::ifstream::traits_type::eof())
+                    results << part.rdbuf();
+            }
+            std::error_code ec;
+            std::filesystem::remove(part_paths[i], ec);
+            stats.append(segment_stats[i]);
+        }
+
+        for (const auto& exception : exceptions)
+        {
+            if (exception)
+                std::rethrow_exception(exception);
+        }
+    }
+
+    stats.wall_time = elapsed(start_time);
+    writer.write_footer(stats);
+
+    STEP_LOG(L_INFO,
+             "Offline analyzer: file {}: {} frames in {} segments ({} warmup), decode {:.1f} fps, "
+             "analysis {:.1f} fps, total {:.1f} fps; waiting for decoder {} us",
+             filename, stats.frames, stats.segments, stats.warmup_frames, stats.get_fps(stats.decode_time),
+             stats.get_fps(stats.analysis_time), stats.get_fps(stats.wall_time), stats.decode_wait.count());
+
+    return stats;
+}
+
+OfflineAnalysisStats OfflineAnalyzer::analyze_segment(const std::string& filename,
+                                                      const video::ff::VideoSegment& segment,
+                                                      const std::vector<video::ff::KeyframeIndex::Entry>& keyframes,
+                                                      FrameSyncPipeline& pipeline, std::ostream& results)
+{
+    OfflineAnalysisStats stats;
+    stats.filename = filename;
+
+    video::ff::FileFrameSource source(filename, m_source_settings);
+
+    // Индекс уже построен при разбиении: seek на начало прогрева попадает точно в ключевой кадр
+    if (!keyframes.empty())
+        source.set_keyframe_index(keyframes);
+
+    if (segment.warmup_start != AV_NOPTS_VALUE && !source.seek(segment.warmup_start))
+        STEP_THROW_RUNTIME("Offline analyzer: invalid seek to {}, file {}", segment.warmup_start, filename);
+
+    ResultsWriter writer(results);
+
+    FrameQueue queue(FRAME_QUEUE_SIZE);
+    Microseconds decode_time{0};
+    std::exception_ptr decode_exception;
+    std::thread decode_thread([&]() {
+        try
+        {
+            while (true)
+            {
+                const auto decode_start = Clock::now();
+                auto frame = source.read_frame();
+                decode_time += elapsed(decode_start);
+
+                // Кадры следующего сегмента не декодируем дальше первого
+                if (frame && segment.is_after_end(frame->ts.count()))
+                    frame.reset();
+
+                const bool eof = !frame;
+                if (!queue.push(std::move(frame)) || eof)
+                    break;
+            }
+        }
+        catch (...)
+        {
+            decode_exception = std::current_exception();
+            queue.push(nullptr);
+        }
+    });
+
+    try
+    {
+        while (true)
+        {
+            const auto wait_start = Clock::now();
+            auto frame = queue.pop();
+            stats.decode_wait += elapsed(wait_start);
+            if (!frame)
+                break;
+
+            const auto analysis_start = Clock::now();
+            // Кадр больше никому не нужен, пайплайн получает его без копирования
+            auto data = VideoProcessorInfo::create(std::move(*frame));
+            try
+            {
+                pipeline.process(data);
+            }
+            catch (const std::exception& e)
+            {
+                STEP_LOG(L_ERROR, "Offline analyzer: handled exception due frame {} analyzing: {}",
+                         data->data.ts.count(), e.what());
+            }
+            stats.analysis_time += elapsed(analysis_start);
+
+            if (!segment.contains(data->data.ts.count()))
+            {
+                ++stats.warmup_frames;
+                continue;
+            }
+
+            writer.write(*data, stats);
+            ++stats.frames;
+        }
+    }
+    catch (...)
+    {
+        queue.stop();
+        source.terminate();
+        decode_thread.join();
+        throw;
+    }
+
+    decode_thread.join();
+    if (decode_exception)
+        std::rethrow_exception(decode_exception);
+
+    stats.decode_time = decode_time;
+
+    const auto io_stats = source.get_io_stats();
+    STEP_LOG(L_DEBUG, "Offline analyzer: segment [{}, {}) of {}: {} frames, {} warmup; read {} bytes, {} storage reads",
+             segment.start, segment.end, filename, stats.frames, stats.warmup_frames, io_stats.bytes_read,
+             io_stats.storage_reads);
+
+    return stats;
+}
+
+}  // namespace step::proc
@@ -0,0 +1,98 @@
+#pragma once
+
+#include <core/base/types/time.hpp>
+
+#include <video/ffmpeg/decoding/keyframe_index.hpp>
+#include <video/ffmpeg/reader/file_frame_source.hpp>
+#include <video/ffmpeg/reader/video_segments.hpp>
+
+#include <proc/interfaces/face_engine_controller.hpp>
+#include <proc/pipeline/impl/frame_pipeline.hpp>
+
+#include <filesystem>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace step::proc {
+
+/*! @brief Итоги анализа одного файла по стадиям.
+    @details При обработке по сегментам времена стадий суммируются по всем потокам.
+*/
+struct OfflineAnalysisStats
+{
+    std::string filename;
+    size_t segments{1};
+    size_t frames{0};
+    size_t warmup_frames{0};        ///< кадры прогрева перед началом сегментов, в результат не входят
+    size_t faces{0};
+    size_t persons{0};
+    size_t matched_faces{0};        ///< лица со статусом Matched или Possible
+    Microseconds decode_time{0};    ///< работа потока декодирования без ожидания места в очереди
+    Microseconds analysis_time{0};  ///< работа пайплайна
+    Microseconds decode_wait{0};    ///< простой анализа в ожидании кадров от декодера
+    Microseconds wall_time{0};
+
+    double get_fps(Microseconds time) const noexcept;
+
+    /*! @brief Добавляет итоги сегмента того же файла, кроме общего времени.
+    */
+    void append(const OfflineAnalysisStats& segment_stats);
+};
+
+/*! @brief Анализ файлов без отображения: декодирование и пайплайн с максимальной скоростью.
+    @details В отличие от VideoProcessingManager не использует ReaderFF и пулы наблюдателей.
+    Декодер работает в отдельном потоке и заполняет ограниченную очередь, пайплайн забирает кадры
+    в вызывающем потоке, так что декодирование следующих кадров идет параллельно с анализом.
+    Пайплайн и модели создаются один раз и используются для всех файлов.
+    Конфигурация совпадает с конфигурацией VideoProcessingManager, секции reader_ff и offline_analyzer необязательны.
+    Без секции face_engine_controller face engine не создается, пайплайн без узлов лиц работает и так.
+
+    С segment_workers > 1 файл делится по ключевым кадрам на сегменты, которые декодируются и анализируются
+    одновременно, у каждого потока свои парсер, декодер и пайплайн. Чтобы состояние обработки (трекинг)
+    на границе не начиналось с нуля, сегмент декодируется с прогревом за segment_warmup_ms до своего начала.
+    У каждого пайплайна свой экземпляр face engine со своими моделями, потоки не ждут друг друга.
+*/
+class OfflineAnalyzer : public IFaceEngineController
+{
+public:
+    OfflineAnalyzer(const ObjectPtrJSON& cfg);
+
+    /*! @brief Анализирует файл целиком и пишет результаты в results_path.
+        @details Формат результатов - текст с табуляцией, строка на объект:
+        ts_us, тип (F - лицо, P - человек), x0, y0, x1, y1, уверенность, статус сравнения лица (FaceMatchStatus).
+        Кадры без объектов не пишутся, строки с # - комментарии. Строки идут по возрастанию ts
+        и при обработке по сегментам.
+    */
+    OfflineAnalysisStats analyze(const std::string& filename, const std::filesystem::path& results_path);
+
+    void set_segment_workers(size_t count) noexcept { m_segment_workers = std::max<size_t>(count, 1); }
+    size_t get_segment_workers() const noexcept { return m_segment_workers; }
+
+    /*! @brief Профилировщики пайплайнов (по одному на поток сегментов), накоплены по всем файлам.
+    */
+    std::vector<PipelineProfilerPtr> get_profilers() const;
+
+private:
+    void prepare_pipelines(size_t count);
+
+    std::vector<video::ff::VideoSegment> plan_segments(const std::string& filename,
+                                                       std::vector<video::ff::KeyframeIndex::Entry>& keyframes);
+
+    OfflineAnalysisStats analyze_segment(const std::string& filename, const video::ff::VideoSegment& segment,
+                                         const std::vector<video::ff::KeyframeIndex::Entry>& keyframes,
+                                         FrameSyncPipeline& pipeline, std::ostream& results);
+
+private:
+    ObjectPtrJSON m_pipeline_cfg;
+    std::vector<std::unique_ptr<FrameSyncPipeline>> m_pipelines;
+    std::vector<std::shared_ptr<IFaceEngine>> m_worker_face_engines;  ///< для пайплайнов кроме первого
+
+    video::ff::FileFrameSourceSettings m_source_settings;
+
+    size_t m_segment_workers{1};
+    video::ff::TimeFF m_segment_warmup{0};
+};
+
+}  // namespace step::proc
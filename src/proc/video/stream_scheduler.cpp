@@ -0,0 +1,30 @@
+#include "stream_scheduler.hpp"
+
+#include <core/exception/assert.hpp>
+
+#include <algorithm>
+
+namespace step::proc {
+
+size_t StreamScheduler::add_stream(double priority)
+{
+    STEP_ASSERT(priority > 0.0, "Stream scheduler: invalid priority {}", priority);
+    m_streams.push_back({priority, m_virtual_time});
+    return m_streams.size() - 1;
+}
+
+void StreamScheduler::start(size_t index) { m_virtual_time = m_streams.at(index).pass; }
+
+void StreamScheduler::charge(size_t index, Microseconds cost)
+{
+    auto& stream = m_streams.at(index);
+    stream.pass += static_cast<double>(std::max<Microseconds::rep>(cost.count(), 0)) / stream.priority;
+}
+
+void StreamScheduler::resume(size_t index)
+{
+    auto& stream = m_streams.at(index);
+    stream.pass = std::max(stream.pass, m_virtual_time);
+}
+
+}  // namespace step::proc
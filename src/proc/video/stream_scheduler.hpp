@@ -0,0 +1,67 @@
+#pragma once
+
+#include <core/base/types/time.hpp>
+
+#include <cstddef>
+#include <optional>
+#include <vector>
+
+namespace step::proc {
+
+/*! @brief Взвешенная справедливая очередь (start-time fair queuing) входных потоков.
+    @details У каждого потока свое виртуальное время pass. Из готовых выбирается поток с наименьшим pass,
+    после обработки кадра pass увеличивается на затраченное время, деленное на приоритет, так что доли
+    обработки пропорциональны приоритетам. Виртуальное время очереди - pass последнего начатого потока.
+    Поток, простаивавший без кадров, при возвращении получает текущее виртуальное время и не набирает долг.
+    Не потокобезопасен, вызывающий сериализует обращения.
+*/
+class StreamScheduler
+{
+public:
+    /*! @brief Добавляет поток, возвращает его индекс.
+    */
+    size_t add_stream(double priority);
+
+    /*! @brief Выбирает готовый поток с наименьшим pass, is_ready(index) - есть ли у потока работа.
+    */
+    template <typename TIsReady>
+    std::optional<size_t> pick(TIsReady&& is_ready) const
+    {
+        std::optional<size_t> picked;
+        for (size_t i = 0; i < m_streams.size(); ++i)
+        {
+            if (is_ready(i) && (!picked || m_streams[i].pass < m_streams[*picked].pass))
+                picked = i;
+        }
+        return picked;
+    }
+
+    /*! @brief Поток взят в обработку.
+    */
+    void start(size_t index);
+
+    /*! @brief Учитывает время обработки кадра потока.
+    */
+    void charge(size_t index, Microseconds cost);
+
+    /*! @brief Поток снова получил работу после простоя.
+    */
+    void resume(size_t index);
+
+    double get_pass(size_t index) const { return m_streams.at(index).pass; }
+    double get_virtual_time() const noexcept { return m_virtual_time; }
+    size_t get_streams_count() const noexcept { return m_streams.size(); }
+
+private:
+    struct StreamState
+    {
+        double priority{1.0};
+        double pass{0.0};
+    };
+
+private:
+    std::vector<StreamState> m_streams;
+    double m_virtual_time{0.0};
+};
+
+}  // namespace step::proc
@@ -65,6 +65,16 @@ cv::Mat bsmToCvMat(const Context& bsmCtx, bool copy)
     return copy ? img.clone() : img;
 }
 
+std::shared_ptr<cv::Mat> bsmToSharedCvMat(const Context& bsmCtx)
+{
+    if (!bsmCtx.get<bool>("shared_blob", false))
+        return std::make_shared<cv::Mat>(bsmToCvMat(bsmCtx, true));
+
+    // the Mat keeps the blob alive instead of copying it
+    auto buff = bsmCtx.at("blob").get<std::shared_ptr<unsigned char>>();
+    return std::shared_ptr<cv::Mat>(new cv::Mat(bsmToCvMat(bsmCtx)), [buff](cv::Mat* img) { delete img; });
+}
+
 cv::Mat keypointsBasedCrop(Context& data, cv::Mat& image)
 {
     float left_eye_x = data["objects"][0]["fitter"]["left_eye"][0].get<double>() * image.cols;
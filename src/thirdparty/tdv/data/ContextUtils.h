@@ -3,6 +3,8 @@
 
 #include <opencv2/core/mat.hpp>
 
+#include <memory>
+
 //#include <tdv/data/Context.h>
 #include "Context.h"
 
@@ -13,6 +15,8 @@ cv::Mat keypointsBasedCrop(Context& data, cv::Mat& image);
 cv::Mat keypointsBasedCropOneObject(const Context& data, cv::Mat& image);
 void cvMatToBsm(Context& bsmCtx, const cv::Mat& img, bool copy = false);
 cv::Mat bsmToCvMat(const Context& bsmCtx, bool copy = false);
+// Shares the image with bsmCtx if "shared_blob" is set (the blob owns its data), otherwise returns a copy
+std::shared_ptr<cv::Mat> bsmToSharedCvMat(const Context& bsmCtx);
 
 }  // namespace data
 }  // namespace tdv
@@ -0,0 +1,58 @@
+#include "FaceData.h"
+
+#include <cstring>
+
+namespace {
+
+size_t paddedTemplateSize(size_t count) { return (count + 3) / 4 * 4; }
+
+}  // namespace
+
+namespace tdv {
+namespace data {
+
+ArenaArray<cv::Point3f> FaceData::allocateKeypoints(size_t count)
+{
+    if (keypoints.size != count)
+        keypoints = {arena->allocate<cv::Point3f>(count), count};
+    return keypoints;
+}
+
+ArenaArray<float> FaceData::allocateTemplate(size_t count)
+{
+    if (templ.size != count)
+    {
+        const size_t padded = paddedTemplateSize(count);
+        templ = {arena->allocate<float>(padded, TEMPLATE_ALIGNMENT), count};
+        std::fill(templ.data + count, templ.data + padded, 0.f);
+    }
+    return templ;
+}
+
+FaceData FaceData::clone() const
+{
+    FaceData face;
+    face.arena = std::make_shared<FaceArena>(keypoints.size * sizeof(cv::Point3f) +
+                                             paddedTemplateSize(templ.size) * sizeof(float) + TEMPLATE_ALIGNMENT);
+    face.image = image;
+    face.bbox = bbox;
+    face.confidence = confidence;
+    face.leftEye = leftEye;
+    face.rightEye = rightEye;
+    face.mouth = mouth;
+    face.fitterScore = fitterScore;
+
+    if (hasFitter())
+        std::copy(keypoints.begin(), keypoints.end(), face.allocateKeypoints(keypoints.size).begin());
+
+    if (hasTemplate())
+    {
+        face.allocateTemplate(templ.size);
+        std::memcpy(face.templ.data, templ.data, templ.size * sizeof(float));
+    }
+
+    return face;
+}
+
+}  // namespace data
+}  // namespace tdv
@@ -0,0 +1,83 @@
+#ifndef TDV_DATA_FACEDATA_H_
+#define TDV_DATA_FACEDATA_H_
+
+#include <opencv2/core/mat.hpp>
+#include <opencv2/core/types.hpp>
+
+#include <algorithm>
+#include <array>
+#include <memory>
+#include <memory_resource>
+#include <mutex>
+
+namespace tdv {
+namespace data {
+
+// Storage for the variable-size arrays (keypoints, templates) of the faces found in one image.
+// Monotonic: memory is released at once when the last face referencing the arena is gone.
+class FaceArena
+{
+public:
+    explicit FaceArena(size_t initialSize = 32 * 1024) : resource(initialSize) {}
+
+    FaceArena(const FaceArena&) = delete;
+    FaceArena& operator=(const FaceArena&) = delete;
+
+    template <typename T>
+    T* allocate(size_t count, size_t alignment = alignof(T))
+    {
+        std::lock_guard<std::mutex> lock(guard);
+        return static_cast<T*>(resource.allocate(count * sizeof(T), (std::max)(alignment, alignof(T))));
+    }
+
+private:
+    std::mutex guard;
+    std::pmr::monotonic_buffer_resource resource;
+};
+
+template <typename T>
+struct ArenaArray
+{
+    T* data = nullptr;
+    size_t size = 0;
+
+    bool empty() const { return size == 0; }
+    T* begin() const { return data; }
+    T* end() const { return data + size; }
+    T& operator[](size_t index) const { return data[index]; }
+};
+
+// Typed face data passed between FaceDetectionModule, MeshFitterModule, FaceIdentificationModule
+// and MatcherModule instead of a Context tree: no map lookups and no per-field heap nodes.
+struct FaceData
+{
+    std::shared_ptr<FaceArena> arena;
+    std::shared_ptr<cv::Mat> image;  // the whole image the face was found on
+    std::array<float, 4> bbox{};     // x1, y1, x2, y2 normalized to the image
+    float confidence = 0;
+
+    // MeshFitterModule, normalized to the image
+    ArenaArray<cv::Point3f> keypoints;
+    cv::Point3f leftEye, rightEye, mouth;
+    float fitterScore = 0;
+
+    // FaceIdentificationModule: l2-normalized, TEMPLATE_ALIGNMENT aligned and zero padded
+    // to a multiple of 4 floats for the SSE matcher
+    ArenaArray<float> templ;
+
+    static constexpr size_t TEMPLATE_ALIGNMENT = 16;
+
+    bool hasFitter() const { return !keypoints.empty(); }
+    bool hasTemplate() const { return !templ.empty(); }
+
+    ArenaArray<cv::Point3f> allocateKeypoints(size_t count);
+    ArenaArray<float> allocateTemplate(size_t count);
+
+    // Copy with its own arena sharing nothing but the image
+    FaceData clone() const;
+};
+
+}  // namespace data
+}  // namespace tdv
+
+#endif  // TDV_DATA_FACEDATA_H_
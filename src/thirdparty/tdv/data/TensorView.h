@@ -0,0 +1,34 @@
+#ifndef TDV_DATA_TENSORVIEW_H_
+#define TDV_DATA_TENSORVIEW_H_
+
+#include <cstddef>
+
+namespace tdv {
+namespace data {
+
+// Read-only view of a [rows x cols] tensor with rows `stride` elements apart.
+// Does not own the data: the output buffer of the module must outlive the view.
+template <typename T>
+struct TensorView
+{
+    const T* data = nullptr;
+    size_t rows = 0;
+    size_t cols = 0;
+    size_t stride = 0;
+
+    TensorView() = default;
+    TensorView(const T* data, size_t rows, size_t cols) : TensorView(data, rows, cols, cols) {}
+    TensorView(const T* data, size_t rows, size_t cols, size_t stride)
+        : data(data), rows(rows), cols(cols), stride(stride)
+    {
+    }
+
+    bool empty() const { return rows == 0; }
+    const T* operator[](size_t row) const { return data + row * stride; }
+    const T& at(size_t row, size_t col) const { return data[row * stride + col]; }
+};
+
+}  // namespace data
+}  // namespace tdv
+
+#endif  // TDV_DATA_TENSORVIEW_H_
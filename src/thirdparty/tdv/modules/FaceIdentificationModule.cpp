@@ -35,11 +35,11 @@ cv::Mat blobFromImage(cv::Mat& image, int nchannel = 3, const int ddepth = CV_32
 
     output.create(3, sz, ddepth);
 
-    cv::Mat* ch = new cv::Mat[nch];
+    std::vector<cv::Mat> ch(nch);
     for (int j = 0; j < nchannel; j++)
         ch[j] = cv::Mat(image.rows, image.cols, ddepth, output.ptr(j));
 
-    cv::split(image, ch);
+    cv::split(image, ch.data());
 
     return output;
 }
@@ -69,6 +69,25 @@ cv::Mat processObject(const tdv::data::Context& obj, const int input_width, cons
     return (*image)(rect);
 }
 
+cv::Mat processObject(const tdv::data::FaceData& face, const int input_width, const int input_height)
+{
+    cv::Mat& image = *face.image;
+
+    if (face.hasFitter())
+    {
+        const cv::Matx23f crop2image =
+            makeCrop2ImageByPoints(face, image, (std::max)(input_width, input_height));
+        cv::Mat result;
+        warpAffine(image, result, crop2image, cv::Size(input_width, input_height));
+        return result;
+    }
+
+    cv::Rect rect(cv::Point{static_cast<int>(face.bbox[0] * image.cols), static_cast<int>(face.bbox[1] * image.rows)},
+                  cv::Point{static_cast<int>(face.bbox[2] * image.cols), static_cast<int>(face.bbox[3] * image.rows)});
+
+    return image(rect);
+}
+
 void imageToInput(cv::Mat& image, tdv::data::Context& data, size_t sizeInBytes, int N_CHANNEL)
 {
     unsigned char* input_ptr = static_cast<unsigned char*>(malloc(sizeInBytes));
@@ -118,6 +137,21 @@ std::vector<float> FaceIdentificationModule::getOutputData(std::shared_ptr<uint8
     return result_predict;
 }
 
+void FaceIdentificationModule::identify(tdv::data::FaceData& face)
+{
+    const auto& shape = this->getInputShapes();
+    const auto& INPUT_H = shape.front()[2];
+    const auto& INPUT_W = shape.front()[3];
+    const auto& N_CHANNEL = shape.front()[1];
+
+    cv::Mat image = processObject(face, INPUT_W, INPUT_H);
+    cv::resize(image, image, cv::Size(INPUT_W, INPUT_H));
+    cv::Mat img_blob = blobFromImage(image, N_CHANNEL);
+
+    const std::vector<float> embeds = getOutputData(infer(img_blob.data));
+    std::copy(embeds.begin(), embeds.end(), face.allocateTemplate(embeds.size()).begin());
+}
+
 void FaceIdentificationModule::preprocess(tdv::data::Context& data)
 {
     const auto& shape = this->getInputShapes();
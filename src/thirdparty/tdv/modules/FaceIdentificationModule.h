@@ -2,6 +2,7 @@
 #define FACEREIDENTIFICATOR_H
 
 //#include <tdv/modules/ONNXModule.h>
+#include <thirdparty/tdv/data/FaceData.h>
 #include <thirdparty/tdv/modules/ONNXModule.h>
 
 namespace tdv {
@@ -13,6 +14,9 @@ class FaceIdentificationModule : public ONNXModule<FaceIdentificationModule>
 public:
     FaceIdentificationModule(const tdv::data::Context& config);
 
+    // Typed recognition of a detected face, the template is allocated in the face arena
+    void identify(tdv::data::FaceData& face);
+
 private:
     friend class ONNXModule<FaceIdentificationModule>;
     void virtual preprocess(tdv::data::Context& data) override;
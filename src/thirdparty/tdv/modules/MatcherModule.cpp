@@ -78,6 +78,14 @@ void MatcherModule::operator()(tdv::data::Context& data)
     }
 }
 
+double MatcherModule::compare(const tdv::data::FaceData& a, const tdv::data::FaceData& b) const
+{
+    RHAssert2(0x4c0d78ce, a.templ.size == b.templ.size, "templates of different size");
+    // templates are aligned and zero padded to a multiple of 4
+    const int padded_size = static_cast<int>((a.templ.size + 3) / 4 * 4);
+    return l2_distance(a.templ.data, b.templ.data, padded_size);
+}
+
 void MatcherModule::verifyMatch(tdv::data::Context& data)
 {
     RCAssert(0x4c0d78cd, data["objects"].size() == 2);
@@ -10,6 +10,7 @@
 #include <memory>
 
 //#include <tdv/modules/ProcessingBlock.h>
+#include <thirdparty/tdv/data/FaceData.h>
 #include <thirdparty/tdv/modules/ProcessingBlock.h>
 
 namespace tdv {
@@ -22,6 +23,10 @@ public:
     MatcherModule(const tdv::data::Context& config);
     virtual void operator()(tdv::data::Context& data) override;
 
+    // Typed verification of two recognized faces
+    double compare(const tdv::data::FaceData& a, const tdv::data::FaceData& b) const;
+    bool verdict(double distance) const { return distance < threshold; }
+
 private:
     double threshold;
     virtual void verifyMatch(tdv::data::Context& data);
@@ -1,4 +1,5 @@
 #include <new>
+#include <algorithm>
 #include <cmath>
 
 #include <opencv2/core.hpp>
@@ -30,11 +31,11 @@ cv::Mat blobFromImage(cv::Mat& image, int nchannel = 3, const int ddepth = CV_32
 
     output.create(4, sz, ddepth);
 
-    cv::Mat* ch = new cv::Mat[nch];
+    std::vector<cv::Mat> ch(nch);
     for (int j = 0; j < nchannel; j++)
         ch[j] = cv::Mat(image.rows, image.cols, ddepth, output.ptr(0, j));
 
-    cv::split(image, ch);
+    cv::split(image, ch.data());
 
     return output;
 }
@@ -68,6 +69,23 @@ void imageToInput(cv::Mat& image, tdv::data::Context& data, size_t sizeInBytes,
     inputData["input_ptr"] = std::shared_ptr<unsigned char>(input_ptr, [](unsigned char* ptr) { free(ptr); });
 }
 
+cv::Mat cropObject(const tdv::data::FaceData& face)
+{
+    const int img_width = face.image->cols;
+    const int img_height = face.image->rows;
+    cv::Rect rect(cv::Point{static_cast<int>(face.bbox[0] * img_width), static_cast<int>(face.bbox[1] * img_height)},
+                  cv::Point{static_cast<int>(face.bbox[2] * img_width), static_cast<int>(face.bbox[3] * img_height)});
+    return (*face.image)(rect);
+}
+
+cv::Point3f getSpecialPoint(const tdv::data::ArenaArray<cv::Point3f>& keypoints, const std::vector<int>& point_indexs)
+{
+    cv::Point3f point;
+    for (const int& index : point_indexs)
+        point += keypoints[index];
+    return point / static_cast<float>(point_indexs.size());
+}
+
 void getSpecialPoint(std::string key, tdv::data::Context& context, std::vector<int>& point_indexs)
 {
     double x = 0, y = 0, z = 0;
@@ -87,7 +105,9 @@ namespace tdv {
 
 namespace modules {
 
-MeshFitterModule::MeshFitterModule(const tdv::data::Context& config) : ONNXModule<MeshFitterModule>(config)
+MeshFitterModule::MeshFitterModule(const tdv::data::Context& config)
+    : ONNXModule<MeshFitterModule>(config),
+      maxBatchSize((std::max)(config.get<size_t>("max_batch_size", 16), size_t(1)))
 {
     const auto& shape = getInputShapes();
     RHAssert2(0x8758bc91, shape.front()[2] == shape.front()[3], "incorrect input shape");
@@ -171,6 +191,103 @@ void MeshFitterModule::objectFromPredict(std::vector<float>& predict, tdv::data:
     obj["fitter"]["fitter_type"] = "mesh";
 }
 
+void MeshFitterModule::fit(tdv::data::FaceData& face)
+{
+    tdv::data::FaceData* faces[] = {&face};
+    fitBatch(faces, 1);
+}
+
+void MeshFitterModule::fit(const std::vector<tdv::data::FaceData*>& faces) { fitBatch(faces.data(), faces.size()); }
+
+void MeshFitterModule::fillInput(const tdv::data::FaceData& face, float* input, int width, int height, int channels)
+{
+    cv::resize(cropObject(face), resized, cv::Size(width, height));
+    if (resized.channels() == 1)
+        cv::cvtColor(resized, resized, cv::COLOR_GRAY2BGR);
+
+    if (resized.depth() == CV_8U)
+        resized.convertTo(converted, CV_32F, 1.f / 255);
+    else
+        resized.convertTo(converted, CV_32F);
+    RHAssert2(0x5c1e7a02, converted.channels() == channels && channels <= 4, "incorrect mesh fitter input channels");
+
+    // planar channels written straight into the batch tensor
+    cv::Mat planes[4];
+    for (int c = 0; c < channels; ++c)
+        planes[c] = cv::Mat(height, width, CV_32F, input + static_cast<size_t>(c) * width * height);
+    cv::split(converted, planes);
+}
+
+void MeshFitterModule::fitBatch(tdv::data::FaceData* const* faces, size_t count)
+{
+    if (count == 0)
+        return;
+
+    const auto& shape = this->getInputShapes().front();
+    const int INPUT_H = static_cast<int>(shape[2]);
+    const int INPUT_W = static_cast<int>(shape[3]);
+    const int N_CHANNEL = static_cast<int>(shape[1]);
+    const size_t inputSize = static_cast<size_t>(INPUT_W) * INPUT_H * N_CHANNEL;
+    const float INPUT_SIZE = static_cast<float>(INPUT_H);
+
+    // A model with a fixed batch runs once per face on the same buffer
+    size_t batchSize = (std::min)(count, maxBatchSize);
+    const bool dynamicBatch = setBatchSize(batchSize);
+    if (!dynamicBatch)
+        batchSize = 1;
+    batchInput.resize(batchSize * inputSize);
+
+    for (size_t begin = 0; begin < count; begin += batchSize)
+    {
+        const size_t size = (std::min)(batchSize, count - begin);
+        if (dynamicBatch && size != batchSize)
+            setBatchSize(size);
+
+        for (size_t i = 0; i < size; ++i)
+            fillInput(*faces[begin + i], batchInput.data() + i * inputSize, INPUT_W, INPUT_H, N_CHANNEL);
+
+        const auto output = infer(batchInput.data());
+        const auto& shapes = getOutputShapes();
+        RHAssert2(0xcb64809d, !shapes.empty() && shapes.front()[0] == static_cast<int64_t>(size),
+                  "incorrect mesh fitter output batch");
+
+        // outputs follow each other in the buffer: keypoints of all faces, then the scores
+        const size_t predictSize = static_cast<size_t>(shapes.front()[1]);
+        const float* predicts = reinterpret_cast<const float*>(output.get());
+        const float* scores = shapes.size() > 1 ? predicts + size * predictSize : nullptr;
+
+        for (size_t i = 0; i < size; ++i)
+        {
+            tdv::data::FaceData& face = *faces[begin + i];
+            const float* predict = predicts + i * predictSize;
+
+            const float i_w = face.image->cols;
+            const float i_h = face.image->rows;
+            const float o_x = face.bbox[0];
+            const float o_y = face.bbox[1];
+            const float ci_w = face.bbox[2] * i_w - o_x * i_w;
+            const float ci_h = face.bbox[3] * i_h - o_y * i_h;
+
+            auto keypoints = face.allocateKeypoints(predictSize / 3);
+            for (size_t k = 0; k < keypoints.size; ++k)
+            {
+                const float* p = predict + 3 * k;
+                keypoints[k] = {o_x + (p[0] / INPUT_SIZE) * (ci_w / i_w), o_y + (p[1] / INPUT_SIZE) * (ci_h / i_h),
+                                p[2] / INPUT_SIZE};
+            }
+
+            face.fitterScore = scores ? scores[i] / 50 : 0.f;
+            face.leftEye = getSpecialPoint(keypoints, l_idx);
+            face.rightEye = getSpecialPoint(keypoints, r_idx);
+            face.mouth = getSpecialPoint(keypoints, mouth_idx);
+        }
+    }
+
+    // the Context entry point expects a single image batch
+    if (dynamicBatch && batchSize != 1)
+        setBatchSize(1);
+}
+
 void MeshFitterModule::postprocess(std::shared_ptr<uint8_t> buffer, tdv::data::Context& data)
 {
     if (buffer)
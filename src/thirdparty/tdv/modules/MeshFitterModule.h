@@ -2,6 +2,7 @@
 #define MESHFITTER_H
 
 //#include <tdv/modules/ONNXModule.h>
+#include <thirdparty/tdv/data/FaceData.h>
 #include <thirdparty/tdv/modules/ONNXModule.h>
 
 namespace tdv {
@@ -13,7 +14,17 @@ class MeshFitterModule : public ONNXModule<MeshFitterModule>
 public:
     MeshFitterModule(const tdv::data::Context& config);
 
+    // Typed mesh fitting of a detected face, keypoints are allocated in the face arena
+    void fit(tdv::data::FaceData& face);
+
+    // Mesh fitting of all faces of an image: one inference per max_batch_size faces if the model has
+    // a dynamic batch, otherwise one per face. The input tensor is reused between calls
+    void fit(const std::vector<tdv::data::FaceData*>& faces);
+
 private:
+    void fitBatch(tdv::data::FaceData* const* faces, size_t count);
+    void fillInput(const tdv::data::FaceData& face, float* input, int width, int height, int channels);
+
     friend class ONNXModule<MeshFitterModule>;
     void virtual preprocess(tdv::data::Context& data) override;
     void virtual postprocess(std::shared_ptr<uint8_t> buffer, tdv::data::Context& data) override;
@@ -23,6 +34,10 @@ private:
     std::vector<int> r_idx{385, 387, 380, 373};
     std::vector<int> l_idx{160, 158, 144, 153};
     std::vector<int> mouth_idx{13, 14};
+
+    size_t maxBatchSize;
+    std::vector<float> batchInput;
+    cv::Mat resized, converted;
 };
 
 }  // namespace modules
@@ -27,6 +27,12 @@ protected:
 
     const std::vector<std::vector<int64_t>>& getOutputShapes() const { return ort_env->getOutputShapes(); }
 
+    // typed entry points of the modules run the model without the "objects@input" context
+    std::shared_ptr<uint8_t> infer(void* input) { return ort_env->infer({input}); }
+
+    // batch size of the first input for the next infer calls, false if the model has a fixed batch
+    bool setBatchSize(size_t batchSize) { return ort_env->adjust_batch_size(0, static_cast<long>(batchSize)); }
+
     std::vector<int> getOutputTypes() const
     {
         std::vector<int> outTypes;
@@ -1,6 +1,8 @@
 #ifndef Yv5DETECTOR_H
 #define Yv5DETECTOR_H
 
+#include <algorithm>
+#include <array>
 #include <new>
 #include <tuple>
 
@@ -12,12 +14,16 @@
 // #include <tdv/utils/rassert/RAssert.h>
 
 #include <thirdparty/tdv/data/ContextUtils.h>
+#include <thirdparty/tdv/data/FaceData.h>
+#include <thirdparty/tdv/data/TensorView.h>
 #include <thirdparty/tdv/modules/ONNXModule.h>
 #include <thirdparty/tdv/utils/rassert/RAssert.h>
 
 namespace {
 
-std::tuple<int, int, double> resizeWithPad(cv::Mat& image, int new_width, int new_height)
+// Letterbox into output (new_width x new_height). Only the image part is resized, the padding is filled in place,
+// so the full-size padded copy of the input is never built. Returns (left, top, scale) in input pixels.
+std::tuple<int, int, double> resizeWithPad(const cv::Mat& image, cv::Mat& output, int new_width, int new_height)
 {
     double scale;
     int dw(0), dh(0);
@@ -34,109 +40,126 @@ std::tuple<int, int, double> resizeWithPad(cv::Mat& image, int new_width, int ne
     }
 
     int top = dh / 2;
-    int bottom = dh - top;
     int left = dw / 2;
-    int right = dw - left;
 
     cv::Scalar val = (image.depth() == CV_8U) ? cv::Scalar(127) : cv::Scalar(0.5);
 
-    cv::copyMakeBorder(image, image, top, bottom, left, right, cv::BORDER_CONSTANT, val);
-    cv::resize(image, image, cv::Size(new_width, new_height), 0, 0, cv::INTER_LINEAR);
+    output.create(new_height, new_width, image.type());
+    output.setTo(val);
+
+    const int x = std::min(cvRound(left / scale), new_width - 1);
+    const int y = std::min(cvRound(top / scale), new_height - 1);
+    const int w = std::clamp(cvRound(image.cols / scale), 1, new_width - x);
+    const int h = std::clamp(cvRound(image.rows / scale), 1, new_height - y);
+    cv::Mat roi = output(cv::Rect(x, y, w, h));
+    cv::resize(image, roi, roi.size(), 0, 0, cv::INTER_LINEAR);
     return std::make_tuple(left, top, scale);
 }
 
-cv::Mat blobFromImage(cv::Mat& image, int nchannel = 3, bool needBGR = false, const int ddepth = CV_32F)
+// Writes the image as a planar float tensor straight into output (nchannel x rows x cols).
+// image is modified in place, floatImage is a scratch buffer reused between calls.
+void blobFromImage(cv::Mat& image, float* output, cv::Mat& floatImage, int nchannel = 3, bool needBGR = false)
 {
-    cv::Mat output;
     if (image.channels() == 1)
         cv::cvtColor(image, image, cv::COLOR_GRAY2RGB);
 
     if (needBGR)
         cv::cvtColor(image, image, cv::COLOR_RGB2BGR);
 
-    if (image.depth() == CV_8U && ddepth == CV_32F)
-    {
-        image.convertTo(image, ddepth, 1.f / 255);
-    }
+    image.convertTo(floatImage, CV_32F, image.depth() == CV_8U ? 1. / 255 : 1.);
 
-    int nch = image.channels();
-    int sz[] = {1, nchannel, image.rows, image.cols};
+    RHAssert2(0x11113334, floatImage.channels() == nchannel, "image channels do not match the model input");
 
-    output.create(4, sz, ddepth);
-
-    cv::Mat* ch = new cv::Mat[nch];
+    const size_t planeSize = static_cast<size_t>(floatImage.rows) * floatImage.cols;
+    std::vector<cv::Mat> ch;
     for (int j = 0; j < nchannel; j++)
-        ch[j] = cv::Mat(image.rows, image.cols, ddepth, output.ptr(0, j));
+        ch.emplace_back(floatImage.rows, floatImage.cols, CV_32F, output + j * planeSize);
 
-    cv::split(image, ch);
-    return output;
+    cv::split(floatImage, ch.data());
 }
 
-inline float area(const std::vector<float>& v)
+// Truncated to an integer, as NMS always did
+inline float boxArea(float x1, float y1, float x2, float y2)
 {
-    if (v.size() != 4)
-        return 0;
-    long area = (v[2] - v[0]) * (v[3] - v[1]);
+    long area = (x2 - x1) * (y2 - y1);
     return (area > 0) ? area : 0;
 }
 
-inline std::vector<float> intersection(const std::vector<float>& v1, const std::vector<float>& v2)
+// Candidate boxes of one output in SoA layout. Kept by the module and reused between calls:
+// postprocessing allocates only when the number of candidates grows.
+struct DetectionCandidates
 {
-    if (!(v1.size() == 4 && v2.size() == 4 && (v1[0] < v1[2]) && (v1[1] < v1[3]) && (v2[0] < v2[2]) && (v2[1] < v2[3])))
-        return {0, 0, 0, 0};
+    std::vector<float> x1, y1, x2, y2;
+    std::vector<float> scores;
+    std::vector<float> areas;
+    std::vector<std::pair<float, int>> order;  // (score, index) sorted by score descending
+    std::vector<int> indices;                  // kept after NMS
 
-    float x1_max = (v1[0] < v2[0]) ? v2[0] : v1[0];
-    float y1_max = (v1[1] < v2[1]) ? v2[1] : v1[1];
-    float x2_min = (v1[2] < v2[2]) ? v1[2] : v2[2];
-    float y2_min = (v1[3] < v2[3]) ? v1[3] : v2[3];
+    size_t size() const { return scores.size(); }
 
-    if ((x1_max >= x2_min) || (y1_max >= y2_min))
+    void clear()
     {
-        return {0, 0, 0, 0};
+        x1.clear();
+        y1.clear();
+        x2.clear();
+        y2.clear();
+        scores.clear();
+        areas.clear();
+        order.clear();
+        indices.clear();
     }
-    return {x1_max, y1_max, x2_min, y2_min};
-}
-
-template <typename T>
-inline bool SortScorePairDescend(const std::pair<float, T>& pair1, const std::pair<float, T>& pair2)
-{
-    return pair1.first > pair2.first;
-}
 
-void GetMaxScoreIndex(const std::vector<float>& scores, const float threshold, const int top_k,
-                      std::vector<std::pair<float, int>>& score_index_vec)
-{
-    // Generate index score pairs.
-    for (size_t i = 0; i < scores.size(); ++i)
+    void push(float bx1, float by1, float bx2, float by2, float score)
     {
-        if (scores[i] > threshold)
-        {
-            score_index_vec.push_back(std::make_pair(scores[i], i));
-        }
+        x1.push_back(bx1);
+        y1.push_back(by1);
+        x2.push_back(bx2);
+        y2.push_back(by2);
+        scores.push_back(score);
+        areas.push_back(boxArea(bx1, by1, bx2, by2));
     }
+};
 
-    // Sort the score pair according to the scores in descending order
-    std::stable_sort(score_index_vec.begin(), score_index_vec.end(), SortScorePairDescend<int>);
+inline float intersectionArea(const DetectionCandidates& c, int i, int j)
+{
+    if (!((c.x1[i] < c.x2[i]) && (c.y1[i] < c.y2[i]) && (c.x1[j] < c.x2[j]) && (c.y1[j] < c.y2[j])))
+        return 0;
 
-    // Keep top_k scores if needed.
-    if (top_k > 0 && top_k < (int)score_index_vec.size())
-    {
-        score_index_vec.resize(top_k);
-    }
+    const float x1_max = std::max(c.x1[i], c.x1[j]);
+    const float y1_max = std::max(c.y1[i], c.y1[j]);
+    const float x2_min = std::min(c.x2[i], c.x2[j]);
+    const float y2_min = std::min(c.y2[i], c.y2[j]);
+
+    if ((x1_max >= x2_min) || (y1_max >= y2_min))
+        return 0;
+    return boxArea(x1_max, y1_max, x2_min, y2_min);
 }
 
-void NMSFast_(const std::vector<std::vector<float>>& bboxes, const std::vector<float>& scores,
-              const float score_threshold, const float nms_threshold, std::vector<int>& indices, const float eta = 1.f,
-              const int top_k = 0)
+// Equal scores keep the index order, same as a stable sort but without its temporary buffer
+inline bool SortScorePairDescend(const std::pair<float, int>& pair1, const std::pair<float, int>& pair2)
 {
-    RHAssert(0x000000, bboxes.size() == scores.size());
+    return pair1.first > pair2.first || (pair1.first == pair2.first && pair1.second < pair2.second);
+}
 
+// Fills candidates.indices with the boxes kept, in score descending order
+void NMSFast_(DetectionCandidates& candidates, const float score_threshold, const float nms_threshold,
+              const float eta = 1.f, const int top_k = 0)
+{
     // Get top_k scores (with corresponding indices).
-    std::vector<std::pair<float, int>> score_index_vec;
-    GetMaxScoreIndex(scores, score_threshold, top_k, score_index_vec);
+    auto& score_index_vec = candidates.order;
+    score_index_vec.clear();
+    for (size_t i = 0; i < candidates.size(); ++i)
+    {
+        if (candidates.scores[i] > score_threshold)
+            score_index_vec.emplace_back(candidates.scores[i], static_cast<int>(i));
+    }
+    std::sort(score_index_vec.begin(), score_index_vec.end(), SortScorePairDescend);
+    if (top_k > 0 && top_k < (int)score_index_vec.size())
+        score_index_vec.resize(top_k);
 
     // Do nms.
     float adaptive_threshold = nms_threshold;
+    auto& indices = candidates.indices;
     indices.clear();
     for (size_t i = 0; i < score_index_vec.size(); ++i)
     {
@@ -145,8 +168,8 @@ void NMSFast_(const std::vector<std::vector<float>>& bboxes, const std::vector<f
         for (int k = 0; k < (int)indices.size() && keep; ++k)
         {
             const int kept_idx = indices[k];
-            float intArea = static_cast<float>(area(intersection(bboxes[idx], bboxes[kept_idx])));
-            float unionArea = area(bboxes[idx]) + area(bboxes[kept_idx]) - intArea;
+            float intArea = intersectionArea(candidates, idx, kept_idx);
+            float unionArea = candidates.areas[idx] + candidates.areas[kept_idx] - intArea;
             float overlap = intArea / unionArea;
             keep = overlap <= adaptive_threshold;
         }
@@ -179,17 +202,38 @@ class BaseDetectionModule : public ONNXModule<Impl>
 public:
     BaseDetectionModule(const tdv::data::Context& config);
 
+    // Typed detection: the objects share the image and one arena for the data of the next modules
+    std::vector<tdv::data::FaceData> detect(const std::shared_ptr<cv::Mat>& image);
+
 private:
+    struct Detection
+    {
+        std::array<float, 4> bbox;  // x1, y1, x2, y2 normalized to the image
+        float confidence;
+    };
+
     friend class ONNXModule<Impl>;
     void virtual preprocess(tdv::data::Context& data) override;
     void virtual postprocess(std::shared_ptr<uint8_t> buffer, tdv::data::Context& data) override;
-    std::vector<std::vector<float>> getOutputData(std::shared_ptr<uint8_t> buff) const;
-    tdv::data::Context processOutputData(std::vector<std::vector<float>> predictions,
+    std::tuple<int, int, double> prepareInput(const cv::Mat& image);
+    // Rows of the output tensor: xc, yc, w, h, confidence, class. A view of buff, nothing is copied
+    tdv::data::TensorView<float> getOutputData(const std::shared_ptr<uint8_t>& buff) const;
+    std::vector<Detection> decodeDetections(const tdv::data::TensorView<float>& predictions,
+                                            const std::tuple<int, int, double>& offset, long img_width,
+                                            long img_height);
+    tdv::data::Context processOutputData(const tdv::data::TensorView<float>& predictions,
                                          const tdv::data::Context& metadata);
     const double IOU_THRESH;
     const double CONF_THRESH;
     const bool RAW_OUTPUT;
 
+    // reused between calls, a module instance is not called concurrently
+    std::shared_ptr<unsigned char> inputBuffer;
+    size_t inputBufferSize = 0;
+    cv::Mat resizedImage;
+    cv::Mat floatImage;
+    DetectionCandidates candidates;
+
 protected:
     bool needBGR = false;
 };
@@ -204,7 +248,7 @@ BaseDetectionModule<Impl>::BaseDetectionModule(const tdv::data::Context& config)
 }
 
 template <typename Impl>
-std::vector<std::vector<float>> BaseDetectionModule<Impl>::getOutputData(std::shared_ptr<uint8_t> buff) const
+tdv::data::TensorView<float> BaseDetectionModule<Impl>::getOutputData(const std::shared_ptr<uint8_t>& buff) const
 {
     const auto& shapes = this->getOutputShapes();
     RHAssert2(0x7b64809c, shapes.front()[0] == 1, "batch output not supported yet");
@@ -213,31 +257,41 @@ std::vector<std::vector<float>> BaseDetectionModule<Impl>::getOutputData(std::sh
 
     RHAssert2(0x7b64809c, predict_shape == 6, "unsupported output shape");
 
-    std::vector<std::vector<float>> bboxes;
-
     auto types = this->getOutputTypes();
     switch (types.front())
     {            // ONNXTensorElementDataType
         case 1:  // maps to c type float
-            for (size_t i = 0; i < predict_count; ++i)
-            {
-                float* blob_data = reinterpret_cast<float*>(buff.get() + sizeof(float) * i * predict_shape);
-                bboxes.emplace_back(blob_data, blob_data + predict_shape);
-            }
-            break;
+            return {reinterpret_cast<const float*>(buff.get()), predict_count, predict_shape};
         default:
             throw tdv::utils::rassert::tdv_error(0xed26ca12, "unsupported output type");
     }
-    return bboxes;
 }
 
 template <typename Impl>
-void BaseDetectionModule<Impl>::preprocess(tdv::data::Context& data)
+std::vector<tdv::data::FaceData> BaseDetectionModule<Impl>::detect(const std::shared_ptr<cv::Mat>& image)
 {
-    Context& imageInput = data.at("image");
+    const auto offset = prepareInput(*image);
+    const auto output = this->infer(inputBuffer.get());
+    const auto detections = decodeDetections(getOutputData(output), offset, image->cols, image->rows);
 
-    cv::Mat image = tdv::data::bsmToCvMat(imageInput, true);
+    std::vector<tdv::data::FaceData> objects(detections.size());
+    if (detections.empty())
+        return objects;
 
+    auto arena = std::make_shared<tdv::data::FaceArena>();
+    for (size_t i = 0; i < detections.size(); ++i)
+    {
+        objects[i].arena = arena;
+        objects[i].image = image;
+        objects[i].bbox = detections[i].bbox;
+        objects[i].confidence = detections[i].confidence;
+    }
+    return objects;
+}
+
+template <typename Impl>
+std::tuple<int, int, double> BaseDetectionModule<Impl>::prepareInput(const cv::Mat& image)
+{
     RHAssert2(0x11113333, image.depth() == CV_8U || image.depth() == CV_32F,
               "only 8U and 32F image types are suported");
 
@@ -246,17 +300,32 @@ void BaseDetectionModule<Impl>::preprocess(tdv::data::Context& data)
     const auto& INPUT_WIDTH = shape.front()[3];
     const auto& N_CHANNEL = shape.front()[1];
 
-    auto offset = resizeWithPad(image, INPUT_WIDTH, INPUT_HEIGHT);
+    auto offset = resizeWithPad(image, resizedImage, INPUT_WIDTH, INPUT_HEIGHT);
     size_t sizeInBytes = INPUT_WIDTH * INPUT_HEIGHT * N_CHANNEL * sizeof(float);
 
-    unsigned char* input_ptr = static_cast<unsigned char*>(malloc(sizeInBytes));
-    if (!input_ptr)
-        throw std::bad_alloc();
-    cv::Mat img_blob = blobFromImage(image, N_CHANNEL, needBGR);
-    memcpy(input_ptr, img_blob.data, sizeInBytes);
+    // the previous call releases the buffer with "objects@input", otherwise someone still holds it
+    if (!inputBuffer || inputBufferSize != sizeInBytes || inputBuffer.use_count() > 1)
+    {
+        unsigned char* input_ptr = static_cast<unsigned char*>(malloc(sizeInBytes));
+        if (!input_ptr)
+            throw std::bad_alloc();
+        inputBuffer = std::shared_ptr<unsigned char>(input_ptr, [](unsigned char* ptr) { free(ptr); });
+        inputBufferSize = sizeInBytes;
+    }
+    blobFromImage(resizedImage, reinterpret_cast<float*>(inputBuffer.get()), floatImage, N_CHANNEL, needBGR);
+    return offset;
+}
+
+template <typename Impl>
+void BaseDetectionModule<Impl>::preprocess(tdv::data::Context& data)
+{
+    Context& imageInput = data.at("image");
+
+    // no copy: the input image is only read, resize and padding go to the module buffers
+    auto offset = prepareInput(tdv::data::bsmToCvMat(imageInput));
 
     Context& inputData = data["objects@input"][0];
-    inputData["input_ptr"] = std::shared_ptr<unsigned char>(input_ptr, [](unsigned char* ptr) { free(ptr); });
+    inputData["input_ptr"] = inputBuffer;
     inputData["resize_offset"] = offset;
     inputData["image_shape"] = data.at("image").at("shape");
     return;
@@ -267,26 +336,32 @@ void BaseDetectionModule<Impl>::postprocess(std::shared_ptr<uint8_t> buffer, tdv
 {
     if (buffer)
     {
-        std::vector<std::vector<float>> bboxes = getOutputData(buffer);
+        const auto predictions = getOutputData(buffer);
         if (!RAW_OUTPUT)
         {
-            data["objects"] = processOutputData(bboxes, data);
+            data["objects"] = processOutputData(predictions, data);
         }
         else
+        {
+            std::vector<std::vector<float>> bboxes;
+            bboxes.reserve(predictions.rows);
+            for (size_t i = 0; i < predictions.rows; ++i)
+                bboxes.emplace_back(predictions[i], predictions[i] + predictions.cols);
             data["body_boxes"] = std::move(bboxes);
+        }
     }
 }
 
 template <typename Impl>
-tdv::data::Context BaseDetectionModule<Impl>::processOutputData(std::vector<std::vector<float>> predictions,
-                                                                const tdv::data::Context& metadata)
+std::vector<typename BaseDetectionModule<Impl>::Detection> BaseDetectionModule<Impl>::decodeDetections(
+    const tdv::data::TensorView<float>& predictions, const std::tuple<int, int, double>& offset, long img_width,
+    long img_height)
 {
-    std::vector<std::vector<float>> localBoxes;
-    std::vector<float> localConfidences;
-    std::vector<int> indices;
+    candidates.clear();
 
-    for (const auto& cur_pred : predictions)
+    for (size_t i = 0; i < predictions.rows; ++i)
     {
+        const float* cur_pred = predictions[i];
         float obj_conf = cur_pred[4];  // confidence
         if (obj_conf < CONF_THRESH)
             continue;
@@ -300,37 +375,50 @@ tdv::data::Context BaseDetectionModule<Impl>::processOutputData(std::vector<std:
         float y1 = yc - h / 2;
         float x2 = xc + w / 2;
         float y2 = yc + h / 2;
-        localBoxes.push_back({x1, y1, x2, y2});
-        localConfidences.push_back(obj_conf);
+        candidates.push(x1, y1, x2, y2, obj_conf);
     }
 
-    NMSFast_(localBoxes, localConfidences, 0.0, IOU_THRESH, indices);
+    NMSFast_(candidates, 0.0, IOU_THRESH);
+
+    std::vector<Detection> detections;
+    detections.reserve(candidates.indices.size());
+    for (const int idx : candidates.indices)
+    {
+        // convert to original image normalized coordinates
+        Detection detection;
+        detection.bbox[0] = (candidates.x1[idx] * std::get<2>(offset) - std::get<0>(offset)) / img_width;
+        detection.bbox[1] = (candidates.y1[idx] * std::get<2>(offset) - std::get<1>(offset)) / img_height;
+        detection.bbox[2] = (candidates.x2[idx] * std::get<2>(offset) - std::get<0>(offset)) / img_width;
+        detection.bbox[3] = (candidates.y2[idx] * std::get<2>(offset) - std::get<1>(offset)) / img_height;
+        for (auto& coord : detection.bbox)
+            coord = clip_value(coord, 0.0, 1.0);
+        detection.confidence = candidates.scores[idx];
+        detections.push_back(detection);
+    }
+    return detections;
+}
+
+template <typename Impl>
+tdv::data::Context BaseDetectionModule<Impl>::processOutputData(const tdv::data::TensorView<float>& predictions,
+                                                                const tdv::data::Context& metadata)
+{
     const auto offset = metadata.at("objects@input")[0].at("resize_offset").get<std::tuple<int, int, double>>();
     const auto img_height = metadata.at("objects@input")[0].at("image_shape")[0].get<long>();
     const auto img_width = metadata.at("objects@input")[0].at("image_shape")[1].get<long>();
+    const auto detections = decodeDetections(predictions, offset, img_width, img_height);
 
     const Context& imageInput = metadata.at("image");
-    std::shared_ptr<cv::Mat> image = std::shared_ptr<cv::Mat>(new cv::Mat(tdv::data::bsmToCvMat(imageInput, true)));
+    std::shared_ptr<cv::Mat> image = tdv::data::bsmToSharedCvMat(imageInput);
 
     tdv::data::Context objects;
-    for (size_t i = 0; i < indices.size(); i++)
+    for (size_t i = 0; i < detections.size(); i++)
     {
         tdv::data::Context object;
         object["id"] = static_cast<long>(i);
         object["class"] = Impl::CLASS_NAME;
-        object["confidence"] = (double)localConfidences[indices[i]];
-        std::vector<float>& lbox = localBoxes[indices[i]];
-        // convert to original image normalized coordinates
-        lbox[0] = (lbox[0] * std::get<2>(offset) - std::get<0>(offset)) / img_width;
-        lbox[1] = (lbox[1] * std::get<2>(offset) - std::get<1>(offset)) / img_height;
-        lbox[2] = (lbox[2] * std::get<2>(offset) - std::get<0>(offset)) / img_width;
-        lbox[3] = (lbox[3] * std::get<2>(offset) - std::get<1>(offset)) / img_height;
-
-        for (auto coord : localBoxes[indices[i]])
-        {
-            coord = clip_value(coord, 0.0, 1.0);
+        object["confidence"] = (double)detections[i].confidence;
+        for (auto coord : detections[i].bbox)
             object["bbox"].push_back(static_cast<double>(coord));
-        }
         object["object@image"] = image;
         objects.push_back(std::move(object));
     }
@@ -165,12 +165,11 @@ cv::Matx23f estimate_scaled_rigid_transform(const std::vector<cv::Point2f>& src,
     }
 }
 
-cv::Matx23f makeCrop2ImageByPoints(const tdv::data::Context& fitter, cv::Mat& image, const int base_crop_size)
-{
-    std::vector<cv::Point2f> constructed_points;
-
-    construct_fda_points(fitter, constructed_points, image.cols, image.rows);
+namespace {
 
+// image_points: left eye, right eye, nose, left and right mouth corners
+cv::Matx23f makeCrop2ImageByPoints(const cv::Point2f (&image_points)[5], const int base_crop_size)
+{
     static const int target_points_count = 5;
     static const int crop_size_src = 112;
     cv::Point2f crop_points[target_points_count] = {
@@ -186,11 +185,6 @@ cv::Matx23f makeCrop2ImageByPoints(const tdv::data::Context& fitter, cv::Mat& im
         crop_points[i].y *= scale_factor;
     }
 
-    const cv::Point2f image_points[target_points_count] = {
-        constructed_points[7],  constructed_points[10], constructed_points[14],
-        constructed_points[17], constructed_points[19],
-    };
-
     const cv::Matx23f crop2image =
         estimate_scaled_rigid_transform(std::vector<cv::Point2f>(crop_points, crop_points + target_points_count),
                                         std::vector<cv::Point2f>(image_points, image_points + target_points_count),
@@ -200,6 +194,38 @@ cv::Matx23f makeCrop2ImageByPoints(const tdv::data::Context& fitter, cv::Mat& im
     return crop2image;
 }
 
+}  // namespace
+
+cv::Matx23f makeCrop2ImageByPoints(const tdv::data::Context& fitter, cv::Mat& image, const int base_crop_size)
+{
+    std::vector<cv::Point2f> constructed_points;
+
+    construct_fda_points(fitter, constructed_points, image.cols, image.rows);
+
+    const cv::Point2f image_points[] = {
+        constructed_points[7],  constructed_points[10], constructed_points[14],
+        constructed_points[17], constructed_points[19],
+    };
+
+    return makeCrop2ImageByPoints(image_points, base_crop_size);
+}
+
+cv::Matx23f makeCrop2ImageByPoints(const tdv::data::FaceData& face, const cv::Mat& image, const int base_crop_size)
+{
+    // the same mesh points as construct_fda_points picks: 1 - nose, 78 and 308 - mouth corners
+    const cv::Point2f scale(image.cols, image.rows);
+    const auto to_image = [&scale](const cv::Point3f& point) {
+        return cv::Point2f(point.x * scale.x, point.y * scale.y);
+    };
+
+    const cv::Point2f image_points[] = {
+        to_image(face.leftEye),       to_image(face.rightEye),       to_image(face.keypoints[1]),
+        to_image(face.keypoints[78]), to_image(face.keypoints[308]),
+    };
+
+    return makeCrop2ImageByPoints(image_points, base_crop_size);
+}
+
 void warpAffine(cv::Mat& src, cv::Mat& dst, const cv::Matx23f& transform_m_input_, const cv::Size& dsize)
 {
     cv::Matx23f transform_m = transform_m_input_;
@@ -3,12 +3,14 @@
 
 #include <opencv2/core/mat.hpp>
 #include <thirdparty/tdv/data/Context.h>
+#include <thirdparty/tdv/data/FaceData.h>
 
 namespace tdv {
 namespace utils {
 namespace recognizer_utils {
 
 cv::Matx23f makeCrop2ImageByPoints(const tdv::data::Context& fitter, cv::Mat& image, const int base_crop_size);
+cv::Matx23f makeCrop2ImageByPoints(const tdv::data::FaceData& face, const cv::Mat& image, const int base_crop_size);
 
 void warpAffine(cv::Mat& src, cv::Mat& dst, const cv::Matx23f& transform_m_input_, const cv::Size& dsize);
 
@@ -3,6 +3,8 @@
 #include <video/frame/utils/frame_utils.hpp>
 
 #include <core/base/json/json_utils.hpp>
+#include <core/base/utils/media_clock.hpp>
+#include <core/base/utils/string_utils.hpp>
 #include <core/exception/assert.hpp>
 
 #include <core/log/log.hpp>
@@ -12,7 +14,8 @@
 namespace {
 
 template <typename ErrorCallable>
-void add_frame(std::deque<std::filesystem::path>& frames, const std::filesystem::path& path, ErrorCallable handle_error)
+void add_frame(std::vector<std::filesystem::path>& frames, const std::filesystem::path& path,
+               ErrorCallable handle_error)
 {
     auto frame = step::video::utils::open_file(path.string(), step::video::PixFmt::BGR);
     if (!frame.is_valid())
@@ -37,6 +40,8 @@ FakeFrameProvider::FakeFrameProvider(const FakeCameraSettings& settings) : m_set
     STEP_ASSERT(std::filesystem::exists(source_path),
                 "Failed to create FakeFrameProvider: provided path {} does not exist", source_path.string());
 
+    std::vector<std::filesystem::path> candidates;
+    FakeFrameErrorHandler handle_error;
     if (std::filesystem::is_directory(source_path))
     {
         STEP_LOG(L_INFO, "Camera {}: Searching for frames in directory {}", source_path.string(), m_settings.id);
@@ -45,20 +50,50 @@ FakeFrameProvider::FakeFrameProvider(const FakeCameraSettings& settings) : m_set
             if (std::filesystem::is_directory(entry))  // skip directories
                 continue;
 
-            const auto& entry_path = entry.path();
-            add_frame(m_frames, entry_path, [cam_id = m_settings.id](const std::filesystem::path& path) {
-                STEP_LOG(L_DEBUG, "Camera {}: Path {} does not point to a valid frame", path.string(), cam_id);
-            });
+            candidates.push_back(entry.path());
         }
 
-        STEP_ASSERT(!m_frames.empty(), "Directory {} does not contain any valid frames", source_path.string());
+        handle_error = [cam_id = m_settings.id](const std::filesystem::path& path) {
+            STEP_LOG(L_DEBUG, "Camera {}: Path {} does not point to a valid frame", path.string(), cam_id);
+        };
     }
     else  // assume single file
     {
-        add_frame(m_frames, source_path, [](const std::filesystem::path& path) {
+        candidates.push_back(source_path);
+        handle_error = [](const std::filesystem::path& path) {
             STEP_THROW_RUNTIME("Path {} does not point to a valid frame", path.string());
-        });
+        };
     }
+
+    size_t frames_count = 0;
+    switch (m_settings.replay)
+    {
+        case FakeFrameReplay::Memory:
+            m_store = create_memory_frame_store(candidates, m_settings.pix_fmt, handle_error);
+            frames_count = m_store->size();
+            break;
+        case FakeFrameReplay::Mapped:
+        {
+            const auto raw_path = m_settings.replay_file.empty()
+                                      ? get_default_replay_file(source_path, m_settings.pix_fmt)
+                                      : m_settings.replay_file;
+            m_store = create_mapped_frame_store(candidates, m_settings.pix_fmt, raw_path, handle_error);
+            frames_count = m_store->size();
+            break;
+        }
+        default:
+            for (const auto& path : candidates)
+                add_frame(m_paths, path, handle_error);
+            frames_count = m_paths.size();
+            break;
+    }
+
+    STEP_ASSERT(frames_count > 0, "Path {} does not contain any valid frames", source_path.string());
+    STEP_LOG(L_INFO, "Camera {}: {} frames, replay {}", m_settings.id, frames_count,
+             step::utils::to_string(m_settings.replay));
+
+    for (size_t i = 0; i < frames_count; ++i)
+        m_frames.push_back(i);
 }
 
 Frame FakeFrameProvider::get_next_frame()
@@ -72,17 +107,20 @@ Frame FakeFrameProvider::get_next_frame()
         swap(m_frames, m_retired_frames);
     }
 
-    auto next_frame_path = m_frames.front();
+    const auto next_frame = m_frames.front();
     m_frames.pop_front();
 
     if (m_settings.is_cyclic)
     {
-        // clone the frame for later refilling
-        m_retired_frames.push_back(next_frame_path);
+        // keep the frame index for later refilling
+        m_retired_frames.push_back(next_frame);
     }
 
+    if (m_store)
+        return m_store->get_frame(next_frame);
+
     // open_file() must succeed since each path is tested in the ctor
-    return utils::open_file(next_frame_path.string(), m_settings.pix_fmt);
+    return utils::open_file(m_paths[next_frame].string(), m_settings.pix_fmt);
 }
 
 void FakeCameraStreamer::start()
@@ -94,10 +132,10 @@ void FakeCameraStreamer::start()
     }
 
     STEP_LOG(L_INFO, "Camera {}: Starting streaming...", m_provider.settings().id);
-    // sleep according to the specified FPS
-    const std::int64_t sleep = 1000.0 / static_cast<double>(m_provider.settings().frame_rate.value());
+    const auto frame_rate = static_cast<double>(m_provider.settings().frame_rate.value());
+    const auto frame_period = Microseconds(static_cast<std::int64_t>(1'000'000.0 / frame_rate));
     const bool is_cyclic = m_provider.settings().is_cyclic;
-    m_streamer_thread = std::thread(&FakeCameraStreamer::stream, this, std::chrono::milliseconds(sleep), is_cyclic);
+    m_streamer_thread = std::thread(&FakeCameraStreamer::stream, this, frame_period, is_cyclic);
 }
 
 void FakeCameraStreamer::stop()
@@ -110,8 +148,14 @@ void FakeCameraStreamer::stop()
     }
 }
 
-void FakeCameraStreamer::stream(std::chrono::milliseconds sleep_ms, bool is_cyclic)
+void FakeCameraStreamer::stream(Microseconds frame_period, bool is_cyclic)
 {
+    // Срок каждого кадра считается от начала потока, а не от предыдущего кадра:
+    // время загрузки и обработки кадра не сдвигает темп
+    step::utils::MediaClock clock;
+    Timestamp frame_ts{0};
+    clock.start(frame_ts);
+
     while (m_is_streaming)
     {
         Frame frame;
@@ -133,7 +177,16 @@ void FakeCameraStreamer::stream(std::chrono::milliseconds sleep_ms, bool is_cycl
 
         handle_frame(std::move(frame));
 
-        std::this_thread::sleep_for(sleep_ms);
+        frame_ts += frame_period;
+        if (clock.get_lateness(frame_ts) > frame_period)
+        {
+            // Отстали больше чем на кадр - пачкой не догоняем, отсчет начинается заново
+            ++m_late_count;
+            clock.start(frame_ts);
+            continue;
+        }
+
+        std::this_thread::sleep_until(clock.get_deadline(frame_ts));
     }
 }
 
@@ -1,14 +1,17 @@
 #pragma once
 
 #include <video/camera/camera_fake/fake_camera_settings.hpp>
+#include <video/camera/camera_fake/fake_frame_store.hpp>
 
 #include <video/frame/interfaces/frame.hpp>
 
 #include <atomic>
 #include <deque>
 #include <filesystem>
+#include <memory>
 #include <thread>
 #include <mutex>
+#include <vector>
 
 namespace step::video {
 
@@ -24,8 +27,10 @@ public:
     FakeCameraSettings settings() const { return m_settings; }
 
 private:
-    std::deque<std::filesystem::path> m_frames;
-    std::deque<std::filesystem::path> m_retired_frames;
+    std::vector<std::filesystem::path> m_paths;  ///< файлы для декодирования на каждом кадре (replay decode)
+    std::unique_ptr<IFakeFrameStore> m_store;    ///< заранее декодированные кадры (replay memory/mapped)
+    std::deque<size_t> m_frames;
+    std::deque<size_t> m_retired_frames;
     FakeCameraSettings m_settings;
 };
 
@@ -52,13 +57,18 @@ public:
     void stop() override;
     bool exhausted() const;
 
+    /*! @brief Сколько раз поток не успел к сроку кадра больше чем на период и начал отсчет заново.
+    */
+    uint64_t get_late_count() const noexcept { return m_late_count; }
+
 private:
-    void stream(std::chrono::milliseconds sleep_ms, bool is_cyclic);
+    void stream(Microseconds frame_period, bool is_cyclic);
 
     FakeFrameProvider m_provider;
     mutable std::mutex m_provider_mutex;
 
     std::thread m_streamer_thread{};
+    std::atomic<uint64_t> m_late_count{0};
 };
 
 }  // namespace step::video
@@ -1,6 +1,37 @@
 #include "fake_camera_settings.hpp"
 
 #include <core/base/types/config_fields.hpp>
+#include <core/base/utils/find_pair.hpp>
+#include <core/base/utils/string_utils.hpp>
+#include <core/exception/assert.hpp>
+
+namespace {
+
+/* clang-format off */
+const std::pair<step::video::FakeFrameReplay, std::string> g_replay_modes[] = {
+    { step::video::FakeFrameReplay::Decode  , "decode" },
+    { step::video::FakeFrameReplay::Memory  , "memory" },
+    { step::video::FakeFrameReplay::Mapped  , "mapped" },
+};
+/* clang-format on */
+
+}  // namespace
+
+namespace step::utils {
+
+template <>
+std::string to_string(step::video::FakeFrameReplay mode)
+{
+    return find_by_type(mode, g_replay_modes);
+}
+
+template <>
+void from_string(step::video::FakeFrameReplay& mode, const std::string& str)
+{
+    find_by_str(str, mode, g_replay_modes);
+}
+
+}  // namespace step::utils
 
 namespace step::video {
 
@@ -11,6 +42,8 @@ bool FakeCameraSettings::operator==(const FakeCameraSettings& rhs) const noexcep
         && CameraSettings::operator==(rhs)
         && source_path == rhs.source_path
         && is_cyclic == rhs.is_cyclic
+        && replay == rhs.replay
+        && replay_file == rhs.replay_file
     ;
     /* clang-format on */
 }
@@ -20,6 +53,9 @@ void FakeCameraSettings::serialize(ObjectPtrJSON& container)
     CameraSettings::serialize(container);
     json::set(container, CFG_FLD::PATH, source_path.string());
     json::set(container, CFG_FLD::CYCLIC, is_cyclic);
+    json::set(container, CFG_FLD::REPLAY, step::utils::to_string(replay));
+    if (!replay_file.empty())
+        json::set(container, CFG_FLD::REPLAY_FILE, replay_file.string());
 }
 
 void FakeCameraSettings::deserialize(const ObjectPtrJSON& container)
@@ -27,6 +63,9 @@ void FakeCameraSettings::deserialize(const ObjectPtrJSON& container)
     CameraSettings::deserialize(container);
     source_path = json::get<std::string>(container, CFG_FLD::PATH);
     is_cyclic = json::get<bool>(container, CFG_FLD::CYCLIC);
+    step::utils::from_string(replay, json::get<std::string>(container, CFG_FLD::REPLAY, "decode"));
+    STEP_ASSERT(replay != FakeFrameReplay::Undefined, "Fake camera {}: invalid replay mode", id);
+    replay_file = json::get<std::string>(container, CFG_FLD::REPLAY_FILE, "");
 }
 
 }  // namespace step::video
\ No newline at end of file
@@ -8,10 +8,22 @@
 
 namespace step::video {
 
+/*! @brief Откуда берутся кадры при выдаче.
+*/
+enum class FakeFrameReplay
+{
+    Undefined,
+    Decode,  ///< файл изображения декодируется на каждый кадр
+    Memory,  ///< все изображения декодируются один раз при создании и хранятся в памяти
+    Mapped,  ///< декодированные кадры один раз пишутся в файл replay_file, который отображается в память
+};
+
 struct FakeCameraSettings : public CameraSettings
 {
     std::filesystem::path source_path{};
     bool is_cyclic{false};
+    FakeFrameReplay replay{FakeFrameReplay::Decode};
+    std::filesystem::path replay_file{};  ///< для Mapped, пусто - файл во временном каталоге по пути source_path
 
     FakeCameraSettings() = default;
     FakeCameraSettings(const std::filesystem::path& p) : source_path(p) {}
@@ -0,0 +1,270 @@
+#include "fake_frame_store.hpp"
+
+#include <video/frame/utils/frame_utils.hpp>
+
+#include <core/exception/assert.hpp>
+#include <core/log/log.hpp>
+
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <thread>
+
+namespace {
+
+constexpr char RAW_FILE_MAGIC[8] = {'S', 'T', 'E', 'P', 'R', 'A', 'W', '1'};
+constexpr uint64_t RAW_DATA_ALIGNMENT = 64;
+
+struct RawFileHeader
+{
+    char magic[8];
+    uint64_t source_hash;
+    uint32_t pix_fmt;
+    uint32_t count;
+};
+
+struct RawFrameEntry
+{
+    uint64_t offset;
+    uint64_t stride;
+    uint64_t width;
+    uint64_t height;
+};
+
+uint64_t align_up(uint64_t value) { return (value + RAW_DATA_ALIGNMENT - 1) / RAW_DATA_ALIGNMENT * RAW_DATA_ALIGNMENT; }
+
+// FNV-1a
+void hash_bytes(uint64_t& hash, const void* data, size_t size)
+{
+    const auto* bytes = static_cast<const uint8_t*>(data);
+    for (size_t i = 0; i < size; ++i)
+    {
+        hash ^= bytes[i];
+        hash *= 1099511628211ull;
+    }
+}
+
+uint64_t get_source_hash(const std::vector<std::filesystem::path>& paths, step::video::PixFmt pix_fmt)
+{
+    uint64_t hash = 14695981039346656037ull;
+    const auto fmt = static_cast<uint32_t>(pix_fmt);
+    hash_bytes(hash, &fmt, sizeof(fmt));
+    for (const auto& path : paths)
+    {
+        const auto name = path.string();
+        std::error_code ec;
+        const uint64_t file_size = std::filesystem::file_size(path, ec);
+        const int64_t write_time = std::filesystem::last_write_time(path, ec).time_since_epoch().count();
+        hash_bytes(hash, name.data(), name.size());
+        hash_bytes(hash, &file_size, sizeof(file_size));
+        hash_bytes(hash, &write_time, sizeof(write_time));
+    }
+    return hash;
+}
+
+}  // namespace
+
+namespace step::video {
+
+namespace {
+
+class MemoryFrameStore : public IFakeFrameStore
+{
+public:
+    MemoryFrameStore(const std::vector<std::filesystem::path>& paths, PixFmt pix_fmt,
+                     const FakeFrameErrorHandler& on_error)
+    {
+        m_frames.reserve(paths.size());
+        for (const auto& path : paths)
+        {
+            auto frame = utils::open_file(path.string(), pix_fmt);
+            if (frame.is_valid())
+                m_frames.push_back(std::move(frame));
+            else
+                on_error(path);
+        }
+    }
+
+    size_t size() const override { return m_frames.size(); }
+
+    Frame get_frame(size_t index) const override
+    {
+        STEP_ASSERT(index < m_frames.size(), "Invalid fake frame index {}", index);
+        // Копирующий конструктор Frame копирует данные, кэш остается неизменным
+        Frame frame = m_frames[index];
+        frame.ts = get_current_timestamp();
+        return frame;
+    }
+
+private:
+    std::vector<Frame> m_frames;
+};
+
+class MappedFrameStore : public IFakeFrameStore
+{
+public:
+    MappedFrameStore(const std::vector<std::filesystem::path>& paths, PixFmt pix_fmt,
+                     const std::filesystem::path& raw_path, const FakeFrameErrorHandler& on_error)
+        : m_pix_fmt(pix_fmt)
+    {
+        const auto source_hash = get_source_hash(paths, pix_fmt);
+        if (!open(raw_path, source_hash))
+        {
+            build(paths, raw_path, source_hash, on_error);
+            STEP_ASSERT(open(raw_path, source_hash), "Can't map fake camera frames file {}", raw_path.string());
+        }
+    }
+
+    size_t size() const override { return m_entries.size(); }
+
+    Frame get_frame(size_t index) const override
+    {
+        STEP_ASSERT(index < m_entries.size(), "Invalid fake frame index {}", index);
+        const auto& entry = m_entries[index];
+        auto* data = static_cast<Frame::DataTypePtr>(m_region.get_address()) + entry.offset;
+        // Отображение только для чтения, наружу отдается копия
+        return Frame::create_deep(FrameSize(entry.width, entry.height), entry.stride, m_pix_fmt, data);
+    }
+
+private:
+    bool open(const std::filesystem::path& raw_path, uint64_t source_hash)
+    {
+        std::error_code ec;
+        if (!std::filesystem::is_regular_file(raw_path, ec))
+            return false;
+
+        try
+        {
+            boost::interprocess::file_mapping mapping(raw_path.string().c_str(), boost::interprocess::read_only);
+            boost::interprocess::mapped_region region(mapping, boost::interprocess::read_only);
+
+            const auto* base = static_cast<const uint8_t*>(region.get_address());
+            const auto file_size = region.get_size();
+            if (file_size < sizeof(RawFileHeader))
+                return false;
+
+            RawFileHeader header;
+            std::memcpy(&header, base, sizeof(header));
+            /* clang-format off */
+            const bool is_valid_header = true
+                && std::memcmp(header.magic, RAW_FILE_MAGIC, sizeof(RAW_FILE_MAGIC)) == 0
+                && header.source_hash == source_hash
+                && header.pix_fmt == static_cast<uint32_t>(m_pix_fmt)
+                && sizeof(RawFileHeader) + header.count * sizeof(RawFrameEntry) <= file_size
+            ;
+            /* clang-format on */
+            if (!is_valid_header)
+                return false;
+
+            std::vector<RawFrameEntry> entries(header.count);
+            std::memcpy(entries.data(), base + sizeof(RawFileHeader), header.count * sizeof(RawFrameEntry));
+            for (const auto& entry : entries)
+            {
+                if (entry.offset + entry.stride * entry.height > file_size)
+                    return false;
+            }
+
+            // Страницы понадобятся по кругу, подсказываем ядру держать их
+            region.advise(boost::interprocess::mapped_region::advice_willneed);
+
+            m_mapping = std::move(mapping);
+            m_region = std::move(region);
+            m_entries = std::move(entries);
+            return true;
+        }
+        catch (const std::exception& e)
+        {
+            STEP_LOG(L_WARN, "Can't map fake camera frames file {}: {}", raw_path.string(), e.what());
+            return false;
+        }
+    }
+
+    void build(const std::vector<std::filesystem::path>& paths, const std::filesystem::path& raw_path,
+               uint64_t source_hash, const FakeFrameErrorHandler& on_error)
+    {
+        // Камеры с одним набором изображений могут собирать файл одновременно: пишем во временный и переименовываем
+        auto tmp_path = raw_path;
+        tmp_path += fmt::format(".{}.tmp", std::hash<std::thread::id>()(std::this_thread::get_id()));
+
+        std::ofstream out(tmp_path, std::ios::binary | std::ios::trunc);
+        STEP_ASSERT(out, "Can't create fake camera frames file {}", tmp_path.string());
+
+        RawFileHeader header{};
+        std::memcpy(header.magic, RAW_FILE_MAGIC, sizeof(RAW_FILE_MAGIC));
+        header.source_hash = source_hash;
+        header.pix_fmt = static_cast<uint32_t>(m_pix_fmt);
+
+        // Таблица кадров резервируется на все файлы, невалидные пропускаются
+        std::vector<RawFrameEntry> entries;
+        uint64_t offset = align_up(sizeof(RawFileHeader) + paths.size() * sizeof(RawFrameEntry));
+        for (const auto& path : paths)
+        {
+            const auto frame = utils::open_file(path.string(), m_pix_fmt);
+            if (!frame.is_valid())
+            {
+                on_error(path);
+                continue;
+            }
+
+            out.seekp(static_cast<std::streamoff>(offset));
+            out.write(reinterpret_cast<const char*>(frame.data()), static_cast<std::streamsize>(frame.bytesize()));
+            entries.push_back({offset, frame.stride, frame.size.width, frame.size.height});
+            offset = align_up(offset + frame.bytesize());
+        }
+
+        header.count = static_cast<uint32_t>(entries.size());
+        out.seekp(0);
+        out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        out.write(reinterpret_cast<const char*>(entries.data()),
+                  static_cast<std::streamsize>(entries.size() * sizeof(RawFrameEntry)));
+        out.close();
+        STEP_ASSERT(out, "Failed to write fake camera frames file {}", tmp_path.string());
+
+        std::error_code ec;
+        std::filesystem::rename(tmp_path, raw_path, ec);
+        if (ec)
+        {
+            // Файл уже собран другой камерой и занят
+            STEP_LOG(L_DEBUG, "Can't replace fake camera frames file {}: {}", raw_path.string(), ec.message());
+            std::filesystem::remove(tmp_path, ec);
+            return;
+        }
+
+        STEP_LOG(L_INFO, "Fake camera frames file {} is built: {} frames, {} MB", raw_path.string(), entries.size(),
+                 offset / (1024 * 1024));
+    }
+
+private:
+    PixFmt m_pix_fmt;
+    boost::interprocess::file_mapping m_mapping;
+    boost::interprocess::mapped_region m_region;
+    std::vector<RawFrameEntry> m_entries;
+};
+
+}  // namespace
+
+std::unique_ptr<IFakeFrameStore> create_memory_frame_store(const std::vector<std::filesystem::path>& paths,
+                                                           PixFmt pix_fmt, const FakeFrameErrorHandler& on_error)
+{
+    return std::make_unique<MemoryFrameStore>(paths, pix_fmt, on_error);
+}
+
+std::unique_ptr<IFakeFrameStore> create_mapped_frame_store(const std::vector<std::filesystem::path>& paths,
+                                                           PixFmt pix_fmt, const std::filesystem::path& raw_path,
+                                                           const FakeFrameErrorHandler& on_error)
+{
+    return std::make_unique<MappedFrameStore>(paths, pix_fmt, raw_path, on_error);
+}
+
+std::filesystem::path get_default_replay_file(const std::filesystem::path& source_path, PixFmt pix_fmt)
+{
+    const auto source = std::filesystem::absolute(source_path).string();
+    const auto name = fmt::format("seekira_fake_camera_{:016x}_{}.raw", std::hash<std::string>()(source),
+                                  static_cast<int>(pix_fmt));
+    return std::filesystem::temp_directory_path() / name;
+}
+
+}  // namespace step::video
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <video/frame/interfaces/frame.hpp>
+
+#include <filesystem>
+#include <functional>
+#include <memory>
+#include <vector>
+
+namespace step::video {
+
+/*! @brief Кадры фейковой камеры, декодированные один раз.
+    @details Выдача кадра - только копирование данных: потребители могут менять кадр (отрисовка),
+    поэтому общий буфер наружу не отдается.
+*/
+class IFakeFrameStore
+{
+public:
+    virtual ~IFakeFrameStore() = default;
+
+    virtual size_t size() const = 0;
+    virtual Frame get_frame(size_t index) const = 0;
+};
+
+/*! @brief Вызывается для файла, который не удалось декодировать, такие файлы пропускаются.
+*/
+using FakeFrameErrorHandler = std::function<void(const std::filesystem::path&)>;
+
+/*! @brief Кадры в памяти процесса.
+*/
+std::unique_ptr<IFakeFrameStore> create_memory_frame_store(const std::vector<std::filesystem::path>& paths,
+                                                           PixFmt pix_fmt, const FakeFrameErrorHandler& on_error);
+
+/*! @brief Кадры в файле raw_path, отображаемом в память.
+    @details Файл пересобирается, если он не соответствует набору изображений (имена, размеры, время изменения)
+    или формату пикселей, иначе изображения не декодируются вовсе. Несколько камер с одним набором
+    изображений используют одни и те же страницы файла.
+*/
+std::unique_ptr<IFakeFrameStore> create_mapped_frame_store(const std::vector<std::filesystem::path>& paths,
+                                                           PixFmt pix_fmt, const std::filesystem::path& raw_path,
+                                                           const FakeFrameErrorHandler& on_error);
+
+/*! @brief Путь файла кадров по умолчанию: во временном каталоге, имя зависит от набора изображений и формата.
+*/
+std::filesystem::path get_default_replay_file(const std::filesystem::path& source_path, PixFmt pix_fmt);
+
+}  // namespace step::video
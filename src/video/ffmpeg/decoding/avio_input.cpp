@@ -0,0 +1,316 @@
+#include "avio_input.hpp"
+
+#include <core/exception/assert.hpp>
+#include <core/log/log.hpp>
+
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+
+extern "C" {
+#include <libavutil/mem.h>
+}
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <mutex>
+
+namespace {
+
+constexpr int AVIO_BUFFER_SIZE = 64 * 1024;               // буфер самого AVIOContext, из него читает демуксер
+constexpr size_t FALLBACK_BLOCK_SIZE = 1024 * 1024;  // если mmap не удался, а размер блока не задан
+
+}  // namespace
+
+namespace step::video::ff {
+
+namespace {
+
+class FileIoBackend : public IIoBackend
+{
+public:
+    FileIoBackend(const std::string& filename) : m_stream(filename, std::ios::binary)
+    {
+        if (!m_stream)
+            STEP_THROW_RUNTIME("Can't open file {} for reading", filename);
+
+        m_stream.seekg(0, std::ios::end);
+        m_size = static_cast<int64_t>(m_stream.tellg());
+        m_stream.seekg(0, std::ios::beg);
+    }
+
+    size_t read_at(int64_t offset, uint8_t* buffer, size_t size) override
+    {
+        std::scoped_lock lock(m_guard);
+        m_stream.clear();
+        m_stream.seekg(offset);
+        m_stream.read(reinterpret_cast<char*>(buffer), static_cast<std::streamsize>(size));
+        return static_cast<size_t>(m_stream.gcount());
+    }
+
+    int64_t size() const override { return m_size; }
+
+private:
+    std::mutex m_guard;
+    std::ifstream m_stream;
+    int64_t m_size{0};
+};
+
+class MappedFileIoBackend : public IIoBackend
+{
+public:
+    MappedFileIoBackend(const std::string& filename)
+        : m_mapping(filename.c_str(), boost::interprocess::read_only)
+        , m_region(m_mapping, boost::interprocess::read_only)
+    {
+        // Чтение почти всегда последовательное, подсказка ядру увеличить упреждение
+        m_region.advise(boost::interprocess::mapped_region::advice_sequential);
+    }
+
+    size_t read_at(int64_t offset, uint8_t* buffer, size_t size) override
+    {
+        if (offset < 0 || offset >= this->size())
+            return 0;
+
+        const auto count = std::min(size, static_cast<size_t>(this->size() - offset));
+        std::memcpy(buffer, data() + offset, count);
+        return count;
+    }
+
+    int64_t size() const override { return static_cast<int64_t>(m_region.get_size()); }
+
+    const uint8_t* data() const override { return static_cast<const uint8_t*>(m_region.get_address()); }
+
+private:
+    boost::interprocess::file_mapping m_mapping;
+    boost::interprocess::mapped_region m_region;
+};
+
+TimeFF elapsed_since(std::chrono::steady_clock::time_point start)
+{
+    return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+}
+
+}  // namespace
+
+AVIOInputFF::AVIOInputFF(const std::string& filename, const IoSettings& settings) : m_settings(settings)
+{
+    if (m_settings.use_mmap)
+    {
+        try
+        {
+            m_backend = std::make_unique<MappedFileIoBackend>(filename);
+        }
+        catch (const std::exception& e)
+        {
+            STEP_LOG(L_WARN, "Can't map file {} to memory, buffered reading is used: {}", filename, e.what());
+        }
+    }
+
+    if (!m_backend)
+    {
+        m_backend = std::make_unique<FileIoBackend>(filename);
+        if (m_settings.buffer_size == 0)
+            m_settings.buffer_size = FALLBACK_BLOCK_SIZE;
+    }
+
+    m_size = m_backend->size();
+
+    auto* avio_buffer = static_cast<uint8_t*>(av_malloc(AVIO_BUFFER_SIZE));
+    if (!avio_buffer)
+        STEP_THROW_RUNTIME("Can't allocate AVIO buffer for file {}", filename);
+
+    m_context = avio_alloc_context(avio_buffer, AVIO_BUFFER_SIZE, 0, this, &AVIOInputFF::read_callback, nullptr,
+                                   &AVIOInputFF::seek_callback);
+    if (!m_context)
+    {
+        av_free(avio_buffer);
+        STEP_THROW_RUNTIME("Can't allocate AVIO context for file {}", filename);
+    }
+
+    STEP_LOG(L_DEBUG, "Custom AVIO for {}: size {}, mmap {}, block {}, prefetch {}", filename, m_size,
+             !!m_backend->data(), m_settings.buffer_size, m_settings.prefetch);
+}
+
+AVIOInputFF::~AVIOInputFF()
+{
+    // Фоновое чтение обращается к backend, дожидаемся его до разрушения
+    if (m_prefetch.valid())
+        m_prefetch.wait();
+
+    if (m_context)
+    {
+        av_freep(&m_context->buffer);
+        avio_context_free(&m_context);
+    }
+
+    const auto stats = get_stats();
+    STEP_LOG(L_DEBUG, "Custom AVIO closed: read {} bytes in {} calls, fetched {} bytes in {} reads, {} seeks, "
+             "{} prefetch hits, stall {} us", stats.bytes_read, stats.read_calls, stats.bytes_fetched,
+             stats.storage_reads, stats.seeks, stats.prefetch_hits, stats.stall_time);
+}
+
+IoStats AVIOInputFF::get_stats() const
+{
+    IoStats stats;
+    stats.bytes_read = m_bytes_read;
+    stats.bytes_fetched = m_bytes_fetched;
+    stats.read_calls = m_read_calls;
+    stats.storage_reads = m_storage_reads;
+    stats.seeks = m_seeks;
+    stats.prefetch_hits = m_prefetch_hits;
+    stats.stall_time = m_stall_time;
+    return stats;
+}
+
+int AVIOInputFF::read_callback(void* opaque, uint8_t* buffer, int size)
+{
+    // Исключения не должны уходить в C-код ffmpeg
+    try
+    {
+        return static_cast<AVIOInputFF*>(opaque)->read(buffer, size);
+    }
+    catch (const std::exception& e)
+    {
+        STEP_LOG(L_ERROR, "Custom AVIO read error: {}", e.what());
+        return AVERROR(EIO);
+    }
+}
+
+int64_t AVIOInputFF::seek_callback(void* opaque, int64_t offset, int whence)
+{
+    return static_cast<AVIOInputFF*>(opaque)->seek(offset, whence);
+}
+
+int AVIOInputFF::read(uint8_t* buffer, int size)
+{
+    ++m_read_calls;
+    if (size <= 0)
+        return 0;
+    if (m_position >= m_size)
+        return AVERROR_EOF;
+
+    const auto requested = static_cast<int>(std::min<int64_t>(size, m_size - m_position));
+
+    // mmap: данные уже в памяти, блоки не нужны
+    if (const auto* data = m_backend->data())
+    {
+        std::memcpy(buffer, data + m_position, requested);
+        m_position += requested;
+        m_bytes_read += requested;
+        return requested;
+    }
+
+    int copied = 0;
+    while (copied < requested)
+    {
+        if (!m_block.contains(m_position) && !load_block(m_position))
+            break;
+
+        const auto block_pos = static_cast<size_t>(m_position - m_block.offset);
+        const auto count = static_cast<int>(std::min<size_t>(requested - copied, m_block.size - block_pos));
+        std::memcpy(buffer + copied, m_block.data.data() + block_pos, count);
+        copied += count;
+        m_position += count;
+    }
+
+    m_bytes_read += copied;
+    return copied > 0 ? copied : AVERROR(EIO);
+}
+
+int64_t AVIOInputFF::seek(int64_t offset, int whence)
+{
+    int64_t position = 0;
+    switch (whence & ~AVSEEK_FORCE)
+    {
+        case AVSEEK_SIZE:
+            return m_size;
+        case SEEK_SET:
+            position = offset;
+            break;
+        case SEEK_CUR:
+            position = m_position + offset;
+            break;
+        case SEEK_END:
+            position = m_size + offset;
+            break;
+        default:
+            return AVERROR(EINVAL);
+    }
+
+    if (position < 0)
+        return AVERROR(EINVAL);
+
+    if (position != m_position)
+        ++m_seeks;
+
+    // Хранилище не трогаем: блок под новую позицию читается при первом чтении
+    m_position = position;
+    return m_position;
+}
+
+AVIOInputFF::Block AVIOInputFF::fetch_block(int64_t offset, std::vector<uint8_t>&& data)
+{
+    Block block;
+    block.offset = offset;
+    block.data = std::move(data);
+    block.data.resize(m_settings.buffer_size);
+    block.size = m_backend->read_at(offset, block.data.data(), block.data.size());
+
+    ++m_storage_reads;
+    m_bytes_fetched += block.size;
+    return block;
+}
+
+bool AVIOInputFF::load_block(int64_t offset)
+{
+    const auto start = std::chrono::steady_clock::now();
+
+    Block block;
+    if (m_prefetch.valid() && m_prefetch_offset == offset)
+    {
+        if (m_prefetch.wait_for(std::chrono::seconds(0)) == std::future_status::ready)
+            ++m_prefetch_hits;
+        block = m_prefetch.get();
+    }
+    else
+    {
+        // Упреждение ушло не туда (был seek) - оно закончится само, читаем нужный блок синхронно
+        block = fetch_block(offset, {});
+    }
+    m_stall_time += elapsed_since(start);
+
+    auto free_data = std::move(m_block.data);
+    m_block = std::move(block);
+    if (m_block.size == 0)
+        return false;
+
+    if (m_settings.prefetch)
+        start_prefetch(m_block.offset + static_cast<int64_t>(m_block.size), std::move(free_data));
+
+    return true;
+}
+
+void AVIOInputFF::start_prefetch(int64_t offset, std::vector<uint8_t>&& data)
+{
+    if (offset >= m_size)
+        return;
+
+    // Упреждение, ушедшее не туда после seek, может еще читать. Новое ставится в очередь за ним:
+    // к хранилищу идет не больше одного фонового чтения, и блок после seek все равно читается заранее
+    auto stale = std::move(m_prefetch);
+    m_prefetch_offset = offset;
+    m_prefetch = std::async(std::launch::async,
+                            [this, offset, data = std::move(data), stale = std::move(stale)]() mutable {
+                                if (stale.valid())
+                                {
+                                    auto stale_block = stale.get();
+                                    if (data.empty())
+                                        data = std::move(stale_block.data);
+                                }
+                                return fetch_block(offset, std::move(data));
+                            });
+}
+
+}  // namespace step::video::ff
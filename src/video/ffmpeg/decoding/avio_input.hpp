@@ -0,0 +1,119 @@
+#pragma once
+
+#include <video/ffmpeg/interfaces/types.hpp>
+
+extern "C" {
+#include <libavformat/avio.h>
+}
+
+#include <atomic>
+#include <cstdint>
+#include <future>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace step::video::ff {
+
+/*! @brief Настройки собственного слоя ввода для AVFormatContext.
+    @details При buffer_size == 0 и выключенном mmap используется стандартный ввод ffmpeg.
+*/
+struct IoSettings
+{
+    size_t buffer_size{0};  ///< размер блока упреждающего чтения в байтах
+    bool use_mmap{false};   ///< отображение локального файла в память вместо чтения
+    bool prefetch{false};   ///< фоновое чтение следующего блока, пока читается текущий
+
+    bool is_custom() const noexcept { return buffer_size > 0 || use_mmap; }
+};
+
+/*! @brief Статистика ввода: что запросил демуксер и сколько это стоило хранилищу.
+*/
+struct IoStats
+{
+    uint64_t bytes_read{0};     ///< отдано демуксеру
+    uint64_t bytes_fetched{0};  ///< прочитано из хранилища (с упреждением), для mmap - 0
+    uint64_t read_calls{0};
+    uint64_t storage_reads{0};  ///< обращения к хранилищу
+    uint64_t seeks{0};
+    uint64_t prefetch_hits{0};  ///< блоки, которые уже были прочитаны фоном к моменту запроса
+    TimeFF stall_time{0};       ///< время ожидания хранилища в потоке демуксера, мкс
+};
+
+/*! @brief Реализация ввода, которую отдает ffmpeg AVIOContext.
+*/
+class IIoBackend
+{
+public:
+    virtual ~IIoBackend() = default;
+
+    /*! @brief Читает до size байт с позиции offset, возвращает прочитанное количество. Потокобезопасно.
+    */
+    virtual size_t read_at(int64_t offset, uint8_t* buffer, size_t size) = 0;
+    virtual int64_t size() const = 0;
+
+    /*! @brief Данные без копирования, если backend их держит в памяти (mmap), иначе nullptr.
+    */
+    virtual const uint8_t* data() const { return nullptr; }
+};
+
+/*! @brief AVIOContext поверх файла с большим блоком упреждающего чтения или mmap.
+    @details Блоки читаются целиком: мелкие чтения демуксера и seek внутри блока не доходят до хранилища.
+    С prefetch следующий блок читается фоном, после seek упреждение перезапускается с новой позиции.
+*/
+class AVIOInputFF
+{
+public:
+    AVIOInputFF(const std::string& filename, const IoSettings& settings);
+    ~AVIOInputFF();
+
+    AVIOContext* context() const noexcept { return m_context; }
+
+    IoStats get_stats() const;
+
+private:
+    struct Block
+    {
+        int64_t offset{-1};
+        size_t size{0};
+        std::vector<uint8_t> data;
+
+        bool contains(int64_t pos) const noexcept
+        {
+            return offset >= 0 && pos >= offset && pos < offset + static_cast<int64_t>(size);
+        }
+    };
+
+    static int read_callback(void* opaque, uint8_t* buffer, int size);
+    static int64_t seek_callback(void* opaque, int64_t offset, int whence);
+
+    int read(uint8_t* buffer, int size);
+    int64_t seek(int64_t offset, int whence);
+
+    Block fetch_block(int64_t offset, std::vector<uint8_t>&& data);
+    bool load_block(int64_t offset);
+    void start_prefetch(int64_t offset, std::vector<uint8_t>&& data);
+
+private:
+    std::unique_ptr<IIoBackend> m_backend;
+    IoSettings m_settings;
+    AVIOContext* m_context{nullptr};
+
+    int64_t m_position{0};
+    int64_t m_size{0};
+    Block m_block;
+    std::future<Block> m_prefetch;
+    int64_t m_prefetch_offset{-1};
+
+    /* clang-format off */
+    std::atomic<uint64_t> m_bytes_read      {0};
+    std::atomic<uint64_t> m_bytes_fetched   {0};
+    std::atomic<uint64_t> m_read_calls      {0};
+    std::atomic<uint64_t> m_storage_reads   {0};
+    std::atomic<uint64_t> m_seeks           {0};
+    std::atomic<uint64_t> m_prefetch_hits   {0};
+    std::atomic<TimeFF>   m_stall_time      {0};
+    /* clang-format on */
+};
+
+}  // namespace step::video::ff
@@ -6,6 +6,9 @@
 #include <video/ffmpeg/utils/utils.hpp>
 #include <video/ffmpeg/utils/image_utils.hpp>
 
+#include <algorithm>
+#include <cstring>
+
 namespace step::video::ff {
 
 namespace {
@@ -13,7 +16,8 @@ namespace {
 // TODO Choose format
 AVPixelFormat get_pixel_format(AVCodecContext*, const enum AVPixelFormat*) { return AV_PIX_FMT_BGR24; }
 
-bool get_context(AVCodecParameters* codec_par, AVRational fps, DecoderContextSafe& out_context)
+bool get_context(AVCodecParameters* codec_par, AVRational fps, const DecoderOptions& options,
+                 DecoderContextSafe& out_context)
 {
     DecoderContextSafe context(codec_par);
 
@@ -25,9 +29,22 @@ bool get_context(AVCodecParameters* codec_par, AVRational fps, DecoderContextSaf
     }
 
     context->workaround_bugs = 1;
-    context->lowres = 0;
+    context->lowres = std::clamp(options.lowres, 0, static_cast<int>(context->codec->max_lowres));
     context->idct_algo = FF_IDCT_AUTO;
 
+    if (options.threads != 1)
+    {
+        context->thread_count = std::max(options.threads, 0);
+        context->thread_type = FF_THREAD_FRAME | FF_THREAD_SLICE;
+    }
+
+    if (options.key_frames_only)
+    {
+        // В режиме перемотки кадры не используются как опорные для следующих, точность фильтров не важна
+        context->skip_frame = AVDISCARD_NONKEY;
+        context->skip_loop_filter = AVDISCARD_ALL;
+    }
+
     //context->get_format = get_pixel_format;
 
     /// UTVideo, HAP decoder requires codec_tag, it was set in parser
@@ -69,7 +86,7 @@ DecoderVideoFF::~DecoderVideoFF()
     m_codec.reset();
 }
 
-bool DecoderVideoFF::open(const FormatCodec& init)
+bool DecoderVideoFF::open(const FormatCodec& init, const DecoderOptions& options)
 {
     m_codec_id = init.codec_par->codec_id;
     m_codec_tag = init.codec_par->codec_tag;
@@ -79,15 +96,25 @@ bool DecoderVideoFF::open(const FormatCodec& init)
     /// Если это произойдет, то кадры будут приведены к текущим m_width и m_height.
     m_out_frame_size =
         FrameSize(static_cast<size_t>(init.codec_par->width), static_cast<size_t>(init.codec_par->height));
+    if (options.out_size.width > 0 && options.out_size.height > 0)
+        m_out_frame_size = options.out_size;
     m_image_flag = init.image_flag;
     m_clock = 0;
     m_clock_reset = true;
 
     m_can_reopen_decoder = false;
 
-    if (!get_context(init.codec_par, m_fps, m_codec))
+    if (!get_context(init.codec_par, m_fps, options, m_codec))
         return false;
 
+    // Без явного размера при lowres оставляем уменьшенный размер, иначе sws растянет кадр обратно
+    if (m_codec->lowres > 0 && (options.out_size.width == 0 || options.out_size.height == 0))
+        m_out_frame_size = FrameSize(static_cast<size_t>(m_codec->width), static_cast<size_t>(m_codec->height));
+
+    if (m_codec->lowres > 0 || options.key_frames_only)
+        STEP_LOG(L_INFO, "Decoder opened in reduced mode: lowres {}, key frames only {}, out size {}x{}",
+                 m_codec->lowres, options.key_frames_only, m_out_frame_size.width, m_out_frame_size.height);
+
     m_clock = AV_NOPTS_VALUE;
 
     m_use_dts = false;
@@ -97,14 +124,72 @@ bool DecoderVideoFF::open(const FormatCodec& init)
     m_open_pix_fmt = m_codec->pix_fmt;
 
     m_sws_context.reset();
+    // При lowres размеры контекста уже уменьшены декодером, масштабирование в выходной размер делает тот же sws
     STEP_LOG(L_INFO, "Try to create sample scaler for converting to best pix fmt");
     m_sws_context =
         SwsContextSafe(m_codec->width, m_codec->height, m_open_pix_fmt, m_out_frame_size.width, m_out_frame_size.height,
                        pix_fmt_to_avformat(m_best_pix_fmt), SWS_FAST_BILINEAR, nullptr, nullptr, nullptr);
 
+    init_analysis_scalers(options.analysis_frames);
+
     return true;
 }
 
+void DecoderVideoFF::init_analysis_scalers(const AnalysisFrameFormats& formats)
+{
+    m_analysis_scalers.clear();
+    m_analysis_scalers.reserve(formats.size());
+    for (const auto& format : formats)
+    {
+        STEP_ASSERT(format.size.width > 0 && format.size.height > 0, "Invalid analysis frame size {}", format.size);
+
+        auto scaled_size = format.size;
+        if (format.letterbox && m_codec->width > 0 && m_codec->height > 0)
+        {
+            const double scale = std::min(static_cast<double>(format.size.width) / m_codec->width,
+                                          static_cast<double>(format.size.height) / m_codec->height);
+            scaled_size.width =
+                std::clamp<size_t>(static_cast<size_t>(m_codec->width * scale + 0.5), 1, format.size.width);
+            scaled_size.height =
+                std::clamp<size_t>(static_cast<size_t>(m_codec->height * scale + 0.5), 1, format.size.height);
+        }
+
+        STEP_LOG(L_INFO, "Create analysis scaler: {} {}, letterbox {}, scaled {}", format.size, format.pix_fmt,
+                 format.letterbox, scaled_size);
+        // Для анализа важнее отсутствие алиасинга при сильном уменьшении, чем скорость bilinear
+        AnalysisScaler scaler;
+        scaler.format = format;
+        scaler.scaled_size = scaled_size;
+        scaler.sws_context = SwsContextSafe(m_codec->width, m_codec->height, m_open_pix_fmt,
+                                           static_cast<int>(scaled_size.width), static_cast<int>(scaled_size.height),
+                                           pix_fmt_to_avformat(format.pix_fmt), SWS_AREA);
+        m_analysis_scalers.push_back(std::move(scaler));
+    }
+}
+
+AnalysisFramesPtr DecoderVideoFF::make_analysis_frames(const AVFrame* avframe) const
+{
+    auto analysis_frames = std::make_shared<AnalysisFrames>();
+    analysis_frames->reserve(m_analysis_scalers.size());
+    for (const auto& scaler : m_analysis_scalers)
+    {
+        auto frame = std::make_shared<Frame>(scaler.format.size, scaler.format.pix_fmt);
+        if (scaler.scaled_size != scaler.format.size)
+            std::memset(frame->data(), 0, frame->bytesize());
+
+        // Пишем прямо в буфер кадра: при letterbox sws заполняет левый верхний угол с шагом строки всего кадра
+        uint8_t* dst_data[4] = {frame->data(), nullptr, nullptr, nullptr};
+        int dst_linesize[4] = {static_cast<int>(frame->stride), 0, 0, 0};
+        sws_scale(scaler.sws_context.get(), avframe->data, avframe->linesize, 0, avframe->height, dst_data,
+                  dst_linesize);
+
+        frame->ts = Microseconds(m_clock);
+        frame->duration = m_prev_duration_frame_pkt;
+        analysis_frames->push_back({scaler.format, std::move(frame)});
+    }
+    return analysis_frames;
+}
+
 void DecoderVideoFF::flush(TimestampFF start_time)
 {
     m_use_dts = false;
@@ -131,6 +216,7 @@ void DecoderVideoFF::release_internal_data()
     m_prev_frame.reset();
 
     m_sws_context.reset();
+    m_analysis_scalers.clear();
     if (m_codec && m_codec->codec)
     {
         avcodec_close(m_codec.get());
@@ -323,8 +409,10 @@ FramePtr DecoderVideoFF::decode_internal(const std::shared_ptr<IDataPacket>& dat
         {
             const auto channels_count = utils::get_channels_count(m_best_pix_fmt);
 
-            AVFrame* frame = allocate_avframe(pix_fmt_to_avformat(m_best_pix_fmt), m_codec->width, m_codec->height,
-                                              m_codec->width * channels_count);
+            const auto out_width = static_cast<int>(m_out_frame_size.width);
+            const auto out_height = static_cast<int>(m_out_frame_size.height);
+            AVFrame* frame = allocate_avframe(pix_fmt_to_avformat(m_best_pix_fmt), out_width, out_height,
+                                              out_width * channels_count);
 
             if (!frame)
                 return nullptr;
@@ -337,6 +425,9 @@ FramePtr DecoderVideoFF::decode_internal(const std::shared_ptr<IDataPacket>& dat
 
             frame_ptr->ts = Microseconds(m_clock);
             frame_ptr->duration = m_prev_duration_frame_pkt;
+
+            if (!m_analysis_scalers.empty())
+                frame_ptr->analysis_frames = make_analysis_frames(avframe.get());
         }
         catch (...)
         {
@@ -13,13 +13,24 @@
 
 namespace step::video::ff {
 
+/*! @brief Параметры декодирования для дешевых режимов (перемотка, превью).
+*/
+struct DecoderOptions
+{
+    bool key_frames_only{false};  ///< декодер отбрасывает неключевые кадры (AVDISCARD_NONKEY)
+    int lowres{0};  ///< декодирование в 1/2^lowres разрешения, если кодек поддерживает (ограничивается max_lowres)
+    FrameSize out_size{0, 0};  ///< размер выходного кадра, {0, 0} - размер исходного видео
+    AnalysisFrameFormats analysis_frames;  ///< копии для анализа, масштабируются из исходного кадра декодера
+    int threads{1};  ///< потоки декодера, 0 - по числу ядер; больше 1 задерживает выдачу кадров на число потоков
+};
+
 class DecoderVideoFF
 {
 public:
     DecoderVideoFF();
     ~DecoderVideoFF();
 
-    bool open(const FormatCodec& format_codec);
+    bool open(const FormatCodec& format_codec, const DecoderOptions& options = {});
     void flush(TimestampFF start_time);
     void release_internal_data();
     FramePtr decode(const std::shared_ptr<IDataPacket>& data);
@@ -28,6 +39,8 @@ private:
     FramePtr decode_internal(const std::shared_ptr<IDataPacket>& data);
     AVRational get_fps() const;
     FramePtr get_next_queued_frame();
+    void init_analysis_scalers(const AnalysisFrameFormats& formats);
+    AnalysisFramesPtr make_analysis_frames(const AVFrame* avframe) const;
 
 private:
     /* clang-format off */
@@ -55,6 +68,14 @@ private:
     std::queue<FramePtr> m_queue;
     FramePtr m_prev_frame;
 
+    struct AnalysisScaler
+    {
+        AnalysisFrameFormat format;
+        FrameSize scaled_size;  ///< при letterbox - область с изображением, иначе равен format.size
+        SwsContextSafe sws_context;
+    };
+    std::vector<AnalysisScaler> m_analysis_scalers;
+
     TimestampFF m_start_time {0}; /// начальная временная метка, выдаваемая декодером
     TimestampFF m_end_time{AV_NOPTS_VALUE};   /// конечная временная метка, выдаваемая декодером
 
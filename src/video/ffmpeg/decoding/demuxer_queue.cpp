@@ -52,6 +52,10 @@ TimestampFF DemuxerQueue::seek(TimestampFF time)
 
     m_seek_time = (std::max)(TimestampFF(0), time);  ///< фиксируем начальную временную метку
 
+    /// Если ключевой кадр для метки известен из индекса - позиционируемся сразу на него без подбора шага
+    if (time > 0 && seek_keyframe(m_seek_time))
+        return time;
+
     const TimestampFF WARN_STEP = 20 * AV_SECOND;
 
     TimestampFF step = AV_SECOND * 4;
@@ -70,6 +74,38 @@ TimestampFF DemuxerQueue::seek(TimestampFF time)
     return time;
 }
 
+bool DemuxerQueue::seek_keyframe(TimestampFF time)
+{
+    const auto keyframe = m_parser->get_keyframe_index().find(time);
+    if (!keyframe)
+        return false;
+
+    const StreamId index = m_parser->get_seek_stream();
+    reset_queue();
+    try
+    {
+        if (!m_parser->seek_to_keyframe(index, *keyframe))
+            return false;
+    }
+    catch (std::exception& e)
+    {
+        STEP_LOG(L_ERROR, "Handled exception: seek to keyframe. {}", e.what());
+        return false;
+    }
+
+    fill_queue(false);
+    if (!check_streams_position(m_seek_time))
+    {
+        STEP_LOG(L_WARN, "Seek to indexed keyframe {} for {} missed, fallback to search", keyframe->pts, time);
+        return false;
+    }
+
+    fill_queue(true);
+    STEP_LOG(L_DEBUG, "Seek {} by keyframe index: keyframe {}, gop length {}", time, keyframe->pts,
+             keyframe->gop_length);
+    return true;
+}
+
 bool DemuxerQueue::seek_internal(TimestampFF time)
 {
     StreamId idx_start, idx_stop;
@@ -36,6 +36,7 @@ private:
     bool fill_queue(bool key_packets_must_exist);
     bool read_packets_from_parser(int packet_count);
     bool seek_internal(TimestampFF time);
+    bool seek_keyframe(TimestampFF time);
 
 private:
     std::shared_ptr<ParserFF> m_parser;
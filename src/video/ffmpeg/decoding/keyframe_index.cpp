@@ -0,0 +1,262 @@
+#include "keyframe_index.hpp"
+
+#include <core/exception/assert.hpp>
+#include <core/log/log.hpp>
+
+#include <algorithm>
+#include <array>
+#include <fstream>
+
+namespace {
+
+constexpr std::array<char, 8> SIDECAR_MAGIC = {'S', 'T', 'E', 'P', 'K', 'F', 'I', 'X'};
+constexpr uint32_t SIDECAR_VERSION = 1;
+const std::string SIDECAR_EXTENSION = ".kfidx";
+
+template <typename T>
+void write_value(std::ofstream& stream, const T& value)
+{
+    stream.write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+template <typename T>
+bool read_value(std::ifstream& stream, T& value)
+{
+    return static_cast<bool>(stream.read(reinterpret_cast<char*>(&value), sizeof(T)));
+}
+
+}  // namespace
+
+namespace step::video::ff {
+
+void KeyframeIndex::add_packet(TimestampFF pts, TimestampFF dts, int64_t pos, bool key_frame)
+{
+    std::scoped_lock lock(m_guard);
+    if (m_complete)
+        return;
+
+    if (key_frame)
+    {
+        const auto ts = (pts != AV_NOPTS_VALUE) ? pts : dts;
+        if (ts == AV_NOPTS_VALUE)
+        {
+            m_cursor = INVALID_CURSOR;
+            return;
+        }
+
+        auto it = std::lower_bound(m_entries.begin(), m_entries.end(), ts,
+                                   [](const Entry& entry, TimestampFF value) { return entry.pts < value; });
+        const bool inserted = (it == m_entries.end() || it->pts != ts);
+        if (inserted)
+        {
+            Entry entry;
+            entry.pts = ts;
+            entry.dts = dts;
+            entry.pos = pos;
+            entry.gop_length = 1;
+            entry.last_dts = dts;
+            entry.max_pts = ts;
+            it = m_entries.insert(it, entry);
+        }
+
+        const auto index = static_cast<size_t>(std::distance(m_entries.begin(), it));
+        // Предыдущий GOP закрыт, только если между ним и текущим ключевым нет других известных ключевых
+        if (m_cursor != INVALID_CURSOR && index > 0)
+        {
+            const auto prev_index = (inserted && m_cursor >= index) ? m_cursor + 1 : m_cursor;
+            if (prev_index == index - 1)
+                m_entries[prev_index].closed = true;
+        }
+        m_cursor = index;
+        return;
+    }
+
+    if (m_cursor == INVALID_CURSOR)
+        return;
+
+    // Пакеты одного GOP могут быть прочитаны повторно после seek, считаем их по возрастанию dts
+    auto& entry = m_entries[m_cursor];
+    if (dts != AV_NOPTS_VALUE && entry.last_dts != AV_NOPTS_VALUE && dts <= entry.last_dts)
+        return;
+
+    ++entry.gop_length;
+    entry.last_dts = dts;
+    if (pts != AV_NOPTS_VALUE)
+        entry.max_pts = std::max(entry.max_pts, pts);
+}
+
+void KeyframeIndex::reset_cursor()
+{
+    std::scoped_lock lock(m_guard);
+    m_cursor = INVALID_CURSOR;
+}
+
+void KeyframeIndex::clear()
+{
+    std::scoped_lock lock(m_guard);
+    m_entries.clear();
+    m_cursor = INVALID_CURSOR;
+    m_complete = false;
+}
+
+std::optional<KeyframeIndex::Entry> KeyframeIndex::find(TimestampFF time) const
+{
+    std::scoped_lock lock(m_guard);
+
+    auto it = std::upper_bound(m_entries.cbegin(), m_entries.cend(), time,
+                               [](TimestampFF value, const Entry& entry) { return value < entry.pts; });
+    if (it == m_entries.cbegin())
+        return std::nullopt;
+
+    const auto& entry = *std::prev(it);
+    // Без полного индекса между entry и time может оказаться непрочитанный ключевой кадр
+    if (m_complete || entry.closed || time <= entry.max_pts)
+        return entry;
+
+    return std::nullopt;
+}
+
+size_t KeyframeIndex::size() const
+{
+    std::scoped_lock lock(m_guard);
+    return m_entries.size();
+}
+
+std::vector<KeyframeIndex::Entry> KeyframeIndex::get_entries() const
+{
+    std::scoped_lock lock(m_guard);
+    return m_entries;
+}
+
+void KeyframeIndex::assign(std::vector<Entry> entries, bool complete)
+{
+    STEP_ASSERT(std::is_sorted(entries.cbegin(), entries.cend(),
+                               [](const Entry& lhs, const Entry& rhs) { return lhs.pts < rhs.pts; }),
+                "Keyframe index entries must be sorted by pts");
+
+    std::scoped_lock lock(m_guard);
+    m_entries = std::move(entries);
+    m_complete = complete;
+    m_cursor = INVALID_CURSOR;
+}
+
+bool KeyframeIndex::is_complete() const
+{
+    std::scoped_lock lock(m_guard);
+    return m_complete;
+}
+
+void KeyframeIndex::set_complete(bool complete)
+{
+    std::scoped_lock lock(m_guard);
+    m_complete = complete;
+}
+
+bool KeyframeIndex::save(const std::string& path, int64_t file_size) const
+{
+    std::scoped_lock lock(m_guard);
+
+    std::ofstream stream(path, std::ios::binary | std::ios::trunc);
+    if (!stream)
+    {
+        STEP_LOG(L_WARN, "Can't save keyframe index: can't open file {}", path);
+        return false;
+    }
+
+    stream.write(SIDECAR_MAGIC.data(), SIDECAR_MAGIC.size());
+    write_value(stream, SIDECAR_VERSION);
+    write_value(stream, file_size);
+    write_value(stream, static_cast<uint8_t>(m_complete));
+    write_value(stream, static_cast<uint64_t>(m_entries.size()));
+    for (const auto& entry : m_entries)
+    {
+        write_value(stream, entry.pts);
+        write_value(stream, entry.dts);
+        write_value(stream, entry.pos);
+        write_value(stream, entry.gop_length);
+        write_value(stream, entry.max_pts);
+        write_value(stream, static_cast<uint8_t>(entry.closed));
+    }
+
+    if (!stream)
+    {
+        STEP_LOG(L_WARN, "Can't save keyframe index: write error, file {}", path);
+        return false;
+    }
+
+    STEP_LOG(L_DEBUG, "Keyframe index saved: {} entries, file {}", m_entries.size(), path);
+    return true;
+}
+
+bool KeyframeIndex::load(const std::string& path, int64_t file_size)
+{
+    std::ifstream stream(path, std::ios::binary);
+    if (!stream)
+        return false;
+
+    std::array<char, SIDECAR_MAGIC.size()> magic{};
+    uint32_t version = 0;
+    int64_t stored_file_size = 0;
+    uint8_t complete = 0;
+    uint64_t count = 0;
+    /* clang-format off */
+    const bool header_is_valid = true
+        && stream.read(magic.data(), magic.size())
+        && magic == SIDECAR_MAGIC
+        && read_value(stream, version)
+        && version == SIDECAR_VERSION
+        && read_value(stream, stored_file_size)
+        && stored_file_size == file_size
+        && read_value(stream, complete)
+        && read_value(stream, count)
+        && count <= static_cast<uint64_t>(std::max<int64_t>(file_size, 0))  // защита от мусора вместо размера
+    ;
+    /* clang-format on */
+    if (!header_is_valid)
+    {
+        STEP_LOG(L_WARN, "Keyframe index {} is invalid or outdated, skipped", path);
+        return false;
+    }
+
+    std::vector<Entry> entries(count);
+    for (auto& entry : entries)
+    {
+        uint8_t closed = 0;
+        /* clang-format off */
+        const bool entry_is_valid = true
+            && read_value(stream, entry.pts)
+            && read_value(stream, entry.dts)
+            && read_value(stream, entry.pos)
+            && read_value(stream, entry.gop_length)
+            && read_value(stream, entry.max_pts)
+            && read_value(stream, closed)
+        ;
+        /* clang-format on */
+        if (!entry_is_valid)
+        {
+            STEP_LOG(L_WARN, "Keyframe index {} is truncated, skipped", path);
+            return false;
+        }
+        entry.closed = closed;
+        entry.last_dts = AV_NOPTS_VALUE;
+    }
+
+    if (!std::is_sorted(entries.cbegin(), entries.cend(),
+                        [](const Entry& lhs, const Entry& rhs) { return lhs.pts < rhs.pts; }))
+    {
+        STEP_LOG(L_WARN, "Keyframe index {} is not sorted, skipped", path);
+        return false;
+    }
+
+    std::scoped_lock lock(m_guard);
+    m_entries = std::move(entries);
+    m_complete = complete;
+    m_cursor = INVALID_CURSOR;
+
+    STEP_LOG(L_DEBUG, "Keyframe index loaded: {} entries, complete {}, file {}", m_entries.size(), m_complete, path);
+    return true;
+}
+
+std::string KeyframeIndex::get_sidecar_path(const std::string& filename) { return filename + SIDECAR_EXTENSION; }
+
+}  // namespace step::video::ff
@@ -0,0 +1,75 @@
+#pragma once
+
+#include <video/ffmpeg/interfaces/types.hpp>
+
+extern "C" {
+#include <libavutil/avutil.h>
+}
+
+#include <mutex>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace step::video::ff {
+
+/*! @brief Индекс ключевых кадров потока позиционирования: pts, позиция в файле и длина GOP.
+    @details Заполняется лениво пакетами, прочитанными парсером, или целиком быстрым проходом по пакетам
+    без декодирования. Пока индекс неполный, ключевой кадр выдается только для участков,
+    прочитанных подряд, иначе seek идет старым путем с подбором шага назад.
+*/
+class KeyframeIndex
+{
+public:
+    struct Entry
+    {
+        TimestampFF pts{AV_NOPTS_VALUE};
+        TimestampFF dts{AV_NOPTS_VALUE};
+        int64_t pos{-1};                       ///< позиция пакета в файле, -1 если неизвестна
+        uint32_t gop_length{0};                ///< количество кадров GOP, прочитанных подряд от ключевого
+        TimestampFF last_dts{AV_NOPTS_VALUE};  ///< dts последнего учтенного кадра GOP
+        TimestampFF max_pts{AV_NOPTS_VALUE};   ///< наибольший pts кадров GOP
+        bool closed{false};  ///< следующий ключевой кадр прочитан подряд, GOP известен целиком
+    };
+
+public:
+    /*! @brief Учитывает очередной пакет потока позиционирования.
+    */
+    void add_packet(TimestampFF pts, TimestampFF dts, int64_t pos, bool key_frame);
+
+    /*! @brief Сбрасывает текущий GOP: следующие пакеты до ключевого не учитываются (вызывается при seek).
+    */
+    void reset_cursor();
+    void clear();
+
+    /*! @brief Ближайший ключевой кадр с pts <= time, если его выбор гарантированно точен.
+    */
+    std::optional<Entry> find(TimestampFF time) const;
+
+    size_t size() const;
+
+    /*! @brief Копия записей и замена их готовыми, например индексом другого парсера того же файла.
+    */
+    std::vector<Entry> get_entries() const;
+    void assign(std::vector<Entry> entries, bool complete);
+
+    bool is_complete() const;
+    void set_complete(bool complete);
+
+    /*! @brief Сохранение/загрузка индекса в файл рядом с видео, file_size защищает от устаревшего индекса.
+    */
+    bool save(const std::string& path, int64_t file_size) const;
+    bool load(const std::string& path, int64_t file_size);
+
+    static std::string get_sidecar_path(const std::string& filename);
+
+private:
+    static constexpr size_t INVALID_CURSOR = static_cast<size_t>(-1);
+
+    mutable std::mutex m_guard;
+    std::vector<Entry> m_entries;  ///< отсортированы по pts
+    size_t m_cursor{INVALID_CURSOR};  ///< индекс GOP, который сейчас читается
+    bool m_complete{false};
+};
+
+}  // namespace step::video::ff
@@ -249,9 +249,19 @@ bool find_end_of_chapter(AVFormatContext* ctx,    ///< контекст
 
 namespace step::video::ff {
 
-AVFormatInputFF::AVFormatInputFF(const std::string& filename) : m_context(nullptr)
+AVFormatInputFF::AVFormatInputFF(const std::string& filename, const IoSettings& io_settings) : m_context(nullptr)
 {
+    if (io_settings.is_custom())
+        m_io = std::make_unique<AVIOInputFF>(filename, io_settings);
+
     m_context = avformat_alloc_context();
+    if (m_io)
+    {
+        // С AVFMT_FLAG_CUSTOM_IO avformat_close_input не освобождает pb, им владеет m_io
+        m_context->pb = m_io->context();
+        m_context->flags |= AVFMT_FLAG_CUSTOM_IO;
+    }
+
     int err_code = avformat_open_input(&m_context, filename.c_str(), nullptr, nullptr);
     if (err_code < 0)
         STEP_THROW_RUNTIME("Cant't open file {}, err: {}", filename, av_make_error(err_code));
@@ -262,6 +272,8 @@ AVFormatInputFF::~AVFormatInputFF()
     if (m_context)
         avformat_close_input(&m_context);
 }
+
+IoStats AVFormatInputFF::get_io_stats() const { return m_io ? m_io->get_stats() : IoStats(); }
 }  // namespace step::video::ff
 
 namespace step::video::ff {
@@ -289,7 +301,7 @@ bool ParserFF::open_file(const std::string& filename)
 
     try
     {
-        m_input = std::make_shared<AVFormatInputFF>(filename);
+        m_input = std::make_shared<AVFormatInputFF>(filename, m_io_settings);
     }
     catch (...)
     {
@@ -422,6 +434,9 @@ bool ParserFF::open_file(const std::string& filename)
                            m_format_name, m_stream_count);
     }
 
+    m_keyframe_index.clear();
+    m_keyframe_index_stream = get_seek_stream();
+
     return true;
 }
 
@@ -464,7 +479,7 @@ void ParserFF::reopen()
     AVDictionary* options = nullptr;
 
     if (!m_filename.empty())
-        m_input = std::make_shared<AVFormatInputFF>(m_filename);
+        m_input = std::make_shared<AVFormatInputFF>(m_filename, m_io_settings);
     else
         STEP_THROW_RUNTIME("Empty filename in reopen ParserFF");
 
@@ -515,6 +530,7 @@ void ParserFF::seek(StreamId index, TimestampFF time)
         return;
 
     m_current_chapter.clear();
+    m_keyframe_index.reset_cursor();
 
     if (m_avi_with_repeating_pts || m_format_DAV)
     {
@@ -676,7 +692,76 @@ std::shared_ptr<IDataPacket> ParserFF::read()
                                                                 MediaType::Undefined;
     /* clang-format on */
 
-    return DataPacketFF::create(pkt, type, packet_time_pts, packet_time_dts, packet_duration);
+    auto data_packet = DataPacketFF::create(pkt, type, packet_time_pts, packet_time_dts, packet_duration);
+    if (data_packet->get_stream_index() == m_keyframe_index_stream)
+        m_keyframe_index.add_packet(data_packet->pts(), data_packet->dts(), data_packet->get_packet()->pos,
+                                    data_packet->is_key_frame());
+
+    return data_packet;
+}
+
+bool ParserFF::seek_to_keyframe(StreamId index, const KeyframeIndex::Entry& keyframe)
+{
+    // Форматы, где seek подменяется чтением с начала или зависит от восстановленных меток, индекс не используют
+    if (!m_input || index != m_keyframe_index_stream || is_cover(index) || m_avi_with_repeating_pts ||
+        m_format_DAV || m_format_ASF || m_format_SWF || m_format_IMG)
+        return false;
+
+    m_current_chapter.clear();
+    m_keyframe_index.reset_cursor();
+
+    for (StreamId i = 0; i < m_stream_count; i++)
+    {
+        const AVRational& time_base = m_input->context()->streams[i]->time_base;
+        m_gen_pts[i] = av_rescale(keyframe.pts, time_base.den, AV_SECOND * (int64_t)time_base.num);
+    }
+
+    int res = -1;
+    if (is_binary_seek() || m_format_MpegTs)
+    {
+        if (keyframe.pos < 0)
+            return false;
+
+        res = av_seek_frame(m_input->context(), index, keyframe.pos, AVSEEK_FLAG_BYTE);
+    }
+    else
+    {
+        // Ключевой кадр с меткой <= pts из индекса - это он сам, поэтому правая граница совпадает с целью
+        const AVStream* const stream = m_input->context()->streams[index];
+        TimestampFF stream_time = global_to_stream(keyframe.pts, stream->time_base);
+        if (stream->start_time != AV_NOPTS_VALUE)
+            stream_time += stream->start_time;
+
+        res = avformat_seek_file(m_input->context(), index, INT64_MIN, stream_time, stream_time, 0);
+    }
+
+    STEP_LOG(L_DEBUG, "Seek [ {} ] to keyframe pts {}, pos {}: {}", index, keyframe.pts, keyframe.pos, res);
+    return res >= 0;
+}
+
+bool ParserFF::build_keyframe_index()
+{
+    if (!m_input || m_keyframe_index_stream == INVALID_STREAM_ID || m_avi_with_repeating_pts || m_format_DAV ||
+        m_format_ASF || m_format_SWF || m_format_IMG)
+        return false;
+
+    m_keyframe_index.clear();
+
+    size_t packet_count = 0;
+    while (read())
+        ++packet_count;
+
+    if (seek_to_zero() < 0)
+    {
+        STEP_LOG(L_WARN, "Keyframe index: can't return to the file start after scan, reopen {}", m_filename);
+        reopen();
+    }
+    m_keyframe_index.reset_cursor();
+    m_keyframe_index.set_complete(true);
+
+    STEP_LOG(L_INFO, "Keyframe index built: {} keyframes, {} packets scanned, file {}", m_keyframe_index.size(),
+             packet_count, m_filename);
+    return true;
 }
 
 AVPacket* ParserFF::read_packet()
@@ -1385,6 +1470,8 @@ void ParserFF::detect_bitrate()
 
 TimeFF ParserFF::get_duration() const { return m_input ? m_input->context()->duration : 0; }
 
+IoStats ParserFF::get_io_stats() const { return m_input ? m_input->get_io_stats() : IoStats(); }
+
 int64_t ParserFF::get_size() const
 {
     if (!m_input)
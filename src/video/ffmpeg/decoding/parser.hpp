@@ -1,6 +1,8 @@
 #pragma once
 
+#include "avio_input.hpp"
 #include "decoder_video.hpp"
+#include "keyframe_index.hpp"
 
 #include <video/ffmpeg/interfaces/format_codec.hpp>
 
@@ -14,14 +16,17 @@ namespace step::video::ff {
 class AVFormatInputFF
 {
 public:
-    AVFormatInputFF(const std::string& filename);
+    AVFormatInputFF(const std::string& filename, const IoSettings& io_settings = {});
     ~AVFormatInputFF();
 
     AVFormatContext* context() const noexcept { return m_context; }
 
     AVFormatContext* operator->() const { return context(); }
 
+    IoStats get_io_stats() const;
+
 private:
+    std::unique_ptr<AVIOInputFF> m_io;  ///< собственный ввод, nullptr - стандартный ввод ffmpeg
     AVFormatContext* m_context{nullptr};
 };
 
@@ -33,9 +38,26 @@ public:
 
     bool open_file(const std::string& filename);
 
+    /*! @brief Настройки ввода для следующих open_file, по умолчанию - стандартный ввод ffmpeg.
+    */
+    void set_io_settings(const IoSettings& settings) { m_io_settings = settings; }
+    IoStats get_io_stats() const;
+
     void seek(StreamId index, TimestampFF time);
     std::shared_ptr<IDataPacket> read();
 
+    /*! @brief Точный seek на ключевой кадр из индекса: по позиции в файле для бинарных форматов,
+        иначе по временной метке ключевого кадра. false - формат не позволяет, нужен обычный seek.
+    */
+    bool seek_to_keyframe(StreamId index, const KeyframeIndex::Entry& keyframe);
+
+    /*! @brief Быстрый проход по всем пакетам файла без декодирования для заполнения индекса ключевых кадров.
+        После прохода парсер возвращается в начало файла.
+    */
+    bool build_keyframe_index();
+    const KeyframeIndex& get_keyframe_index() const noexcept { return m_keyframe_index; }
+    KeyframeIndex& get_keyframe_index() noexcept { return m_keyframe_index; }
+
     TimeFF get_duration() const;
     StreamId get_seek_stream();
     int64_t get_size() const;
@@ -99,6 +121,7 @@ private:
     TimestampFF m_first_pkt_pos{AV_NOPTS_VALUE};
     std::string m_format_name;
     std::shared_ptr<AVFormatInputFF> m_input;
+    IoSettings m_io_settings;
     std::vector<TimestampFF> m_dts_shifts;
 
     std::map<StreamId, TimestampFF> m_last_seek_ts;
@@ -128,6 +151,9 @@ private:
     bool m_format_MpegTs = false;
     bool m_format_DAV = false;
     bool m_format_ASF = false;
+
+    KeyframeIndex m_keyframe_index;  ///< индекс ключевых кадров потока позиционирования
+    StreamId m_keyframe_index_stream{INVALID_STREAM_ID};
 };
 
 }  // namespace step::video::ff
\ No newline at end of file
@@ -19,7 +19,7 @@ DemuxedStream::DemuxedStream(std::shared_ptr<StreamReader> reader, StreamId stre
     {
         m_video_decoder = std::make_unique<DecoderVideoFF>();
         auto format_codec = m_reader->get_format_codec(stream_id);
-        if (!m_video_decoder->open(format_codec))
+        if (!m_video_decoder->open(format_codec, m_reader->get_decoder_options()))
             STEP_THROW_RUNTIME("Can't open decoder for stream {}, format codec: {}", stream_id, format_codec);
     }
 }
@@ -131,7 +131,8 @@ FramePtr DemuxedStream::read_frame()
         m_video_decoder->decode(pkt).swap(m_buffered_data);
         if (m_buffered_data)
         {
-            m_last_key_frame = pkt->is_key_frame();
+            // В конце потока декодер отдает задержанные кадры без нового пакета
+            m_last_key_frame = pkt && pkt->is_key_frame();
             continue;
         }
 
@@ -99,6 +99,7 @@ protected:
 
 private:
     std::mutex m_seek_mutex;
+    DecoderOptions m_decoder_options;
 
 public:
     static std::shared_ptr<IStreamReader> create(const DemuxerPtr& demuxer);
@@ -118,6 +119,11 @@ public:
 
     void release_internal_data(StreamId stream_id);
 
+    /*! @brief Параметры декодера для потоков, которые будут созданы после вызова.
+    */
+    void set_decoder_options(const DecoderOptions& options) { m_decoder_options = options; }
+    const DecoderOptions& get_decoder_options() const noexcept { return m_decoder_options; }
+
 protected:
     void request_seek(StreamId stream_id, TimestampFF time, const StreamPtr& result_checker);
     void seek(StreamId stream_id);
@@ -6,8 +6,17 @@ namespace step::video::ff {
 
 void IReader::Initializer::deserialize(const ObjectPtrJSON& container)
 {
-    IReader::Initializer init;
-    step::utils::from_string<video::ff::ReaderMode>(init.mode, json::get<std::string>(container, CFG_FLD::MODE));
+    step::utils::from_string<video::ff::ReaderMode>(mode, json::get<std::string>(container, CFG_FLD::MODE));
+    keyframe_index_scan = json::get<bool>(container, CFG_FLD::KEYFRAME_INDEX_SCAN, false);
+    keyframe_index_sidecar = json::get<bool>(container, CFG_FLD::KEYFRAME_INDEX_SIDECAR, false);
+    gop_cache_size_mb = json::get<size_t>(container, CFG_FLD::GOP_CACHE_SIZE, 0);
+    analysis_frames = deserialize_analysis_frame_formats(container);
+    io_buffer_size_kb = json::get<size_t>(container, CFG_FLD::IO_BUFFER_SIZE, 0);
+    io_mmap = json::get<bool>(container, CFG_FLD::IO_MMAP, false);
+    io_prefetch = json::get<bool>(container, CFG_FLD::IO_PREFETCH, false);
+    decoder_threads = json::get<int>(container, CFG_FLD::DECODER_THREADS, 1);
+    realtime_pacing = json::get<bool>(container, CFG_FLD::REALTIME_PACING, false);
+    max_lateness_ms = json::get<size_t>(container, CFG_FLD::MAX_LATENESS, 0);
 }
 
 bool IReader::Initializer::is_valid() const noexcept
@@ -24,6 +33,16 @@ bool IReader::Initializer::operator==(const IReader::Initializer& rhs) const noe
     /* clang-format off */
     return true
         && mode == rhs.mode
+        && keyframe_index_scan == rhs.keyframe_index_scan
+        && keyframe_index_sidecar == rhs.keyframe_index_sidecar
+        && gop_cache_size_mb == rhs.gop_cache_size_mb
+        && analysis_frames == rhs.analysis_frames
+        && io_buffer_size_kb == rhs.io_buffer_size_kb
+        && io_mmap == rhs.io_mmap
+        && io_prefetch == rhs.io_prefetch
+        && decoder_threads == rhs.decoder_threads
+        && realtime_pacing == rhs.realtime_pacing
+        && max_lateness_ms == rhs.max_lateness_ms
     ;
     /* clang-format on */
 }
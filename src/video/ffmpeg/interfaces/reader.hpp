@@ -15,6 +15,7 @@ enum class ReaderMode
     Undefined,
     KeyFrame,
     All,
+    Scrub,  ///< только ключевые кадры в уменьшенном разрешении, для быстрой перемотки
 };
 
 enum class ReaderState
@@ -50,6 +51,16 @@ public:
     struct Initializer : public ISerializable
     {
         ReaderMode mode{ReaderMode::Undefined};
+        bool keyframe_index_scan{false};     ///< индекс ключевых кадров строится проходом по файлу при открытии
+        bool keyframe_index_sidecar{false};  ///< индекс читается из файла рядом с видео и сохраняется туда
+        size_t gop_cache_size_mb{0};  ///< объем кэша декодированных GOP для шага назад, 0 - кэш выключен
+        AnalysisFrameFormats analysis_frames;  ///< копии кадра для анализа, готовятся декодером вместе с кадром
+        size_t io_buffer_size_kb{0};  ///< блок упреждающего чтения файла, 0 - стандартный ввод ffmpeg
+        bool io_mmap{false};          ///< отображение файла в память
+        bool io_prefetch{false};      ///< фоновое чтение следующего блока
+        int decoder_threads{1};       ///< потоки декодера, 0 - по числу ядер
+        bool realtime_pacing{false};  ///< воспроизведение вперед в темпе меток времени, а не со скоростью декодера
+        size_t max_lateness_ms{0};    ///< с realtime_pacing: более опоздавшие кадры не отдаются, 0 - отдаются все
 
         void deserialize(const ObjectPtrJSON& container);
 
@@ -69,6 +80,7 @@ public:
     virtual ReaderState get_state() const = 0;
 
     virtual void play() = 0;
+    virtual void play_backward() = 0;
     virtual void pause() = 0;
     virtual void stop() = 0;
     virtual void step_forward() = 0;
@@ -0,0 +1,57 @@
+#include "file_frame_source.hpp"
+
+#include <core/base/types/config_fields.hpp>
+#include <core/base/json/json_utils.hpp>
+#include <core/exception/assert.hpp>
+
+#include <video/frame/interfaces/analysis_frame_format.hpp>
+
+namespace step::video::ff {
+
+void FileFrameSourceSettings::deserialize(const ObjectPtrJSON& container)
+{
+    decoder.analysis_frames = deserialize_analysis_frame_formats(container);
+    decoder.threads = json::get<int>(container, CFG_FLD::DECODER_THREADS, decoder.threads);
+    io.buffer_size = json::get<size_t>(container, CFG_FLD::IO_BUFFER_SIZE, io.buffer_size / 1024) * 1024;
+    io.use_mmap = json::get<bool>(container, CFG_FLD::IO_MMAP, io.use_mmap);
+    io.prefetch = json::get<bool>(container, CFG_FLD::IO_PREFETCH, io.prefetch);
+}
+
+FileFrameSource::FileFrameSource(const std::string& filename, const FileFrameSourceSettings& settings)
+    : m_filename(filename)
+{
+    m_parser = std::make_shared<ParserFF>();
+    m_parser->set_io_settings(settings.io);
+    if (!m_parser->open_file(filename))
+        STEP_THROW_RUNTIME("Failed to open file {}", filename);
+
+    m_demuxer = std::make_shared<DemuxerQueue>(m_parser);
+    m_stream_reader = std::make_shared<StreamReader>(m_demuxer);
+    m_stream_reader->set_decoder_options(settings.decoder);
+
+    m_stream = m_stream_reader->get_best_video_stream();
+    if (!m_stream)
+        STEP_THROW_RUNTIME("No video stream in file {}", filename);
+}
+
+void FileFrameSource::set_keyframe_index(std::vector<KeyframeIndex::Entry> entries)
+{
+    m_parser->get_keyframe_index().assign(std::move(entries), true);
+}
+
+bool FileFrameSource::seek(TimestampFF ts)
+{
+    m_stream->request_seek(ts, nullptr);
+    m_stream->do_seek();
+    return m_stream->get_last_seek_result();
+}
+
+FramePtr FileFrameSource::read_frame() { return m_stream->read_frame(); }
+
+void FileFrameSource::terminate() { m_stream->terminate(); }
+
+TimeFF FileFrameSource::get_duration() const { return m_parser->get_duration(); }
+
+IoStats FileFrameSource::get_io_stats() const { return m_parser->get_io_stats(); }
+
+}  // namespace step::video::ff
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <core/base/interfaces/serializable.hpp>
+
+#include <video/ffmpeg/decoding/stream_reader.hpp>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace step::video::ff {
+
+/*! @brief Параметры чтения файла без ReaderFF, читаются из той же секции reader_ff.
+*/
+struct FileFrameSourceSettings : public ISerializable
+{
+    IoSettings io;
+    DecoderOptions decoder;
+
+    /*! @brief Незаданные в конфиге поля сохраняют текущие значения.
+    */
+    void deserialize(const ObjectPtrJSON& container) override;
+};
+
+/*! @brief Последовательное чтение кадров файла в вызывающем потоке: свои парсер, демуксер и декодер,
+    без потока чтения, состояний воспроизведения и наблюдателей.
+*/
+class FileFrameSource
+{
+public:
+    FileFrameSource(const std::string& filename, const FileFrameSourceSettings& settings = {});
+
+    /*! @brief Готовый индекс ключевых кадров того же файла, чтобы seek попадал точно без прохода по файлу.
+    */
+    void set_keyframe_index(std::vector<KeyframeIndex::Entry> entries);
+
+    /*! @brief Позиционирование на ключевой кадр не позже ts.
+    */
+    bool seek(TimestampFF ts);
+
+    /*! @brief Следующий кадр, nullptr - конец файла или terminate.
+    */
+    FramePtr read_frame();
+
+    /*! @brief Прерывает read_frame из другого потока.
+    */
+    void terminate();
+
+    const std::string& get_filename() const noexcept { return m_filename; }
+    TimeFF get_duration() const;
+    IoStats get_io_stats() const;
+
+private:
+    std::string m_filename;
+    std::shared_ptr<ParserFF> m_parser;
+    std::shared_ptr<DemuxerQueue> m_demuxer;
+    std::shared_ptr<StreamReader> m_stream_reader;
+    StreamPtr m_stream;
+};
+
+}  // namespace step::video::ff
@@ -0,0 +1,117 @@
+#include "gop_frame_cache.hpp"
+
+#include <core/log/log.hpp>
+
+namespace step::video::ff {
+
+GopFrameCache::GopFrameCache(size_t memory_budget) : m_memory_budget(memory_budget) {}
+
+void GopFrameCache::put(TimestampFF gop_ts, const FramePtr& frame)
+{
+    if (!frame)
+        return;
+
+    std::scoped_lock lock(m_guard);
+
+    auto [it, inserted] = m_gops.try_emplace(gop_ts);
+    auto& gop = it->second;
+    if (inserted)
+    {
+        m_lru.push_front(gop_ts);
+        gop.lru_it = m_lru.begin();
+    }
+    else
+    {
+        touch(gop);
+    }
+
+    const auto [frame_it, frame_inserted] = gop.frames.try_emplace(frame->ts.count(), frame);
+    if (!frame_inserted)
+        return;
+
+    gop.bytes += frame->bytesize();
+    m_memory_usage += frame->bytesize();
+    evict(gop_ts);
+}
+
+FramePtr GopFrameCache::find_previous(TimestampFF ts)
+{
+    std::scoped_lock lock(m_guard);
+
+    // GOP с наибольшим началом < ts, при неполном GOP - еще один шаг назад
+    auto gop_it = m_gops.lower_bound(ts);
+    for (int attempt = 0; attempt < 2 && gop_it != m_gops.begin(); ++attempt)
+    {
+        --gop_it;
+        auto& frames = gop_it->second.frames;
+        auto frame_it = frames.lower_bound(ts);
+        if (frame_it == frames.begin())
+            continue;
+
+        const auto& frame = std::prev(frame_it)->second;
+        // Кадр должен примыкать к ts, иначе между ними есть кадры, которых нет в кэше
+        const auto duration = (frame->duration > 0) ? frame->duration : 0;
+        if (frame->ts.count() + duration + duration / 2 < ts)
+            return nullptr;
+
+        touch(gop_it->second);
+        return frame;
+    }
+
+    return nullptr;
+}
+
+std::optional<TimestampFF> GopFrameCache::get_gop_start(TimestampFF ts) const
+{
+    std::scoped_lock lock(m_guard);
+
+    auto gop_it = m_gops.upper_bound(ts);
+    if (gop_it == m_gops.begin())
+        return std::nullopt;
+
+    --gop_it;
+    if (gop_it->second.frames.empty() || gop_it->second.frames.rbegin()->first < ts)
+        return std::nullopt;
+
+    return gop_it->first;
+}
+
+void GopFrameCache::clear()
+{
+    std::scoped_lock lock(m_guard);
+    m_gops.clear();
+    m_lru.clear();
+    m_memory_usage = 0;
+}
+
+size_t GopFrameCache::get_memory_usage() const
+{
+    std::scoped_lock lock(m_guard);
+    return m_memory_usage;
+}
+
+void GopFrameCache::touch(Gop& gop) { m_lru.splice(m_lru.begin(), m_lru, gop.lru_it); }
+
+void GopFrameCache::evict(TimestampFF protected_gop_ts)
+{
+    while (m_memory_usage > m_memory_budget && m_lru.back() != protected_gop_ts)
+    {
+        auto gop_it = m_gops.find(m_lru.back());
+        m_memory_usage -= gop_it->second.bytes;
+        STEP_LOG(L_TRACE, "GOP cache: evict GOP {} ({} frames)", gop_it->first, gop_it->second.frames.size());
+        m_lru.pop_back();
+        m_gops.erase(gop_it);
+    }
+
+    // Остался только заполняемый GOP, и он не помещается - жертвуем его началом
+    auto& gop = m_gops[protected_gop_ts];
+    while (m_memory_usage > m_memory_budget && gop.frames.size() > 1)
+    {
+        const auto bytes = gop.frames.begin()->second->bytesize();
+        gop.bytes -= bytes;
+        m_memory_usage -= bytes;
+        gop.frames.erase(gop.frames.begin());
+    }
+}
+
+}  // namespace step::video::ff
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <video/frame/interfaces/frame.hpp>
+
+#include <video/ffmpeg/interfaces/types.hpp>
+
+#include <list>
+#include <map>
+#include <mutex>
+#include <optional>
+
+namespace step::video::ff {
+
+/*! @brief Кэш декодированных кадров, сгруппированных по GOP, с ограничением по памяти.
+    @details Вытесняются целые GOP в порядке LRU. Если не помещается даже заполняемый GOP,
+    из него удаляются самые ранние кадры: для шага назад нужнее кадры у конца GOP.
+    Кадры в кэше не изменяются, наружу их отдают только на чтение.
+*/
+class GopFrameCache
+{
+public:
+    explicit GopFrameCache(size_t memory_budget);
+
+    /*! @brief Добавляет кадр в GOP, начинающийся с gop_ts (кадры одного GOP идут по возрастанию ts).
+    */
+    void put(TimestampFF gop_ts, const FramePtr& frame);
+
+    /*! @brief Кадр, непосредственно предшествующий ts, nullptr если его нет в кэше.
+    */
+    FramePtr find_previous(TimestampFF ts);
+
+    /*! @brief Начало GOP в кэше, которому принадлежит кадр ts.
+    */
+    std::optional<TimestampFF> get_gop_start(TimestampFF ts) const;
+
+    void clear();
+
+    size_t get_memory_usage() const;
+    size_t get_memory_budget() const noexcept { return m_memory_budget; }
+
+private:
+    struct Gop
+    {
+        std::map<TimestampFF, FramePtr> frames;
+        size_t bytes{0};
+        std::list<TimestampFF>::iterator lru_it;
+    };
+
+    void touch(Gop& gop);
+    void evict(TimestampFF protected_gop_ts);
+
+private:
+    const size_t m_memory_budget;
+
+    mutable std::mutex m_guard;
+    std::map<TimestampFF, Gop> m_gops;
+    std::list<TimestampFF> m_lru;  ///< в начале - недавно использованные
+    size_t m_memory_usage{0};
+};
+
+}  // namespace step::video::ff
@@ -0,0 +1,115 @@
+#include "gop_prefetcher.hpp"
+
+#include <core/log/log.hpp>
+
+#include <utility>
+
+namespace step::video::ff {
+
+GopPrefetcher::GopPrefetcher(std::shared_ptr<GopFrameCache> cache) : m_cache(std::move(cache)) {}
+
+GopPrefetcher::~GopPrefetcher() { stop_worker(); }
+
+bool GopPrefetcher::open_file(const std::string& filename, const DecoderOptions& options)
+{
+    std::scoped_lock lock(m_decode_guard);
+
+    m_parser = std::make_shared<ParserFF>();
+    if (!m_parser->open_file(filename))
+    {
+        STEP_LOG(L_ERROR, "GOP prefetcher: failed to open file {}", filename);
+        m_parser.reset();
+        return false;
+    }
+
+    m_demuxer = std::make_shared<DemuxerQueue>(m_parser);
+    auto stream_reader = std::make_shared<StreamReader>(m_demuxer);
+    stream_reader->set_decoder_options(options);
+    m_stream_reader = stream_reader;
+    m_stream = m_stream_reader->get_best_video_stream();
+    return !!m_stream;
+}
+
+void GopPrefetcher::request(TimestampFF end_ts)
+{
+    // Кадр перед end_ts уже есть - GOP загружен раньше
+    if (end_ts <= 0 || m_cache->find_previous(end_ts))
+        return;
+
+    std::scoped_lock lock(m_request_guard);
+    m_requested_ts = end_ts;
+    m_request_cnd.notify_all();
+}
+
+bool GopPrefetcher::decode_gop(TimestampFF end_ts)
+{
+    if (end_ts <= 0)
+        return false;
+
+    std::scoped_lock lock(m_decode_guard);
+    if (!m_stream)
+        return false;
+
+    // seek чуть раньше end_ts приходит на ключевой кадр предыдущего GOP
+    m_stream->request_seek(end_ts - 1, nullptr);
+    m_stream->do_seek();
+    if (!m_stream->get_last_seek_result())
+    {
+        STEP_LOG(L_WARN, "GOP prefetcher: invalid seek to {}", end_ts - 1);
+        return false;
+    }
+
+    TimestampFF gop_ts = AV_NOPTS_VALUE;
+    size_t frame_count = 0;
+    while (!m_need_stop)
+    {
+        auto frame = m_stream->read_frame();
+        if (!frame || frame->ts.count() >= end_ts)
+            break;
+
+        if (gop_ts == AV_NOPTS_VALUE)
+            gop_ts = frame->ts.count();
+
+        m_cache->put(gop_ts, frame);
+        ++frame_count;
+    }
+
+    STEP_LOG(L_DEBUG, "GOP prefetcher: GOP {} before {} decoded, {} frames, cache {} / {} bytes", gop_ts, end_ts,
+             frame_count, m_cache->get_memory_usage(), m_cache->get_memory_budget());
+    return frame_count > 0;
+}
+
+void GopPrefetcher::worker_thread()
+{
+    while (!m_need_stop)
+    {
+        TimestampFF end_ts = AV_NOPTS_VALUE;
+        {
+            std::unique_lock lock(m_request_guard);
+            m_request_cnd.wait(lock, [this]() { return m_need_stop || m_requested_ts != AV_NOPTS_VALUE; });
+            if (m_need_stop)
+                break;
+
+            end_ts = std::exchange(m_requested_ts, AV_NOPTS_VALUE);
+        }
+
+        try
+        {
+            decode_gop(end_ts);
+        }
+        catch (const std::exception& e)
+        {
+            STEP_LOG(L_ERROR, "GOP prefetcher: failed to decode GOP before {}: {}", end_ts, e.what());
+        }
+    }
+
+    STEP_LOG(L_DEBUG, "GOP prefetcher worker thread finished");
+}
+
+void GopPrefetcher::thread_worker_stop_impl()
+{
+    std::scoped_lock lock(m_request_guard);
+    m_request_cnd.notify_all();
+}
+
+}  // namespace step::video::ff
@@ -0,0 +1,52 @@
+#pragma once
+
+#include "gop_frame_cache.hpp"
+
+#include <core/threading/thread_worker.hpp>
+
+#include <video/ffmpeg/decoding/stream_reader.hpp>
+
+#include <condition_variable>
+#include <mutex>
+
+namespace step::video::ff {
+
+/*! @brief Декодирует предыдущие GOP в кэш для шага назад и обратного воспроизведения.
+    @details Держит собственные парсер и декодер того же файла, поэтому позиция основного потока ReaderFF
+    не сбивается. Фоновая загрузка запрашивается через request, синхронная - через decode_gop.
+*/
+class GopPrefetcher : public threading::ThreadWorker
+{
+public:
+    GopPrefetcher(std::shared_ptr<GopFrameCache> cache);
+    ~GopPrefetcher();
+
+    bool open_file(const std::string& filename, const DecoderOptions& options = {});
+
+    /*! @brief Ставит в очередь загрузку GOP, который заканчивается перед end_ts. Повторный запрос заменяет прежний.
+    */
+    void request(TimestampFF end_ts);
+
+    /*! @brief Синхронно декодирует в кэш GOP, который заканчивается перед end_ts.
+    */
+    bool decode_gop(TimestampFF end_ts);
+
+private:
+    void worker_thread() override;
+    void thread_worker_stop_impl() override;
+
+private:
+    std::shared_ptr<GopFrameCache> m_cache;
+
+    std::shared_ptr<ParserFF> m_parser{nullptr};
+    std::shared_ptr<IDemuxer> m_demuxer{nullptr};
+    std::shared_ptr<IStreamReader> m_stream_reader{nullptr};
+    StreamPtr m_stream{nullptr};
+    std::mutex m_decode_guard;
+
+    std::mutex m_request_guard;
+    std::condition_variable m_request_cnd;
+    TimestampFF m_requested_ts{AV_NOPTS_VALUE};
+};
+
+}  // namespace step::video::ff
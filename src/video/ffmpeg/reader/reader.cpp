@@ -14,12 +14,29 @@
 namespace {
 
 constexpr size_t MAX_INVALID_THRESHOLD = 10;
+constexpr int SCRUB_LOWRES = 1;  // половина разрешения: для перемотки достаточно, декодирование в ~4 раза дешевле
+
+// После долгой задержки (отладчик, перегрузка диска) часы перепривязываются, а не отбрасывают все кадры подряд
+constexpr step::Microseconds RESYNC_LATENESS = step::Seconds(1);
 
 }  // namespace
 
 namespace step::video::ff {
 
-ReaderFF::ReaderFF(IReader::Initializer&& init) : m_mode(std::move(init.mode)) {}
+ReaderFF::ReaderFF(IReader::Initializer&& init)
+    : m_mode(std::move(init.mode))
+    , m_keyframe_index_scan(init.keyframe_index_scan)
+    , m_keyframe_index_sidecar(init.keyframe_index_sidecar)
+    , m_gop_cache_size_mb(init.gop_cache_size_mb)
+    , m_analysis_frames(std::move(init.analysis_frames))
+    , m_decoder_threads(init.decoder_threads)
+    , m_realtime_pacing(init.realtime_pacing)
+    , m_max_lateness(Milliseconds(init.max_lateness_ms))
+{
+    m_io_settings.buffer_size = init.io_buffer_size_kb * 1024;
+    m_io_settings.use_mmap = init.io_mmap;
+    m_io_settings.prefetch = init.io_prefetch;
+}
 
 ReaderFF::ReaderFF(const ObjectPtrJSON& cfg) { deserialize(cfg); }
 
@@ -27,25 +44,43 @@ ReaderFF::~ReaderFF()
 {
     STEP_LOG(L_INFO, "ReaderFF destruction, file: {}", m_filename);
     stop();
+    save_keyframe_index();
+    log_io_stats();
+    if (m_late_frames > 0)
+        STEP_LOG(L_INFO, "ReaderFF: {} frames were late more than {} ms and dropped", m_late_frames,
+                 m_max_lateness.count() / 1000);
 }
 
 bool ReaderFF::open_file(const std::string& filename)
 {
+    save_keyframe_index();
+
+    log_io_stats();
+
     m_parser = std::make_shared<ParserFF>();
+    m_parser->set_io_settings(m_io_settings);
     if (!m_parser->open_file(filename))
     {
         STEP_LOG(L_ERROR, "Failed to open file {}", filename);
         return false;
     }
 
+    m_filename = filename;
+    init_keyframe_index();
+
     m_demuxer = std::make_shared<DemuxerQueue>(m_parser);
-    m_stream_reader = std::make_shared<StreamReader>(m_demuxer);
+    auto stream_reader = std::make_shared<StreamReader>(m_demuxer);
+    auto decoder_options = (m_mode == ReaderMode::Scrub) ? get_scrub_decoder_options() : DecoderOptions();
+    decoder_options.analysis_frames = m_analysis_frames;
+    decoder_options.threads = m_decoder_threads;
+    stream_reader->set_decoder_options(decoder_options);
+    m_stream_reader = stream_reader;
 
     m_stream = m_stream_reader->get_best_video_stream();
+    init_gop_cache();
 
     set_reader_state(ReaderState::Reading);
 
-    m_filename = filename;
     m_invalid_counter = 0;
 
     return true;
@@ -97,6 +132,9 @@ bool ReaderFF::has_event() const
 
 void ReaderFF::handle_event(ReaderEvent event)
 {
+    // Пауза, переход или смена направления разрывают временную шкалу
+    m_clock.reset();
+
     switch (event.get_type())
     {
         case ReaderEvent::Type::Pause:
@@ -105,6 +143,9 @@ void ReaderFF::handle_event(ReaderEvent event)
         case ReaderEvent::Type::Play:
             play_impl();
             break;
+        case ReaderEvent::Type::PlayBackward:
+            play_backward_impl();
+            break;
         case ReaderEvent::Type::RewindBackward:
             rewind_backward_impl();
             break;
@@ -133,6 +174,7 @@ void ReaderFF::handle_event(ReaderEvent event)
 
 /* clang-format off */
 void ReaderFF::play             () { add_reader_event(ReaderEvent(ReaderEvent::Type::Play           )); }
+void ReaderFF::play_backward    () { add_reader_event(ReaderEvent(ReaderEvent::Type::PlayBackward   )); }
 void ReaderFF::pause            () { add_reader_event(ReaderEvent(ReaderEvent::Type::Pause          )); }
 void ReaderFF::stop             () { add_reader_event(ReaderEvent(ReaderEvent::Type::Stop           )); }
 void ReaderFF::step_forward     () { add_reader_event(ReaderEvent(ReaderEvent::Type::StepForward    )); }
@@ -150,8 +192,82 @@ void ReaderFF::set_reader_state(ReaderState state)
         std::bind(&IReaderEventObserver::on_reader_state_changed, std::placeholders::_1, m_state));
 }
 
+void ReaderFF::init_keyframe_index()
+{
+    auto& keyframe_index = m_parser->get_keyframe_index();
+    if (m_keyframe_index_sidecar &&
+        keyframe_index.load(KeyframeIndex::get_sidecar_path(m_filename), m_parser->get_size()))
+        return;
+
+    // Без прохода по файлу индекс заполняется лениво по мере чтения
+    if (m_keyframe_index_scan && m_parser->build_keyframe_index() && m_keyframe_index_sidecar)
+        keyframe_index.save(KeyframeIndex::get_sidecar_path(m_filename), m_parser->get_size());
+}
+
+void ReaderFF::save_keyframe_index()
+{
+    if (!m_keyframe_index_sidecar || !m_parser || m_filename.empty())
+        return;
+
+    // Полный индекс уже лежит рядом с файлом, ленивый - сохраняем, чтобы не собирать его заново
+    const auto& keyframe_index = m_parser->get_keyframe_index();
+    if (keyframe_index.is_complete() || keyframe_index.size() == 0)
+        return;
+
+    keyframe_index.save(KeyframeIndex::get_sidecar_path(m_filename), m_parser->get_size());
+}
+
+IoStats ReaderFF::get_io_stats() const { return m_parser ? m_parser->get_io_stats() : IoStats(); }
+
+void ReaderFF::log_io_stats() const
+{
+    if (!m_parser || !m_io_settings.is_custom())
+        return;
+
+    const auto stats = get_io_stats();
+    STEP_LOG(L_INFO, "IO stats for {}: read {} bytes, fetched {} bytes in {} reads, {} seeks, {} prefetch hits, "
+             "stall {} ms", m_filename, stats.bytes_read, stats.bytes_fetched, stats.storage_reads, stats.seeks,
+             stats.prefetch_hits, stats.stall_time / AV_MILLISECOND);
+}
+
+DecoderOptions ReaderFF::get_scrub_decoder_options()
+{
+    DecoderOptions options;
+    options.key_frames_only = true;
+    options.lowres = SCRUB_LOWRES;
+    return options;
+}
+
+void ReaderFF::init_gop_cache()
+{
+    m_gop_prefetcher.reset();
+    m_gop_cache.reset();
+    m_gop_ts = AV_NOPTS_VALUE;
+    m_need_resync = false;
+    // В режиме перемотки декодируются только ключевые кадры, соседних кадров для шага назад нет
+    if (m_gop_cache_size_mb == 0 || m_mode == ReaderMode::Scrub)
+        return;
+
+    m_gop_cache = std::make_shared<GopFrameCache>(m_gop_cache_size_mb * 1024 * 1024);
+    m_gop_prefetcher = std::make_unique<GopPrefetcher>(m_gop_cache);
+    // Кадры из кэша идут тем же потребителям, что и прочитанные вперед, копии для анализа нужны и им
+    DecoderOptions prefetcher_options;
+    prefetcher_options.analysis_frames = m_analysis_frames;
+    prefetcher_options.threads = m_decoder_threads;
+    if (!m_gop_prefetcher->open_file(m_filename, prefetcher_options))
+    {
+        STEP_LOG(L_WARN, "GOP cache is disabled: prefetcher can't open file {}", m_filename);
+        m_gop_prefetcher.reset();
+        m_gop_cache.reset();
+        return;
+    }
+
+    m_gop_prefetcher->run_worker();
+}
+
 void ReaderFF::seek(TimestampFF pos)
 {
+    m_gop_ts = AV_NOPTS_VALUE;
     m_stream->request_seek(pos, nullptr);
     m_stream->do_seek();
     if (!m_stream->get_last_seek_result())
@@ -169,13 +285,22 @@ void ReaderFF::read_frame()
     auto frame_ptr = m_stream->read_frame();
 
     m_is_last_key_frame = m_stream->is_last_key_frame();
-    const bool need_handle = need_handle_frame();
+    const bool need_handle = need_handle_frame() && !(frame_ptr && is_frame_late(*frame_ptr));
 
     if (frame_ptr)
     {
         m_invalid_counter = 0;
         m_prev_duration = m_last_valid_frame ? m_last_valid_frame->duration : 0;
-        m_last_valid_frame = Frame::clone_deep(frame_ptr);
+        // Пропускаемые при позиционировании кадры никуда не отдаются, копия не нужна
+        m_last_valid_frame = need_handle ? Frame::clone_deep(frame_ptr) : frame_ptr;
+
+        // m_last_valid_frame больше никуда не отдается, поэтому его можно хранить в кэше без копирования
+        if (m_gop_cache)
+        {
+            if (m_gop_ts == AV_NOPTS_VALUE || m_is_last_key_frame)
+                m_gop_ts = m_last_valid_frame->ts.count();
+            m_gop_cache->put(m_gop_ts, m_last_valid_frame);
+        }
 
         if (need_handle)
         {
@@ -194,6 +319,122 @@ void ReaderFF::read_frame()
              need_handle ? "" : "not ", m_last_valid_frame->ts.count(), m_last_valid_frame->duration);
 }
 
+void ReaderFF::read_next_frame()
+{
+    if (!m_need_resync)
+    {
+        read_frame();
+        return;
+    }
+
+    // Кадры выдавались из кэша: позиционируем основной поток на кадр, следующий за показанным
+    const auto next_position = get_position() + m_last_valid_frame->duration;
+    if (next_position >= get_duration())
+    {
+        m_continue_reading = false;
+        return;
+    }
+
+    const bool need_handle_after_force_set_pos = m_need_handle_after_force_set_pos;
+    m_need_handle_after_force_set_pos = true;
+    set_position_impl(next_position);
+    m_need_handle_after_force_set_pos = need_handle_after_force_set_pos;
+}
+
+void ReaderFF::read_previous_frame()
+{
+    if (read_cached_previous_frame())
+        return;
+
+    // Кэша нет или предыдущий GOP не декодируется - обычный seek на кадр назад
+    const auto position = get_position();
+    set_position_impl(position - m_prev_duration);
+    if (get_position() >= position)
+    {
+        STEP_LOG(L_DEBUG, "Can't read previous frame: start of the stream is reached at {}", position);
+        m_continue_reading = false;
+    }
+}
+
+bool ReaderFF::read_cached_previous_frame()
+{
+    if (!m_gop_cache || !m_gop_prefetcher || !m_last_valid_frame)
+        return false;
+
+    const auto position = get_position();
+    auto frame_ptr = m_gop_cache->find_previous(position);
+    if (!frame_ptr && m_gop_prefetcher->decode_gop(position))
+        frame_ptr = m_gop_cache->find_previous(position);
+
+    if (!frame_ptr)
+        return false;
+
+    const auto gop_ts = m_gop_cache->get_gop_start(frame_ptr->ts.count());
+    m_is_last_key_frame = gop_ts && *gop_ts == frame_ptr->ts.count();
+    m_invalid_counter = 0;
+    m_prev_duration = frame_ptr->duration;
+    m_last_valid_frame = frame_ptr;
+    m_need_resync = true;
+
+    // Кадр из кэша неизменяемый, обзерверам отдаем копию
+    if (need_handle_frame())
+    {
+        auto frame_copy = Frame::clone_deep(frame_ptr);
+        reader_process_frame(frame_copy);
+        m_frame_observers.perform_for_each_event_handler(
+            std::bind(&IFrameSourceObserver::process_frame, std::placeholders::_1, frame_copy));
+    }
+
+    // Заранее подгружаем GOP перед текущим, пока показываются кадры из кэша
+    if (gop_ts)
+        m_gop_prefetcher->request(*gop_ts);
+
+    STEP_LOG(L_DEBUG, "Read cached frame with ts {}, duration {}", frame_ptr->ts.count(), frame_ptr->duration);
+    return true;
+}
+
+bool ReaderFF::wait_frame_deadline(std::unique_lock<std::mutex>& lock)
+{
+    if (!m_realtime_pacing || !m_last_valid_frame || !m_clock.is_started())
+        return false;
+
+    // Срок следующего кадра считается от привязки часов, время декодирования и обработки в темп не входит
+    const auto next_ts = m_last_valid_frame->ts + Microseconds(std::max<TimeFF>(m_last_valid_frame->duration, 0));
+    return m_read_cnd.wait_until(lock, m_clock.get_deadline(next_ts),
+                                 [this]() { return need_break_reading() || has_event(); });
+}
+
+bool ReaderFF::is_frame_late(const Frame& frame)
+{
+    // Темп держится только при воспроизведении вперед, шаги и позиционирование отдают кадр сразу
+    if (!m_realtime_pacing || !m_continue_reading || m_play_backward || m_need_handle_after_force_set_pos)
+        return false;
+
+    if (!m_clock.is_started())
+    {
+        m_clock.start(frame.ts);
+        return false;
+    }
+
+    const auto lateness = m_clock.get_lateness(frame.ts);
+    if (lateness > RESYNC_LATENESS)
+    {
+        STEP_LOG(L_DEBUG, "ReaderFF: frame {} is late for {} us, clock is restarted", frame.ts.count(),
+                 lateness.count());
+        m_clock.start(frame.ts);
+        return false;
+    }
+
+    if (m_max_lateness.count() == 0 || lateness <= m_max_lateness)
+        return false;
+
+    // Отстающий кадр не отдаем: задержка до потребителей остается ограниченной
+    ++m_late_frames;
+    STEP_LOG_THROTTLE(L_DEBUG, Seconds(1), "ReaderFF: frame {} is late for {} us and dropped, {} dropped total",
+                      frame.ts.count(), lateness.count(), m_late_frames);
+    return true;
+}
+
 bool ReaderFF::need_break_reading(bool verbose /*= false*/) const
 {
     bool need_break = false;
@@ -230,6 +471,7 @@ bool ReaderFF::need_handle_frame()
     /* clang-format off */
     return false
         || m_mode == ReaderMode::All
+        || m_mode == ReaderMode::Scrub
         || m_is_last_key_frame
         || m_need_handle_after_force_set_pos
     ;
@@ -267,7 +509,7 @@ void ReaderFF::worker_thread()
                 }
             }
 
-            if (m_stream->is_eof_reached())
+            if (!m_play_backward && m_stream->is_eof_reached())
                 m_continue_reading = false;
 
             if (!m_continue_reading)
@@ -281,8 +523,14 @@ void ReaderFF::worker_thread()
             if (has_event())
                 continue;
 
+            if (!m_play_backward && wait_frame_deadline(lock))
+                continue;
+
             set_reader_state(ReaderState::Reading);
-            read_frame();
+            if (m_play_backward)
+                read_previous_frame();
+            else
+                read_next_frame();
         }
         catch (const std::exception& e)
         {
@@ -324,6 +572,16 @@ namespace step::video::ff {
 void ReaderFF::deserialize(const ObjectPtrJSON& container)
 {
     step::utils::from_string<video::ff::ReaderMode>(m_mode, json::get<std::string>(container, CFG_FLD::MODE));
+    m_keyframe_index_scan = json::get<bool>(container, CFG_FLD::KEYFRAME_INDEX_SCAN, false);
+    m_keyframe_index_sidecar = json::get<bool>(container, CFG_FLD::KEYFRAME_INDEX_SIDECAR, false);
+    m_gop_cache_size_mb = json::get<size_t>(container, CFG_FLD::GOP_CACHE_SIZE, 0);
+    m_analysis_frames = deserialize_analysis_frame_formats(container);
+    m_io_settings.buffer_size = json::get<size_t>(container, CFG_FLD::IO_BUFFER_SIZE, 0) * 1024;
+    m_io_settings.use_mmap = json::get<bool>(container, CFG_FLD::IO_MMAP, false);
+    m_io_settings.prefetch = json::get<bool>(container, CFG_FLD::IO_PREFETCH, false);
+    m_decoder_threads = json::get<int>(container, CFG_FLD::DECODER_THREADS, 1);
+    m_realtime_pacing = json::get<bool>(container, CFG_FLD::REALTIME_PACING, false);
+    m_max_lateness = Milliseconds(json::get<size_t>(container, CFG_FLD::MAX_LATENESS, 0));
 }
 
 }  // namespace step::video::ff
\ No newline at end of file
@@ -1,8 +1,10 @@
 #pragma once
 
 #include "reader_event.hpp"
+#include "gop_prefetcher.hpp"
 
 #include <core/base/interfaces/event_handler_list.hpp>
+#include <core/base/utils/media_clock.hpp>
 #include <core/threading/thread_worker.hpp>
 #include <core/threading/thread_utils.hpp>
 #include <core/threading/thread_pool_execute_policy.hpp>
@@ -32,6 +34,7 @@ public:
     ReaderState get_state() const override;
 
     void play() override;
+    void play_backward() override;
     void pause() override;
     void stop() override;
     void step_forward() override;
@@ -40,6 +43,10 @@ public:
     void rewind_backward() override;
     void set_position(TimestampFF) override;
 
+    /*! @brief Статистика ввода текущего файла (нулевая, если собственный ввод выключен).
+    */
+    IoStats get_io_stats() const;
+
 public:
     void register_observer(IFrameSourceObserver* observer) override;
     void unregister_observer(IFrameSourceObserver* observer) override;
@@ -52,6 +59,7 @@ protected:
 
 private:
     void play_impl();
+    void play_backward_impl();
     void pause_impl();
     void stop_impl();
     void step_forward_impl();
@@ -67,8 +75,18 @@ private:
     void thread_worker_stop_impl() override;
 
     void set_reader_state(ReaderState);
+    void init_keyframe_index();
+    void save_keyframe_index();
+    void init_gop_cache();
+    static DecoderOptions get_scrub_decoder_options();
+    void log_io_stats() const;
     void seek(TimestampFF pos);
     void read_frame();
+    void read_next_frame();
+    void read_previous_frame();
+    bool read_cached_previous_frame();
+    bool wait_frame_deadline(std::unique_lock<std::mutex>& lock);
+    bool is_frame_late(const Frame& frame);
     bool need_break_reading(bool verbose = false) const;
     bool need_handle_frame();
 
@@ -101,6 +119,25 @@ private:
     step::EventHandlerList<IReaderEventObserver, threading::ThreadPoolExecutePolicy<0>> m_reader_observers;
 
     ReaderMode m_mode{ReaderMode::Undefined};
+    bool m_keyframe_index_scan{false};
+    bool m_keyframe_index_sidecar{false};
+    size_t m_gop_cache_size_mb{0};
+    AnalysisFrameFormats m_analysis_frames;
+    IoSettings m_io_settings;
+    int m_decoder_threads{1};
+
+    // Темп воспроизведения вперед, часы перепривязываются после любого события (пауза, переход...)
+    step::utils::MediaClock m_clock;
+    bool m_realtime_pacing{false};
+    Microseconds m_max_lateness{0};
+    uint64_t m_late_frames{0};
+
+    // Кэш GOP для шага назад и обратного воспроизведения
+    std::shared_ptr<GopFrameCache> m_gop_cache{nullptr};
+    std::unique_ptr<GopPrefetcher> m_gop_prefetcher{nullptr};
+    TimestampFF m_gop_ts{AV_NOPTS_VALUE};  // начало GOP, который сейчас читается основным потоком
+    bool m_need_resync{false};  // кадры выдавались из кэша, основной поток стоит не на следующем кадре
+    bool m_play_backward{false};
     ReaderState m_state{ReaderState::Undefined};
 
     mutable std::mutex m_read_guard;
@@ -12,6 +12,7 @@ public:
     {
         Undefined,
         Play,
+        PlayBackward,
         Pause,
         Stop,
         StepForward,
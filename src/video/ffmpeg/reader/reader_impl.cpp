@@ -21,6 +21,17 @@ namespace step::video::ff {
 
 void ReaderFF::play_impl()
 {
+    m_play_backward = false;
+    if (!m_continue_reading)
+        m_continue_reading.store(true);
+}
+
+void ReaderFF::play_backward_impl()
+{
+    if (!m_gop_cache)
+        STEP_LOG(L_WARN, "Play backward without GOP cache: every frame needs a seek");
+
+    m_play_backward = true;
     if (!m_continue_reading)
         m_continue_reading.store(true);
 }
@@ -46,7 +57,7 @@ void ReaderFF::step_forward_impl()
     }
 
     m_need_handle_after_force_set_pos = true;
-    read_frame();
+    read_next_frame();
     m_need_handle_after_force_set_pos = false;
 }
 
@@ -59,7 +70,7 @@ void ReaderFF::step_backward_impl()
     }
 
     m_need_handle_after_force_set_pos = true;
-    set_position_impl(get_position() - m_prev_duration);
+    read_previous_frame();
     m_need_handle_after_force_set_pos = false;
 }
 
@@ -95,6 +106,7 @@ void ReaderFF::set_position_impl(TimestampFF pos)
     }
 
     STEP_LOG(L_DEBUG, "Try to set position {} to {}", get_position(), pos);
+    m_need_resync = false;
 
     // Отключаем обзерверов, чтобы не летели кадры и статусы
     m_frame_observers.disable();
@@ -114,6 +126,16 @@ void ReaderFF::set_position_impl(TimestampFF pos)
         return;
     }
 
+    if (m_mode == ReaderMode::Scrub)
+    {
+        // Декодер отдает только ключевые кадры: показываем ключевой кадр перед pos, без дочитывания
+        m_frame_observers.enable();
+        m_reader_observers.enable();
+        read_frame();
+        set_reader_state(prev_state);
+        return;
+    }
+
     // После seek мы стоим на ключевом кадре, надо дочитать до нужного места, если требуется
     // Читаем по одному кадру, пока следующий для чтения кадр не будет нужным
     auto next_frame_ts = m_stream->get_position();
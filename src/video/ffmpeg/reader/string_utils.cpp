@@ -15,6 +15,7 @@ namespace {
 constexpr std::pair<step::video::ff::ReaderMode, std::string_view> g_reader_modes[] = {
     { step::video::ff::ReaderMode::KeyFrame , "KeyFrame"    },
     { step::video::ff::ReaderMode::All      , "All"         },
+    { step::video::ff::ReaderMode::Scrub    , "Scrub"       },
 };
 
 constexpr std::pair<step::video::ff::ReaderState, std::string_view> g_reader_statutes[] = {
@@ -29,6 +30,7 @@ constexpr std::pair<step::video::ff::ReaderState, std::string_view> g_reader_sta
 constexpr std::pair<step::video::ff::ReaderEvent::Type, std::string_view> g_reader_events[] = {
     { step::video::ff::ReaderEvent::Type::Pause             , "Pause"           },
     { step::video::ff::ReaderEvent::Type::Play              , "Play"            },
+    { step::video::ff::ReaderEvent::Type::PlayBackward      , "PlayBackward"    },
     { step::video::ff::ReaderEvent::Type::RewindBackward    , "RewindBackward"  },
     { step::video::ff::ReaderEvent::Type::RewindForward     , "RewindForward"   },
     { step::video::ff::ReaderEvent::Type::SetPosition       , "SetPosition"     },
@@ -0,0 +1,144 @@
+#include "thumbnail_strip.hpp"
+
+#include <core/exception/assert.hpp>
+#include <core/log/log.hpp>
+#include <core/threading/thread_pool_event_handler.hpp>
+
+#include <video/ffmpeg/decoding/stream_reader.hpp>
+
+#include <algorithm>
+#include <latch>
+#include <memory>
+#include <thread>
+
+namespace {
+
+constexpr int MAX_THUMBNAIL_LOWRES = 3;
+
+}  // namespace
+
+namespace step::video::ff {
+
+namespace {
+
+/*! @brief Наибольшее уменьшение декодера, после которого кадр еще не уже превью.
+*/
+int choose_lowres(int src_width, size_t width)
+{
+    int lowres = 0;
+    while (lowres < MAX_THUMBNAIL_LOWRES && static_cast<size_t>(src_width >> (lowres + 1)) >= width)
+        ++lowres;
+    return lowres;
+}
+
+void extract_thumbnails(const std::string& filename, size_t width, const std::vector<TimestampFF>& positions,
+                        size_t begin, size_t end, std::vector<FramePtr>& thumbnails)
+{
+    auto parser = std::make_shared<ParserFF>();
+    if (!parser->open_file(filename))
+    {
+        STEP_LOG(L_ERROR, "Thumbnail strip: failed to open file {}", filename);
+        return;
+    }
+
+    auto demuxer = std::make_shared<DemuxerQueue>(parser);
+    const auto stream_id = demuxer->get_best_video_stream_id();
+    if (stream_id == INVALID_STREAM_ID)
+    {
+        STEP_LOG(L_ERROR, "Thumbnail strip: no video stream in file {}", filename);
+        return;
+    }
+
+    const auto* codec_par = demuxer->get_format_codec(stream_id).codec_par;
+    const auto height = codec_par->width > 0 ? width * codec_par->height / codec_par->width : width;
+
+    DecoderOptions options;
+    options.key_frames_only = true;
+    options.lowres = choose_lowres(codec_par->width, width);
+    options.out_size = FrameSize(width, std::max<size_t>(height & ~size_t(1), 2));
+
+    auto stream_reader = std::make_shared<StreamReader>(demuxer);
+    stream_reader->set_decoder_options(options);
+    auto stream = stream_reader->get_best_video_stream();
+    if (!stream)
+        return;
+
+    for (size_t i = begin; i < end; ++i)
+    {
+        stream->request_seek(positions[i], nullptr);
+        stream->do_seek();
+        if (!stream->get_last_seek_result())
+        {
+            STEP_LOG(L_WARN, "Thumbnail strip: invalid seek to {}, file {}", positions[i], filename);
+            continue;
+        }
+
+        // После seek декодер с отбрасыванием неключевых кадров отдает ключевой кадр перед позицией
+        thumbnails[i] = stream->read_frame();
+    }
+}
+
+}  // namespace
+
+std::vector<FramePtr> generate_thumbnail_strip(const std::string& filename, const ThumbnailStripSettings& settings)
+{
+    STEP_ASSERT(settings.count > 0 && settings.width > 0, "Invalid thumbnail strip settings: count {}, width {}",
+                settings.count, settings.width);
+
+    TimeFF duration = 0;
+    {
+        auto parser = std::make_shared<ParserFF>();
+        if (!parser->open_file(filename))
+            STEP_THROW_RUNTIME("Thumbnail strip: failed to open file {}", filename);
+        duration = parser->get_duration();
+    }
+
+    std::vector<TimestampFF> positions(settings.count);
+    for (size_t i = 0; i < settings.count; ++i)
+        positions[i] = duration * static_cast<TimeFF>(2 * i + 1) / static_cast<TimeFF>(2 * settings.count);
+
+    const size_t hardware_threads = std::max(std::thread::hardware_concurrency(), 1u);
+    const size_t thread_count = std::min(settings.count, settings.threads > 0 ? settings.threads : hardware_threads);
+
+    std::vector<FramePtr> thumbnails(settings.count);
+    // latch в shared_ptr: задача пула может еще держать его после count_down, когда мы уже вышли
+    auto done = std::make_shared<std::latch>(static_cast<std::ptrdiff_t>(thread_count));
+    auto& thread_pool = threading::get_or_create_global_thread_pool();
+    for (size_t t = 0; t < thread_count; ++t)
+    {
+        // Соседние позиции в одном потоке: seek вперед по файлу дешевле случайного
+        const size_t begin = t * settings.count / thread_count;
+        const size_t end = (t + 1) * settings.count / thread_count;
+        thread_pool.add_task([&, done, begin, end]() {
+            try
+            {
+                extract_thumbnails(filename, settings.width, positions, begin, end, thumbnails);
+            }
+            catch (const std::exception& e)
+            {
+                STEP_LOG(L_ERROR, "Thumbnail strip: failed to extract thumbnails {}-{}: {}", begin, end, e.what());
+            }
+            catch (...)
+            {
+                // Без count_down вызывающий поток ждал бы задачу вечно
+                STEP_LOG(L_ERROR, "Thumbnail strip: failed to extract thumbnails {}-{}: unknown exception", begin,
+                         end);
+            }
+            done->count_down();
+        });
+    }
+
+    // Помогаем пулу, пока ждем: вызов может прийти из потока самого пула
+    while (!done->try_wait())
+    {
+        if (!thread_pool.try_run_one())
+            std::this_thread::yield();
+    }
+
+    STEP_LOG(L_DEBUG, "Thumbnail strip: {} of {} thumbnails extracted, {} threads, file {}",
+             std::count_if(thumbnails.cbegin(), thumbnails.cend(), [](const FramePtr& frame) { return !!frame; }),
+             settings.count, thread_count, filename);
+    return thumbnails;
+}
+
+}  // namespace step::video::ff
@@ -0,0 +1,24 @@
+#pragma once
+
+#include <video/frame/interfaces/frame.hpp>
+
+#include <string>
+#include <vector>
+
+namespace step::video::ff {
+
+struct ThumbnailStripSettings
+{
+    size_t count{10};   ///< количество превью, равномерно по длительности файла
+    size_t width{160};  ///< ширина превью, высота - по пропорциям кадра
+    size_t threads{0};  ///< 0 - по числу ядер
+};
+
+/*! @brief Полоса превью для таймлайна: по одному ключевому кадру в центре каждого из count равных отрезков.
+    @details Декодируются только ключевые кадры в уменьшенном разрешении (lowres, если кодек поддерживает),
+    масштабирование сразу в размер превью. Отрезки делятся между потоками глобального пула,
+    у каждого потока свой парсер и декодер. Если кадр не удалось получить, на его месте nullptr.
+*/
+std::vector<FramePtr> generate_thumbnail_strip(const std::string& filename, const ThumbnailStripSettings& settings);
+
+}  // namespace step::video::ff
@@ -0,0 +1,39 @@
+#include "video_segments.hpp"
+
+#include <algorithm>
+
+namespace step::video::ff {
+
+std::vector<VideoSegment> split_into_segments(const std::vector<TimestampFF>& keyframes, TimeFF duration,
+                                              size_t count, TimeFF warmup)
+{
+    // Границы - ключевые кадры, ближайшие к равным долям длительности. Первый ключевой кадр границей
+    // не бывает: все, что до него, и так относится к первому сегменту.
+    std::vector<TimestampFF> bounds;
+    for (size_t i = 1; i < count && keyframes.size() > 1; ++i)
+    {
+        const auto target = duration * static_cast<TimeFF>(i) / static_cast<TimeFF>(count);
+        auto it = std::lower_bound(keyframes.cbegin() + 1, keyframes.cend(), target);
+        if (it == keyframes.cend() || (it != keyframes.cbegin() + 1 && target - *std::prev(it) < *it - target))
+            --it;
+
+        if (bounds.empty() || *it > bounds.back())
+            bounds.push_back(*it);
+    }
+
+    std::vector<VideoSegment> segments(bounds.size() + 1);
+    for (size_t i = 0; i < bounds.size(); ++i)
+    {
+        segments[i].end = bounds[i];
+
+        auto& next = segments[i + 1];
+        next.start = bounds[i];
+        // Последний ключевой кадр не позже start - warmup, но не раньше первого ключевого кадра файла
+        auto warmup_it = std::upper_bound(keyframes.cbegin(), keyframes.cend(), next.start - warmup);
+        next.warmup_start = (warmup_it == keyframes.cbegin()) ? keyframes.front() : *std::prev(warmup_it);
+    }
+
+    return segments;
+}
+
+}  // namespace step::video::ff
@@ -0,0 +1,39 @@
+#pragma once
+
+#include <video/ffmpeg/interfaces/types.hpp>
+
+extern "C" {
+#include <libavutil/avutil.h>
+}
+
+#include <cstddef>
+#include <vector>
+
+namespace step::video::ff {
+
+/*! @brief Участок файла для независимой обработки, границы - ключевые кадры.
+    @details Кадры с ts в [start, end) принадлежат сегменту. Декодирование начинается с warmup_start,
+    кадры до start нужны только для прогрева состояния обработки (трекинг) и в результат не идут.
+*/
+struct VideoSegment
+{
+    TimestampFF start{AV_NOPTS_VALUE};         ///< AV_NOPTS_VALUE - с начала файла
+    TimestampFF end{AV_NOPTS_VALUE};           ///< AV_NOPTS_VALUE - до конца файла
+    TimestampFF warmup_start{AV_NOPTS_VALUE};  ///< ключевой кадр для seek, AV_NOPTS_VALUE - без seek
+
+    bool contains(TimestampFF ts) const noexcept
+    {
+        return (start == AV_NOPTS_VALUE || ts >= start) && (end == AV_NOPTS_VALUE || ts < end);
+    }
+    bool is_after_end(TimestampFF ts) const noexcept { return end != AV_NOPTS_VALUE && ts >= end; }
+};
+
+/*! @brief Делит файл на не более count сегментов примерно равной длительности по ключевым кадрам.
+    @param keyframes pts ключевых кадров по возрастанию
+    @param warmup сколько времени перед началом сегмента декодировать для прогрева, 0 - без прогрева
+    @details Сегменты идут подряд без пропусков и пересечений. Если ключевых кадров мало, сегментов меньше count.
+*/
+std::vector<VideoSegment> split_into_segments(const std::vector<TimestampFF>& keyframes, TimeFF duration,
+                                              size_t count, TimeFF warmup = 0);
+
+}  // namespace step::video::ff
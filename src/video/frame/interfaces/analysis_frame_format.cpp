@@ -0,0 +1,29 @@
+#include "analysis_frame_format.hpp"
+
+#include <core/base/types/config_fields.hpp>
+
+namespace step::video {
+
+void AnalysisFrameFormat::deserialize(const ObjectPtrJSON& cfg)
+{
+    size.deserialize(json::get_object(cfg, CFG_FLD::FRAME_SIZE));
+    step::utils::from_string(pix_fmt, json::get<std::string>(cfg, CFG_FLD::PIXEL_FORMAT, "RGB"));
+    letterbox = json::get<bool>(cfg, CFG_FLD::LETTERBOX, false);
+}
+
+AnalysisFrameFormats deserialize_analysis_frame_formats(const ObjectPtrJSON& container)
+{
+    AnalysisFrameFormats formats;
+    auto formats_json = json::opt_array(container, CFG_FLD::ANALYSIS_FRAMES);
+    if (!formats_json)
+        return formats;
+
+    json::for_each_in_array<ObjectPtrJSON>(formats_json, [&formats](const ObjectPtrJSON& cfg) {
+        AnalysisFrameFormat format;
+        format.deserialize(cfg);
+        formats.push_back(std::move(format));
+    });
+    return formats;
+}
+
+}  // namespace step::video
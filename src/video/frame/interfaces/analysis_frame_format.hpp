@@ -0,0 +1,37 @@
+#pragma once
+
+#include "pixel_format.hpp"
+#include "frame_size.hpp"
+
+#include <core/base/interfaces/serializable.hpp>
+
+#include <vector>
+
+namespace step::video {
+
+/*! @brief Формат уменьшенной копии кадра для анализа (детектор, face engine).
+    @details Декодер готовит такие копии из исходного YUV-кадра вместе с кадром отображения,
+    поэтому потребителям не нужно копировать и масштабировать полноразмерный кадр.
+*/
+struct AnalysisFrameFormat : public ISerializable
+{
+    FrameSize size;
+    PixFmt pix_fmt{PixFmt::RGB};
+    bool letterbox{false};  ///< вписать с сохранением пропорций в левый верхний угол, остаток - черный
+
+    void deserialize(const ObjectPtrJSON& cfg) override;
+
+    bool operator==(const AnalysisFrameFormat& rhs) const noexcept
+    {
+        return size == rhs.size && pix_fmt == rhs.pix_fmt && letterbox == rhs.letterbox;
+    }
+    bool operator!=(const AnalysisFrameFormat& rhs) const noexcept { return !(*this == rhs); }
+};
+
+using AnalysisFrameFormats = std::vector<AnalysisFrameFormat>;
+
+/*! @brief Читает необязательный массив форматов analysis_frames из container.
+*/
+AnalysisFrameFormats deserialize_analysis_frame_formats(const ObjectPtrJSON& container);
+
+}  // namespace step::video
@@ -2,11 +2,13 @@
 
 #include "pixel_format.hpp"
 #include "frame_size.hpp"
+#include "analysis_frame_format.hpp"
 
 #include <core/base/utils/time_utils.hpp>
 
 #include <fmt/format.h>
 
+#include <algorithm>
 #include <cstddef>
 #include <cstdint>
 #include <memory>
@@ -22,6 +24,17 @@ using Frames = std::vector<Frame>;
 using FramePtr = std::shared_ptr<Frame>;
 using FramesPtrs = std::vector<FramePtr>;
 
+/*! @brief Уменьшенная копия кадра для анализа, подготовленная декодером вместе с кадром.
+*/
+struct AnalysisFrame
+{
+    AnalysisFrameFormat format;
+    FramePtr frame;
+};
+
+using AnalysisFrames = std::vector<AnalysisFrame>;
+using AnalysisFramesPtr = std::shared_ptr<const AnalysisFrames>;
+
 class Frame
 {
 public:
@@ -94,12 +107,17 @@ public:
     }
 
     Frame(const Frame& rhs)
-        : size(rhs.size), stride(rhs.stride), pix_fmt(rhs.pix_fmt), ts(rhs.ts), duration(rhs.duration)
+        : size(rhs.size)
+        , stride(rhs.stride)
+        , pix_fmt(rhs.pix_fmt)
+        , ts(rhs.ts)
+        , duration(rhs.duration)
+        , analysis_frames(rhs.analysis_frames)
     {
         reset();
 
         m_data = new DataType[rhs.bytesize()];
-        std::memcpy(m_data, rhs.m_data, bytesize());
+        std::memcpy(m_data, rhs.m_data, rhs.datasize());
     }
     Frame& operator=(const Frame& rhs)
     {
@@ -116,6 +134,7 @@ public:
         , pix_fmt(std::exchange(rhs.pix_fmt, PixFmt::Undefined))
         , ts(std::exchange(rhs.ts, get_current_timestamp()))
         , duration(std::exchange(rhs.duration, -1))
+        , analysis_frames(std::move(rhs.analysis_frames))
     {
     }
     Frame& operator=(Frame&& rhs)
@@ -135,7 +154,7 @@ public:
             && size == lhs.size
             && pix_fmt == lhs.pix_fmt
             && stride == lhs.stride
-            && std::memcmp(m_data, lhs.m_data, bytesize()) == 0
+            && std::memcmp(m_data, lhs.m_data, datasize()) == 0
         ;
         /* clang-format on */
     }
@@ -149,6 +168,7 @@ public:
         std::swap(lhs.stride, rhs.stride);
         std::swap(lhs.ts, rhs.ts);
         std::swap(lhs.duration, rhs.duration);
+        std::swap(lhs.analysis_frames, rhs.analysis_frames);
     }
 
     bool is_valid() const noexcept
@@ -166,6 +186,15 @@ public:
 public:
     size_t bytesize() const noexcept { return stride * size.height; }
 
+    /*! @brief Bytes from data() to the end of the last row's pixels.
+        @details A view of a frame region keeps the stride of the frame, so the buffer may end right after
+        the pixels of its last row. Copies and comparisons must not read past that.
+    */
+    size_t datasize() const noexcept
+    {
+        return size.height > 0 ? std::min(bytesize(), stride * (size.height - 1) + calculate_stride()) : 0;
+    }
+
     size_t bpp() const { return video::utils::get_bpp(pix_fmt); }
 
     DataTypePtr data() noexcept { return m_data; }
@@ -203,6 +232,7 @@ public:
     PixFmt pix_fmt{PixFmt::Undefined};
     Timestamp ts{step::get_current_timestamp()};
     int64_t duration{-1};
+    AnalysisFramesPtr analysis_frames;  ///< копии для анализа, общие для всех копий кадра и не изменяются
 };
 
 }  // namespace step::video
@@ -5,6 +5,8 @@
 #include <opencv2/imgcodecs.hpp>
 #include <opencv2/imgproc.hpp>
 
+#include <algorithm>
+
 namespace step::video::utils {
 
 void convert_colorspace(Frame& frame, PixFmt dst_format)
@@ -19,4 +21,32 @@ void convert_colorspace(Frame& frame, PixFmt dst_format)
                                dst.data);
 }
 
-}  // namespace step::video::utils
+FramePtr find_analysis_frame(const Frame& frame, const AnalysisFrameFormat& format)
+{
+    if (!frame.analysis_frames)
+        return nullptr;
+
+    const auto& analysis_frames = *frame.analysis_frames;
+    auto it = std::find_if(analysis_frames.cbegin(), analysis_frames.cend(),
+                           [&format](const AnalysisFrame& item) { return item.format == format; });
+    return it != analysis_frames.cend() ? it->frame : nullptr;
+}
+
+FramePtr find_largest_analysis_frame(const Frame& frame, PixFmt pix_fmt)
+{
+    if (!frame.analysis_frames)
+        return nullptr;
+
+    FramePtr result = nullptr;
+    for (const auto& item : *frame.analysis_frames)
+    {
+        if (item.format.pix_fmt != pix_fmt || item.format.letterbox || !item.frame)
+            continue;
+
+        if (!result || item.frame->size.width > result->size.width)
+            result = item.frame;
+    }
+    return result;
+}
+
+}  // namespace step::video::utils
\ No newline at end of file
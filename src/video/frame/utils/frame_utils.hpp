@@ -25,4 +25,43 @@ namespace step::video::utils {
 
 void convert_colorspace(Frame& frame, PixFmt dst_format);
 
-}  // namespace step::video::utils
\ No newline at end of file
+/*! @brief Веса яркости BT.601 в 1/SCALE в порядке каналов кадра, альфа-канал не учитывается.
+*/
+struct LumaWeights
+{
+    static constexpr uint32_t SCALE = 256;
+
+    uint32_t c0;
+    uint32_t c1;
+    uint32_t c2;
+
+    /*! @brief Взвешенная сумма каналов, яркость - сумма / SCALE. Каналы могут быть суммами по нескольким пикселям.
+    */
+    template <typename T>
+    T weighted_sum(T v0, T v1, T v2) const noexcept
+    {
+        return static_cast<T>(c0) * v0 + static_cast<T>(c1) * v1 + static_cast<T>(c2) * v2;
+    }
+};
+
+/*! @brief Веса яркости для трехканальных (и с альфа-каналом) форматов RGB и BGR.
+*/
+constexpr LumaWeights get_luma_weights(PixFmt pix_fmt) noexcept
+{
+    const bool is_bgr = pix_fmt == PixFmt::BGR || pix_fmt == PixFmt::BGRA;
+    return is_bgr ? LumaWeights{29, 150, 77} : LumaWeights{77, 150, 29};
+}
+
+}  // namespace step::video::utils
+// Analysis frames utils
+namespace step::video::utils {
+
+/*! @brief Копия кадра для анализа точно в формате format, nullptr если декодер ее не готовил.
+*/
+FramePtr find_analysis_frame(const Frame& frame, const AnalysisFrameFormat& format);
+
+/*! @brief Наибольшая копия кадра для анализа в pix_fmt без полей (не letterbox), nullptr если такой нет.
+*/
+FramePtr find_largest_analysis_frame(const Frame& frame, PixFmt pix_fmt);
+
+}  // namespace step::video::utils
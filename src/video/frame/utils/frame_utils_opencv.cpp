@@ -59,6 +59,13 @@ cv::Mat to_mat(Frame& frame)
                    frame.stride);
 }
 
+cv::Mat to_mat(const Frame& frame)
+{
+    // cv::Mat has no read-only view, constness is kept by the caller
+    return cv::Mat(frame.size.height, frame.size.width, utils::get_cv_data_type(frame.pix_fmt),
+                   const_cast<Frame::DataTypePtr>(frame.data()), frame.stride);
+}
+
 cv::Mat to_mat_deep(Frame& frame) { return to_mat(frame).clone(); }
 
 Frame from_mat(cv::Mat& mat, PixFmt fmt)
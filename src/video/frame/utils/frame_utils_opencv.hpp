@@ -12,6 +12,9 @@ namespace step::video::utils {
 // Non-owned Mat
 cv::Mat to_mat(Frame& frame);
 
+// Non-owned Mat for read-only access, the frame data must not be modified through it
+cv::Mat to_mat(const Frame& frame);
+
 // Owned Mat
 cv::Mat to_mat_deep(Frame& frame);
 
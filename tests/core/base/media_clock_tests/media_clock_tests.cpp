@@ -0,0 +1,64 @@
+#include <core/base/utils/media_clock.hpp>
+
+#include <gtest/gtest.h>
+
+using namespace step;
+using namespace step::utils;
+
+TEST(MediaClockTest, not_started_deadline_is_now)
+{
+    MediaClock clock;
+    EXPECT_FALSE(clock.is_started());
+
+    const auto before = MediaClock::Clock::now();
+    const auto deadline = clock.get_deadline(Seconds(100));
+    EXPECT_GE(deadline, before);
+    EXPECT_LE(deadline, MediaClock::Clock::now());
+
+    // Без привязки кадр не опаздывает и не ждет
+    EXPECT_LE(clock.get_lateness(Seconds(100), before), Microseconds(0));
+}
+
+TEST(MediaClockTest, deadlines_follow_anchor)
+{
+    MediaClock clock;
+    const auto anchor = MediaClock::Clock::now();
+    clock.start(Seconds(10), anchor);
+    EXPECT_TRUE(clock.is_started());
+
+    EXPECT_EQ(clock.get_deadline(Seconds(10)), anchor);
+    EXPECT_EQ(clock.get_deadline(Milliseconds(10'040)), anchor + Milliseconds(40));
+    EXPECT_EQ(clock.get_deadline(Milliseconds(9'500)), anchor - Milliseconds(500));
+
+    // Срок кадра не зависит от того, когда был отдан предыдущий
+    EXPECT_EQ(clock.get_deadline(Seconds(12)) - clock.get_deadline(Seconds(11)), Seconds(1));
+}
+
+TEST(MediaClockTest, lateness)
+{
+    MediaClock clock;
+    const auto anchor = MediaClock::Clock::now();
+    clock.start(Timestamp(0), anchor);
+
+    EXPECT_EQ(clock.get_lateness(Milliseconds(40), anchor + Milliseconds(140)), Milliseconds(100));
+    EXPECT_EQ(clock.get_lateness(Milliseconds(40), anchor + Milliseconds(40)), Microseconds(0));
+    EXPECT_EQ(clock.get_lateness(Seconds(1), anchor), -Seconds(1));
+}
+
+TEST(MediaClockTest, restart_and_reset)
+{
+    MediaClock clock;
+    const auto anchor = MediaClock::Clock::now();
+    clock.start(Seconds(0), anchor);
+
+    // Перепривязка после паузы или перехода
+    const auto resumed = anchor + Seconds(30);
+    clock.start(Seconds(5), resumed);
+    EXPECT_EQ(clock.get_deadline(Seconds(6)), resumed + Seconds(1));
+    EXPECT_EQ(clock.get_lateness(Seconds(5), resumed), Microseconds(0));
+
+    clock.reset();
+    EXPECT_FALSE(clock.is_started());
+    const auto before = MediaClock::Clock::now();
+    EXPECT_GE(clock.get_deadline(Seconds(6)), before);
+}
@@ -0,0 +1,138 @@
+#include <core/threading/delivery_queue.hpp>
+
+#include <core/base/utils/string_utils.hpp>
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <future>
+#include <thread>
+
+using namespace step;
+using namespace step::threading;
+
+namespace {
+
+/*! @brief Ждет, пока производитель не заблокируется на полной очереди.
+*/
+bool wait_blocked(const DeliveryQueue<int>& queue, uint64_t blocked)
+{
+    for (int i = 0; i < 1000; ++i)
+    {
+        if (queue.get_stats().blocked >= blocked)
+            return true;
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    return false;
+}
+
+}  // namespace
+
+TEST(DeliveryQueueTest, queue_policy_blocks_producer)
+{
+    DeliveryQueue<int> queue(DeliveryPolicy::Queue, 2);
+    EXPECT_EQ(queue.push(1), DeliveryResult::Accepted);
+    EXPECT_EQ(queue.push(2), DeliveryResult::Accepted);
+
+    auto producer = std::async(std::launch::async, [&queue]() { return queue.push(3); });
+    ASSERT_TRUE(wait_blocked(queue, 1));
+    EXPECT_EQ(queue.size(), 2);
+
+    EXPECT_EQ(queue.pop(), 1);
+    EXPECT_EQ(producer.get(), DeliveryResult::Accepted);
+    EXPECT_EQ(queue.pop(), 2);
+    EXPECT_EQ(queue.pop(), 3);
+    EXPECT_FALSE(queue.try_pop().has_value());
+
+    const auto stats = queue.get_stats();
+    EXPECT_EQ(stats.pushed, 3);
+    EXPECT_EQ(stats.delivered, 3);
+    EXPECT_EQ(stats.dropped, 0);
+    EXPECT_EQ(stats.blocked, 1);
+    EXPECT_EQ(stats.max_size, 2);
+}
+
+TEST(DeliveryQueueTest, drop_oldest_policy)
+{
+    DeliveryQueue<int> queue(DeliveryPolicy::DropOldest, 3);
+    for (int i = 0; i < 3; ++i)
+        EXPECT_EQ(queue.push(i), DeliveryResult::Accepted);
+    EXPECT_EQ(queue.push(3), DeliveryResult::AcceptedWithDrop);
+    EXPECT_EQ(queue.push(4), DeliveryResult::AcceptedWithDrop);
+
+    EXPECT_EQ(queue.size(), 3);
+    EXPECT_EQ(queue.try_pop(), 2);
+    EXPECT_EQ(queue.try_pop(), 3);
+    EXPECT_EQ(queue.try_pop(), 4);
+    EXPECT_TRUE(queue.empty());
+
+    const auto stats = queue.get_stats();
+    EXPECT_EQ(stats.pushed, 5);
+    EXPECT_EQ(stats.delivered, 3);
+    EXPECT_EQ(stats.dropped, 2);
+    EXPECT_EQ(stats.blocked, 0);
+    EXPECT_EQ(stats.max_size, 3);
+}
+
+TEST(DeliveryQueueTest, latest_only_policy)
+{
+    // Емкость для LatestOnly всегда 1
+    DeliveryQueue<int> queue(DeliveryPolicy::LatestOnly, 10);
+    EXPECT_EQ(queue.push(1), DeliveryResult::Accepted);
+    EXPECT_EQ(queue.push(2), DeliveryResult::AcceptedWithDrop);
+    EXPECT_EQ(queue.push(3), DeliveryResult::AcceptedWithDrop);
+
+    EXPECT_EQ(queue.size(), 1);
+    EXPECT_EQ(queue.pop(), 3);
+
+    EXPECT_EQ(queue.push(4), DeliveryResult::Accepted);
+    EXPECT_EQ(queue.pop(), 4);
+
+    const auto stats = queue.get_stats();
+    EXPECT_EQ(stats.pushed, 4);
+    EXPECT_EQ(stats.delivered, 2);
+    EXPECT_EQ(stats.dropped, 2);
+    EXPECT_EQ(stats.max_size, 1);
+}
+
+TEST(DeliveryQueueTest, stop_and_restart)
+{
+    DeliveryQueue<int> queue(DeliveryPolicy::Queue, 1);
+    EXPECT_EQ(queue.push(1), DeliveryResult::Accepted);
+
+    // stop будит ждущих производителя и потребителя
+    auto producer = std::async(std::launch::async, [&queue]() { return queue.push(2); });
+    ASSERT_TRUE(wait_blocked(queue, 1));
+    queue.stop();
+    EXPECT_EQ(producer.get(), DeliveryResult::Stopped);
+    EXPECT_FALSE(queue.pop().has_value());
+    EXPECT_EQ(queue.push(3), DeliveryResult::Stopped);
+
+    // Оставшиеся в очереди данные считаются потерянными
+    auto stats = queue.get_stats();
+    EXPECT_EQ(stats.pushed, 1);
+    EXPECT_EQ(stats.delivered, 0);
+    EXPECT_EQ(stats.dropped, 1);
+
+    queue.restart();
+    EXPECT_EQ(queue.push(4), DeliveryResult::Accepted);
+    EXPECT_EQ(queue.pop(), 4);
+
+    stats = queue.get_stats();
+    EXPECT_EQ(stats.pushed, 2);
+    EXPECT_EQ(stats.delivered, 1);
+}
+
+TEST(DeliveryQueueTest, policy_from_string)
+{
+    for (const auto policy : {DeliveryPolicy::Queue, DeliveryPolicy::DropOldest, DeliveryPolicy::LatestOnly})
+    {
+        auto parsed = DeliveryPolicy::Undefined;
+        utils::from_string(parsed, utils::to_string(policy));
+        EXPECT_EQ(parsed, policy);
+    }
+
+    auto parsed = DeliveryPolicy::Undefined;
+    utils::from_string(parsed, "latest_only");
+    EXPECT_EQ(parsed, DeliveryPolicy::LatestOnly);
+}
@@ -0,0 +1,115 @@
+#include <core/threading/latest_mailbox.hpp>
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <memory>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+using namespace step;
+using namespace step::threading;
+
+TEST(LatestMailboxTest, put_notifies_only_empty_slot)
+{
+    LatestMailbox<int> mailbox;
+    EXPECT_TRUE(mailbox.empty());
+    EXPECT_FALSE(mailbox.take().has_value());
+
+    EXPECT_TRUE(mailbox.put(1));
+    EXPECT_FALSE(mailbox.empty());
+    EXPECT_FALSE(mailbox.put(2));
+
+    EXPECT_EQ(mailbox.take(), 2);
+    EXPECT_TRUE(mailbox.empty());
+
+    // После take ячейка снова пуста, потребителя нужно будить
+    EXPECT_TRUE(mailbox.put(3));
+    EXPECT_EQ(mailbox.take(), 3);
+}
+
+TEST(LatestMailboxTest, coalescing_counts_skipped)
+{
+    LatestMailbox<std::string> mailbox;
+    for (int i = 0; i < 5; ++i)
+        mailbox.put(std::to_string(i));
+
+    EXPECT_EQ(mailbox.take(), "4");
+    EXPECT_EQ(mailbox.get_taken_count(), 1);
+    EXPECT_EQ(mailbox.get_skipped_count(), 4);
+
+    // Пустой take счетчики не меняет
+    EXPECT_FALSE(mailbox.take().has_value());
+    EXPECT_EQ(mailbox.get_taken_count(), 1);
+    EXPECT_EQ(mailbox.get_skipped_count(), 4);
+}
+
+TEST(LatestMailboxTest, clear)
+{
+    LatestMailbox<std::unique_ptr<int>> mailbox;
+    mailbox.clear();
+    EXPECT_EQ(mailbox.get_skipped_count(), 0);
+
+    mailbox.put(std::make_unique<int>(1));
+    mailbox.clear();
+    EXPECT_TRUE(mailbox.empty());
+    EXPECT_FALSE(mailbox.take().has_value());
+    EXPECT_EQ(mailbox.get_skipped_count(), 1);
+    EXPECT_EQ(mailbox.get_taken_count(), 0);
+
+    EXPECT_TRUE(mailbox.put(std::make_unique<int>(2)));
+    auto value = mailbox.take();
+    ASSERT_TRUE(value.has_value());
+    EXPECT_EQ(**value, 2);
+}
+
+TEST(LatestMailboxTest, multiple_producers_stress)
+{
+    constexpr int PRODUCERS = 4;
+    constexpr int PUTS_PER_PRODUCER = 20'000;
+
+    // Значение - номер производителя и порядковый номер
+    LatestMailbox<std::pair<int, int>> mailbox;
+    std::atomic_int finished_producers{0};
+    std::vector<std::thread> producers;
+    for (int p = 0; p < PRODUCERS; ++p)
+    {
+        producers.emplace_back([&mailbox, &finished_producers, p]() {
+            for (int i = 0; i < PUTS_PER_PRODUCER; ++i)
+                mailbox.put({p, i});
+            ++finished_producers;
+        });
+    }
+
+    // От каждого производителя значения приходят по возрастанию
+    std::vector<int> last_taken(PRODUCERS, -1);
+    uint64_t taken = 0;
+    const auto take = [&]() {
+        auto value = mailbox.take();
+        if (!value)
+            return false;
+
+        const auto [producer, index] = *value;
+        EXPECT_GT(index, last_taken[producer]);
+        last_taken[producer] = index;
+        ++taken;
+        return true;
+    };
+
+    while (finished_producers < PRODUCERS)
+    {
+        if (!take())
+            std::this_thread::yield();
+    }
+    for (auto& producer : producers)
+        producer.join();
+    take();
+
+    EXPECT_TRUE(mailbox.empty());
+    EXPECT_GT(taken, 0);
+    EXPECT_EQ(mailbox.get_taken_count(), taken);
+    EXPECT_EQ(mailbox.get_taken_count() + mailbox.get_skipped_count(),
+              static_cast<uint64_t>(PRODUCERS) * PUTS_PER_PRODUCER);
+}
@@ -0,0 +1,222 @@
+#include <proc/detect/face_quality.hpp>
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+
+using namespace step;
+using namespace step::proc;
+
+namespace {
+
+constexpr size_t g_width = 640;
+constexpr size_t g_height = 480;
+
+class TestFace : public BaseFace<int>
+{
+public:
+    TestFace(const Rect& rect, double confidence)
+    {
+        m_rect = rect;
+        m_confidence = confidence;
+    }
+
+    FacePtr clone() const noexcept override { return std::make_shared<TestFace>(*this); }
+};
+
+FacePtr make_face(const Rect& rect, double confidence = 0.9, const FaceLandmarks& landmarks = {})
+{
+    FacePtr face = std::make_shared<TestFace>(rect, confidence);
+    face->set_landmarks(landmarks);
+    return face;
+}
+
+// Серый кадр BGR, в области textured - шахматная доска с клеткой cell
+video::Frame make_frame(const Rect& textured, int cell = 4)
+{
+    video::Frame frame(video::FrameSize(g_width, g_height), video::PixFmt::BGR);
+    std::fill(frame.data(), frame.data() + frame.stride * g_height, 128);
+    for (int y = textured.p0.y; y < textured.p1.y; ++y)
+        for (int x = textured.p0.x; x < textured.p1.x; ++x)
+            std::fill_n(frame.data() + y * frame.stride + x * 3, 3, ((x / cell + y / cell) % 2) ? 220 : 30);
+    return frame;
+}
+
+// Сетка MeshFitter: глаза, кончик носа и рот анфас с межглазным расстоянием 100, нос сдвинут на nose_shift
+FaceLandmarks make_landmarks(const Point2D& nose_shift = {})
+{
+    FaceLandmarks landmarks(468, Point2D(0, 0));
+    for (const auto index : {160, 158, 144, 153})
+        landmarks[index] = Point2D(200, 200);
+    for (const auto index : {385, 387, 380, 373})
+        landmarks[index] = Point2D(300, 200);
+    for (const auto index : {13, 14})
+        landmarks[index] = Point2D(250, 300);
+    landmarks[1] = Point2D(250 + nose_shift.x, 260 + nose_shift.y);
+    return landmarks;
+}
+
+SettingsFaceQuality make_settings()
+{
+    SettingsFaceQuality settings;
+    settings.set_min_size(48);
+    settings.set_min_sharpness(50.0);
+    settings.set_min_confidence(0.5);
+    settings.set_max_yaw(30.0);
+    settings.set_max_pitch(30.0);
+    settings.set_track_ttl(2);
+    return settings;
+}
+
+}  // namespace
+
+TEST(FaceQualityTest, sharpness)
+{
+    const Rect rect(100, 100, 300, 300);
+    const auto sharp_frame = make_frame(rect);
+    const auto flat_frame = make_frame({});
+
+    EXPECT_GT(calc_sharpness(sharp_frame, rect, 64), 1000.0);
+    EXPECT_EQ(calc_sharpness(flat_frame, rect, 64), 0.0);
+
+    // Область за краем кадра обрезается, слишком маленькая область не оценивается
+    EXPECT_GT(calc_sharpness(sharp_frame, Rect(-50, -50, 200, 200), 64), 1000.0);
+    EXPECT_EQ(calc_sharpness(sharp_frame, Rect(100, 100, 102, 200), 64), 0.0);
+}
+
+TEST(FaceQualityTest, sharpness_uses_gray_analysis_frame)
+{
+    // Цветной кадр без текстуры, текстура есть только в GRAY копии половинного размера
+    auto frame = make_frame({});
+    auto gray = std::make_shared<video::Frame>(video::FrameSize(g_width / 2, g_height / 2), video::PixFmt::GRAY);
+    for (size_t y = 0; y < gray->size.height; ++y)
+        for (size_t x = 0; x < gray->size.width; ++x)
+            gray->data()[y * gray->stride + x] = ((x / 2 + y / 2) % 2) ? 220 : 30;
+
+    video::AnalysisFrameFormat format;
+    format.size = gray->size;
+    format.pix_fmt = video::PixFmt::GRAY;
+    frame.analysis_frames = std::make_shared<const video::AnalysisFrames>(video::AnalysisFrames{{format, gray}});
+
+    EXPECT_GT(calc_sharpness(frame, Rect(100, 100, 300, 300), 64), 1000.0);
+
+    // В копии лицо мельче выборки: резкость считается по кадру
+    EXPECT_EQ(calc_sharpness(frame, Rect(100, 100, 200, 200), 64), 0.0);
+}
+
+TEST(FaceQualityTest, head_angles)
+{
+    EXPECT_FALSE(estimate_head_angles({}).has_value());
+    EXPECT_FALSE(estimate_head_angles(FaceLandmarks(5, Point2D(0, 0))).has_value());
+
+    const auto frontal = estimate_head_angles(make_landmarks());
+    ASSERT_TRUE(frontal.has_value());
+    EXPECT_NEAR(frontal->yaw, 0.0, 1e-6);
+    EXPECT_NEAR(frontal->pitch, 0.0, 1e-6);
+
+    const auto turned = estimate_head_angles(make_landmarks(Point2D(40, 0)));
+    ASSERT_TRUE(turned.has_value());
+    EXPECT_NEAR(std::abs(turned->yaw), 45.0, 1e-6);
+    EXPECT_NEAR(turned->pitch, 0.0, 1e-6);
+
+    const auto tilted = estimate_head_angles(make_landmarks(Point2D(0, -20)));
+    ASSERT_TRUE(tilted.has_value());
+    EXPECT_NEAR(tilted->yaw, 0.0, 1e-6);
+    EXPECT_NEAR(std::abs(tilted->pitch), 26.565, 1e-3);
+}
+
+TEST(FaceQualityTest, thresholds)
+{
+    FaceQualityFilter filter(make_settings());
+    const Rect rect(100, 100, 200, 200);
+    const auto frame = make_frame(rect);
+
+    auto quality = filter.evaluate(frame, *make_face(rect));
+    EXPECT_TRUE(quality.passed);
+    EXPECT_EQ(quality.size, 100);
+    EXPECT_GT(quality.score, 0.0);
+    EXPECT_FALSE(quality.angles.has_value());
+
+    EXPECT_FALSE(filter.evaluate(frame, *make_face(Rect(100, 100, 140, 140))).passed);
+    EXPECT_FALSE(filter.evaluate(frame, *make_face(rect, 0.3)).passed);
+    EXPECT_FALSE(filter.evaluate(make_frame({}), *make_face(rect)).passed);
+    EXPECT_FALSE(filter.evaluate(frame, *make_face(rect, 0.9, make_landmarks(Point2D(40, 0)))).passed);
+
+    quality = filter.evaluate(frame, *make_face(rect, 0.9, make_landmarks(Point2D(10, 0))));
+    EXPECT_TRUE(quality.passed);
+    ASSERT_TRUE(quality.angles.has_value());
+
+    // Повернутое лицо проходит порог, но получает меньшую оценку
+    EXPECT_LT(quality.score, filter.evaluate(frame, *make_face(rect, 0.9, make_landmarks())).score);
+}
+
+TEST(FaceQualityTest, best_face_per_track)
+{
+    FaceQualityFilter filter(make_settings());
+    const Rect rect(100, 100, 200, 200);
+    const auto frame = make_frame(Rect(0, 0, g_width, g_height));
+
+    auto qualities = filter.process(frame, {make_face(rect, 0.6), make_face(Rect(400, 100, 430, 130))});
+    ASSERT_EQ(qualities.size(), 2);
+    EXPECT_TRUE(qualities[0].selected);
+    EXPECT_FALSE(qualities[1].passed);
+    EXPECT_FALSE(qualities[1].selected);
+    EXPECT_EQ(filter.get_tracks_count(), 2);
+
+    // То же лицо не лучше прежнего - не распознается повторно, заметно лучшее - распознается
+    const Rect moved(105, 100, 205, 200);
+    EXPECT_FALSE(filter.process(frame, {make_face(moved, 0.62)}).front().selected);
+    EXPECT_TRUE(filter.process(frame, {make_face(moved, 0.9)}).front().selected);
+    EXPECT_FALSE(filter.process(frame, {make_face(moved, 0.9)}).front().selected);
+
+    // Треки без лиц удаляются через track_ttl кадров, после этого лицо снова новое
+    for (int i = 0; i < 3; ++i)
+        filter.process(frame, {});
+    EXPECT_EQ(filter.get_tracks_count(), 0);
+    EXPECT_TRUE(filter.process(frame, {make_face(moved, 0.6)}).front().selected);
+
+    EXPECT_TRUE(need_recognition(std::nullopt, 0));
+    EXPECT_TRUE(need_recognition(qualities, 0));
+    EXPECT_FALSE(need_recognition(qualities, 1));
+    EXPECT_FALSE(need_recognition(qualities, 2));
+}
+
+TEST(FaceQualityTest, track_identity_for_unselected_faces)
+{
+    FaceQualityFilter filter(make_settings());
+    const Rect rect(100, 100, 200, 200);
+    const auto frame = make_frame(Rect(0, 0, g_width, g_height));
+
+    const auto first = filter.process(frame, {make_face(rect, 0.9), make_face(Rect(400, 100, 500, 200))});
+    ASSERT_EQ(first.size(), 2);
+    ASSERT_TRUE(first[0].selected);
+    ASSERT_TRUE(first[0].track);
+    EXPECT_NE(first[0].track, first[1].track);
+
+    // Узлы распознавания и сравнения записывают итог отобранного лица в трек
+    first[0].track->set_recognizer_data({1.0f, 2.0f});
+    first[0].track->set_match_status(FaceMatchStatus::Matched);
+
+    // Следующие лица трека не отбираются, но видят итог его последнего отобранного лица
+    const auto next = filter.process(frame, {make_face(Rect(105, 100, 205, 200), 0.9)});
+    ASSERT_FALSE(next.front().selected);
+    EXPECT_EQ(next.front().track, first[0].track);
+    EXPECT_EQ(get_track_identity(next, 0)->get_match_status(), FaceMatchStatus::Matched);
+    EXPECT_EQ(get_track_identity(next, 0)->get_recognizer_data(), FaceRecognizerData({1.0f, 2.0f}));
+
+    EXPECT_EQ(get_track_identity(std::nullopt, 0), nullptr);
+    EXPECT_EQ(get_track_identity(next, 1), nullptr);
+}
+
+TEST(FaceQualityTest, every_passed_face_without_tracking)
+{
+    auto settings = make_settings();
+    settings.set_best_per_track(false);
+    FaceQualityFilter filter(settings);
+    const Rect rect(100, 100, 200, 200);
+    const auto frame = make_frame(rect);
+
+    for (int i = 0; i < 3; ++i)
+        EXPECT_TRUE(filter.process(frame, {make_face(rect)}).front().selected);
+}
@@ -0,0 +1,165 @@
+#include <proc/detect/motion_gate.hpp>
+#include <proc/settings/settings_empty.hpp>
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+
+using namespace step;
+using namespace step::proc;
+
+namespace {
+
+constexpr size_t g_width = 640;
+constexpr size_t g_height = 480;
+
+// Серый кадр BGR с белым квадратом object
+video::Frame make_frame(const Rect& object)
+{
+    video::Frame frame(video::FrameSize(g_width, g_height), video::PixFmt::BGR);
+    std::fill(frame.data(), frame.data() + frame.stride * g_height, 64);
+    for (int y = std::max(object.p0.y, 0); y < std::min<int>(object.p1.y, g_height); ++y)
+        for (int x = std::max(object.p0.x, 0); x < std::min<int>(object.p1.x, g_width); ++x)
+            std::fill_n(frame.data() + y * frame.stride + x * 3, 3, 255);
+    return frame;
+}
+
+SettingsMotionGate make_settings()
+{
+    SettingsMotionGate settings;
+    settings.set_analysis_width(160);
+    settings.set_block_size(8);
+    settings.set_activate_frames(1);
+    settings.set_deactivate_frames(3);
+    settings.set_region_margin(1);
+    settings.set_max_region_area(0.5);
+    return settings;
+}
+
+/*! @brief Возвращает bbox кадра целиком и считает вызовы и размеры переданных кадров.
+*/
+class CountingDetector : public BaseDetector<SettingsEmpty>
+{
+public:
+    DetectionResult process(video::Frame& frame)
+    {
+        sizes.push_back(frame.size);
+        return {{Rect(0, 0, static_cast<int>(frame.size.width), static_cast<int>(frame.size.height))}};
+    }
+
+    std::vector<video::FrameSize> sizes;
+};
+
+}  // namespace
+
+TEST(MotionGateTest, first_frame_is_detected_whole)
+{
+    MotionGate gate(make_settings());
+
+    const auto result = gate.process(make_frame({}));
+    EXPECT_TRUE(result.active);
+    ASSERT_EQ(result.regions.size(), 1);
+    EXPECT_EQ(result.regions.front(), Rect(0, 0, g_width, g_height));
+}
+
+TEST(MotionGateTest, still_frames_are_inactive)
+{
+    auto settings = make_settings();
+    settings.set_idle_interval(3);
+    MotionGate gate(settings);
+
+    const auto frame = make_frame(Rect(100, 100, 140, 140));
+    gate.process(frame);
+
+    std::vector<bool> active;
+    for (int i = 0; i < 6; ++i)
+    {
+        const auto result = gate.process(frame);
+        EXPECT_FALSE(result.changed);
+        active.push_back(result.active);
+    }
+
+    // Полная детекция раз в idle_interval кадров
+    EXPECT_EQ(active, std::vector<bool>({false, false, true, false, false, true}));
+}
+
+TEST(MotionGateTest, moving_object_region_and_hysteresis)
+{
+    MotionGate gate(make_settings());
+
+    const Rect object(200, 120, 260, 180);
+    gate.process(make_frame({}));
+
+    const auto moved = make_frame(object);
+    auto result = gate.process(moved);
+    EXPECT_TRUE(result.changed);
+    EXPECT_TRUE(result.active);
+    EXPECT_GT(result.changed_fraction, 0.0);
+    EXPECT_LT(result.changed_fraction, 0.1);
+    EXPECT_EQ(result.grid, video::FrameSize(20, 15));
+    EXPECT_EQ(result.frame_size, video::FrameSize(g_width, g_height));
+
+    ASSERT_EQ(result.regions.size(), 1);
+    const auto& region = result.regions.front();
+    EXPECT_LE(region.p0.x, object.p0.x);
+    EXPECT_LE(region.p0.y, object.p0.y);
+    EXPECT_GE(region.p1.x, object.p1.x);
+    EXPECT_GE(region.p1.y, object.p1.y);
+    EXPECT_LT(region.length() * region.height(), int(g_width * g_height) / 4);
+
+    // Объект остановился: области движения держатся deactivate_frames кадров
+    for (int i = 0; i < 2; ++i)
+    {
+        result = gate.process(moved);
+        EXPECT_FALSE(result.changed);
+        EXPECT_TRUE(result.active);
+        EXPECT_EQ(result.regions.size(), 1);
+    }
+
+    result = gate.process(moved);
+    EXPECT_FALSE(result.active);
+    EXPECT_TRUE(result.regions.empty());
+    EXPECT_TRUE(std::none_of(result.mask.cbegin(), result.mask.cend(), [](uint8_t value) { return value; }));
+}
+
+TEST(MotionGateTest, activation_needs_consecutive_changes)
+{
+    auto settings = make_settings();
+    settings.set_activate_frames(2);
+    MotionGate gate(settings);
+
+    gate.process(make_frame({}));
+    EXPECT_FALSE(gate.process(make_frame(Rect(100, 100, 140, 140))).active);
+    EXPECT_TRUE(gate.process(make_frame(Rect(120, 100, 160, 140))).active);
+}
+
+TEST(MotionGateTest, gated_detection)
+{
+    MotionGate gate(make_settings());
+
+    auto still = make_frame({});
+    gate.process(still);
+    const auto inactive = gate.process(still);
+
+    auto moved = make_frame(Rect(200, 120, 260, 180));
+    const auto active = gate.process(moved);
+
+    CountingDetector detector;
+    EXPECT_TRUE(detect_gated(detector, still, inactive, MotionGating::Skip).bboxes().empty());
+    EXPECT_TRUE(detect_gated(detector, still, inactive, MotionGating::Regions).bboxes().empty());
+    EXPECT_TRUE(detector.sizes.empty());
+
+    EXPECT_EQ(detect_gated(detector, still, inactive, MotionGating::None).bboxes().size(), 1);
+    EXPECT_EQ(detect_gated(detector, moved, std::nullopt, MotionGating::Regions).bboxes().size(), 1);
+    EXPECT_EQ(detect_gated(detector, moved, active, MotionGating::Skip).bboxes().size(), 1);
+    ASSERT_EQ(detector.sizes.size(), 3);
+    EXPECT_EQ(detector.sizes.back(), video::FrameSize(g_width, g_height));
+
+    // Детектор видит только область движения, результат в координатах кадра
+    const auto result = detect_gated(detector, moved, active, MotionGating::Regions);
+    ASSERT_EQ(detector.sizes.size(), 4);
+    ASSERT_EQ(result.bboxes().size(), 1);
+    EXPECT_EQ(result.bboxes().front(), active.regions.front());
+    EXPECT_LT(detector.sizes.back().width, g_width);
+    EXPECT_LT(detector.sizes.back().height, g_height);
+}
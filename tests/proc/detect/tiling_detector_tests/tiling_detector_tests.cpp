@@ -0,0 +1,322 @@
+#include <core/base/types/config_fields.hpp>
+
+#include <proc/detect/registrator.hpp>
+#include <proc/detect/tiling.hpp>
+#include <proc/effects/registrator.hpp>
+#include <proc/interfaces/face_engine_controller.hpp>
+#include <proc/settings/settings_empty.hpp>
+#include <proc/settings/settings_resizer.hpp>
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <climits>
+#include <thread>
+
+using namespace step;
+using namespace step::proc;
+
+namespace {
+
+/*! @brief Находит заданные объекты кадра в переданном тайле.
+    @details Положение тайла определяется по смещению его данных от данных кадра. Объект на границе тайла
+    обрезается, score - видимая доля объекта.
+*/
+class FakeDetector : public BaseDetector<SettingsEmpty>
+{
+public:
+    FakeDetector(const video::Frame& frame, const std::vector<Rect>& objects, std::atomic_int& calls)
+        : m_frame(frame), m_objects(objects), m_calls(calls)
+    {
+    }
+
+    DetectionResult process(video::Frame& tile)
+    {
+        ++m_calls;
+
+        const auto offset = static_cast<size_t>(tile.data() - m_frame.data());
+        const int tile_x = static_cast<int>(offset % m_frame.stride / (m_frame.bpp() / CHAR_BIT));
+        const int tile_y = static_cast<int>(offset / m_frame.stride);
+        const int tile_width = static_cast<int>(tile.size.width);
+        const int tile_height = static_cast<int>(tile.size.height);
+
+        std::vector<Rect> bboxes;
+        std::vector<double> scores;
+        for (const auto& object : m_objects)
+        {
+            const int x0 = std::max(object.p0.x, tile_x);
+            const int y0 = std::max(object.p0.y, tile_y);
+            const int x1 = std::min(object.p1.x, tile_x + tile_width);
+            const int y1 = std::min(object.p1.y, tile_y + tile_height);
+            if (x0 >= x1 || y0 >= y1)
+                continue;
+
+            bboxes.emplace_back(x0 - tile_x, y0 - tile_y, x1 - tile_x, y1 - tile_y);
+            scores.push_back(1.0 * (x1 - x0) * (y1 - y0) / (object.length() * object.height()));
+        }
+
+        MetaStorage storage;
+        storage.set_attachment(CFG_FLD::DETECTION_SCORES, std::move(scores));
+        return {std::move(bboxes), std::move(storage)};
+    }
+
+private:
+    const video::Frame& m_frame;
+    std::vector<Rect> m_objects;
+    std::atomic_int& m_calls;
+};
+
+/*! @brief Копирует тайл, как это делают внутренние детекторы.
+    @details PersonDetector уменьшает тайл EffectResizer, который делает глубокую копию кадра, детекторы лиц
+    копируют RGB кадр. Буфер view нижнего тайла кончается сразу после пикселей его последней строки.
+*/
+class CopyingDetector : public BaseDetector<SettingsEmpty>
+{
+public:
+    CopyingDetector(std::vector<Point2D>& last_pixels) : m_last_pixels(last_pixels)
+    {
+        auto resizer_settings = std::make_shared<SettingsResizer>();
+        resizer_settings->set_frame_size(video::FrameSize(64, 64));
+        resizer_settings->set_size_mode(SettingsResizer::SizeMode::Direct);
+        resizer_settings->set_interpolation(InterpolationType::Linear);
+        m_resizer = create_effect_resizer(resizer_settings);
+    }
+
+    DetectionResult process(video::Frame& tile)
+    {
+        const auto resized = m_resizer->process(tile);
+        EXPECT_EQ(resized.size, video::FrameSize(64, 64));
+
+        const video::Frame copy(tile);
+        EXPECT_EQ(copy, tile);
+
+        // Последний пиксель тайла хранит свое положение в кадре, см. fill_positions
+        const auto* last_pixel = copy.data() + copy.stride * (copy.size.height - 1) + copy.size.width * 3 - 3;
+        m_last_pixels.emplace_back(last_pixel[0], last_pixel[1]);
+        return {};
+    }
+
+private:
+    std::vector<Point2D>& m_last_pixels;
+    std::unique_ptr<IEffect> m_resizer;
+};
+
+/*! @brief Счетчики фиктивных face engine, общие для всех экземпляров.
+*/
+struct FaceEngineCalls
+{
+    std::atomic_int instances{0};
+    std::atomic_int overlaps{0};  // detect, вызванные, пока экземпляр занят другим потоком
+};
+
+/*! @brief Face engine без моделей, замечающий одновременные вызовы detect одного экземпляра.
+*/
+class FakeFaceEngine : public IFaceEngine
+{
+public:
+    FakeFaceEngine(FaceEngineCalls& calls) : m_calls(calls) { ++m_calls.instances; }
+
+    Faces detect(const video::Frame&) override
+    {
+        if (m_busy.exchange(true))
+            ++m_calls.overlaps;
+        std::this_thread::sleep_for(std::chrono::milliseconds(2));
+        m_busy = false;
+        return {};
+    }
+
+    void recognize(const FacePtr&) override {}
+    FaceMatchResult compare(const FacePtr&, const FacePtr&) override { return {}; }
+
+    std::shared_ptr<IFaceEngine> create_instance() const override
+    {
+        return std::make_shared<FakeFaceEngine>(m_calls);
+    }
+
+protected:
+    void calc_landmarks(const video::Frame&, const FacePtr&) override {}
+    double calc_match_probability(double) const noexcept override { return 0.0; }
+    bool load_models() override { return true; }
+
+private:
+    FaceEngineCalls& m_calls;
+    std::atomic_bool m_busy{false};
+};
+
+const std::string FAKE_FACE_ENGINE_CONN_ID = "tiling_detector_tests_face_engine";
+
+class FakeFaceEngineController : public IFaceEngineController
+{
+public:
+    FakeFaceEngineController() : IFaceEngineController(nullptr)
+    {
+        set_conn_id(FAKE_FACE_ENGINE_CONN_ID);
+        Connector::register_conn_source(this);
+    }
+};
+
+/*! @brief Детектор лиц, получающий face engine от контроллера по conn_id, как FaceDetector.
+*/
+class FaceEngineDetector : public BaseDetector<SettingsEmpty>, public IFaceEngineUser
+{
+public:
+    FaceEngineDetector()
+    {
+        set_conn_id(FAKE_FACE_ENGINE_CONN_ID);
+        Connector::connect(this);
+    }
+
+    DetectionResult process(video::Frame& tile)
+    {
+        get_face_engine()->detect(tile);
+        return {};
+    }
+};
+
+/*! @brief Пиксель BGR кадра хранит свои координаты по модулю 256: B - x, G - y.
+*/
+void fill_positions(video::Frame& frame)
+{
+    for (size_t y = 0; y < frame.size.height; ++y)
+    {
+        auto* row = frame.data() + y * frame.stride;
+        for (size_t x = 0; x < frame.size.width; ++x)
+        {
+            row[3 * x] = static_cast<uint8_t>(x);
+            row[3 * x + 1] = static_cast<uint8_t>(y);
+            row[3 * x + 2] = 0;
+        }
+    }
+}
+
+SettingsTilingDetector make_settings(size_t workers)
+{
+    SettingsTilingDetector settings;
+    settings.set_tile_size(video::FrameSize(640, 640));
+    settings.set_tile_overlap(0.25);
+    settings.set_tile_scales({1.0});
+    settings.set_full_frame(false);
+    settings.set_workers(workers);
+    settings.set_nms_threshold(0.5);
+    return settings;
+}
+
+}  // namespace
+
+TEST(TilingDetectorTest, tiles_cover_frame)
+{
+    const video::FrameSize frame_size(1920, 1080);
+    const auto tiles = make_detection_tiles(frame_size, video::FrameSize(640, 640), 0.25, {1.0}, false);
+
+    // x: 0, 480, 960, 1280; y: 0, 440
+    ASSERT_EQ(tiles.size(), 8);
+    for (const auto& tile : tiles)
+    {
+        EXPECT_EQ(tile.length(), 640);
+        EXPECT_EQ(tile.height(), 640);
+        EXPECT_GE(tile.p0.x, 0);
+        EXPECT_GE(tile.p0.y, 0);
+        EXPECT_LE(tile.p1.x, 1920);
+        EXPECT_LE(tile.p1.y, 1080);
+    }
+    EXPECT_EQ(tiles.back(), Rect(1280, 440, 1920, 1080));
+}
+
+TEST(TilingDetectorTest, tiles_scale_pyramid)
+{
+    const video::FrameSize frame_size(1920, 1080);
+    const auto tiles = make_detection_tiles(frame_size, video::FrameSize(640, 640), 0.25, {1.0, 0.5}, true);
+
+    // Весь кадр, 8 тайлов масштаба 1 и 2 тайла 1280x1080 масштаба 0.5
+    ASSERT_EQ(tiles.size(), 11);
+    EXPECT_EQ(tiles.front(), Rect(0, 0, 1920, 1080));
+    EXPECT_EQ(tiles[9], Rect(0, 0, 1280, 1080));
+    EXPECT_EQ(tiles[10], Rect(640, 0, 1920, 1080));
+}
+
+TEST(TilingDetectorTest, suppress_truncated_duplicates)
+{
+    // Полный объект, его обрезанная границей тайла часть и отдельный объект рядом
+    const std::vector<Rect> bboxes = {Rect(100, 100, 120, 140), Rect(100, 100, 140, 140), Rect(150, 100, 190, 140)};
+    const std::vector<double> scores = {0.5, 1.0, 0.9};
+
+    const auto kept = suppress_tile_duplicates(bboxes, scores, 0.5);
+    EXPECT_EQ(kept, std::vector<size_t>({1, 2}));
+}
+
+TEST(TilingDetectorTest, merge_objects_across_tiles)
+{
+    video::Frame frame(video::FrameSize(1920, 1080), video::PixFmt::BGR);
+
+    // Первый объект целиком в зоне перекрытия тайлов, второй пересекает границу тайла
+    const std::vector<Rect> objects = {Rect(500, 450, 540, 490), Rect(620, 100, 660, 140)};
+
+    for (const size_t workers : {1, 3})
+    {
+        std::atomic_int calls{0};
+        auto detector = create_tiling_detector_with(make_settings(workers), [&]() -> DetectorPtr {
+            return std::make_unique<FakeDetector>(frame, objects, calls);
+        });
+
+        auto result = detector->process(frame);
+
+        EXPECT_EQ(calls, 8);
+        ASSERT_EQ(result.bboxes().size(), objects.size());
+        EXPECT_EQ(result.bboxes()[0], objects[0]);
+        EXPECT_EQ(result.bboxes()[1], objects[1]);
+
+        const auto scores = result.data().get_attachment<std::vector<double>>(CFG_FLD::DETECTION_SCORES);
+        ASSERT_TRUE(scores.has_value());
+        EXPECT_EQ(*scores, std::vector<double>({1.0, 1.0}));
+    }
+}
+
+TEST(TilingDetectorTest, tile_copies_stay_in_frame_buffer)
+{
+    // Под ASan: буфер кадра ровно stride * height, нижние тайлы начинаются не с начала строки
+    video::Frame frame(video::FrameSize(1000, 700), video::PixFmt::BGR);
+    fill_positions(frame);
+
+    std::vector<Point2D> last_pixels;
+    auto detector = create_tiling_detector_with(make_settings(1), [&last_pixels]() -> DetectorPtr {
+        return std::make_unique<CopyingDetector>(last_pixels);
+    });
+    detector->process(frame);
+
+    // x: 0, 360; y: 0, 60
+    ASSERT_EQ(last_pixels.size(), 4);
+    EXPECT_EQ(last_pixels.back(), Point2D(999 % 256, 699 % 256));
+
+    // Область движения у правого нижнего угла
+    last_pixels.clear();
+    CopyingDetector region_detector(last_pixels);
+    detect_in_region(region_detector, frame, Rect(990, 650, 1000, 700));
+    ASSERT_EQ(last_pixels.size(), 1);
+    EXPECT_EQ(last_pixels.back(), Point2D(999 % 256, 699 % 256));
+}
+
+TEST(TilingDetectorTest, face_engine_workers_use_own_instances)
+{
+    FaceEngineCalls calls;
+    FakeFaceEngineController controller;
+    controller.set_face_engine(std::make_shared<FakeFaceEngine>(calls));
+
+    // 8 тайлов на 4 потока
+    video::Frame frame(video::FrameSize(1920, 1080), video::PixFmt::BGR);
+    auto detector = create_tiling_detector_with(make_settings(4), []() -> DetectorPtr {
+        return std::make_unique<FaceEngineDetector>();
+    });
+    for (int i = 0; i < 3; ++i)
+        detector->process(frame);
+
+    EXPECT_EQ(calls.overlaps, 0);
+    EXPECT_EQ(calls.instances, 4);
+
+    // Переназначение движка контроллером не возвращает потокам общий экземпляр
+    controller.set_face_engine(std::make_shared<FakeFaceEngine>(calls));
+    detector->process(frame);
+
+    EXPECT_EQ(calls.overlaps, 0);
+    EXPECT_EQ(calls.instances, 5);
+}
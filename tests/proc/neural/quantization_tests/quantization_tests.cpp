@@ -0,0 +1,286 @@
+#include <core/log/log.hpp>
+#include <core/base/json/json_utils.hpp>
+#include <core/base/types/config_fields.hpp>
+#include <core/base/utils/string_utils.hpp>
+#include <core/task/settings_factory.hpp>
+#include <core/task/task_factory.hpp>
+
+#include <video/frame/utils/frame_utils.hpp>
+
+#include <proc/detect/registrator.hpp>
+#include <proc/face_engine/face_engine_factory.hpp>
+#include <proc/neural/validation/model_validation.hpp>
+
+#include <application/registrator.hpp>
+
+#include <gtest/gtest.h>
+
+#include <filesystem>
+
+using namespace step;
+using namespace step::proc;
+
+struct TestDataProvider
+{
+    static std::filesystem::path test_data_dir()
+    {
+#ifndef QUANTIZATION_TESTS_DATA_DIR
+#error "QUANTIZATION_TESTS_DATA_DIR must be defined and point to valid testdata folder"
+#endif
+        std::filesystem::path path(QUANTIZATION_TESTS_DATA_DIR);
+        assert(std::filesystem::is_directory(path));
+        return path;
+    }
+
+    static std::string dataset_path() { return test_data_dir().append("quantization_dataset.json").string(); }
+};
+
+namespace {
+
+struct LabelledImage
+{
+    video::Frame frame;
+    std::vector<Rect> persons;
+    std::vector<Rect> faces;
+};
+
+std::vector<Rect> read_rects(const ObjectPtrJSON& container, const std::string& key)
+{
+    std::vector<Rect> rects;
+    auto rects_json = json::opt_array(container, key);
+    if (!rects_json)
+        return rects;
+
+    json::for_each_in_array<ObjectPtrJSON>(rects_json, [&rects](const ObjectPtrJSON& rect_json) {
+        Rect rect;
+        rect.deserialize(rect_json);
+        rects.push_back(rect);
+    });
+    return rects;
+}
+
+template <typename TFunc>
+Microseconds measure(TFunc&& func)
+{
+    const auto start = get_current_time<Microseconds>();
+    func();
+    return get_current_time<Microseconds>() - start;
+}
+
+}  // namespace
+
+class QuantizationTest : public ::testing::Test
+{
+protected:
+    void SetUp()
+    {
+        step::app::Registrator::instance();
+
+        m_dataset = json::utils::from_file(TestDataProvider::dataset_path());
+        m_iterations = json::get<int>(m_dataset, "latency_iterations", 20);
+        m_iou_threshold = json::get<double>(m_dataset, "iou_threshold", 0.5);
+
+        json::for_each_in_array<ObjectPtrJSON>(json::get_array(m_dataset, "images"), [this](const ObjectPtrJSON& cfg) {
+            LabelledImage image;
+            image.frame = video::utils::open_file(
+                TestDataProvider::test_data_dir().append(json::get<std::string>(cfg, CFG_FLD::FILENAME)));
+            image.persons = read_rects(cfg, "persons");
+            image.faces = read_rects(cfg, "faces");
+            m_images.push_back(std::move(image));
+        });
+    }
+
+    ObjectPtrJSON person_detector_cfg(ModelPrecision precision) const
+    {
+        // Каждый вариант получает собственную копию конфига
+        auto cfg = json::utils::from_file(TestDataProvider::dataset_path());
+        auto detector_cfg = json::get_object(cfg, "person_detector");
+        auto net_cfg = json::get_object(detector_cfg, CFG_FLD::NEURAL_NET_SETTINGS);
+        json::set(net_cfg, CFG_FLD::PRECISION, step::utils::to_string(precision));
+        return detector_cfg;
+    }
+
+    IFaceEngine::Initializer face_engine_init(ModelPrecision precision) const
+    {
+        IFaceEngine::Initializer init;
+        init.deserialize(json::get_object(m_dataset, CFG_FLD::FACE_ENGINE_INIT));
+        init.precision = precision;
+        return init;
+    }
+
+protected:
+    ObjectPtrJSON m_dataset;
+    std::vector<LabelledImage> m_images;
+    int m_iterations{20};
+    double m_iou_threshold{0.5};
+};
+
+TEST(QuantizationMetricsTest, iou)
+{
+    EXPECT_DOUBLE_EQ(calc_iou(Rect(0, 0, 10, 10), Rect(0, 0, 10, 10)), 1.0);
+    EXPECT_DOUBLE_EQ(calc_iou(Rect(0, 0, 10, 10), Rect(20, 20, 30, 30)), 0.0);
+    EXPECT_NEAR(calc_iou(Rect(0, 0, 10, 10), Rect(5, 0, 15, 10)), 1.0 / 3.0, 1e-9);
+}
+
+TEST(QuantizationMetricsTest, average_precision)
+{
+    DetectionSample perfect{{Rect(0, 0, 10, 10)}, {Rect(0, 0, 10, 10)}, {0.9}};
+    EXPECT_DOUBLE_EQ(calc_average_precision({perfect}), 1.0);
+
+    DetectionSample missed{{Rect(0, 0, 10, 10), Rect(50, 50, 60, 60)}, {Rect(0, 0, 10, 10)}, {}};
+    EXPECT_DOUBLE_EQ(calc_average_precision({missed}), 0.5);
+
+    // ложное срабатывание с большей уверенностью снижает precision на первом пороге
+    DetectionSample false_first{{Rect(0, 0, 10, 10)}, {Rect(100, 100, 110, 110), Rect(0, 0, 10, 10)}, {0.9, 0.8}};
+    EXPECT_DOUBLE_EQ(calc_average_precision({false_first}), 0.5);
+
+    EXPECT_DOUBLE_EQ(calc_average_precision({}), 1.0);
+}
+
+TEST(QuantizationMetricsTest, cosine_similarity)
+{
+    EXPECT_NEAR(calc_cosine_similarity({1.f, 2.f, 3.f}, {2.f, 4.f, 6.f}), 1.0, 1e-9);
+    EXPECT_NEAR(calc_cosine_similarity({1.f, 0.f}, {0.f, 1.f}), 0.0, 1e-9);
+    EXPECT_ANY_THROW(calc_cosine_similarity({1.f}, {1.f, 2.f}));
+}
+
+TEST(QuantizationMetricsTest, latency_stats)
+{
+    std::vector<Microseconds> samples;
+    for (int i = 1; i <= 100; ++i)
+        samples.emplace_back(i);
+
+    const auto stats = calc_latency_stats(samples);
+    EXPECT_EQ(stats.count, 100);
+    EXPECT_EQ(stats.min, Microseconds(1));
+    EXPECT_EQ(stats.max, Microseconds(100));
+    EXPECT_EQ(stats.p50, Microseconds(50));
+    EXPECT_EQ(stats.p95, Microseconds(95));
+    EXPECT_EQ(stats.mean, Microseconds(50));
+}
+
+TEST_F(QuantizationTest, person_detector_fp32_vs_int8)
+{
+    auto fp32_cfg = person_detector_cfg(ModelPrecision::FP32);
+    auto int8_cfg = person_detector_cfg(ModelPrecision::INT8);
+
+    const auto fp32_model = json::get<std::string>(json::get_object(fp32_cfg, CFG_FLD::NEURAL_NET_SETTINGS),
+                                                   CFG_FLD::MODEL_PATH);
+    if (!std::filesystem::is_regular_file(make_int8_model_path(fp32_model)))
+        GTEST_SKIP() << "No INT8 variant for " << fp32_model;
+
+    const auto run = [this](const ObjectPtrJSON& cfg, double& map, LatencyStats& latency) {
+        auto detector = IDetector::from_abstract(CREATE_TASK_UNIQUE(CREATE_SETTINGS(cfg)));
+
+        std::vector<DetectionSample> samples;
+        std::vector<Microseconds> times;
+        for (auto& image : m_images)
+        {
+            DetectionResult result;
+            for (int i = 0; i < m_iterations; ++i)
+                times.push_back(measure([&]() { result = detector->process(image.frame); }));
+
+            DetectionSample sample;
+            sample.groundtruth = image.persons;
+            sample.detections = result.bboxes();
+            sample.scores = result.data().get_attachment<std::vector<double>>(CFG_FLD::DETECTION_SCORES).value_or(
+                std::vector<double>());
+            samples.push_back(std::move(sample));
+        }
+
+        map = calc_average_precision(samples, m_iou_threshold);
+        latency = calc_latency_stats(std::move(times));
+    };
+
+    QuantizationReport report;
+    ASSERT_NO_THROW(run(fp32_cfg, report.fp32_map, report.fp32_latency));
+    ASSERT_NO_THROW(run(int8_cfg, report.int8_map, report.int8_latency));
+
+    STEP_LOG(L_INFO, "Person detector quantization report: {}", report);
+    EXPECT_GT(report.map_delta(), -0.05);
+}
+
+TEST_F(QuantizationTest, face_engine_fp32_vs_int8)
+{
+    auto fp32_init = face_engine_init(ModelPrecision::FP32);
+    if (!std::filesystem::is_directory(fp32_init.models_path) ||
+        !std::filesystem::is_regular_file(make_int8_model_path(fp32_init.models_path / "recognizer.onnx")))
+        GTEST_SKIP() << "No INT8 face models in " << fp32_init.models_path.string();
+
+    struct EngineRun
+    {
+        double map{0.0};
+        LatencyStats latency;
+        std::vector<FaceRecognizerData> embeddings;  // по лучшему лицу каждого изображения
+    };
+
+    const auto run = [this](IFaceEngine::Initializer&& init) {
+        EngineRun engine_run;
+        auto engine = create_face_engine(std::move(init));
+
+        std::vector<DetectionSample> samples;
+        std::vector<Microseconds> times;
+        for (auto& image : m_images)
+        {
+            Faces faces;
+            for (int i = 0; i < m_iterations; ++i)
+            {
+                times.push_back(measure([&]() {
+                    faces = engine->detect(image.frame);
+                    for (const auto& face : faces)
+                        engine->recognize(face);
+                }));
+            }
+
+            DetectionSample sample;
+            sample.groundtruth = image.faces;
+            for (const auto& face : faces)
+            {
+                sample.detections.push_back(face->get_rect());
+                sample.scores.push_back(face->get_confidence());
+            }
+            samples.push_back(std::move(sample));
+
+            auto best = std::max_element(faces.cbegin(), faces.cend(), [](const auto& lhs, const auto& rhs) {
+                return lhs->get_confidence() < rhs->get_confidence();
+            });
+            engine_run.embeddings.push_back(best != faces.cend() ? (*best)->get_recognizer_data()
+                                                                 : FaceRecognizerData());
+        }
+
+        engine_run.map = calc_average_precision(samples, m_iou_threshold);
+        engine_run.latency = calc_latency_stats(std::move(times));
+        return engine_run;
+    };
+
+    EngineRun fp32_run, int8_run;
+    ASSERT_NO_THROW(fp32_run = run(face_engine_init(ModelPrecision::FP32)));
+    ASSERT_NO_THROW(int8_run = run(face_engine_init(ModelPrecision::INT8)));
+
+    QuantizationReport report;
+    report.fp32_map = fp32_run.map;
+    report.int8_map = int8_run.map;
+    report.fp32_latency = fp32_run.latency;
+    report.int8_latency = int8_run.latency;
+
+    double similarity_sum = 0.0;
+    size_t similarity_count = 0;
+    for (size_t i = 0; i < m_images.size(); ++i)
+    {
+        const auto& fp32_embedding = fp32_run.embeddings[i];
+        const auto& int8_embedding = int8_run.embeddings[i];
+        if (fp32_embedding.empty() || fp32_embedding.size() != int8_embedding.size())
+            continue;
+
+        const auto similarity = calc_cosine_similarity(fp32_embedding, int8_embedding);
+        report.min_cosine_similarity = std::min(report.min_cosine_similarity, similarity);
+        similarity_sum += similarity;
+        ++similarity_count;
+    }
+    if (similarity_count)
+        report.mean_cosine_similarity = similarity_sum / similarity_count;
+
+    STEP_LOG(L_INFO, "Face engine quantization report: {}", report);
+    EXPECT_GT(report.map_delta(), -0.05);
+    EXPECT_GT(report.mean_cosine_similarity, 0.95);
+}
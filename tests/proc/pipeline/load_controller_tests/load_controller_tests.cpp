@@ -0,0 +1,187 @@
+#include <proc/pipeline/load_controller.hpp>
+#include <proc/pipeline/pipeline_settings.hpp>
+
+#include <core/base/json/json_utils.hpp>
+#include <core/base/types/config_fields.hpp>
+
+#include <gtest/gtest.h>
+
+using namespace step;
+using namespace step::proc;
+
+namespace {
+
+LoadControlSettings make_settings()
+{
+    LoadControlSettings settings;
+    settings.latency_target = Milliseconds(100);
+    settings.queue_target = 0.75;
+    settings.recover_ratio = 0.5;
+    settings.degrade_samples = 2;
+    settings.recover_samples = 3;
+    settings.low_priority = 1.0;
+    return settings;
+}
+
+LoadSample make_sample(Microseconds latency, uint64_t dropped = 0, double queue_fill = 0.0)
+{
+    LoadSample sample;
+    sample.stage = "branch";
+    sample.stage_latency = latency;
+    sample.queue_fill = queue_fill;
+    sample.dropped = dropped;
+    return sample;
+}
+
+}  // namespace
+
+TEST(LoadControllerTest, degrade_and_recover_with_hysteresis)
+{
+    LoadController controller(make_settings(), "test");
+    const auto overloaded = make_sample(Milliseconds(150));
+    const auto moderate = make_sample(Milliseconds(70));
+    const auto relaxed = make_sample(Milliseconds(20));
+
+    // Одиночный всплеск не меняет ступень
+    EXPECT_FALSE(controller.update(overloaded));
+    EXPECT_FALSE(controller.update(relaxed));
+    EXPECT_EQ(controller.get_level(), 0);
+
+    EXPECT_FALSE(controller.update(overloaded));
+    EXPECT_TRUE(controller.update(overloaded));
+    EXPECT_EQ(controller.get_level(), 1);
+
+    // Потери кадров и переполнение очередей - тоже перегрузка
+    EXPECT_FALSE(controller.update(make_sample(Milliseconds(20), 3)));
+    EXPECT_TRUE(controller.update(make_sample(Milliseconds(20), 0, 1.0)));
+    EXPECT_EQ(controller.get_level(), 2);
+
+    // Между порогами ступень держится
+    for (int i = 0; i < 10; ++i)
+        EXPECT_FALSE(controller.update(moderate));
+    EXPECT_EQ(controller.get_level(), 2);
+
+    EXPECT_FALSE(controller.update(relaxed));
+    EXPECT_FALSE(controller.update(relaxed));
+    EXPECT_TRUE(controller.update(relaxed));
+    EXPECT_EQ(controller.get_level(), 1);
+}
+
+TEST(LoadControllerTest, level_is_bounded)
+{
+    LoadController controller(make_settings(), "test");
+    const auto levels = controller.get_settings().levels.size();
+
+    for (int i = 0; i < 20; ++i)
+        controller.update(make_sample(Seconds(1)));
+    EXPECT_EQ(controller.get_level(), levels - 1);
+
+    for (int i = 0; i < 40; ++i)
+        controller.update(make_sample(Microseconds(0)));
+    EXPECT_EQ(controller.get_level(), 0);
+}
+
+TEST(LoadControllerTest, shedding_follows_level)
+{
+    auto settings = make_settings();
+    settings.degrade_samples = 1;
+    settings.levels.resize(2);
+    settings.levels[1].resize_scale = 0.5;
+    settings.levels[1].detect_interval = 3;
+    settings.levels[1].skip_recognition = true;
+    LoadController controller(settings, "test");
+
+    uint64_t counter = 0;
+    auto shedding = controller.get_shedding(0.5, counter);
+    EXPECT_EQ(shedding.level, 0);
+    EXPECT_EQ(shedding.resize_scale, 1.0);
+    EXPECT_FALSE(shedding.skip_detection);
+    EXPECT_FALSE(shedding.skip_recognition);
+
+    controller.update(make_sample(Seconds(1)));
+    ASSERT_EQ(controller.get_level(), 1);
+
+    counter = 0;
+    std::vector<bool> skipped;
+    for (int i = 0; i < 6; ++i)
+        skipped.push_back(controller.get_shedding(1.0, counter).skip_detection);
+    EXPECT_EQ(skipped, std::vector<bool>({false, true, true, false, true, true}));
+
+    // Распознавание отключается только у потоков с приоритетом ниже low_priority
+    EXPECT_TRUE(controller.get_shedding(0.5, counter).skip_recognition);
+    EXPECT_FALSE(controller.get_shedding(1.0, counter).skip_recognition);
+    EXPECT_EQ(controller.get_shedding(1.0, counter).resize_scale, 0.5);
+}
+
+TEST(LoadControllerTest, pipeline_priority_controls_recognition_shedding)
+{
+    auto load_control_cfg = json::make_object_json_ptr();
+    json::set(load_control_cfg, CFG_FLD::LOW_PRIORITY, 1.0);
+    json::set(load_control_cfg, CFG_FLD::DEGRADE_SAMPLES, 1);
+
+    auto pipeline_cfg = json::make_object_json_ptr();
+    json::set(pipeline_cfg, CFG_FLD::NAME, std::string("test"));
+    json::set(pipeline_cfg, CFG_FLD::SYNC_MODE, std::string("sync"));
+    json::set(pipeline_cfg, CFG_FLD::LOAD_CONTROL, load_control_cfg);
+
+    // Без priority пайплайн не считается низкоприоритетным
+    PipelineSettings settings(pipeline_cfg);
+    ASSERT_TRUE(settings.load_control.has_value());
+    EXPECT_EQ(settings.priority, 1.0);
+
+    json::set(pipeline_cfg, CFG_FLD::STREAM_PRIORITY, 0.5);
+    PipelineSettings low_priority_settings(pipeline_cfg);
+    EXPECT_EQ(low_priority_settings.priority, 0.5);
+
+    // Ступень по умолчанию 2 отключает распознавание у низкоприоритетных потоков
+    LoadController controller(*low_priority_settings.load_control, "test");
+    controller.update(make_sample(Seconds(1)));
+    controller.update(make_sample(Seconds(1)));
+    ASSERT_EQ(controller.get_level(), 2);
+
+    uint64_t counter = 0;
+    EXPECT_TRUE(controller.get_shedding(low_priority_settings.priority, counter).skip_recognition);
+    EXPECT_FALSE(controller.get_shedding(settings.priority, counter).skip_recognition);
+}
+
+TEST(LoadControllerTest, sample_from_profilers)
+{
+    LoadController controller(make_settings(), "test");
+
+    auto profilers = std::vector<PipelineProfilerPtr>{std::make_shared<PipelineProfiler>("first"),
+                                                      std::make_shared<PipelineProfiler>("second")};
+    auto* fast = profilers[0]->register_branch("fast");
+    auto* slow_first = profilers[0]->register_branch("slow");
+    auto* slow_second = profilers[1]->register_branch("slow");
+
+    const auto start = PipelineProfiler::Clock::now();
+    auto record = [&start](PipelineProfiler& profiler, PipelineNodeStats* stats, Milliseconds duration) {
+        profiler.record_execution(stats, start, start + duration);
+    };
+
+    record(*profilers[0], fast, Milliseconds(100));
+    auto sample = controller.make_sample(profilers, 0.0, 0, start);
+    EXPECT_EQ(sample.stage, "fast");
+    EXPECT_EQ(sample.stage_latency, Milliseconds(100));
+
+    // Следующий замер видит только новые данные; одноименные ветви разных пайплайнов - один этап
+    record(*profilers[0], fast, Milliseconds(10));
+    record(*profilers[0], slow_first, Milliseconds(20));
+    record(*profilers[1], slow_second, Milliseconds(40));
+    profilers[1]->record_queue_wait(slow_second, start, start + Milliseconds(10));
+    profilers[1]->record_drop(slow_second);
+
+    EXPECT_FALSE(controller.need_sample(start + Milliseconds(100)));
+    EXPECT_TRUE(controller.need_sample(start + Milliseconds(500)));
+
+    sample = controller.make_sample(profilers, 0.5, 2, start + Milliseconds(500));
+    EXPECT_EQ(sample.stage, "slow");
+    EXPECT_EQ(sample.stage_latency, Milliseconds(35));
+    EXPECT_EQ(sample.queue_fill, 0.5);
+    EXPECT_EQ(sample.dropped, 3);
+
+    sample = controller.make_sample(profilers, 0.0, 2, start + Milliseconds(1000));
+    EXPECT_TRUE(sample.stage.empty());
+    EXPECT_EQ(sample.stage_latency, Microseconds(0));
+    EXPECT_EQ(sample.dropped, 0);
+}
@@ -2,6 +2,9 @@
 #include <core/threading/thread_pool_execute_policy.hpp>
 #include <core/base/json/json_utils.hpp>
 
+#include <core/task/settings_factory.hpp>
+#include <core/task/task_factory.hpp>
+
 #include <proc/pipeline/impl/frame_pipeline.hpp>
 
 #include <application/registrator.hpp>
@@ -12,6 +15,9 @@
 
 #include <atomic>
 #include <filesystem>
+#include <mutex>
+#include <thread>
+#include <vector>
 
 using namespace step;
 using namespace step::video;
@@ -62,6 +68,62 @@ private:
     step::EventHandlerList<video::IFrameSourceObserver, step::threading::ThreadPoolExecutePolicy<0>> m_frame_observers;
 };
 
+// Пишет во вложение "result" свое значение, с write_shared - еще и во вложение "shared"
+class AttachmentWriterNodeSettings : public task::BaseSettings
+{
+public:
+    TASK_SETTINGS(AttachmentWriterNodeSettings)
+
+    AttachmentWriterNodeSettings() = default;
+
+    bool operator==(const AttachmentWriterNodeSettings& rhs) const noexcept { return false; }
+    bool operator!=(const AttachmentWriterNodeSettings& rhs) const noexcept { return !(*this == rhs); }
+
+    std::string value;
+    bool write_shared{false};
+};
+
+const std::string AttachmentWriterNodeSettings::SETTINGS_ID = "AttachmentWriterNodeSettings";
+
+void AttachmentWriterNodeSettings::deserialize(const ObjectPtrJSON& cfg)
+{
+    value = json::get<std::string>(cfg, "value");
+    write_shared = json::get<bool>(cfg, "write_shared", false);
+}
+
+class AttachmentWriterNode : public PipelineNodeTask<Frame, AttachmentWriterNodeSettings>
+{
+public:
+    AttachmentWriterNode(const AttachmentWriterNodeSettings& settings) : m_settings(settings) {}
+
+    void process(PipelineDataPtr<Frame> data) override
+    {
+        data->storage.set_attachment("result", std::string(m_settings.value));
+        if (m_settings.write_shared)
+            data->storage.set_attachment("shared", std::string(m_settings.value));
+    }
+
+private:
+    AttachmentWriterNodeSettings m_settings;
+};
+
+void register_attachment_writer_node()
+{
+    static std::once_flag once;
+    std::call_once(once, []() {
+        REGISTER_TASK_SETTINGS_CREATOR(AttachmentWriterNodeSettings::SETTINGS_ID, [](const ObjectPtrJSON& cfg) {
+            return std::shared_ptr<task::BaseSettings>(std::make_shared<AttachmentWriterNodeSettings>(cfg));
+        });
+        REGISTER_TASK_CREATOR_UNIQUE(AttachmentWriterNodeSettings::SETTINGS_ID,
+                                     [](const std::shared_ptr<task::BaseSettings>& settings) {
+                                         const auto& typed_settings =
+                                             dynamic_cast<const AttachmentWriterNodeSettings&>(*settings);
+                                         return std::unique_ptr<task::IAbstractTask>(
+                                             std::make_unique<AttachmentWriterNode>(typed_settings));
+                                     });
+    });
+}
+
 class PipelineTest : public ::testing::Test
 {
 public:
@@ -129,4 +191,128 @@ TEST_F(PipelineTest, multi_branch_pipeline_multiple_run)
         EXPECT_NO_THROW(source.create_and_process_frame());
         counter++;
     }
-}
\ No newline at end of file
+}
+
+TEST_F(PipelineTest, multi_branch_pipeline_execution_plan)
+{
+    const auto filename = "multi_branch_pipeline.json";
+    auto entry_path = TestDataProvider::test_data_dir().append(filename);
+    auto pipeline_cfg = TestDataProvider::open_pipeline_config(entry_path.string());
+
+    ASSERT_NO_THROW(m_pipeline = FrameAsyncPipeline::create(pipeline_cfg));
+
+    // Ветви пронумерованы топологически: корень первый, потомки всегда после родителя
+    const auto& plan = m_pipeline->get_execution_plan();
+    ASSERT_GT(plan.size(), 1);
+    EXPECT_EQ(plan.get_root_index(), 0);
+    EXPECT_EQ(plan.get_id(plan.get_root_index()), m_pipeline->get_root_id());
+    EXPECT_EQ(plan.get_dependency_counts()[plan.get_root_index()], 0);
+
+    for (PipelineExecutionPlan::IndexType index = 0; index < plan.size(); ++index)
+    {
+        EXPECT_EQ(plan.index_of(plan.get_id(index)), index);
+        EXPECT_TRUE(plan.is_reachable(index));
+        for (const auto child_index : plan.get_children(index))
+        {
+            EXPECT_GT(child_index, index);
+            EXPECT_EQ(plan.get_dependency_counts()[child_index], 1);
+        }
+    }
+}
+
+TEST_F(PipelineTest, multi_branch_sync_pipeline_fork_join)
+{
+    const auto filename = "multi_branch_fork_join_pipeline.json";
+    auto entry_path = TestDataProvider::test_data_dir().append(filename);
+    auto pipeline_cfg = TestDataProvider::open_pipeline_config(entry_path.string());
+
+    std::unique_ptr<FrameSyncPipeline> pipeline;
+    ASSERT_NO_THROW(pipeline = FrameSyncPipeline::create(pipeline_cfg));
+    ASSERT_TRUE(pipeline->get_execution_plan().has_forks());
+
+    constexpr size_t frames_count = 50;
+    for (size_t i = 0; i < frames_count; ++i)
+        EXPECT_NO_THROW(pipeline->process(PipelineData<Frame>::create(Frame())));
+
+    // Каждая ветвь отработала на каждом кадре, ничего не потеряно при параллельном выполнении
+    for (const auto& branch_stats : pipeline->get_profiler()->get_branches_snapshot())
+    {
+        EXPECT_EQ(branch_stats.processed, frames_count) << branch_stats.id;
+        EXPECT_EQ(branch_stats.exceptions, 0) << branch_stats.id;
+    }
+}
+
+TEST_F(PipelineTest, multi_branch_sync_pipeline_concurrent_process)
+{
+    // Состояние обработки кадра локальное: один экземпляр могут вызывать несколько потоков
+    const auto filename = "multi_branch_fork_join_pipeline.json";
+    auto entry_path = TestDataProvider::test_data_dir().append(filename);
+    auto pipeline_cfg = TestDataProvider::open_pipeline_config(entry_path.string());
+
+    std::unique_ptr<FrameSyncPipeline> pipeline;
+    ASSERT_NO_THROW(pipeline = FrameSyncPipeline::create(pipeline_cfg));
+
+    constexpr size_t threads_count = 4;
+    constexpr size_t frames_count = 25;
+    std::atomic<size_t> exceptions{0};
+    std::vector<std::thread> threads;
+    for (size_t t = 0; t < threads_count; ++t)
+    {
+        threads.emplace_back([&pipeline, &exceptions]() {
+            for (size_t i = 0; i < frames_count; ++i)
+            {
+                try
+                {
+                    pipeline->process(PipelineData<Frame>::create(Frame()));
+                }
+                catch (...)
+                {
+                    ++exceptions;
+                }
+            }
+        });
+    }
+    for (auto& thread : threads)
+        thread.join();
+
+    EXPECT_EQ(exceptions, 0);
+    for (const auto& branch_stats : pipeline->get_profiler()->get_branches_snapshot())
+        EXPECT_EQ(branch_stats.processed, threads_count * frames_count) << branch_stats.id;
+}
+
+TEST_F(PipelineTest, multi_branch_sync_pipeline_fork_join_attachments)
+{
+    // writer_2 - сосед writer_1, writer_3 - потомок writer_1: оба пишут "shared". Итог fork-join
+    // должен совпадать с последовательным выполнением независимо от планирования потоков
+    register_attachment_writer_node();
+
+    const auto filename = "multi_branch_attachments_pipeline.json";
+    auto entry_path = TestDataProvider::test_data_dir().append(filename);
+
+    const auto process_frame = [&entry_path](bool fork_join, size_t frames_count) {
+        auto pipeline_cfg = TestDataProvider::open_pipeline_config(entry_path.string());
+        auto settings_cfg = json::get_object(pipeline_cfg, CFG_FLD::SETTINGS);
+        json::set(settings_cfg, CFG_FLD::FORK_JOIN, fork_join);
+
+        auto pipeline = FrameSyncPipeline::create(pipeline_cfg);
+        std::vector<std::pair<std::string, std::string>> results;
+        for (size_t i = 0; i < frames_count; ++i)
+        {
+            auto data = PipelineData<Frame>::create(Frame());
+            pipeline->process(data);
+            results.emplace_back(data->storage.get_attachment<std::string>("result").value_or(""),
+                                 data->storage.get_attachment<std::string>("shared").value_or(""));
+        }
+        return results;
+    };
+
+    const auto expected = process_frame(false, 1).front();
+    ASSERT_FALSE(expected.first.empty());
+    ASSERT_FALSE(expected.second.empty());
+
+    for (const auto& result : process_frame(true, 50))
+    {
+        EXPECT_EQ(result.first, expected.first);
+        EXPECT_EQ(result.second, expected.second);
+    }
+}
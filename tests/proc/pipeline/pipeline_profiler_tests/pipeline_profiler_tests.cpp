@@ -0,0 +1,158 @@
+#include <proc/pipeline/pipeline_profiler.hpp>
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <fstream>
+#include <sstream>
+
+using namespace step;
+using namespace step::proc;
+
+namespace {
+
+size_t count_substr(const std::string& str, const std::string& substr)
+{
+    size_t count = 0;
+    for (auto pos = str.find(substr); pos != std::string::npos; pos = str.find(substr, pos + substr.size()))
+        ++count;
+    return count;
+}
+
+}  // namespace
+
+TEST(PipelineProfilerTest, histogram_small_values_are_exact)
+{
+    LatencyHistogram histogram;
+    EXPECT_EQ(histogram.percentile(0.5), Microseconds(0));
+    EXPECT_EQ(histogram.mean(), Microseconds(0));
+
+    for (int i = 0; i < 16; ++i)
+        histogram.record(Microseconds(i));
+
+    EXPECT_EQ(histogram.count(), 16);
+    EXPECT_EQ(histogram.total(), Microseconds(120));
+    EXPECT_EQ(histogram.max(), Microseconds(15));
+    EXPECT_EQ(histogram.percentile(0.0), Microseconds(0));
+    EXPECT_EQ(histogram.percentile(0.5), Microseconds(7));
+    EXPECT_EQ(histogram.percentile(1.0), Microseconds(15));
+
+    // Отрицательная длительность (скачок часов) считается нулевой
+    histogram.record(Microseconds(-5));
+    EXPECT_EQ(histogram.count(), 17);
+    EXPECT_EQ(histogram.total(), Microseconds(120));
+}
+
+TEST(PipelineProfilerTest, histogram_percentiles_relative_error)
+{
+    LatencyHistogram histogram;
+    for (int i = 1; i <= 100'000; ++i)
+        histogram.record(Microseconds(i));
+
+    for (const auto p : {0.5, 0.9, 0.95, 0.99})
+    {
+        const double expected = p * 100'000;
+        const double actual = static_cast<double>(histogram.percentile(p).count());
+        EXPECT_LE(std::abs(actual - expected) / expected, 1.0 / 16) << "p = " << p;
+    }
+
+    // Перцентиль не больше максимума даже для середины последнего бакета
+    EXPECT_EQ(histogram.percentile(1.0), Microseconds(100'000));
+    EXPECT_EQ(histogram.mean(), Microseconds(50'000));
+}
+
+TEST(PipelineProfilerTest, histogram_total_is_exact)
+{
+    // total() - основа учета нагрузки в LoadController, бакеты на него не влияют
+    LatencyHistogram histogram;
+    const Microseconds huge = std::chrono::hours(24);  // за пределами диапазона бакетов
+    histogram.record(Microseconds(1'234'567));
+    histogram.record(Microseconds(7));
+    histogram.record(huge);
+
+    EXPECT_EQ(histogram.total(), Microseconds(1'234'574) + huge);
+    EXPECT_EQ(histogram.max(), huge);
+    EXPECT_EQ(histogram.percentile(1.0), huge);
+
+    histogram.reset();
+    EXPECT_EQ(histogram.count(), 0);
+    EXPECT_EQ(histogram.total(), Microseconds(0));
+    EXPECT_EQ(histogram.max(), Microseconds(0));
+    EXPECT_EQ(histogram.percentile(0.99), Microseconds(0));
+}
+
+TEST(PipelineProfilerTest, node_counters)
+{
+    PipelineProfiler profiler("test");
+    auto* node = profiler.register_node("node");
+    EXPECT_EQ(profiler.register_node("node"), node);
+    EXPECT_EQ(profiler.get_node_stats("node"), node);
+    EXPECT_EQ(profiler.get_node_stats("branch"), nullptr);
+
+    const auto start = profiler.now();
+    profiler.record_execution(node, start, start + Microseconds(300));
+    profiler.record_execution(node, start, start + Microseconds(100));
+    profiler.record_queue_wait(node, start, start + Microseconds(50));
+    profiler.record_drop(node);
+    profiler.record_exception(node);
+
+    // Незарегистрированные узлы игнорируются
+    profiler.record_execution(nullptr, start, start);
+    profiler.record_drop(nullptr);
+
+    const auto snapshot = profiler.get_nodes_snapshot();
+    ASSERT_EQ(snapshot.size(), 1);
+    EXPECT_EQ(snapshot.front().id, "node");
+    EXPECT_EQ(snapshot.front().processed, 2);
+    EXPECT_EQ(snapshot.front().dropped, 1);
+    EXPECT_EQ(snapshot.front().exceptions, 1);
+    EXPECT_EQ(snapshot.front().exec_mean, Microseconds(200));
+    EXPECT_EQ(snapshot.front().wait_max, Microseconds(50));
+    EXPECT_EQ(node->execution.total(), Microseconds(400));
+
+    profiler.reset();
+    EXPECT_EQ(node->processed, 0);
+    EXPECT_EQ(node->execution.count(), 0);
+}
+
+TEST(PipelineProfilerTest, chrome_trace_export)
+{
+    PipelineProfiler profiler("test \"pipeline\"");
+    auto* node = profiler.register_node("node");
+    auto* branch = profiler.register_branch("branch");
+
+    // Без записи trace-событий нет
+    const auto start = profiler.now();
+    profiler.record_execution(node, start, start + Microseconds(10));
+    EXPECT_EQ(count_substr(profiler.get_chrome_trace(), "\"ph\":\"X\""), 0);
+
+    profiler.start_trace(2);
+    EXPECT_TRUE(profiler.is_trace_enabled());
+    profiler.record_execution(node, start, start + Microseconds(10));
+    profiler.record_execution(branch, start, start + Microseconds(20));
+    profiler.record_execution(node, start, start + Microseconds(30));  // сверх max_events
+    profiler.stop_trace();
+    profiler.record_execution(node, start, start + Microseconds(40));
+
+    const auto trace = profiler.get_chrome_trace();
+    EXPECT_EQ(trace.rfind("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[", 0), 0);
+    EXPECT_EQ(trace.substr(trace.size() - 2), "]}");
+    EXPECT_EQ(count_substr(trace, "\"ph\":\"X\""), 2);
+    EXPECT_EQ(count_substr(trace, "\"name\":\"node\",\"cat\":\"node\""), 1);
+    EXPECT_EQ(count_substr(trace, "\"name\":\"branch\",\"cat\":\"branch\""), 1);
+    EXPECT_EQ(count_substr(trace, "\"dur\":20,"), 1);
+    EXPECT_EQ(count_substr(trace, "test \\\"pipeline\\\""), 1);
+    EXPECT_EQ(count_substr(trace, "{"), count_substr(trace, "}"));
+
+    // Счетчики ведутся независимо от записи событий
+    EXPECT_EQ(node->processed, 4);
+
+    const auto path = std::filesystem::temp_directory_path() / "step_pipeline_profiler_trace.json";
+    ASSERT_TRUE(profiler.export_chrome_trace(path));
+    std::ifstream file(path);
+    std::stringstream content;
+    content << file.rdbuf();
+    EXPECT_EQ(content.str(), trace);
+    file.close();
+    std::filesystem::remove(path);
+}
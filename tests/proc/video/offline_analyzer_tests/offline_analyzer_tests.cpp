@@ -0,0 +1,225 @@
+#include <core/base/json/json_utils.hpp>
+#include <core/base/types/config_fields.hpp>
+
+#include <core/task/settings_factory.hpp>
+#include <core/task/task_factory.hpp>
+
+#include <proc/interfaces/detector_interface.hpp>
+#include <proc/video/offline_analyzer.hpp>
+
+#include <application/registrator.hpp>
+
+#include <core/log/log.hpp>
+
+#include <gtest/gtest.h>
+
+#include <filesystem>
+#include <fstream>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace step;
+using namespace step::proc;
+
+namespace {
+
+constexpr size_t VIDEO_FRAMES = 40;
+constexpr int64_t VIDEO_FRAME_DURATION_US = 100'000;  // 10 fps
+
+struct TestDataProvider
+{
+    static std::filesystem::path test_data_dir()
+    {
+#ifndef OFFLINE_ANALYZER_TESTS_DATA_DIR
+#error "OFFLINE_ANALYZER_TESTS_DATA_DIR must be defined and point to valid testdata folder"
+#endif
+        std::filesystem::path path(OFFLINE_ANALYZER_TESTS_DATA_DIR);
+        assert(std::filesystem::is_directory(path));
+        return path;
+    }
+
+    static ObjectPtrJSON open_config(const std::string& config_path)
+    {
+        return step::json::utils::from_file(config_path);
+    }
+};
+
+/*! @brief Люди, которых фиктивный детектор находит на кадре с номером frame_index.
+    @details На каждом пятом кадре людей нет, на четных кадрах двое.
+*/
+std::vector<Rect> get_fake_persons(int64_t frame_index)
+{
+    const int i = static_cast<int>(frame_index);
+    if (i % 5 == 4)
+        return {};
+
+    std::vector<Rect> persons{Rect(i, i, i + 8, i + 8)};
+    if (i % 2 == 0)
+        persons.emplace_back(100 + i, 50, 120 + i, 90);
+    return persons;
+}
+
+int64_t get_frame_index(Timestamp ts) { return (ts.count() + VIDEO_FRAME_DURATION_US / 2) / VIDEO_FRAME_DURATION_US; }
+
+class FakePersonDetectorSettings : public task::BaseSettings
+{
+public:
+    TASK_SETTINGS(FakePersonDetectorSettings)
+
+    FakePersonDetectorSettings() = default;
+
+    bool operator==(const FakePersonDetectorSettings& rhs) const noexcept { return true; }
+    bool operator!=(const FakePersonDetectorSettings& rhs) const noexcept { return !(*this == rhs); }
+};
+
+/*! @brief Детектор людей без моделей: объекты определяются временем кадра, см. get_fake_persons.
+*/
+class FakePersonDetector : public BaseDetector<FakePersonDetectorSettings>
+{
+public:
+    DetectionResult process(video::Frame& frame) override
+    {
+        auto bboxes = get_fake_persons(get_frame_index(frame.ts));
+        std::vector<double> scores(bboxes.size(), 0.5);
+
+        MetaStorage storage;
+        storage.set_attachment(CFG_FLD::DETECTION_SCORES, std::move(scores));
+        return {std::move(bboxes), std::move(storage)};
+    }
+};
+
+const std::string FakePersonDetectorSettings::SETTINGS_ID = "FakePersonDetectorSettings";
+
+void FakePersonDetectorSettings::deserialize(const ObjectPtrJSON&) {}
+
+void register_fake_person_detector()
+{
+    static std::once_flag once;
+    std::call_once(once, []() {
+        REGISTER_TASK_SETTINGS_CREATOR(FakePersonDetectorSettings::SETTINGS_ID, [](const ObjectPtrJSON& cfg) {
+            return std::shared_ptr<task::BaseSettings>(std::make_shared<FakePersonDetectorSettings>(cfg));
+        });
+        REGISTER_TASK_CREATOR_UNIQUE(FakePersonDetectorSettings::SETTINGS_ID,
+                                     [](const std::shared_ptr<task::BaseSettings>&) {
+                                         return std::unique_ptr<task::IAbstractTask>(
+                                             std::make_unique<FakePersonDetector>());
+                                     });
+    });
+}
+
+std::string read_file(const std::filesystem::path& path)
+{
+    std::ifstream file(path);
+    std::stringstream content;
+    content << file.rdbuf();
+    return content.str();
+}
+
+/*! @brief Строки результатов без комментариев.
+*/
+std::vector<std::string> read_objects(const std::filesystem::path& path)
+{
+    std::vector<std::string> objects;
+    std::ifstream file(path);
+    for (std::string line; std::getline(file, line);)
+    {
+        if (!line.empty() && line.front() != '#')
+            objects.push_back(line);
+    }
+    return objects;
+}
+
+}  // namespace
+
+class OfflineAnalyzerTest : public ::testing::Test
+{
+public:
+    void SetUp()
+    {
+        step::log::Logger::instance().set_log_level(L_INFO);
+        step::app::Registrator::instance();
+        register_fake_person_detector();
+    }
+
+    void TearDown()
+    {
+        std::error_code ec;
+        for (const auto& path : m_results_paths)
+            std::filesystem::remove(path, ec);
+    }
+
+    std::filesystem::path get_results_path(const std::string& name)
+    {
+        m_results_paths.push_back(std::filesystem::temp_directory_path() / name);
+        return m_results_paths.back();
+    }
+
+private:
+    std::vector<std::filesystem::path> m_results_paths;
+};
+
+TEST_F(OfflineAnalyzerTest, segment_results_are_merged_in_order)
+{
+    const auto data_dir = TestDataProvider::test_data_dir();
+    const auto video = (data_dir / "persons_16x16_10fps.avi").string();
+    const auto cfg = TestDataProvider::open_config((data_dir / "offline_analyzer.json").string());
+
+    size_t expected_persons = 0;
+    for (size_t i = 0; i < VIDEO_FRAMES; ++i)
+        expected_persons += get_fake_persons(i).size();
+
+    // Один анализатор на оба прогона: пайплайны для сегментов добавляются к уже созданному
+    OfflineAnalyzer analyzer(cfg);
+    EXPECT_EQ(analyzer.get_face_engine(), nullptr);
+
+    const auto single_path = get_results_path("step_offline_analyzer_single.txt");
+    const auto single_stats = analyzer.analyze(video, single_path);
+    EXPECT_EQ(single_stats.segments, 1);
+    EXPECT_EQ(single_stats.frames, VIDEO_FRAMES);
+    EXPECT_EQ(single_stats.warmup_frames, 0);
+    EXPECT_EQ(single_stats.persons, expected_persons);
+
+    analyzer.set_segment_workers(3);
+    const auto segments_path = get_results_path("step_offline_analyzer_segments.txt");
+    const auto segments_stats = analyzer.analyze(video, segments_path);
+    EXPECT_EQ(segments_stats.segments, 3);
+    EXPECT_EQ(segments_stats.frames, VIDEO_FRAMES);
+    EXPECT_GT(segments_stats.warmup_frames, 0);
+    EXPECT_EQ(segments_stats.persons, expected_persons);
+    EXPECT_EQ(analyzer.get_profilers().size(), 3);
+
+    // Прогрев не попадает в результат, склейка частей дает тот же файл, что и обработка целиком
+    EXPECT_EQ(read_file(segments_path), read_file(single_path));
+    for (size_t i = 0; i < segments_stats.segments; ++i)
+    {
+        auto part_path = segments_path;
+        part_path += fmt::format(".part{}", i);
+        EXPECT_FALSE(std::filesystem::exists(part_path)) << part_path;
+    }
+
+    // Строки по возрастанию ts, люди кадра - в порядке детектора
+    const auto objects = read_objects(segments_path);
+    ASSERT_EQ(objects.size(), expected_persons);
+
+    size_t line = 0;
+    int64_t prev_ts = -1;
+    for (const auto& object : objects)
+    {
+        std::istringstream fields(object);
+        int64_t ts = 0;
+        char type = 0;
+        Rect rect;
+        fields >> ts >> type >> rect.p0.x >> rect.p0.y >> rect.p1.x >> rect.p1.y;
+        ASSERT_FALSE(fields.fail()) << object;
+        EXPECT_EQ(type, 'P');
+        EXPECT_GE(ts, prev_ts);
+
+        const auto persons = get_fake_persons(get_frame_index(Timestamp(ts)));
+        line = (ts == prev_ts) ? line + 1 : 0;
+        ASSERT_LT(line, persons.size()) << object;
+        EXPECT_EQ(rect, persons[line]) << object;
+        prev_ts = ts;
+    }
+}
@@ -0,0 +1,118 @@
+#include <proc/video/stream_scheduler.hpp>
+
+#include <gtest/gtest.h>
+
+#include <vector>
+
+using namespace step;
+using namespace step::proc;
+
+namespace {
+
+/*! @brief Обрабатывает rounds кадров готовых потоков с одинаковой ценой кадра, возвращает число кадров по потокам.
+*/
+std::vector<size_t> run_rounds(StreamScheduler& scheduler, const std::vector<bool>& ready, size_t rounds,
+                               Microseconds cost = Microseconds(100))
+{
+    std::vector<size_t> processed(scheduler.get_streams_count(), 0);
+    for (size_t i = 0; i < rounds; ++i)
+    {
+        const auto index = scheduler.pick([&ready](size_t index) { return ready[index]; });
+        if (!index)
+            break;
+
+        scheduler.start(*index);
+        scheduler.charge(*index, cost);
+        ++processed[*index];
+    }
+    return processed;
+}
+
+}  // namespace
+
+TEST(StreamSchedulerTest, no_ready_streams)
+{
+    StreamScheduler scheduler;
+    EXPECT_FALSE(scheduler.pick([](size_t) { return true; }).has_value());
+
+    scheduler.add_stream(1.0);
+    EXPECT_FALSE(scheduler.pick([](size_t) { return false; }).has_value());
+}
+
+TEST(StreamSchedulerTest, shares_follow_priorities)
+{
+    StreamScheduler scheduler;
+    EXPECT_EQ(scheduler.add_stream(2.0), 0);
+    EXPECT_EQ(scheduler.add_stream(1.0), 1);
+    EXPECT_EQ(scheduler.add_stream(1.0), 2);
+
+    const auto processed = run_rounds(scheduler, {true, true, true}, 400);
+    EXPECT_NEAR(static_cast<double>(processed[0]), 200.0, 1.0);
+    EXPECT_NEAR(static_cast<double>(processed[1]), 100.0, 1.0);
+    EXPECT_NEAR(static_cast<double>(processed[2]), 100.0, 1.0);
+}
+
+TEST(StreamSchedulerTest, pass_accounting)
+{
+    StreamScheduler scheduler;
+    scheduler.add_stream(4.0);
+    scheduler.add_stream(1.0);
+
+    scheduler.start(0);
+    scheduler.charge(0, Microseconds(400));
+    EXPECT_DOUBLE_EQ(scheduler.get_pass(0), 100.0);
+    EXPECT_DOUBLE_EQ(scheduler.get_virtual_time(), 0.0);
+
+    scheduler.start(1);
+    scheduler.charge(1, Microseconds(400));
+    EXPECT_DOUBLE_EQ(scheduler.get_pass(1), 400.0);
+
+    // Скачок часов не уменьшает виртуальное время
+    scheduler.charge(1, Microseconds(-50));
+    EXPECT_DOUBLE_EQ(scheduler.get_pass(1), 400.0);
+
+    // Виртуальное время - pass последнего начатого потока
+    scheduler.start(0);
+    EXPECT_DOUBLE_EQ(scheduler.get_virtual_time(), 100.0);
+}
+
+TEST(StreamSchedulerTest, idle_stream_does_not_accumulate_debt)
+{
+    StreamScheduler scheduler;
+    scheduler.add_stream(1.0);
+    scheduler.add_stream(1.0);
+
+    // Второй поток простаивает, пока первый обрабатывает 100 кадров
+    auto processed = run_rounds(scheduler, {true, false}, 100);
+    EXPECT_EQ(processed[0], 100);
+    EXPECT_EQ(processed[1], 0);
+    EXPECT_DOUBLE_EQ(scheduler.get_pass(1), 0.0);
+
+    // Вернувшись, поток получает текущее виртуальное время, а не 100 кадров подряд
+    scheduler.resume(1);
+    EXPECT_DOUBLE_EQ(scheduler.get_pass(1), scheduler.get_virtual_time());
+    EXPECT_GT(scheduler.get_pass(1), 0.0);
+
+    processed = run_rounds(scheduler, {true, true}, 20);
+    EXPECT_NEAR(static_cast<double>(processed[0]), 10.0, 1.0);
+    EXPECT_NEAR(static_cast<double>(processed[1]), 10.0, 1.0);
+
+    // Поток, не отстающий от очереди, resume не сдвигает
+    const auto pass = scheduler.get_pass(0);
+    scheduler.resume(0);
+    EXPECT_DOUBLE_EQ(scheduler.get_pass(0), pass);
+}
+
+TEST(StreamSchedulerTest, new_stream_starts_at_virtual_time)
+{
+    StreamScheduler scheduler;
+    scheduler.add_stream(1.0);
+    run_rounds(scheduler, {true}, 50);
+
+    const auto index = scheduler.add_stream(1.0);
+    EXPECT_DOUBLE_EQ(scheduler.get_pass(index), scheduler.get_virtual_time());
+
+    const auto processed = run_rounds(scheduler, {true, true}, 20);
+    EXPECT_NEAR(static_cast<double>(processed[0]), 10.0, 1.0);
+    EXPECT_NEAR(static_cast<double>(processed[1]), 10.0, 1.0);
+}
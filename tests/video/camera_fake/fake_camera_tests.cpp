@@ -213,6 +213,41 @@ TEST_F(FakeCameraSingleshotTest, varying_pixel_format)
     }
 }
 
+TEST_F(FakeCameraSingleshotTest, get_frame_cyclic_preloaded)
+{
+    const auto raw_file = std::filesystem::temp_directory_path() / "fake_camera_tests_frames.raw";
+    std::filesystem::remove(raw_file);
+
+    const step::video::FakeFrameReplay modes[] = {
+        step::video::FakeFrameReplay::Memory,
+        step::video::FakeFrameReplay::Mapped,
+        step::video::FakeFrameReplay::Mapped,  // file is already built
+    };
+
+    for (auto mode : modes)
+    {
+        step::video::FakeCameraSettings settings(TestDataProvider::test_data_dir(), true);
+        settings.replay = mode;
+        settings.replay_file = raw_file;
+        auto cam = create_camera_singleshot(settings);
+
+        for (int repeats = 0; repeats < 3; ++repeats)
+        {
+            for (const auto& reference_frame : m_reference_frames)
+            {
+                auto frame = cam->get_frame();
+                ASSERT_TRUE(frame.is_valid());
+                ASSERT_EQ(frame, reference_frame);
+            }
+        }
+
+        ASSERT_TRUE(!exhausted(cam));
+    }
+
+    ASSERT_TRUE(std::filesystem::is_regular_file(raw_file));
+    std::filesystem::remove(raw_file);
+}
+
 TEST_F(FakeCameraStreamingTest, constructible_destructible)
 {
     step::video::FakeCameraSettings settings(TestDataProvider::test_data_dir());
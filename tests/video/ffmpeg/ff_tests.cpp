@@ -6,11 +6,18 @@
 #include <video/frame/utils/frame_utils.hpp>
 
 #include <video/ffmpeg/reader/reader.hpp>
+#include <video/ffmpeg/decoding/avio_input.hpp>
+#include <video/ffmpeg/decoding/keyframe_index.hpp>
+#include <video/ffmpeg/reader/gop_frame_cache.hpp>
+#include <video/ffmpeg/reader/thumbnail_strip.hpp>
+#include <video/ffmpeg/reader/video_segments.hpp>
 
 #include <gtest/gtest.h>
 
+#include <algorithm>
 #include <atomic>
 #include <filesystem>
+#include <fstream>
 
 using namespace step;
 using namespace step::video;
@@ -210,4 +217,201 @@ TEST_F(FFTest, ff_reader_seek_over_the_end)
     EXPECT_NO_THROW(m_reader->step_forward());
 
     //ASSERT_EQ(ReaderState::EndOfFile, m_reader->get_state());
-}
\ No newline at end of file
+}
+
+TEST(ThumbnailStripTest, thumbnail_strip_generation)
+{
+    const std::string filepath = "C:/Work/test_video/IMG_5903.MOV";
+
+    ThumbnailStripSettings settings;
+    settings.count = 16;
+    settings.width = 160;
+
+    std::vector<FramePtr> thumbnails;
+    EXPECT_NO_THROW(thumbnails = generate_thumbnail_strip(filepath, settings));
+    ASSERT_EQ(thumbnails.size(), settings.count);
+
+    for (const auto& thumbnail : thumbnails)
+    {
+        ASSERT_TRUE(thumbnail);
+        EXPECT_EQ(thumbnail->size.width, settings.width);
+    }
+}
+
+TEST(AVIOInputTest, avio_input_read_and_seek)
+{
+    const auto path = (std::filesystem::temp_directory_path() / "step_avio_input_test.bin").string();
+    constexpr int64_t file_size = 1000000;
+    {
+        std::ofstream stream(path, std::ios::binary);
+        for (int64_t i = 0; i < file_size; ++i)
+            stream.put(static_cast<char>(i * 7));
+    }
+
+    IoSettings buffered;
+    buffered.buffer_size = 100000;
+    IoSettings prefetched = buffered;
+    prefetched.prefetch = true;
+    IoSettings mapped;
+    mapped.use_mmap = true;
+
+    for (const auto& settings : {buffered, prefetched, mapped})
+    {
+        AVIOInputFF input(path, settings);
+        auto* context = input.context();
+        ASSERT_EQ(avio_size(context), file_size);
+
+        constexpr int read_size = 300000;
+        std::vector<uint8_t> buffer(read_size);
+        ASSERT_EQ(avio_read(context, buffer.data(), read_size), read_size);
+        for (size_t i = 0; i < buffer.size(); ++i)
+            ASSERT_EQ(buffer[i], static_cast<uint8_t>(i * 7));
+
+        ASSERT_EQ(avio_seek(context, file_size - 10, SEEK_SET), file_size - 10);
+        ASSERT_EQ(avio_read(context, buffer.data(), 100), 10);
+        ASSERT_EQ(buffer[0], static_cast<uint8_t>((file_size - 10) * 7));
+
+        ASSERT_EQ(avio_seek(context, 500000, SEEK_SET), 500000);
+        ASSERT_EQ(avio_read(context, buffer.data(), 1000), 1000);
+        ASSERT_EQ(buffer[999], static_cast<uint8_t>((500000 + 999) * 7));
+
+        const auto stats = input.get_stats();
+        EXPECT_GE(stats.bytes_read, 300000u + 10u + 1000u);
+        EXPECT_GE(stats.seeks, 2u);
+        if (!settings.use_mmap)
+            EXPECT_LE(stats.storage_reads, 7u);
+    }
+
+    std::filesystem::remove(path);
+}
+
+TEST(KeyframeIndexTest, keyframe_index_lazy_find)
+{
+    KeyframeIndex index;
+    // GOP из 3 кадров по 40 мс, позиция в файле растет на 1000 байт на кадр
+    for (int i = 0; i < 9; ++i)
+        index.add_packet(i * 40 * AV_MILLISECOND, i * 40 * AV_MILLISECOND, i * 1000, i % 3 == 0);
+
+    ASSERT_EQ(3u, index.size());
+    ASSERT_FALSE(index.find(-1).has_value());
+
+    const auto keyframe = index.find(200 * AV_MILLISECOND);
+    ASSERT_TRUE(keyframe.has_value());
+    EXPECT_EQ(120 * AV_MILLISECOND, keyframe->pts);
+    EXPECT_EQ(3000, keyframe->pos);
+    EXPECT_EQ(3u, keyframe->gop_length);
+    EXPECT_TRUE(keyframe->closed);
+
+    // Последний GOP не закрыт: за прочитанными кадрами может оказаться непрочитанный ключевой
+    EXPECT_TRUE(index.find(320 * AV_MILLISECOND).has_value());
+    EXPECT_FALSE(index.find(10 * AV_SECOND).has_value());
+
+    index.set_complete(true);
+    EXPECT_TRUE(index.find(10 * AV_SECOND).has_value());
+}
+
+TEST(KeyframeIndexTest, keyframe_index_reread_after_seek)
+{
+    KeyframeIndex index;
+    for (int i = 0; i < 6; ++i)
+        index.add_packet(i * AV_SECOND, i * AV_SECOND, -1, i % 3 == 0);
+
+    // Повторное чтение первого GOP после seek не должно менять его длину
+    index.reset_cursor();
+    for (int i = 0; i < 3; ++i)
+        index.add_packet(i * AV_SECOND, i * AV_SECOND, -1, i % 3 == 0);
+
+    const auto keyframe = index.find(2 * AV_SECOND);
+    ASSERT_TRUE(keyframe.has_value());
+    EXPECT_EQ(0, keyframe->pts);
+    EXPECT_EQ(3u, keyframe->gop_length);
+}
+
+TEST(KeyframeIndexTest, keyframe_index_sidecar)
+{
+    const auto path = (std::filesystem::temp_directory_path() / "keyframe_index_test.kfidx").string();
+    constexpr int64_t FILE_SIZE = 123456;
+
+    KeyframeIndex index;
+    for (int i = 0; i < 10; ++i)
+        index.add_packet(i * AV_SECOND, i * AV_SECOND, i * 100, i % 5 == 0);
+    index.set_complete(true);
+    ASSERT_TRUE(index.save(path, FILE_SIZE));
+
+    KeyframeIndex loaded;
+    EXPECT_FALSE(loaded.load(path, FILE_SIZE + 1));
+    ASSERT_TRUE(loaded.load(path, FILE_SIZE));
+    EXPECT_TRUE(loaded.is_complete());
+    EXPECT_EQ(index.size(), loaded.size());
+
+    const auto keyframe = loaded.find(7 * AV_SECOND);
+    ASSERT_TRUE(keyframe.has_value());
+    EXPECT_EQ(5 * AV_SECOND, keyframe->pts);
+    EXPECT_EQ(500, keyframe->pos);
+
+    std::filesystem::remove(path);
+}
+
+TEST(GopFrameCacheTest, gop_frame_cache_lru_eviction)
+{
+    // Кадр 1000 байт, 40 мс; бюджет на 10 кадров, 3 GOP по 4 кадра
+    const auto make_frame = [](TimestampFF ts) {
+        auto frame = std::make_shared<Frame>();
+        frame->size.height = 10;
+        frame->stride = 100;
+        frame->ts = Timestamp(ts);
+        frame->duration = 40;
+        return frame;
+    };
+
+    GopFrameCache cache(10 * 1000);
+    for (TimestampFF gop = 0; gop < 3; ++gop)
+        for (TimestampFF i = 0; i < 4; ++i)
+            cache.put(gop * 160, make_frame(gop * 160 + i * 40));
+
+    // Первый GOP вытеснен целиком
+    EXPECT_EQ(8u * 1000, cache.get_memory_usage());
+    EXPECT_EQ(nullptr, cache.find_previous(160));
+
+    // Шаг назад через границу GOP
+    auto frame = cache.find_previous(320);
+    ASSERT_NE(nullptr, frame);
+    EXPECT_EQ(280, frame->ts.count());
+    EXPECT_EQ(160, cache.get_gop_start(280).value());
+}
+
+TEST(VideoSegmentsTest, video_segments_split_by_keyframes)
+{
+    // GOP по 2 с, файл 20 с
+    std::vector<TimestampFF> keyframes;
+    for (TimestampFF ts = 0; ts < 20 * AV_SECOND; ts += 2 * AV_SECOND)
+        keyframes.push_back(ts);
+
+    const auto segments = split_into_segments(keyframes, 20 * AV_SECOND, 3, 3 * AV_SECOND);
+    ASSERT_EQ(3u, segments.size());
+
+    // Границы - ближайшие ключевые кадры к 6.67 и 13.33 с, сегменты идут подряд
+    EXPECT_EQ(AV_NOPTS_VALUE, segments[0].start);
+    EXPECT_EQ(AV_NOPTS_VALUE, segments[0].warmup_start);
+    EXPECT_EQ(6 * AV_SECOND, segments[0].end);
+    EXPECT_EQ(segments[0].end, segments[1].start);
+    EXPECT_EQ(14 * AV_SECOND, segments[1].end);
+    EXPECT_EQ(segments[1].end, segments[2].start);
+    EXPECT_EQ(AV_NOPTS_VALUE, segments[2].end);
+
+    // Прогрев начинается с ключевого кадра не позже start - warmup
+    EXPECT_EQ(2 * AV_SECOND, segments[1].warmup_start);
+    EXPECT_EQ(10 * AV_SECOND, segments[2].warmup_start);
+
+    // Каждый кадр принадлежит ровно одному сегменту
+    for (TimestampFF ts = -AV_SECOND; ts < 20 * AV_SECOND; ts += 40 * AV_MILLISECOND)
+    {
+        const auto owners = std::count_if(segments.cbegin(), segments.cend(),
+                                          [ts](const VideoSegment& segment) { return segment.contains(ts); });
+        EXPECT_EQ(1, owners);
+    }
+
+    // Ключевых кадров меньше, чем сегментов
+    EXPECT_EQ(2u, split_into_segments({0, 10 * AV_SECOND}, 20 * AV_SECOND, 8).size());
+    EXPECT_EQ(1u, split_into_segments({0}, 20 * AV_SECOND, 8).size());
+}
@@ -108,6 +108,45 @@ TEST(Frame, empty_frame_construction_and_destruction_with_default_deleter)
     ASSERT_TRUE(frame.is_valid());
 }
 
+TEST(Frame, analysis_frames_shared_by_copies)
+{
+    AnalysisFrameFormat bgr_letterbox;
+    bgr_letterbox.size = {64, 32};
+    bgr_letterbox.pix_fmt = PixFmt::BGR;
+    bgr_letterbox.letterbox = true;
+
+    AnalysisFrameFormat rgb_small;
+    rgb_small.size = {32, 32};
+
+    AnalysisFrameFormat rgb_large;
+    rgb_large.size = {64, 64};
+
+    auto analysis_frames = std::make_shared<AnalysisFrames>();
+    for (const auto& format : {bgr_letterbox, rgb_small, rgb_large})
+        analysis_frames->push_back({format, std::make_shared<Frame>(format.size, format.pix_fmt)});
+
+    Frame frame({128, 128}, PixFmt::BGR);
+    frame.analysis_frames = analysis_frames;
+
+    Frame copy = frame;
+    ASSERT_EQ(copy.analysis_frames, analysis_frames);
+
+    Frame moved = std::move(copy);
+    ASSERT_EQ(moved.analysis_frames, analysis_frames);
+    ASSERT_FALSE(copy.analysis_frames);
+
+    ASSERT_EQ(find_analysis_frame(moved, bgr_letterbox), analysis_frames->at(0).frame);
+    ASSERT_EQ(find_analysis_frame(moved, rgb_small), analysis_frames->at(1).frame);
+
+    AnalysisFrameFormat bgr_plain = bgr_letterbox;
+    bgr_plain.letterbox = false;
+    ASSERT_FALSE(find_analysis_frame(moved, bgr_plain));
+
+    ASSERT_EQ(find_largest_analysis_frame(moved, PixFmt::RGB), analysis_frames->at(2).frame);
+    ASSERT_FALSE(find_largest_analysis_frame(moved, PixFmt::BGR));
+    ASSERT_FALSE(find_largest_analysis_frame(Frame({8, 8}, PixFmt::RGB), PixFmt::RGB));
+}
+
 TEST(Frame, frame_opening)
 {
     EXPECT_THROW(video::utils::open_file(TestDataProvider::frame_path(), PixFmt::Undefined), std::exception);